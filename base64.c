@@ -1,5 +1,22 @@
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
+
+#include "datatypes.h"
+#include "base64.h"
+#include "memutils.h"
+#include "stuff.h"
+#include "x86.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BASE64_SIMD
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define BASE64_SIMD
+#define TARGET_SSSE3
+#include <tmmintrin.h>
+#endif
 
 // copypasted from http://www.opensource.apple.com/source/QuickTimeStreamingServer/QuickTimeStreamingServer-452/CommonUtilitiesLib/base64.c
 //
@@ -79,34 +96,25 @@ int Base64decode(char *bufplain, const char *bufcoded)
 bool likely_base64_string (char* s)
 {
 	//printf ("%s() s=%s\n", __FUNCTION__, s);
-	size_t len=0;
-	size_t lower_case=0, upper_case=0, digits=0;
-	
-	for (; *s; s++)
-	{
-		len++;
-		if (*s>='A' && *s<='Z')
-			upper_case++;
-		if (*s>='a' && *s<='z')
-			lower_case++;
-		if (*s>='0' && *s<='9')
-			digits++;
-	};
+	struct byte_stats st;
+	byte_stats_calc ((byte*)s, strlen(s), &st);
+	size_t len=st.total;
+
 	// two times lower than distribution of characters in base64(random_data)
 	float latin_expected_value=26.0/64.0/2.0;
 	float digit_expected_value=10.0/64.0/2.0;
 
 	//printf ("latin_expected_value=%f\n", latin_expected_value);
 	//printf ("digits_expected_value=%f\n", digit_expected_value);
-	//printf ("upper_case / len=%f\n", (float)upper_case / (float)len);
-	//printf ("lower_case / len=%f\n", (float)upper_case / (float)len);
-	//printf ("digits / len=%f\n", (float)digits / (float)len);
+	//printf ("upper_case / len=%f\n", (float)st.upper / (float)len);
+	//printf ("lower_case / len=%f\n", (float)st.lower / (float)len);
+	//printf ("digits / len=%f\n", (float)st.digits / (float)len);
 
-	if ((float)upper_case / (float)len < latin_expected_value)
+	if ((float)st.upper / (float)len < latin_expected_value)
 		return false;
-	if ((float)lower_case / (float)len < latin_expected_value)
+	if ((float)st.lower / (float)len < latin_expected_value)
 		return false;
-	if ((float)digits / (float)len < digit_expected_value)
+	if ((float)st.digits / (float)len < digit_expected_value)
 		return false;
 	return true;
 };
@@ -114,16 +122,367 @@ bool likely_base64_string (char* s)
 // without padding symbol!
 bool is_base64_char(char c)
 {
-	if (c>='A' && c<='Z')
-		return true;
-	if (c>='a' && c<='z')
-		return true;
-	if (c>='0' && c<='9')
-		return true;
-	if (c=='+')
-		return true;
-	if (c=='/')
-		return true;
-	return false;
+	return (byte_class_table[(byte)c] & BYTE_CLASS_BASE64)!=0;
+};
+
+// length-safe and streaming codec
+
+static const char six2pr[64]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// can be turned off to measure/test scalar code
+bool base64_simd_enabled=true;
+
+#ifdef BASE64_SIMD
+static int have_ssse3=-1;
+
+static bool use_ssse3()
+{
+	if (base64_simd_enabled==false)
+		return false;
+	if (have_ssse3==-1)
+		have_ssse3=ssse3_supported();
+	return have_ssse3;
+};
+
+// Wojciech Muła's algorithm: http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+// 12 bytes -> 16 characters per iteration, reads 16 bytes, so stops when less than 16 left
+TARGET_SSSE3 static size_t encode_blocks_ssse3 (const byte *in, size_t len, char *out)
+{
+	const __m128i shift_LUT=_mm_setr_epi8('a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+			'0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '+'-62, '/'-63, 'A', 0, 0);
+	size_t k=0;
+
+	while (len-k>=16)
+	{
+		__m128i t=_mm_loadu_si128((const __m128i*)(in+k));
+		// each 32-bit lane: [b1, b0, b2, b1]
+		t=_mm_shuffle_epi8(t, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		__m128i t0=_mm_and_si128(t, _mm_set1_epi32(0x0fc0fc00));
+		__m128i t1=_mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+		__m128i t2=_mm_and_si128(t, _mm_set1_epi32(0x003f03f0));
+		__m128i t3=_mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+		__m128i idx=_mm_or_si128(t1, t3); // sextets
+
+		// sextet -> ASCII: add offset selected by range
+		__m128i r=_mm_subs_epu8(idx, _mm_set1_epi8(51));
+		__m128i less=_mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+		r=_mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+		r=_mm_shuffle_epi8(shift_LUT, r);
+		_mm_storeu_si128((__m128i*)out, _mm_add_epi8(r, idx));
+
+		k+=12;
+		out+=16;
+	};
+	return k;
+};
+
+// 16 characters -> 12 bytes per iteration, stops at first block with non-alphabet character
+TARGET_SSSE3 static size_t decode_blocks_ssse3 (const byte *in, size_t len, byte *out)
+{
+	size_t k=0;
+
+	while (len-k>=16)
+	{
+		__m128i c=_mm_loadu_si128((const __m128i*)(in+k));
+		// bytes >=0x80 are negative, so these signed comparisons reject them
+		__m128i upper=_mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A'-1)), _mm_cmplt_epi8(c, _mm_set1_epi8('Z'+1)));
+		__m128i lower=_mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a'-1)), _mm_cmplt_epi8(c, _mm_set1_epi8('z'+1)));
+		__m128i digit=_mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0'-1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9'+1)));
+		__m128i plus=_mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+		__m128i slash=_mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+
+		__m128i valid=_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+		if (_mm_movemask_epi8(valid)!=0xFFFF)
+			break;
+
+		__m128i shift=_mm_or_si128(
+				_mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26-'a'))),
+				_mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52-'0')),
+					_mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62-'+')), _mm_and_si128(slash, _mm_set1_epi8(63-'/')))));
+		__m128i v=_mm_add_epi8(c, shift);
+
+		// pack 4 sextets into 3 bytes in each 32-bit lane
+		__m128i t=_mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+		t=_mm_madd_epi16(t, _mm_set1_epi32(0x00011000));
+		t=_mm_shuffle_epi8(t, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+		_mm_storel_epi64((__m128i*)out, t);
+		tetra hi=_mm_cvtsi128_si32(_mm_srli_si128(t, 8));
+		memcpy(out+8, &hi, sizeof(tetra));
+
+		k+=16;
+		out+=12;
+	};
+	return k;
+};
+#endif
+
+// len must be multiple of 3
+static size_t encode_blocks (const byte *in, size_t len, char *out)
+{
+	size_t k=0;
+	char *o=out;
+#ifdef BASE64_SIMD
+	if (use_ssse3())
+	{
+		k=encode_blocks_ssse3(in, len, o);
+		o+=k/3*4;
+	};
+#endif
+	for (; k<len; k+=3)
+	{
+		tetra t=(in[k]<<16) | (in[k+1]<<8) | in[k+2];
+		*o++=six2pr[t>>18];
+		*o++=six2pr[(t>>12)&0x3F];
+		*o++=six2pr[(t>>6)&0x3F];
+		*o++=six2pr[t&0x3F];
+	};
+	return o-out;
 };
 
+// returns number of characters consumed (multiple of 4), stops at first non-alphabet character
+static size_t decode_blocks (const byte *in, size_t len, byte *out)
+{
+	size_t k=0;
+#ifdef BASE64_SIMD
+	if (use_ssse3())
+	{
+		k=decode_blocks_ssse3(in, len, out);
+		out+=k/4*3;
+	};
+#endif
+	for (; len-k>=4; k+=4)
+	{
+		byte a=pr2six[in[k]], b=pr2six[in[k+1]], c=pr2six[in[k+2]], d=pr2six[in[k+3]];
+		if ((a|b|c|d)>63)
+			break;
+		*out++=(a<<2) | (b>>4);
+		*out++=(b<<4) | (c>>2);
+		*out++=(c<<6) | d;
+	};
+	return k;
+};
+
+void base64_encoder_init (base64_encoder *e)
+{
+	e->carry_len=0;
+};
+
+size_t base64_encoder_feed (base64_encoder *e, const byte *in, size_t in_len, char *out)
+{
+	char *o=out;
+
+	// complete triplet left from previous call
+	if (e->carry_len)
+	{
+		byte tmp[3];
+		memcpy (tmp, e->carry, e->carry_len);
+		size_t n=min(3-e->carry_len, in_len);
+		memcpy (tmp+e->carry_len, in, n);
+		in+=n;
+		in_len-=n;
+		if (e->carry_len+n<3)
+		{
+			memcpy (e->carry, tmp, e->carry_len+n);
+			e->carry_len+=n;
+			return 0;
+		};
+		o+=encode_blocks(tmp, 3, o);
+		e->carry_len=0;
+	};
+
+	size_t bulk=in_len-in_len%3;
+	o+=encode_blocks(in, bulk, o);
+
+	e->carry_len=in_len-bulk;
+	memcpy (e->carry, in+bulk, e->carry_len);
+	return o-out;
+};
+
+size_t base64_encoder_finish (base64_encoder *e, char *out)
+{
+	size_t rt=0;
+
+	if (e->carry_len==1)
+	{
+		out[0]=six2pr[e->carry[0]>>2];
+		out[1]=six2pr[(e->carry[0]&3)<<4];
+		out[2]='=';
+		out[3]='=';
+		rt=4;
+	}
+	else if (e->carry_len==2)
+	{
+		out[0]=six2pr[e->carry[0]>>2];
+		out[1]=six2pr[((e->carry[0]&3)<<4) | (e->carry[1]>>4)];
+		out[2]=six2pr[(e->carry[1]&0xF)<<2];
+		out[3]='=';
+		rt=4;
+	};
+	e->carry_len=0;
+	return rt;
+};
+
+size_t base64_encode (const byte *in, size_t in_len, char *out)
+{
+	base64_encoder e;
+	base64_encoder_init (&e);
+	size_t rt=base64_encoder_feed (&e, in, in_len, out);
+	rt+=base64_encoder_finish (&e, out+rt);
+	out[rt]=0;
+	return rt;
+};
+
+void base64_decoder_init (base64_decoder *d, bool skip_whitespace)
+{
+	d->acc=0;
+	d->acc_len=0;
+	d->padding=0;
+	d->skip_whitespace=skip_whitespace;
+	d->pos=0;
+	d->err=BASE64_OK;
+	d->err_pos=0;
+};
+
+static enum base64_error decoder_set_error (base64_decoder *d, enum base64_error e, size_t pos)
+{
+	d->err=e;
+	d->err_pos=pos;
+	return e;
+};
+
+// flush 2 or 3 sextets of incomplete quantum
+static size_t decoder_flush_partial (base64_decoder *d, byte *out)
+{
+	size_t rt=0;
+	if (d->acc_len==2)
+	{
+		out[0]=(d->acc>>4)&0xFF;
+		rt=1;
+	}
+	else if (d->acc_len==3)
+	{
+		out[0]=(d->acc>>10)&0xFF;
+		out[1]=(d->acc>>2)&0xFF;
+		rt=2;
+	};
+	return rt;
+};
+
+enum base64_error base64_decoder_feed (base64_decoder *d, const char *in, size_t in_len, byte *out, size_t *out_len)
+{
+	const byte *s=(const byte*)in;
+	byte *o=out;
+	size_t i=0;
+
+	*out_len=0;
+	if (d->err!=BASE64_OK)
+		return d->err;
+
+	while (i<in_len)
+	{
+		// fast path: quantum boundary and no padding seen yet
+		if (d->acc_len==0 && d->padding==0)
+		{
+			size_t k=decode_blocks(s+i, in_len-i, o);
+			i+=k;
+			o+=k/4*3;
+			if (i==in_len)
+				break;
+		};
+
+		byte c=s[i];
+		byte v=pr2six[c];
+		if (v<=63)
+		{
+			if (d->padding)
+			{
+				*out_len=o-out;
+				return decoder_set_error (d, BASE64_ERR_TRAILING_DATA, d->pos+i);
+			};
+			d->acc=(d->acc<<6) | v;
+			d->acc_len++;
+			if (d->acc_len==4)
+			{
+				*o++=(d->acc>>16)&0xFF;
+				*o++=(d->acc>>8)&0xFF;
+				*o++=d->acc&0xFF;
+				d->acc=0;
+				d->acc_len=0;
+			};
+		}
+		else if (c=='=')
+		{
+			if (d->acc_len<2 || d->acc_len+d->padding>=4)
+			{
+				*out_len=o-out;
+				return decoder_set_error (d, BASE64_ERR_BAD_PADDING, d->pos+i);
+			};
+			if (d->padding==0)
+				o+=decoder_flush_partial (d, o);
+			d->padding++;
+		}
+		else if (d->skip_whitespace && (c==' ' || c=='\t' || c=='\r' || c=='\n'))
+			;
+		else
+		{
+			*out_len=o-out;
+			return decoder_set_error (d, BASE64_ERR_BAD_CHAR, d->pos+i);
+		};
+		i++;
+	};
+
+	d->pos+=in_len;
+	*out_len=o-out;
+	return BASE64_OK;
+};
+
+enum base64_error base64_decoder_finish (base64_decoder *d, byte *out, size_t *out_len)
+{
+	*out_len=0;
+	if (d->err!=BASE64_OK)
+		return d->err;
+
+	if (d->padding)
+	{
+		if (d->acc_len+d->padding!=4)
+			return decoder_set_error (d, BASE64_ERR_BAD_PADDING, d->pos);
+		return BASE64_OK;
+	};
+
+	if (d->acc_len==1)
+		return decoder_set_error (d, BASE64_ERR_TRUNCATED, d->pos);
+
+	*out_len=decoder_flush_partial (d, out);
+	d->acc_len=0;
+	return BASE64_OK;
+};
+
+enum base64_error base64_decode (const char *in, size_t in_len, byte *out, size_t *out_len, size_t *err_pos)
+{
+	base64_decoder d;
+	size_t n1, n2=0;
+
+	base64_decoder_init (&d, false);
+	enum base64_error rt=base64_decoder_feed (&d, in, in_len, out, &n1);
+	if (rt==BASE64_OK)
+		rt=base64_decoder_finish (&d, out+n1, &n2);
+
+	*out_len=n1+n2;
+	if (err_pos)
+		*err_pos=d.err_pos;
+	return rt;
+};
+
+const char *base64_error_to_string (enum base64_error e)
+{
+	switch (e)
+	{
+		case BASE64_OK: return "OK";
+		case BASE64_ERR_BAD_CHAR: return "character not in base64 alphabet";
+		case BASE64_ERR_BAD_PADDING: return "bad padding";
+		case BASE64_ERR_TRAILING_DATA: return "data after padding";
+		case BASE64_ERR_TRUNCATED: return "truncated quantum";
+		default: return "unknown error";
+	};
+};
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+
+#include "datatypes.h"
 
 #ifdef  __cplusplus
 extern "C" {
@@ -12,6 +15,66 @@ bool likely_base64_string (char* s);
 // without padding symbol!
 bool is_base64_char(char c);
 
+// length-safe codec, works on (ptr, len) and doesn't require NUL-terminated input
+
+enum base64_error
+{
+	BASE64_OK=0,
+	BASE64_ERR_BAD_CHAR,		// character not in alphabet
+	BASE64_ERR_BAD_PADDING,		// '=' at wrong place or too many of them
+	BASE64_ERR_TRAILING_DATA,	// something except padding after padding
+	BASE64_ERR_TRUNCATED		// single character in last quantum
+};
+
+// size of encoded string (without terminating zero) for n input bytes
+#define BASE64_ENCODED_LEN(n) ((((n)+2)/3)*4)
+// upper bound of decoded data size for n input characters
+#define BASE64_DECODED_MAXLEN(n) ((((n)+3)/4)*3)
+
+// out must be at least BASE64_ENCODED_LEN(in_len)+1 bytes, result is NUL-terminated
+// returns length of encoded string
+size_t base64_encode (const byte *in, size_t in_len, char *out);
+// out must be at least BASE64_DECODED_MAXLEN(in_len) bytes
+// err_pos (can be NULL) receives offset of offending character
+enum base64_error base64_decode (const char *in, size_t in_len, byte *out, size_t *out_len, size_t *err_pos);
+const char *base64_error_to_string (enum base64_error e);
+
+// incremental (streaming) encoder/decoder, input can be split at any place
+
+typedef struct _base64_encoder
+{
+	byte carry[2];
+	unsigned carry_len;
+} base64_encoder;
+
+void base64_encoder_init (base64_encoder *e);
+// out must be at least BASE64_ENCODED_LEN(in_len+2) bytes, no terminating zero is written
+// returns number of characters written
+size_t base64_encoder_feed (base64_encoder *e, const byte *in, size_t in_len, char *out);
+// flushes carried bytes with padding, out must be at least 4 bytes
+size_t base64_encoder_finish (base64_encoder *e, char *out);
+
+typedef struct _base64_decoder
+{
+	tetra acc; // sextets of current quantum
+	unsigned acc_len; // 0..3
+	unsigned padding; // '=' symbols seen
+	bool skip_whitespace;
+	size_t pos; // characters consumed so far
+	enum base64_error err; // sticky
+	size_t err_pos;
+} base64_decoder;
+
+// if skip_whitespace is set, spaces, tabs, CR and LF are ignored (as in PEM and MIME)
+void base64_decoder_init (base64_decoder *d, bool skip_whitespace);
+// out must be at least BASE64_DECODED_MAXLEN(in_len+3) bytes
+enum base64_error base64_decoder_feed (base64_decoder *d, const char *in, size_t in_len, byte *out, size_t *out_len);
+// flushes last incomplete quantum, out must be at least 2 bytes
+enum base64_error base64_decoder_finish (base64_decoder *d, byte *out, size_t *out_len);
+
+// SSSE3 code is used if CPU supports it, can be turned off to measure/test scalar code
+extern bool base64_simd_enabled;
+
 #ifdef  __cplusplus
 }
 #endif
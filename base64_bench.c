@@ -0,0 +1,73 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// throughput of Base64decode() vs base64_encode()/base64_decode(), scalar and SIMD
+
+#include <stdio.h>
+#include <string.h>
+
+#include "base64.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+#define BUF_SIZE (16*_1MiB)
+#define ROUNDS 10
+
+static void report (const char *name, double t, size_t size)
+{
+	printf ("%-28s %8.1f MiB/s\n", name, (double)size*ROUNDS/_1MiB/t);
+};
+
+int main()
+{
+	byte *plain=DMALLOC(byte, BUF_SIZE, "plain");
+	char *coded=DMALLOC(char, BASE64_ENCODED_LEN(BUF_SIZE)+1, "coded");
+	byte *decoded=DMALLOC(byte, BUF_SIZE+3, "decoded");
+	size_t coded_len, decoded_len;
+	double t;
+
+	for (size_t i=0; i<BUF_SIZE; i++)
+		plain[i]=(i*2654435761U)>>24;
+
+	for (int simd=0; simd<2; simd++)
+	{
+		base64_simd_enabled=simd;
+
+		t=get_monotonic_time();
+		for (int r=0; r<ROUNDS; r++)
+			coded_len=base64_encode(plain, BUF_SIZE, coded);
+		report (simd ? "base64_encode (SIMD)" : "base64_encode (scalar)", get_monotonic_time()-t, BUF_SIZE);
+
+		t=get_monotonic_time();
+		for (int r=0; r<ROUNDS; r++)
+			oassert(base64_decode(coded, coded_len, decoded, &decoded_len, NULL)==BASE64_OK);
+		report (simd ? "base64_decode (SIMD)" : "base64_decode (scalar)", get_monotonic_time()-t, coded_len);
+		oassert(decoded_len==BUF_SIZE && memcmp(plain, decoded, BUF_SIZE)==0);
+	};
+
+	t=get_monotonic_time();
+	for (int r=0; r<ROUNDS; r++)
+		oassert(Base64decode((char*)decoded, coded)==BUF_SIZE);
+	report ("Base64decode", get_monotonic_time()-t, coded_len);
+
+	DFREE(plain);
+	DFREE(coded);
+	DFREE(decoded);
+	dump_unfreed_blocks();
+};
+
@@ -28,6 +28,7 @@
 #include "memutils.h"
 #include "stuff.h"
 #include "fmt_utils.h"
+#include "threads.h"
 
 //#define LOGGING
 //#define BREAK_ON_UNKNOWN_BLOCK_BEING_FREED
@@ -38,6 +39,9 @@
 
 static size_t limit=500000000; // 500 MiB
 static size_t allocated=0;
+
+// protects tbl, seq_n and allocated, so DMALLOC/DFREE can be used from several threads
+static my_mutex lock=MY_MUTEX_INITIALIZER;
 #endif
 
 
@@ -70,6 +74,7 @@ static rbtree* tbl;
 
 static bool tbl_created=false;
 
+// must be called with lock held
 void store_info (void* user_ptr, size_t user_size, const char * filename, unsigned line, const char * function, 
         const char * structname)
 {
@@ -115,15 +120,19 @@ void* dmalloc (size_t size, const char * filename, unsigned line, const char * f
     fprintf (stderr, "%s(size=%d, filename=%s:%d func=%s struct=%s)\n", __func__, size, filename, line, function, structname);
 #endif
 
+#ifdef _DEBUG
+    // seq_n is counted only in debug builds, by store_info()
+    my_mutex_lock (&lock);
     if (break_on_seq_n && (seq_n==seq_n_to_break_on))
         debugger_breakpoint();
-
-#ifdef _DEBUG
     if (allocated+size > limit)
     {
         debugger_breakpoint();
         die ("%s() limit reached. allocated="PRI_SIZE_T_DEC" limit="PRI_SIZE_T_DEC" size="PRI_SIZE_T_DEC"\n", __FUNCTION__, allocated, limit, size);
     };
+    // counted right away, so two threads can't pass the limit together
+    allocated=allocated+size;
+    my_mutex_unlock (&lock);
 #endif
 
 #ifdef ADD_GUARDS
@@ -144,8 +153,9 @@ void* dmalloc (size_t size, const char * filename, unsigned line, const char * f
 #endif     
 
 #ifdef _DEBUG
+    my_mutex_lock (&lock);
     store_info (rt, size, filename, line, function, structname);
-    allocated=allocated+size;
+    my_mutex_unlock (&lock);
     //printf ("%s() allocated="PRI_SIZE_T_DEC" limit="PRI_SIZE_T_DEC" size="PRI_SIZE_T_DEC"\n", __FUNCTION__, allocated, limit, size);
 #endif
 
@@ -194,6 +204,7 @@ void* drealloc (void* ptr, size_t size, const char * filename, unsigned line, co
 #endif 
 
 #ifdef _DEBUG
+    my_mutex_lock (&lock);
     if (newptr!=ptr)
     {
         store_info (newptr, size, filename, line, function, structname);
@@ -209,6 +220,7 @@ void* drealloc (void* ptr, size_t size, const char * filename, unsigned line, co
         oassert(tmp && "drealloc(ptr): ptr isn't present in our records"); // ensure it's present
         tmp->user_size=size; // set new size
     };
+    my_mutex_unlock (&lock);
 #endif
 
 #ifdef LOGGING
@@ -306,6 +318,10 @@ void dfree2 (void* ptr, const char *filename, unsigned line, const char *funcnam
     if (ptr==NULL)
         return; // do nothing - by standard
 
+#ifdef _DEBUG
+    my_mutex_lock (&lock);
+#endif
+
 #ifdef DFREE_CHK_ALL_GUARDS
     chk_all_guards();
 #endif
@@ -350,6 +366,13 @@ void dfree2 (void* ptr, const char *filename, unsigned line, const char *funcnam
     }
     //printf ("%s() line %d allocated="PRI_SIZE_T_DEC" limit="PRI_SIZE_T_DEC" size="PRI_SIZE_T_DEC"\n", __FUNCTION__, __LINE__, allocated, limit, blk_user_size);
 #endif
+#endif
+
+#ifdef _DEBUG
+    my_mutex_unlock (&lock);
+#endif
+
+#ifdef ADD_GUARDS
     free ((byte*)ptr-4);
 #else
     free (ptr);
@@ -384,6 +407,7 @@ void dump_unfreed_blocks()
 {
 #ifdef _DEBUG
     //printf ("%s() begin\n", __FUNCTION__);
+    // no locking here: this is called at exit, when other threads are finished
     rbtree_foreach(tbl, (void(*)(void*,void*))dump_unfreed_block, NULL, NULL);
 #endif    
 };
@@ -391,12 +415,14 @@ void dump_unfreed_blocks()
 void dmalloc_deinit()
 {
 #ifdef _DEBUG
+    my_mutex_lock (&lock);
     if (tbl_created)
     {
         rbtree_foreach (tbl, NULL, NULL, free);
         rbtree_clear(tbl);
         tbl_created=false;
     };
+    my_mutex_unlock (&lock);
 #endif    
 };
 
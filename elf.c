@@ -19,6 +19,9 @@
 
 #include "stuff.h"
 #include "bitfields.h"
+#include "dmalloc.h"
+#include "files.h"
+#include "rbtree.h"
 
 // Offsets within the Ehdr e_ident field.
 
@@ -153,41 +156,46 @@ const char *SHT_x[]=
     "SHT_SYMTAB_SHNDX" // 18
 };
 
-void elf_dump_section (byte* buf, Elf32_Shdr *sect)
+static void dump_sh_flags (octa flags)
 {
-    printf ("sect->sh_name=%s\n", elf_get_str_from_shstr (buf, sect->sh_name));
-    printf ("sect->sh_type=");
-    if (sect->sh_type>SHT_SYMTAB_SHNDX)
-        printf ("?\n");
-    else
-        printf ("%s\n", SHT_x[sect->sh_type]);
-
     printf ("sect->sh_flags=");
-    if (IS_SET (sect->sh_flags, SHF_WRITE))             
+    if (IS_SET (flags, SHF_WRITE))
         printf ("SHF_WRITE ");
-    if (IS_SET (sect->sh_flags, SHF_ALLOC))             
+    if (IS_SET (flags, SHF_ALLOC))
         printf ("SHF_ALLOC ");
-    if (IS_SET (sect->sh_flags, SHF_EXECINSTR))         
+    if (IS_SET (flags, SHF_EXECINSTR))
         printf ("SHF_EXECINSTR ");
-    if (IS_SET (sect->sh_flags, SHF_MERGE))             
+    if (IS_SET (flags, SHF_MERGE))
         printf ("SHF_MERGE ");
-    if (IS_SET (sect->sh_flags, SHF_STRINGS))           
+    if (IS_SET (flags, SHF_STRINGS))
         printf ("SHF_STRINGS ");
-    if (IS_SET (sect->sh_flags, SHF_INFO_LINK))         
+    if (IS_SET (flags, SHF_INFO_LINK))
         printf ("SHF_INFO_LINK ");
-    if (IS_SET (sect->sh_flags, SHF_LINK_ORDER))        
+    if (IS_SET (flags, SHF_LINK_ORDER))
         printf ("SHF_LINK_ORDER ");
-    if (IS_SET (sect->sh_flags, SHF_OS_NONCONFORMING))  
+    if (IS_SET (flags, SHF_OS_NONCONFORMING))
         printf ("SHF_OS_NONCONFORMING ");
-    if (IS_SET (sect->sh_flags, SHF_GROUP))             
+    if (IS_SET (flags, SHF_GROUP))
         printf ("SHF_GROUP ");
-    if (IS_SET (sect->sh_flags, SHF_TLS))               
+    if (IS_SET (flags, SHF_TLS))
         printf ("SHF_TLS ");
-    if (IS_SET (sect->sh_flags, SHF_MASKOS))            
+    if (IS_SET (flags, SHF_MASKOS))
         printf ("SHF_MASKOS ");
-    if (IS_SET (sect->sh_flags, SHF_MASKPROC))          
+    if (IS_SET (flags, SHF_MASKPROC))
         printf ("SHF_MASKPROC ");
     printf ("\n");
+};
+
+void elf_dump_section (byte* buf, Elf32_Shdr *sect)
+{
+    printf ("sect->sh_name=%s\n", elf_get_str_from_shstr (buf, sect->sh_name));
+    printf ("sect->sh_type=");
+    if (sect->sh_type>SHT_SYMTAB_SHNDX)
+        printf ("?\n");
+    else
+        printf ("%s\n", SHT_x[sect->sh_type]);
+
+    dump_sh_flags (sect->sh_flags);
 
     printf ("sect->sh_addr=%d\n", sect->sh_addr);
     printf ("sect->sh_offset=0x%x\n", sect->sh_offset);
@@ -265,13 +273,15 @@ void elf_dump_sym (byte* buf, Elf32_Sym *sym)
             bnd_s, typ_s, sym->st_other, sym->st_shndx);
 };
 
+// slow, see elf_image_find_symbol_by_name()
 Elf32_Sym *elf_find_symbol_by_name (byte* buf, const char *name)
 {
-    int i;
+    int i, symbols_total=elf_get_symbols_total(buf);
     Elf32_Sym * s;
+    char *strings=(char*)elf_get_ptr_to_section_start (buf, elf_get_strtable_of_symtab (buf));
 
-    for (i=0,s=elf_get_first_symbol(buf); i<elf_get_symbols_total(buf); i++, s++)
-        if (!strcmp (elf_get_symbol_name(buf, s), name))
+    for (i=0,s=elf_get_first_symbol(buf); i<symbols_total; i++, s++)
+        if (!strcmp (strings + s->st_name, name))
             return s;
 
     // not found
@@ -331,11 +341,11 @@ Elf32_Shdr* elf_find_rel_section_for_section(byte *buf, int sect_n)
 
 void elf_dump_all_symbols (byte *buf)
 {
-    int i;
+    int i, symbols_total=elf_get_symbols_total(buf);
     Elf32_Sym * s;
 
-    printf ("symbols total: %d\n", elf_get_symbols_total(buf));
-    for (i=0,s=elf_get_first_symbol(buf); i<elf_get_symbols_total(buf); i++, s++)
+    printf ("symbols total: %d\n", symbols_total);
+    for (i=0,s=elf_get_first_symbol(buf); i<symbols_total; i++, s++)
         elf_dump_sym(buf, s);
 };
 
@@ -366,7 +376,7 @@ tetra elf_get_tetra_from_symbol_by_name_or_die(byte* buf, const char *name)
     return *(tetra*)s;
 };
 
-// FIXME: slow
+// slow: linear scans, see elf_relindex_find()
 Elf32_Rel* elf_find_reloc_for_sect_and_ofs (byte* buf, int sect_n, Elf32_Addr offset)
 {
     Elf32_Shdr *rel_section;
@@ -529,4 +539,2126 @@ char *elf_get_symbol_name_of_tetra_in_buf_or_NULL(byte *buf, tetra* point)
         return "<symbol not found>";
 };
 
+// ELF64
+
+bool elf64_chk_header(byte *buf)
+{
+    Elf64_Ehdr *hdr=elf64_get_ptr_to_hdr(buf);
+
+    if (hdr->e_ident[EI_MAG0]!=ELFMAG0 || hdr->e_ident[EI_MAG1]!=ELFMAG1 || hdr->e_ident[EI_MAG2]!=ELFMAG2 || hdr->e_ident[EI_MAG3]!=ELFMAG3)
+    {
+        printf ("This file is not ELF\n");
+        return false;
+    };
+
+    if (hdr->e_ident[EI_CLASS]!=ELFCLASS64)
+    {
+        printf ("Not a 64-bit ELF\n");
+        return false;
+    };
+
+    if (hdr->e_ident[EI_DATA]!=ELFDATA2LSB)
+    {
+        printf ("Not a LSB ELF\n");
+        return false;
+    };
+    oassert (hdr->e_ident[EI_VERSION]==EV_CURRENT);
+
+    if (hdr->e_ident[EI_OSABI]!=ELFOSABI_LINUX && hdr->e_ident[EI_OSABI]!=ELFOSABI_NONE)
+    {
+        printf ("Not a Linux ELF (hdr->e_ident[EI_OSABI]=%d)\n", hdr->e_ident[EI_OSABI]);
+        return false;
+    };
+
+    // relocatable files, executables and shared objects of any machine are fine here
+
+    oassert (hdr->e_version==EV_CURRENT);
+
+    oassert (hdr->e_shentsize == sizeof (Elf64_Shdr));
+
+    return true;
+};
+
+int elf_get_class(byte *buf)
+{
+    return buf[EI_CLASS];
+};
+
+void elf64_dump_hdr (byte *buf)
+{
+    Elf64_Ehdr *hdr=elf64_get_ptr_to_hdr(buf);
+
+    printf ("hdr->e_type=%d\n",      hdr->e_type);
+    printf ("hdr->e_machine=%d\n",   hdr->e_machine);
+    printf ("hdr->e_entry=0x%llx\n", hdr->e_entry);
+    printf ("hdr->e_phoff=0x%llx\n", hdr->e_phoff);
+    printf ("hdr->e_shoff=0x%llx\n", hdr->e_shoff);
+    printf ("hdr->e_flags=0x%x\n",   hdr->e_flags);
+    printf ("hdr->e_ehsize=%d\n",    hdr->e_ehsize);
+    printf ("hdr->e_phentsize=%d\n", hdr->e_phentsize);
+    printf ("hdr->e_phnum=%d\n",     hdr->e_phnum);
+    printf ("hdr->e_shentsize=%d\n", hdr->e_shentsize);
+    printf ("hdr->e_shnum=%d\n",     hdr->e_shnum);
+    printf ("hdr->e_shstrndx=%d\n",  hdr->e_shstrndx);
+};
+
+byte* elf64_get_ptr_to_section_start(byte* buf, int sect_n)
+{
+    oassert (sect_n < elf64_get_sections_total(buf));
+    return buf + elf64_get_ptr_to_section_struc (buf, sect_n)->sh_offset;
+};
+
+// SHN_UNDEF is returned if there is no such section
+Elf64_Half elf64_find_section_by_type (byte *buf, Elf64_Word type)
+{
+    Elf64_Half i;
+    Elf64_Shdr *s;
+
+    for (i=0,s=elf64_get_first_section(buf); i<elf64_get_sections_total (buf); i++, s++)
+        if (s->sh_type==type)
+            return i;
+
+    return SHN_UNDEF;
+};
+
+Elf64_Half elf64_find_symtab_section (byte *buf)
+{
+    Elf64_Half rt=elf64_find_section_by_type (buf, SHT_SYMTAB);
+
+    if (rt==SHN_UNDEF)
+        die ("symbol table is not found!\n");
+    oassert (elf64_get_ptr_to_section_struc (buf, rt)->sh_entsize == sizeof (Elf64_Sym)); // just to be sure
+    return rt;
+};
+
+char* elf64_get_str_from_shstr(byte* buf, int idx)
+{
+    return (char*)elf64_get_ptr_to_section_start (buf, elf64_get_ptr_to_hdr(buf)->e_shstrndx) + idx;
+};
+
+char *elf64_get_symbol_name(byte *buf, Elf64_Sym *s)
+{
+    return (char*)elf64_get_ptr_to_section_start (buf, elf64_get_strtable_of_symtab (buf)) + s->st_name;
+};
+
+void elf64_dump_section (byte* buf, Elf64_Shdr *sect)
+{
+    printf ("sect->sh_name=%s\n", elf64_get_str_from_shstr (buf, sect->sh_name));
+    printf ("sect->sh_type=");
+    if (sect->sh_type>SHT_SYMTAB_SHNDX)
+        printf ("0x%x\n", sect->sh_type);
+    else
+        printf ("%s\n", SHT_x[sect->sh_type]);
+
+    dump_sh_flags (sect->sh_flags);
+
+    printf ("sect->sh_addr=0x%llx\n", sect->sh_addr);
+    printf ("sect->sh_offset=0x%llx\n", sect->sh_offset);
+    printf ("sect->sh_size=%lld\n", sect->sh_size);
+    printf ("sect->sh_link=%d\n", sect->sh_link);
+    printf ("sect->sh_info=%d\n", sect->sh_info);
+    printf ("sect->sh_addralign=%lld\n", sect->sh_addralign);
+    printf ("sect->sh_entsize=%lld\n", sect->sh_entsize);
+};
+
+void elf64_dump_all_sections(byte *buf)
+{
+    int i;
+    Elf64_Shdr *s;
+
+    for (i=0,s=elf64_get_first_section(buf); i<elf64_get_sections_total(buf); i++, s++)
+    {
+        elf64_dump_section (buf, s);
+        printf ("\n");
+    };
+};
+
+Elf64_Sym *elf64_get_n_symbol(byte* buf, int n)
+{
+    oassert (n < elf64_get_symbols_total(buf));
+    return elf64_get_first_symbol(buf) + n;
+};
+
+void elf64_dump_sym (byte* buf, Elf64_Sym *sym)
+{
+    const char *bnd_s;
+    const char *typ_s;
+
+    if (ELF64_ST_BIND (sym->st_info)>STB_HIPROC)
+        bnd_s="?";
+    else
+        bnd_s=STB_x[ELF64_ST_BIND (sym->st_info)];
+
+    if (ELF64_ST_TYPE (sym->st_info)>STT_HIPROC)
+        typ_s="?";
+    else
+        typ_s=STT_x[ELF64_ST_TYPE (sym->st_info)];
+
+    printf ("st_name=%-31s st_value=0x%016llx st_size=%5lld st_info=%-10s %-11s st_other=%d st_shndx=%d\n",
+            elf64_get_symbol_name(buf, sym),
+            sym->st_value, sym->st_size,
+            bnd_s, typ_s, sym->st_other, sym->st_shndx);
+};
+
+// slow, see elf_image_find_symbol_by_name()
+Elf64_Sym *elf64_find_symbol_by_name (byte* buf, const char *name)
+{
+    int i, symbols_total=elf64_get_symbols_total(buf);
+    Elf64_Sym *s;
+    char *strings=(char*)elf64_get_ptr_to_section_start (buf, elf64_get_strtable_of_symtab (buf));
+
+    for (i=0,s=elf64_get_first_symbol(buf); i<symbols_total; i++, s++)
+        if (!strcmp (strings + s->st_name, name))
+            return s;
+
+    // not found
+    return NULL;
+};
+
+void elf64_dump_all_symbols (byte *buf)
+{
+    int i, symbols_total=elf64_get_symbols_total(buf);
+    Elf64_Sym *s;
+
+    printf ("symbols total: %d\n", symbols_total);
+    for (i=0,s=elf64_get_first_symbol(buf); i<symbols_total; i++, s++)
+        elf64_dump_sym(buf, s);
+};
+
+// symbol index
+
+// section header fields, of both ELF classes
+struct sect_info
+{
+    tetra type, link, info;
+    octa flags, addr, offset, size, entsize;
+};
+
+static unsigned get_sections_total (byte *buf)
+{
+    if (elf_get_class(buf)==ELFCLASS64)
+        return elf64_get_sections_total(buf);
+    return elf_get_sections_total(buf);
+};
+
+static void get_sect_info (byte *buf, unsigned n, struct sect_info *out)
+{
+    if (elf_get_class(buf)==ELFCLASS64)
+    {
+        Elf64_Shdr *s=elf64_get_ptr_to_section_struc(buf, n);
+        out->type=s->sh_type; out->link=s->sh_link; out->info=s->sh_info; out->flags=s->sh_flags;
+        out->addr=s->sh_addr; out->offset=s->sh_offset; out->size=s->sh_size; out->entsize=s->sh_entsize;
+    }
+    else
+    {
+        Elf32_Shdr *s=elf_get_ptr_to_section_struc(buf, n);
+        out->type=s->sh_type; out->link=s->sh_link; out->info=s->sh_info; out->flags=s->sh_flags;
+        out->addr=s->sh_addr; out->offset=s->sh_offset; out->size=s->sh_size; out->entsize=s->sh_entsize;
+    };
+};
+
+// string table linked from a symbol table: it must be SHT_STRTAB and terminated, NULL is returned otherwise
+static char *get_linked_strtab (byte *buf, tetra n, octa *out_size)
+{
+    struct sect_info si;
+
+    if (n>=get_sections_total(buf))
+        return NULL;
+    get_sect_info (buf, n, &si);
+    if (si.type!=SHT_STRTAB || si.size==0 || buf[si.offset + si.size - 1]!=0)
+        return NULL;
+    *out_size=si.size;
+    return (char*)(buf + si.offset);
+};
+
+// number of section of this type or -1
+static int find_section_by_type (byte *buf, tetra type)
+{
+    struct sect_info si;
+    unsigned i, total=get_sections_total(buf);
+
+    for (i=0; i<total; i++)
+    {
+        get_sect_info (buf, i, &si);
+        if (si.type==type)
+            return i;
+    };
+    return -1;
+};
+
+// hash functions used in SHT_GNU_HASH and SHT_HASH sections
+static tetra gnu_hash (const char *name)
+{
+    tetra h=5381;
+
+    for (const byte *p=(const byte*)name; *p; p++)
+        h=h*33 + *p;
+    return h;
+};
+
+static tetra sysv_hash (const char *name)
+{
+    tetra h=0, g;
+
+    for (const byte *p=(const byte*)name; *p; p++)
+    {
+        h=(h<<4) + *p;
+        g=h & 0xf0000000;
+        if (g)
+            h^=g>>24;
+        h&=~g;
+    };
+    return h;
+};
+
+struct elf_symindex
+{
+    int elf_class;
+    elf_symbol *syms; // all symbols, in symbol table order
+    size_t total;
+
+    // own hash table for symbols [0, own_limit): slots keep symbol number+1, 0 is empty slot
+    tetra *slots, *hashes;
+    size_t slots_total, own_limit;
+
+    // SHT_GNU_HASH section (if it's used), for symbols starting at gnu_symoffset
+    tetra gnu_nbuckets, gnu_symoffset, gnu_bloom_size, gnu_bloom_shift;
+    byte *gnu_bloom;
+    tetra *gnu_buckets, *gnu_chain;
+
+    // SHT_HASH section (if it's used), for all symbols
+    tetra sysv_nbuckets;
+    tetra *sysv_buckets, *sysv_chain;
+
+    // symbol numbers, sorted by (section, value) and by address
+    tetra *by_sect, *by_addr;
+    size_t by_sect_total, by_addr_total;
+};
+
+// section of type SHT_GNU_HASH or SHT_HASH for the symbol table, if it's correct
+static bool use_gnu_hash (byte *buf, int symtab_n, elf_symindex *ix)
+{
+    struct sect_info si;
+    int n=find_section_by_type (buf, SHT_GNU_HASH);
+    tetra *hdr, bloom_word_size=ix->elf_class==ELFCLASS64 ? 8 : 4;
+
+    if (n==-1)
+        return false;
+    get_sect_info (buf, n, &si);
+    if (si.link!=symtab_n || si.size<16)
+        return false;
+    hdr=(tetra*)(buf + si.offset);
+    ix->gnu_nbuckets=hdr[0];
+    ix->gnu_symoffset=hdr[1];
+    ix->gnu_bloom_size=hdr[2];
+    ix->gnu_bloom_shift=hdr[3];
+    if (ix->gnu_nbuckets==0 || ix->gnu_bloom_size==0 || ix->gnu_symoffset>ix->total
+            || 16 + (octa)ix->gnu_bloom_size*bloom_word_size + (octa)ix->gnu_nbuckets*4
+            + (octa)(ix->total-ix->gnu_symoffset)*4 > si.size)
+        return false;
+    ix->gnu_bloom=(byte*)(hdr+4);
+    ix->gnu_buckets=(tetra*)(ix->gnu_bloom + ix->gnu_bloom_size*bloom_word_size);
+    ix->gnu_chain=ix->gnu_buckets + ix->gnu_nbuckets;
+    // symbols below gnu_symoffset (usually undefined ones) are not in GNU hash table
+    ix->own_limit=ix->gnu_symoffset;
+    return true;
+};
+
+static bool use_sysv_hash (byte *buf, int symtab_n, elf_symindex *ix)
+{
+    struct sect_info si;
+    int n=find_section_by_type (buf, SHT_HASH);
+    tetra *hdr;
+
+    if (n==-1)
+        return false;
+    get_sect_info (buf, n, &si);
+    if (si.link!=symtab_n || si.size<8)
+        return false;
+    hdr=(tetra*)(buf + si.offset);
+    if (hdr[0]==0 || hdr[1]!=ix->total || 8 + ((octa)hdr[0]+hdr[1])*4 > si.size)
+        return false;
+    ix->sysv_nbuckets=hdr[0];
+    ix->sysv_buckets=hdr+2;
+    ix->sysv_chain=ix->sysv_buckets + hdr[0];
+    ix->own_limit=0;
+    return true;
+};
+
+static void build_own_hash (elf_symindex *ix)
+{
+    size_t mask;
+
+    if (ix->own_limit==0)
+        return;
+    for (ix->slots_total=16; ix->slots_total < ix->own_limit*2; ix->slots_total*=2)
+        ;
+    mask=ix->slots_total-1;
+    ix->slots=DCALLOC(tetra, ix->slots_total, "elf_symindex slots");
+    ix->hashes=DMALLOC(tetra, ix->own_limit, "elf_symindex hashes");
+    for (size_t i=0; i<ix->own_limit; i++)
+    {
+        size_t slot;
+        ix->hashes[i]=gnu_hash (ix->syms[i].name);
+        if (ix->syms[i].name[0]==0)
+            continue;
+        // symbols with the same name are kept in symbol table order along the probe sequence
+        for (slot=ix->hashes[i] & mask; ix->slots[slot]; slot=(slot+1) & mask)
+            ;
+        ix->slots[slot]=i+1;
+    };
+};
+
+struct sort_key
+{
+    octa value;
+    tetra shndx, n;
+};
+
+static int cmp_sort_keys(const void *_p1, const void *_p2)
+{
+    const struct sort_key *p1=(const struct sort_key*)_p1;
+    const struct sort_key *p2=(const struct sort_key*)_p2;
+
+    if (p1->shndx!=p2->shndx) return p1->shndx<p2->shndx ? -1 : 1;
+    if (p1->value!=p2->value) return p1->value<p2->value ? -1 : 1;
+    if (p1->n!=p2->n) return p1->n<p2->n ? -1 : 1;
+    return 0;
+};
+
+// by address: only symbols which have addresses, i.e. not TLS ones (their values are offsets in TLS segment)
+// and not in sections which aren't loaded
+static tetra* build_sorted (elf_symindex *ix, byte *buf, bool by_addr, size_t *out_total)
+{
+    unsigned sections_total=get_sections_total(buf);
+    struct sect_info si;
+    struct sort_key *keys=DMALLOC(struct sort_key, ix->total, "sort keys");
+    size_t total=0;
+    tetra *rt;
+
+    for (size_t i=0; i<ix->total; i++)
+    {
+        elf_symbol *s=&ix->syms[i];
+        if (by_addr)
+        {
+            if (s->shndx==SHN_UNDEF || s->shndx>=SHN_LORESERVE || s->type==STT_SECTION || s->type==STT_FILE ||
+                    s->type==STT_TLS || s->shndx>=sections_total)
+                continue;
+            get_sect_info (buf, s->shndx, &si);
+            if ((si.flags & SHF_ALLOC)==0)
+                continue;
+        }
+        else if (s->shndx>=sections_total)
+            continue;
+        keys[total].value=s->value;
+        keys[total].shndx=by_addr ? 0 : s->shndx;
+        keys[total].n=i;
+        total++;
+    };
+    qsort (keys, total, sizeof(struct sort_key), cmp_sort_keys);
+    rt=DMALLOC(tetra, total ? total : 1, "elf_symindex sorted");
+    for (size_t i=0; i<total; i++)
+        rt[i]=keys[i].n;
+    DFREE(keys);
+    *out_total=total;
+    return rt;
+};
+
+// returns false (and name is NULL) if the name is out of the string table
+static bool read_symbol (int class, byte *p, char *strings, octa strings_size, tetra n, elf_symbol *out)
+{
+    tetra name;
+
+    out->n=n;
+    if (class==ELFCLASS64)
+    {
+        Elf64_Sym *s=(Elf64_Sym*)p;
+        name=s->st_name;
+        out->value=s->st_value;
+        out->size=s->st_size;
+        out->shndx=s->st_shndx;
+        out->bind=ELF64_ST_BIND(s->st_info);
+        out->type=ELF64_ST_TYPE(s->st_info);
+    }
+    else
+    {
+        Elf32_Sym *s=(Elf32_Sym*)p;
+        name=s->st_name;
+        out->value=s->st_value;
+        out->size=s->st_size;
+        out->shndx=s->st_shndx;
+        out->bind=ELF32_ST_BIND(s->st_info);
+        out->type=ELF32_ST_TYPE(s->st_info);
+    };
+    if (strings==NULL || name>=strings_size)
+    {
+        out->name=NULL;
+        return false;
+    };
+    out->name=strings + name;
+    return true;
+};
+
+elf_symindex *elf_symindex_build (byte *buf, bool dynamic)
+{
+    int class=elf_get_class(buf), symtab_n, i;
+    struct sect_info si;
+    elf_symindex *ix;
+    byte *p;
+    char *strings;
+    octa strings_size;
+
+    symtab_n=find_section_by_type (buf, dynamic ? SHT_DYNSYM : SHT_SYMTAB);
+    if (symtab_n==-1)
+        return NULL;
+    get_sect_info (buf, symtab_n, &si);
+    oassert (si.entsize==(class==ELFCLASS64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym)));
+    strings=get_linked_strtab (buf, si.link, &strings_size);
+    if (strings==NULL)
+        return NULL;
+
+    ix=DCALLOC(elf_symindex, 1, "elf_symindex");
+    ix->elf_class=class;
+    ix->total=si.size / si.entsize;
+    ix->syms=DMALLOC(elf_symbol, ix->total ? ix->total : 1, "elf_symbol");
+    for (i=0, p=buf + si.offset; i<ix->total; i++, p+=si.entsize)
+        if (!read_symbol (class, p, strings, strings_size, i, &ix->syms[i]))
+        {
+            // damaged
+            DFREE(ix->syms);
+            DFREE(ix);
+            return NULL;
+        };
+
+    ix->own_limit=ix->total;
+    if (dynamic && !use_gnu_hash (buf, symtab_n, ix))
+        use_sysv_hash (buf, symtab_n, ix);
+    build_own_hash (ix);
+
+    ix->by_sect=build_sorted (ix, buf, false, &ix->by_sect_total);
+    ix->by_addr=build_sorted (ix, buf, true, &ix->by_addr_total);
+    return ix;
+};
+
+void elf_symindex_free (elf_symindex *ix)
+{
+    if (ix==NULL)
+        return;
+    DFREE(ix->syms);
+    if (ix->slots)
+    {
+        DFREE(ix->slots);
+        DFREE(ix->hashes);
+    };
+    DFREE(ix->by_sect);
+    DFREE(ix->by_addr);
+    DFREE(ix);
+};
+
+size_t elf_symindex_size (elf_symindex *ix)
+{
+    return ix->total;
+};
+
+elf_symbol *elf_symindex_get (elf_symindex *ix, size_t n)
+{
+    oassert (n < ix->total);
+    return &ix->syms[n];
+};
+
+static elf_symbol *find_in_gnu_hash (elf_symindex *ix, const char *name, tetra h)
+{
+    tetra bloom_bits=ix->elf_class==ELFCLASS64 ? 64 : 32;
+    tetra word_n=(h / bloom_bits) & (ix->gnu_bloom_size-1);
+    octa word=0, mask;
+    tetra n;
+
+    memcpy (&word, ix->gnu_bloom + word_n*(bloom_bits/8), bloom_bits/8);
+    mask=(1ULL << (h % bloom_bits)) | (1ULL << ((h >> ix->gnu_bloom_shift) % bloom_bits));
+    if ((word & mask)!=mask)
+        return NULL;
+
+    n=ix->gnu_buckets[h % ix->gnu_nbuckets];
+    if (n<ix->gnu_symoffset)
+        return NULL;
+    for (; n<ix->total; n++)
+    {
+        tetra h2=ix->gnu_chain[n - ix->gnu_symoffset];
+        if ((h|1)==(h2|1) && strcmp (ix->syms[n].name, name)==0)
+            return &ix->syms[n];
+        if (h2 & 1) // end of chain
+            break;
+    };
+    return NULL;
+};
+
+static elf_symbol *find_in_sysv_hash (elf_symindex *ix, const char *name)
+{
+    tetra n;
+    size_t steps=0;
+
+    for (n=ix->sysv_buckets[sysv_hash(name) % ix->sysv_nbuckets]; n!=0 && n<ix->total && steps<ix->total;
+            n=ix->sysv_chain[n], steps++)
+        if (strcmp (ix->syms[n].name, name)==0)
+            return &ix->syms[n];
+    return NULL;
+};
+
+elf_symbol *elf_symindex_find_by_name (elf_symindex *ix, const char *name)
+{
+    tetra h=gnu_hash (name);
+
+    if (ix->slots)
+    {
+        size_t mask=ix->slots_total-1;
+        for (size_t slot=h & mask; ix->slots[slot]; slot=(slot+1) & mask)
+        {
+            tetra n=ix->slots[slot]-1;
+            if (ix->hashes[n]==h && strcmp (ix->syms[n].name, name)==0)
+                return &ix->syms[n];
+        };
+    };
+    if (ix->gnu_buckets)
+        return find_in_gnu_hash (ix, name, h);
+    if (ix->sysv_buckets)
+        return find_in_sysv_hash (ix, name);
+    return NULL;
+};
+
+// first position in a sorted array where (shndx, value) >= (sect_n, value)
+static size_t lower_bound (elf_symindex *ix, tetra *a, size_t total, bool use_shndx, tetra shndx, octa value)
+{
+    size_t lo=0, hi=total;
+
+    while (lo<hi)
+    {
+        size_t mid=lo + (hi-lo)/2;
+        elf_symbol *s=&ix->syms[a[mid]];
+        tetra s_shndx=use_shndx ? s->shndx : 0;
+        if (s_shndx<shndx || (s_shndx==shndx && s->value<value))
+            lo=mid+1;
+        else
+            hi=mid;
+    };
+    return lo;
+};
+
+elf_symbol *elf_symindex_find_by_sect_and_value (elf_symindex *ix, int sect_n, octa value)
+{
+    size_t i=lower_bound (ix, ix->by_sect, ix->by_sect_total, true, sect_n, value);
+
+    if (i<ix->by_sect_total)
+    {
+        elf_symbol *s=&ix->syms[ix->by_sect[i]];
+        if (s->shndx==sect_n && s->value==value)
+            return s;
+    };
+    return NULL;
+};
+
+elf_symbol *elf_symindex_find_by_addr (elf_symindex *ix, octa addr)
+{
+    // the last symbol starting at or below addr, then the first of symbols at the same address
+    size_t i=lower_bound (ix, ix->by_addr, ix->by_addr_total, false, 0, addr+1);
+    octa value;
+
+    if (i==0 || addr==(octa)-1)
+        return NULL;
+    value=ix->syms[ix->by_addr[i-1]].value;
+    for (i=lower_bound (ix, ix->by_addr, ix->by_addr_total, false, 0, value);
+            i<ix->by_addr_total && ix->syms[ix->by_addr[i]].value==value; i++)
+    {
+        elf_symbol *s=&ix->syms[ix->by_addr[i]];
+        if (addr==value || addr-value < s->size)
+            return s;
+    };
+    return NULL;
+};
+
+// relocation index
+
+struct sect_span
+{
+    octa offset, size;
+    tetra n;
+};
+
+struct elf_relindex
+{
+    int elf_class;
+    byte *buf;
+    elf_reloc *relocs; // sorted by (sect_n, offset)
+    size_t total;
+    // sections having contents in file, sorted by offset
+    struct sect_span *sects;
+    size_t sects_total;
+};
+
+static int cmp_relocs(const void *_p1, const void *_p2)
+{
+    const elf_reloc *p1=(const elf_reloc*)_p1;
+    const elf_reloc *p2=(const elf_reloc*)_p2;
+
+    if (p1->sect_n!=p2->sect_n) return p1->sect_n<p2->sect_n ? -1 : 1;
+    if (p1->offset!=p2->offset) return p1->offset<p2->offset ? -1 : 1;
+    if (p1->n!=p2->n) return p1->n<p2->n ? -1 : 1;
+    return 0;
+};
+
+static int cmp_sect_spans(const void *_p1, const void *_p2)
+{
+    const struct sect_span *p1=(const struct sect_span*)_p1;
+    const struct sect_span *p2=(const struct sect_span*)_p2;
+
+    if (p1->offset!=p2->offset) return p1->offset<p2->offset ? -1 : 1;
+    if (p1->n!=p2->n) return p1->n<p2->n ? -1 : 1;
+    return 0;
+};
+
+static void read_reloc (int class, byte *p, bool rela, elf_reloc *out)
+{
+    if (class==ELFCLASS64)
+    {
+        Elf64_Rela *r=(Elf64_Rela*)p; // Elf64_Rel is its prefix
+        out->offset=r->r_offset;
+        out->sym=ELF64_R_SYM(r->r_info);
+        out->type=ELF64_R_TYPE(r->r_info);
+        out->addend=rela ? r->r_addend : 0;
+    }
+    else
+    {
+        Elf32_Rela *r=(Elf32_Rela*)p; // Elf32_Rel is its prefix
+        out->offset=r->r_offset;
+        out->sym=ELF32_R_SYM(r->r_info);
+        out->type=ELF32_R_TYPE(r->r_info);
+        out->addend=rela ? r->r_addend : 0;
+    };
+    out->rela=rela;
+};
+
+elf_relindex *elf_relindex_build (byte *buf)
+{
+    int class=elf_get_class(buf);
+    unsigned i, sections_total=get_sections_total(buf);
+    struct sect_info si;
+    elf_relindex *ix=DCALLOC(elf_relindex, 1, "elf_relindex");
+    size_t rel_size=class==ELFCLASS64 ? sizeof(Elf64_Rel) : sizeof(Elf32_Rel);
+    size_t rela_size=class==ELFCLASS64 ? sizeof(Elf64_Rela) : sizeof(Elf32_Rela);
+
+    ix->elf_class=class;
+    ix->buf=buf;
+    ix->sects=DMALLOC(struct sect_span, sections_total ? sections_total : 1, "sect_span");
+
+    // count relocations first
+    for (i=0; i<sections_total; i++)
+    {
+        get_sect_info (buf, i, &si);
+        if (si.type==SHT_REL || si.type==SHT_RELA)
+        {
+            oassert (si.entsize==(si.type==SHT_REL ? rel_size : rela_size));
+            ix->total+=si.size / si.entsize;
+        };
+        if (si.type!=SHT_NULL && si.type!=SHT_NOBITS && si.size>0)
+        {
+            ix->sects[ix->sects_total].offset=si.offset;
+            ix->sects[ix->sects_total].size=si.size;
+            ix->sects[ix->sects_total].n=i;
+            ix->sects_total++;
+        };
+    };
+    qsort (ix->sects, ix->sects_total, sizeof(struct sect_span), cmp_sect_spans);
+
+    ix->relocs=DMALLOC(elf_reloc, ix->total ? ix->total : 1, "elf_reloc");
+    ix->total=0;
+    for (i=0; i<sections_total; i++)
+    {
+        byte *p;
+        size_t j, total;
+
+        get_sect_info (buf, i, &si);
+        if (si.type!=SHT_REL && si.type!=SHT_RELA)
+            continue;
+        total=si.size / si.entsize;
+        for (j=0, p=buf + si.offset; j<total; j++, p+=si.entsize)
+        {
+            elf_reloc *r=&ix->relocs[ix->total++];
+            read_reloc (class, p, si.type==SHT_RELA, r);
+            // sh_info - section of which relocs are applied, sh_link - symbol table
+            r->sect_n=si.info;
+            r->symtab_n=si.link;
+            r->n=j;
+        };
+    };
+    qsort (ix->relocs, ix->total, sizeof(elf_reloc), cmp_relocs);
+    return ix;
+};
+
+void elf_relindex_free (elf_relindex *ix)
+{
+    if (ix==NULL)
+        return;
+    DFREE(ix->relocs);
+    DFREE(ix->sects);
+    DFREE(ix);
+};
+
+size_t elf_relindex_size (elf_relindex *ix)
+{
+    return ix->total;
+};
+
+// first position where (sect_n, offset) >= (sect_n, offset)
+static size_t reloc_lower_bound (elf_relindex *ix, int sect_n, octa offset)
+{
+    size_t lo=0, hi=ix->total;
+
+    while (lo<hi)
+    {
+        size_t mid=lo + (hi-lo)/2;
+        elf_reloc *r=&ix->relocs[mid];
+        if (r->sect_n<sect_n || (r->sect_n==sect_n && r->offset<offset))
+            lo=mid+1;
+        else
+            hi=mid;
+    };
+    return lo;
+};
+
+elf_reloc *elf_relindex_find (elf_relindex *ix, int sect_n, octa offset)
+{
+    size_t i=reloc_lower_bound (ix, sect_n, offset);
+
+    if (i<ix->total && ix->relocs[i].sect_n==sect_n && ix->relocs[i].offset==offset)
+        return &ix->relocs[i];
+    return NULL;
+};
+
+elf_reloc *elf_relindex_find_range (elf_relindex *ix, int sect_n, octa begin, octa end, size_t *out_total)
+{
+    size_t first=reloc_lower_bound (ix, sect_n, begin);
+    size_t last=reloc_lower_bound (ix, sect_n, end);
+
+    *out_total=last>first ? last-first : 0;
+    return *out_total ? &ix->relocs[first] : NULL;
+};
+
+int elf_relindex_section_of_point (elf_relindex *ix, byte *point)
+{
+    octa ofs=point - ix->buf;
+    size_t lo=0, hi=ix->sects_total;
+
+    // the last section starting at or below ofs
+    while (lo<hi)
+    {
+        size_t mid=lo + (hi-lo)/2;
+        if (ix->sects[mid].offset<=ofs)
+            lo=mid+1;
+        else
+            hi=mid;
+    };
+    if (lo==0 || ofs - ix->sects[lo-1].offset >= ix->sects[lo-1].size)
+        return -1;
+    return ix->sects[lo-1].n;
+};
+
+void elf_relindex_get_symbol (elf_relindex *ix, elf_reloc *r, elf_symbol *out)
+{
+    struct sect_info symtab;
+    char *strings;
+    octa strings_size=0;
+
+    get_sect_info (ix->buf, r->symtab_n, &symtab);
+    oassert (r->sym < symtab.size / symtab.entsize);
+    strings=get_linked_strtab (ix->buf, symtab.link, &strings_size);
+    read_symbol (ix->elf_class, ix->buf + symtab.offset + r->sym*symtab.entsize, strings, strings_size, r->sym, out);
+};
+
+byte *elf_relindex_dereference (elf_relindex *ix, byte *point)
+{
+    int sect_n=elf_relindex_section_of_point (ix, point);
+    struct sect_info si;
+    elf_reloc *r;
+    elf_symbol sym;
+    octa_s addend;
+
+    if (sect_n==-1)
+        return NULL;
+    get_sect_info (ix->buf, sect_n, &si);
+    r=elf_relindex_find (ix, sect_n, point - (ix->buf + si.offset));
+    if (r==NULL) // no reloc here
+        return NULL; // yet
+
+    if (ix->elf_class==ELFCLASS64)
+        oassert (r->type==R_X86_64_64 || r->type==R_X86_64_32 || r->type==R_X86_64_32S);
+    else
+        oassert (r->type==R_386_32);
+
+    if (r->rela)
+        addend=r->addend;
+    else if (r->type==R_X86_64_64 && ix->elf_class==ELFCLASS64)
+        addend=*(octa_s*)point;
+    else if (r->type==R_X86_64_32S && ix->elf_class==ELFCLASS64)
+        addend=*(tetra_s*)point;
+    else
+        addend=*(tetra*)point;
+
+    elf_relindex_get_symbol (ix, r, &sym);
+    // undefined symbols and ones with reserved indices (SHN_LORESERVE..SHN_HIRESERVE: absolute, common)
+    // have no place in the file; shndx may be damaged as well
+    if (sym.shndx==SHN_UNDEF || sym.shndx>=SHN_LORESERVE || sym.shndx>=get_sections_total (ix->buf))
+        return NULL;
+    get_sect_info (ix->buf, sym.shndx, &si);
+    return ix->buf + si.offset + sym.value + addend;
+};
+
+// loaded image
+
+struct elf_image
+{
+    byte *buf;
+    size_t size;
+    bool mapped;
+    int elf_class, type;
+    elf_section *sections;
+    unsigned sections_total;
+    int symtab_n;
+    // built on first use
+    elf_symindex *symindex;
+    elf_relindex *relindex;
+    elf_lineindex *lineindex;
+    bool lineindex_built;
+};
+
+static bool in_file (elf_image *img, octa offset, octa size)
+{
+    return offset<=img->size && size<=img->size-offset;
+};
+
+static void read_section (elf_image *img, unsigned n, elf_section *out)
+{
+    if (img->elf_class==ELFCLASS64)
+    {
+        Elf64_Shdr *s=elf64_get_ptr_to_section_struc(img->buf, n);
+        out->name_idx=s->sh_name; out->type=s->sh_type; out->link=s->sh_link; out->info=s->sh_info;
+        out->flags=s->sh_flags; out->addr=s->sh_addr; out->offset=s->sh_offset; out->size=s->sh_size;
+        out->addralign=s->sh_addralign; out->entsize=s->sh_entsize;
+    }
+    else
+    {
+        Elf32_Shdr *s=elf_get_ptr_to_section_struc(img->buf, n);
+        out->name_idx=s->sh_name; out->type=s->sh_type; out->link=s->sh_link; out->info=s->sh_info;
+        out->flags=s->sh_flags; out->addr=s->sh_addr; out->offset=s->sh_offset; out->size=s->sh_size;
+        out->addralign=s->sh_addralign; out->entsize=s->sh_entsize;
+    };
+};
+
+// headers and section table are checked, so a damaged file is rejected here and not later
+static bool parse_headers (elf_image *img)
+{
+    octa shoff;
+    unsigned shentsize, shstrndx, i;
+    elf_section *shstrtab;
+    byte *buf=img->buf;
+
+    if (img->size<sizeof(Elf32_Ehdr) || buf[0]!=ELFMAG0 || buf[1]!=ELFMAG1 || buf[2]!=ELFMAG2 || buf[3]!=ELFMAG3
+            || buf[EI_DATA]!=ELFDATA2LSB)
+        return false;
+    img->elf_class=buf[EI_CLASS];
+    if (img->elf_class==ELFCLASS64)
+    {
+        Elf64_Ehdr *hdr=elf64_get_ptr_to_hdr(buf);
+        if (img->size<sizeof(Elf64_Ehdr))
+            return false;
+        img->type=hdr->e_type;
+        shoff=hdr->e_shoff;
+        shentsize=hdr->e_shentsize;
+        img->sections_total=hdr->e_shnum;
+        shstrndx=hdr->e_shstrndx;
+        if (img->sections_total && shentsize!=sizeof(Elf64_Shdr))
+            return false;
+    }
+    else if (img->elf_class==ELFCLASS32)
+    {
+        Elf32_Ehdr *hdr=elf_get_ptr_to_hdr(buf);
+        img->type=hdr->e_type;
+        shoff=hdr->e_shoff;
+        shentsize=hdr->e_shentsize;
+        img->sections_total=hdr->e_shnum;
+        shstrndx=hdr->e_shstrndx;
+        if (img->sections_total && shentsize!=sizeof(Elf32_Shdr))
+            return false;
+    }
+    else
+        return false;
+
+    if (img->sections_total==0)
+        return true;
+    if (!in_file (img, shoff, (octa)img->sections_total*shentsize) || shstrndx>=img->sections_total)
+        return false;
+
+    img->sections=DMALLOC(elf_section, img->sections_total, "elf_section");
+    for (i=0; i<img->sections_total; i++)
+    {
+        elf_section *s=&img->sections[i];
+        read_section (img, i, s);
+        if (s->type!=SHT_NOBITS && s->type!=SHT_NULL && !in_file (img, s->offset, s->size))
+            return false;
+        if (s->type==SHT_SYMTAB || s->type==SHT_DYNSYM)
+        {
+            if (s->entsize!=(img->elf_class==ELFCLASS64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym)) || s->link>=img->sections_total)
+                return false;
+            // .symtab is preferred over .dynsym
+            if (img->symtab_n==-1 || (s->type==SHT_SYMTAB && img->sections[img->symtab_n].type!=SHT_SYMTAB))
+                img->symtab_n=i;
+        };
+        if (s->type==SHT_REL || s->type==SHT_RELA)
+        {
+            size_t rel_size=img->elf_class==ELFCLASS64 ? sizeof(Elf64_Rel) : sizeof(Elf32_Rel);
+            size_t rela_size=img->elf_class==ELFCLASS64 ? sizeof(Elf64_Rela) : sizeof(Elf32_Rela);
+            if (s->entsize!=(s->type==SHT_REL ? rel_size : rela_size) || s->link>=img->sections_total)
+                return false;
+        };
+    };
+
+    // string tables of symbol tables: sections of other types (SHT_NOBITS, SHT_NULL) are not checked
+    // for being in the file
+    for (i=0; i<img->sections_total; i++)
+        if ((img->sections[i].type==SHT_SYMTAB || img->sections[i].type==SHT_DYNSYM)
+                && img->sections[img->sections[i].link].type!=SHT_STRTAB)
+            return false;
+
+    shstrtab=&img->sections[shstrndx];
+    // SHT_STRTAB section was checked for being in the file above
+    if (shstrtab->type!=SHT_STRTAB)
+        return false;
+    for (i=0; i<img->sections_total; i++)
+    {
+        if (img->sections[i].name_idx>=shstrtab->size)
+            return false;
+        img->sections[i].name=(char*)buf + shstrtab->offset + img->sections[i].name_idx;
+    };
+    // shstrtab must be terminated
+    return shstrtab->size>0 && buf[shstrtab->offset + shstrtab->size - 1]==0;
+};
+
+elf_image *elf_image_from_buf (byte *buf, size_t size)
+{
+    elf_image *img=DCALLOC(elf_image, 1, "elf_image");
+
+    img->buf=buf;
+    img->size=size;
+    img->symtab_n=-1;
+    if (!parse_headers (img))
+    {
+        elf_image_close (img);
+        return NULL;
+    };
+    return img;
+};
+
+elf_image *elf_image_open (const char *fname)
+{
+    size_t size;
+    byte *buf=map_file (fname, &size);
+    elf_image *img;
+
+    if (buf==NULL)
+        return NULL; // can't be opened, or empty file
+    img=elf_image_from_buf (buf, size);
+    if (img==NULL)
+    {
+        unmap_file (buf, size);
+        return NULL;
+    };
+    img->mapped=true;
+    return img;
+};
+
+void elf_image_close (elf_image *img)
+{
+    if (img==NULL)
+        return;
+    elf_symindex_free (img->symindex);
+    elf_relindex_free (img->relindex);
+    elf_lineindex_free (img->lineindex);
+    if (img->sections)
+        DFREE(img->sections);
+    if (img->mapped)
+        unmap_file (img->buf, img->size);
+    DFREE(img);
+};
+
+byte *elf_image_get_buf (elf_image *img, size_t *size)
+{
+    if (size)
+        *size=img->size;
+    return img->buf;
+};
+
+int elf_image_get_class (elf_image *img)
+{
+    return img->elf_class;
+};
+
+int elf_image_get_type (elf_image *img)
+{
+    return img->type;
+};
+
+unsigned elf_image_get_sections_total (elf_image *img)
+{
+    return img->sections_total;
+};
+
+elf_section *elf_image_get_section (elf_image *img, unsigned n)
+{
+    oassert (n < img->sections_total);
+    return &img->sections[n];
+};
+
+byte *elf_image_get_section_start (elf_image *img, unsigned n)
+{
+    return img->buf + elf_image_get_section (img, n)->offset;
+};
+
+int elf_image_find_section_by_name (elf_image *img, const char *name)
+{
+    for (unsigned i=0; i<img->sections_total; i++)
+        if (strcmp (img->sections[i].name, name)==0)
+            return i;
+    return -1;
+};
+
+int elf_image_get_symtab_section (elf_image *img)
+{
+    return img->symtab_n;
+};
+
+elf_symindex *elf_image_get_symindex (elf_image *img)
+{
+    if (img->symindex==NULL && img->symtab_n!=-1)
+        img->symindex=elf_symindex_build (img->buf, img->sections[img->symtab_n].type==SHT_DYNSYM);
+    return img->symindex;
+};
+
+elf_relindex *elf_image_get_relindex (elf_image *img)
+{
+    if (img->relindex==NULL)
+        img->relindex=elf_relindex_build (img->buf);
+    return img->relindex;
+};
+
+size_t elf_image_get_symbols_total (elf_image *img)
+{
+    elf_symindex *ix=elf_image_get_symindex (img);
+    return ix ? elf_symindex_size (ix) : 0;
+};
+
+elf_symbol *elf_image_get_symbol (elf_image *img, size_t n)
+{
+    return elf_symindex_get (elf_image_get_symindex (img), n);
+};
+
+elf_symbol *elf_image_find_symbol_by_name (elf_image *img, const char *name)
+{
+    elf_symindex *ix=elf_image_get_symindex (img);
+    return ix ? elf_symindex_find_by_name (ix, name) : NULL;
+};
+
+elf_symbol *elf_image_find_symbol_by_sect_and_offset (elf_image *img, int sect_n, byte *point)
+{
+    elf_symindex *ix=elf_image_get_symindex (img);
+    return ix ? elf_symindex_find_by_sect_and_value (ix, sect_n, point - elf_image_get_section_start (img, sect_n)) : NULL;
+};
+
+elf_symbol *elf_image_find_symbol_by_addr (elf_image *img, octa addr)
+{
+    elf_symindex *ix=elf_image_get_symindex (img);
+    return ix ? elf_symindex_find_by_addr (ix, addr) : NULL;
+};
+
+byte *elf_image_get_ptr_to_symbol_start (elf_image *img, elf_symbol *s)
+{
+    return elf_image_get_section_start (img, s->shndx) + s->value;
+};
+
+byte *elf_image_get_ptr_to_symbol_start_by_name (elf_image *img, const char *name)
+{
+    elf_symbol *s=elf_image_find_symbol_by_name (img, name);
+
+    if (s==NULL)
+        return NULL; // symbol not found
+    return elf_image_get_ptr_to_symbol_start (img, s);
+};
+
+int elf_image_find_section_for_point (elf_image *img, byte *point)
+{
+    return elf_relindex_section_of_point (elf_image_get_relindex (img), point);
+};
+
+elf_reloc *elf_image_find_reloc_for_point (elf_image *img, byte *point, elf_symbol **outsym)
+{
+    elf_relindex *rix=elf_image_get_relindex (img);
+    int sect_n=elf_relindex_section_of_point (rix, point);
+    elf_reloc *r;
+
+    if (sect_n==-1)
+        return NULL;
+    r=elf_relindex_find (rix, sect_n, point - elf_image_get_section_start (img, sect_n));
+    if (r && outsym)
+        // relocations of executables may refer to .dynsym while .symtab is indexed
+        *outsym=r->symtab_n==img->symtab_n && r->sym<elf_image_get_symbols_total (img) ? elf_image_get_symbol (img, r->sym) : NULL;
+    return r;
+};
+
+byte *elf_image_dereference (elf_image *img, byte *point)
+{
+    return elf_relindex_dereference (elf_image_get_relindex (img), point);
+};
+
+elf_symbol *elf_image_get_symbol_of_pointer (elf_image *img, byte *point)
+{
+    elf_symbol *s;
+    byte *target;
+
+    if (elf_image_find_reloc_for_point (img, point, &s)==NULL || s==NULL)
+        return NULL;
+
+    target=elf_image_dereference (img, point);
+    if (target==elf_image_get_ptr_to_symbol_start (img, s))
+        return s; // already found
+
+    // find symbol at this place...
+    return elf_image_find_symbol_by_sect_and_offset (img, s->shndx, target);
+};
+
+const char *elf_image_get_symbol_name_of_pointer_or_NULL (elf_image *img, byte *point)
+{
+    elf_symbol *s;
+    octa value=img->elf_class==ELFCLASS64 ? *(octa*)point : *(tetra*)point;
+
+    // no reloc at this point and value is zero?
+    if (elf_image_find_reloc_for_point (img, point, NULL)==NULL && value==0)
+        return "NULL";
+
+    s=elf_image_get_symbol_of_pointer (img, point);
+    if (s)
+        return s->name;
+    else
+        return "<symbol not found>";
+};
+
+void elf_image_dump_sym (elf_image *img, elf_symbol *s)
+{
+    const char *bnd_s=s->bind>STB_HIPROC ? "?" : STB_x[s->bind];
+    const char *typ_s=s->type>STT_HIPROC ? "?" : STT_x[s->type];
+
+    printf ("st_name=%-31s st_value=0x%0*llx st_size=%5lld st_info=%-10s %-11s st_shndx=%d\n",
+            s->name, img->elf_class==ELFCLASS64 ? 16 : 8, s->value, s->size,
+            bnd_s, typ_s, s->shndx);
+};
+
+void elf_image_dump_all_sections (elf_image *img)
+{
+    for (unsigned i=0; i<img->sections_total; i++)
+    {
+        elf_section *s=&img->sections[i];
+        printf ("sect->sh_name=%s\n", s->name);
+        printf ("sect->sh_type=");
+        if (s->type>SHT_SYMTAB_SHNDX)
+            printf ("0x%x\n", s->type);
+        else
+            printf ("%s\n", SHT_x[s->type]);
+        dump_sh_flags (s->flags);
+        printf ("sect->sh_addr=0x%llx\n", s->addr);
+        printf ("sect->sh_offset=0x%llx\n", s->offset);
+        printf ("sect->sh_size=%lld\n", s->size);
+        printf ("sect->sh_link=%d\n", s->link);
+        printf ("sect->sh_info=%d\n", s->info);
+        printf ("sect->sh_addralign=%lld\n", s->addralign);
+        printf ("sect->sh_entsize=%lld\n", s->entsize);
+        printf ("\n");
+    };
+};
+
+void elf_image_dump_all_symbols (elf_image *img)
+{
+    size_t symbols_total=elf_image_get_symbols_total (img);
+
+    printf ("symbols total: %d\n", (int)symbols_total);
+    for (size_t i=0; i<symbols_total; i++)
+        elf_image_dump_sym (img, elf_image_get_symbol (img, i));
+};
+
+static int cmp_symbol_sizes_desc(const void *_p1, const void *_p2)
+{
+    const elf_symbol *p1=*(const elf_symbol**)_p1;
+    const elf_symbol *p2=*(const elf_symbol**)_p2;
+
+    if (p1->size>p2->size) return -1;
+    if (p1->size<p2->size) return 1;
+    // symbol table order for the same size
+    if (p1->n<p2->n) return -1;
+    if (p1->n>p2->n) return 1;
+    return 0;
+};
+
+size_t elf_image_get_biggest_data_objects (elf_image *img, elf_symbol **out, size_t n)
+{
+    size_t symbols_total=elf_image_get_symbols_total (img), objects=0;
+    elf_symbol **all;
+
+    if (symbols_total==0)
+        return 0;
+    all=DMALLOC(elf_symbol*, symbols_total, "elf_symbol*");
+    for (size_t i=0; i<symbols_total; i++)
+    {
+        elf_symbol *s=elf_image_get_symbol (img, i);
+        if (s->type==STT_OBJECT)
+            all[objects++]=s;
+    };
+    qsort (all, objects, sizeof(elf_symbol*), cmp_symbol_sizes_desc);
+    if (objects>n)
+        objects=n;
+    memcpy (out, all, objects*sizeof(elf_symbol*));
+    DFREE(all);
+    return objects;
+};
+
+void elf_image_dump_biggest_data_objects (elf_image *img, int n)
+{
+    elf_symbol **objects=DMALLOC(elf_symbol*, n>0 ? n : 1, "elf_symbol*");
+    size_t total=elf_image_get_biggest_data_objects (img, objects, n>0 ? n : 0);
+
+    for (size_t i=0; i<total; i++)
+        elf_image_dump_sym (img, objects[i]);
+    DFREE(objects);
+};
+
+// line table index
+
+// file number of the row after the last one of a sequence
+#define LINE_END_OF_SEQUENCE 0xffffffff
+
+struct line_row
+{
+    octa addr;
+    tetra file; // in ix->files, or LINE_END_OF_SEQUENCE
+    tetra line;
+};
+
+struct elf_lineindex
+{
+    struct line_row *rows; // sorted by addr
+    size_t rows_total;
+    char **files;
+    size_t files_total;
+};
+
+struct line_seq
+{
+    octa addr;
+    size_t first, total; // rows in line_builder
+    size_t n; // order in .debug_line
+};
+
+// state of elf_lineindex_build()
+struct line_builder
+{
+    elf_image *img;
+    int sect_n;
+    byte *sect; // .debug_line
+    elf_section *line_str, *str; // .debug_line_str and .debug_str, if present
+    elf_relindex *rel; // for relocatable files
+    // rows of all sequences, in .debug_line order
+    struct line_row *rows;
+    size_t rows_total, rows_allocated;
+    struct line_seq *seqs;
+    size_t seqs_total, seqs_allocated;
+    size_t seq_first; // first row of current sequence
+    // file names of all units, each name is here once
+    rbtree *files_seen; // name -> number in files + 1
+    char **files;
+    size_t files_total, files_allocated;
+    // current unit
+    int version;
+    unsigned min_inst_len, max_ops, line_range, opcode_base;
+    int line_base;
+    byte *std_lengths;
+    const char **dirs;
+    size_t dirs_total, dirs_allocated;
+    tetra *unit_files; // file register -> number in files
+    size_t unit_files_total, unit_files_allocated;
+};
+
+#define GROW_ARRAY(a, type, total, allocated, comment) \
+    if ((total)==(allocated)) \
+    { \
+        (allocated)=(allocated) ? (allocated)*2 : 16; \
+        (a)=DREALLOC((a), type, (allocated), comment); \
+    }
+
+// reading .debug_line, all reads are checked against end
+
+struct dw_cursor
+{
+    byte *p, *end;
+    bool bad;
+};
+
+static void dw_skip (struct dw_cursor *c, octa size)
+{
+    if (c->bad || size>(octa)(c->end-c->p))
+    {
+        c->bad=true;
+        c->p=c->end;
+        return;
+    };
+    c->p+=size;
+};
+
+// little-endian, size is up to 8
+static octa dw_read (struct dw_cursor *c, unsigned size)
+{
+    octa rt=0;
+    byte *p=c->p;
+
+    dw_skip (c, size);
+    if (c->bad)
+        return 0;
+    for (unsigned i=0; i<size; i++)
+        rt|=(octa)p[i]<<(i*8);
+    return rt;
+};
+
+static octa dw_read_uleb (struct dw_cursor *c)
+{
+    octa rt=0;
+    unsigned shift=0;
+    byte b;
+
+    do
+    {
+        if (c->p>=c->end)
+        {
+            c->bad=true;
+            return 0;
+        };
+        b=*c->p++;
+        if (shift<64)
+            rt|=(octa)(b&0x7f)<<shift;
+        shift+=7;
+    }
+    while (b&0x80);
+    return rt;
+};
+
+static octa_s dw_read_sleb (struct dw_cursor *c)
+{
+    octa rt=0;
+    unsigned shift=0;
+    byte b;
+
+    do
+    {
+        if (c->p>=c->end)
+        {
+            c->bad=true;
+            return 0;
+        };
+        b=*c->p++;
+        if (shift<64)
+            rt|=(octa)(b&0x7f)<<shift;
+        shift+=7;
+    }
+    while (b&0x80);
+    if (shift<64 && (b&0x40))
+        rt|=~(octa)0<<shift;
+    return (octa_s)rt;
+};
+
+static const char *dw_read_str (struct dw_cursor *c)
+{
+    byte *p=c->p, *z;
+
+    if (c->bad || (z=(byte*)memchr (p, 0, c->end-p))==NULL)
+    {
+        c->bad=true;
+        c->p=c->end;
+        return NULL;
+    };
+    c->p=z+1;
+    return (const char*)p;
+};
+
+// address or offset, relocation is applied for relocatable files
+static octa read_relocated (struct line_builder *b, struct dw_cursor *c, unsigned size)
+{
+    octa offset=c->p - b->sect;
+    octa rt=dw_read (c, size);
+    elf_reloc *r;
+    elf_symbol sym;
+
+    if (b->rel==NULL || c->bad || (r=elf_relindex_find (b->rel, b->sect_n, offset))==NULL)
+        return rt;
+    elf_relindex_get_symbol (b->rel, r, &sym);
+    return sym.value + (r->rela ? r->addend : rt);
+};
+
+// string at offset in .debug_line_str or .debug_str, NULL if it's not there
+static const char *get_debug_str (struct line_builder *b, elf_section *s, octa offset)
+{
+    byte *start;
+
+    if (s==NULL || offset>=s->size)
+        return NULL;
+    start=b->img->buf + s->offset;
+    if (memchr (start + offset, 0, s->size - offset)==NULL)
+        return NULL;
+    return (const char*)start + offset;
+};
+
+static const char *read_form_str (struct line_builder *b, struct dw_cursor *c, octa form, unsigned offset_size)
+{
+    switch (form)
+    {
+        case DW_FORM_string:
+            return dw_read_str (c);
+        case DW_FORM_line_strp:
+            return get_debug_str (b, b->line_str, read_relocated (b, c, offset_size));
+        case DW_FORM_strp:
+            return get_debug_str (b, b->str, read_relocated (b, c, offset_size));
+        default:
+            // DW_FORM_strx* need .debug_str_offsets base from .debug_info
+            c->bad=true;
+            return NULL;
+    };
+};
+
+static octa read_form_uint (struct dw_cursor *c, octa form)
+{
+    switch (form)
+    {
+        case DW_FORM_data1: return dw_read (c, 1);
+        case DW_FORM_data2: return dw_read (c, 2);
+        case DW_FORM_data4: return dw_read (c, 4);
+        case DW_FORM_data8: return dw_read (c, 8);
+        case DW_FORM_udata: return dw_read_uleb (c);
+        default:
+            c->bad=true;
+            return 0;
+    };
+};
+
+static void skip_form (struct dw_cursor *c, octa form, unsigned offset_size)
+{
+    switch (form)
+    {
+        case DW_FORM_string: dw_read_str (c); break;
+        case DW_FORM_strp:
+        case DW_FORM_line_strp: dw_skip (c, offset_size); break;
+        case DW_FORM_data1: dw_skip (c, 1); break;
+        case DW_FORM_data2: dw_skip (c, 2); break;
+        case DW_FORM_data4: dw_skip (c, 4); break;
+        case DW_FORM_data8: dw_skip (c, 8); break;
+        case DW_FORM_data16: dw_skip (c, 16); break;
+        case DW_FORM_udata: dw_read_uleb (c); break;
+        case DW_FORM_sdata: dw_read_sleb (c); break;
+        case DW_FORM_block: dw_skip (c, dw_read_uleb (c)); break;
+        case DW_FORM_block1: dw_skip (c, dw_read (c, 1)); break;
+        case DW_FORM_block2: dw_skip (c, dw_read (c, 2)); break;
+        case DW_FORM_block4: dw_skip (c, dw_read (c, 4)); break;
+        default:
+            c->bad=true;
+    };
+};
+
+static int cmp_file_names (void* left, void* right)
+{
+    return strcmp ((const char*)left, (const char*)right);
+};
+
+static char *join_path (const char *dir, const char *name)
+{
+    size_t dir_len, name_len;
+    char *rt;
+
+    if (dir==NULL || dir[0]==0 || name[0]=='/')
+        return DSTRDUP(name, "file name");
+    dir_len=strlen (dir);
+    name_len=strlen (name);
+    rt=DMALLOC(char, dir_len + 1 + name_len + 1, "file name");
+    memcpy (rt, dir, dir_len);
+    rt[dir_len]='/';
+    memcpy (rt + dir_len + 1, name, name_len + 1);
+    return rt;
+};
+
+// path is owned by builder after this call, number in b->files is returned
+static tetra add_file (struct line_builder *b, char *path)
+{
+    void *n=rbtree_lookup (b->files_seen, path);
+
+    if (n)
+    {
+        DFREE(path);
+        return (tetra)((uintptr_t)n - 1);
+    };
+    GROW_ARRAY(b->files, char*, b->files_total, b->files_allocated, "file name");
+    b->files[b->files_total]=path;
+    rbtree_insert (b->files_seen, path, (void*)(uintptr_t)(b->files_total + 1));
+    return b->files_total++;
+};
+
+static void add_unit_dir (struct line_builder *b, const char *dir)
+{
+    GROW_ARRAY(b->dirs, const char*, b->dirs_total, b->dirs_allocated, "dir name");
+    b->dirs[b->dirs_total++]=dir;
+};
+
+static void add_unit_file (struct line_builder *b, octa dir_n, const char *name)
+{
+    const char *dir=dir_n<b->dirs_total ? b->dirs[dir_n] : NULL;
+    char *tmp=NULL;
+    tetra n;
+
+    // DWARF 5: directory 0 is the compilation directory, others may be relative to it
+    if (b->version>=5 && dir && dir[0]!='/' && dir_n!=0 && b->dirs[0])
+        dir=tmp=join_path (b->dirs[0], dir);
+    n=add_file (b, join_path (dir, name));
+    if (tmp)
+        DFREE(tmp);
+    GROW_ARRAY(b->unit_files, tetra, b->unit_files_total, b->unit_files_allocated, "unit file");
+    b->unit_files[b->unit_files_total++]=n;
+};
+
+// DWARF 2..4: include_directories and file_names
+static bool read_entries (struct line_builder *b, struct dw_cursor *c)
+{
+    const char *s;
+
+    // directory 0 is the compilation directory, which is in .debug_info
+    add_unit_dir (b, NULL);
+    while ((s=dw_read_str (c))!=NULL && s[0])
+        add_unit_dir (b, s);
+    // file numbers start at 1
+    add_unit_file (b, 0, "??");
+    while ((s=dw_read_str (c))!=NULL && s[0])
+    {
+        octa dir_n=dw_read_uleb (c);
+        dw_read_uleb (c); // time
+        dw_read_uleb (c); // size
+        add_unit_file (b, dir_n, s);
+    };
+    return !c->bad;
+};
+
+// DWARF 5: directories and file names, described by entry formats
+static bool read_entries_v5 (struct line_builder *b, struct dw_cursor *c, unsigned offset_size)
+{
+    octa formats[255*2];
+
+    for (int files=0; files<2; files++)
+    {
+        unsigned formats_total=dw_read (c, 1);
+        octa entries_total;
+
+        for (unsigned i=0; i<formats_total*2; i++)
+            formats[i]=dw_read_uleb (c);
+        entries_total=dw_read_uleb (c);
+        for (octa i=0; i<entries_total && !c->bad; i++)
+        {
+            const char *name=NULL;
+            octa dir_n=0;
+
+            for (unsigned j=0; j<formats_total; j++)
+                if (formats[j*2]==DW_LNCT_path)
+                    name=read_form_str (b, c, formats[j*2+1], offset_size);
+                else if (formats[j*2]==DW_LNCT_directory_index)
+                    dir_n=read_form_uint (c, formats[j*2+1]);
+                else
+                    skip_form (c, formats[j*2+1], offset_size);
+            if (c->bad || name==NULL)
+                return false;
+            if (files)
+                add_unit_file (b, dir_n, name);
+            else
+                add_unit_dir (b, name);
+        };
+    };
+    return !c->bad;
+};
+
+// false if row can't be added: addresses in sequence can't decrease
+static bool add_row (struct line_builder *b, octa addr, tetra file, tetra line)
+{
+    struct line_row *last;
+
+    if (b->rows_total>b->seq_first && b->rows[b->rows_total-1].addr>addr)
+        return false;
+    // rows at the same address: the last one is used
+    while (b->rows_total>b->seq_first && b->rows[b->rows_total-1].addr==addr)
+        b->rows_total--;
+    last=b->rows_total>b->seq_first ? &b->rows[b->rows_total-1] : NULL;
+    if (last && file!=LINE_END_OF_SEQUENCE && last->file==file && last->line==line)
+        return true;
+    GROW_ARRAY(b->rows, struct line_row, b->rows_total, b->rows_allocated, "line_row");
+    b->rows[b->rows_total].addr=addr;
+    b->rows[b->rows_total].file=file;
+    b->rows[b->rows_total].line=line;
+    b->rows_total++;
+    return true;
+};
+
+static void add_unit_row (struct line_builder *b, octa addr, octa file, tetra line)
+{
+    if (file>=b->unit_files_total)
+        add_row (b, addr, add_file (b, DSTRDUP("??", "file name")), line);
+    else
+        add_row (b, addr, b->unit_files[file], line);
+};
+
+static void end_sequence (struct line_builder *b, octa addr)
+{
+    // a sequence with no rows or with decreasing addresses is dropped
+    if (add_row (b, addr, LINE_END_OF_SEQUENCE, 0) && b->rows_total - b->seq_first>=2)
+    {
+        GROW_ARRAY(b->seqs, struct line_seq, b->seqs_total, b->seqs_allocated, "line_seq");
+        b->seqs[b->seqs_total].addr=b->rows[b->seq_first].addr;
+        b->seqs[b->seqs_total].first=b->seq_first;
+        b->seqs[b->seqs_total].total=b->rows_total - b->seq_first;
+        b->seqs[b->seqs_total].n=b->seqs_total;
+        b->seqs_total++;
+    }
+    else
+        b->rows_total=b->seq_first;
+    b->seq_first=b->rows_total;
+};
+
+static void advance (struct line_builder *b, octa *addr, octa *op_index, octa operation_advance)
+{
+    if (b->max_ops==1)
+        *addr+=b->min_inst_len * operation_advance;
+    else
+    {
+        // VLIW
+        *addr+=b->min_inst_len * ((*op_index + operation_advance) / b->max_ops);
+        *op_index=(*op_index + operation_advance) % b->max_ops;
+    };
+};
+
+// line number program of one unit
+static bool run_program (struct line_builder *b, struct dw_cursor *c)
+{
+    octa addr=0, op_index=0, file=1;
+    tetra line=1;
+
+    while (c->p<c->end && !c->bad)
+    {
+        byte op=dw_read (c, 1);
+
+        if (op>=b->opcode_base)
+        {
+            // special opcode
+            unsigned adjusted=op - b->opcode_base;
+            advance (b, &addr, &op_index, adjusted / b->line_range);
+            line+=b->line_base + (int)(adjusted % b->line_range);
+            add_unit_row (b, addr, file, line);
+            continue;
+        };
+
+        switch (op)
+        {
+            case 0:
+            {
+                // extended opcode
+                octa len=dw_read_uleb (c);
+                byte *next=c->p + len;
+
+                if (c->bad || len==0 || len>(octa)(c->end - c->p))
+                    return false;
+                switch (dw_read (c, 1))
+                {
+                    case DW_LNE_end_sequence:
+                        end_sequence (b, addr);
+                        addr=op_index=0;
+                        file=line=1;
+                        break;
+                    case DW_LNE_set_address:
+                        if (len-1==4 || len-1==8)
+                            addr=read_relocated (b, c, len-1);
+                        op_index=0;
+                        break;
+                    case DW_LNE_define_file:
+                    {
+                        const char *name=dw_read_str (c);
+                        octa dir_n=dw_read_uleb (c);
+                        if (c->bad)
+                            return false;
+                        add_unit_file (b, dir_n, name);
+                        break;
+                    };
+                    default:
+                        // DW_LNE_set_discriminator and vendor extensions
+                        break;
+                };
+                c->p=next;
+                break;
+            };
+            case DW_LNS_copy:
+                add_unit_row (b, addr, file, line);
+                break;
+            case DW_LNS_advance_pc:
+                advance (b, &addr, &op_index, dw_read_uleb (c));
+                break;
+            case DW_LNS_advance_line:
+                line+=(tetra)dw_read_sleb (c);
+                break;
+            case DW_LNS_set_file:
+                file=dw_read_uleb (c);
+                break;
+            case DW_LNS_const_add_pc:
+                advance (b, &addr, &op_index, (255 - b->opcode_base) / b->line_range);
+                break;
+            case DW_LNS_fixed_advance_pc:
+                addr+=dw_read (c, 2);
+                op_index=0;
+                break;
+            default:
+                // DW_LNS_set_column, DW_LNS_negate_stmt, etc, and unknown standard opcodes: operands are skipped
+                for (unsigned i=0; i<b->std_lengths[op-1]; i++)
+                    dw_read_uleb (c);
+                break;
+        };
+    };
+    // a sequence without DW_LNE_end_sequence is dropped
+    b->rows_total=b->seq_first;
+    return !c->bad;
+};
+
+// one unit of .debug_line, c is set to its contents after unit_length
+static bool read_unit (struct line_builder *b, struct dw_cursor *c, unsigned offset_size)
+{
+    octa header_length;
+    struct dw_cursor program;
+
+    b->version=dw_read (c, 2);
+    if (c->bad || b->version<2 || b->version>5)
+        return false;
+    if (b->version>=5)
+        dw_skip (c, 2); // address_size and segment_selector_size
+    header_length=dw_read (c, offset_size);
+    if (c->bad || header_length>(octa)(c->end - c->p))
+        return false;
+    program.p=c->p + header_length;
+    program.end=c->end;
+    program.bad=false;
+
+    b->min_inst_len=dw_read (c, 1);
+    b->max_ops=b->version>=4 ? dw_read (c, 1) : 1;
+    dw_skip (c, 1); // default_is_stmt
+    b->line_base=(signed char)dw_read (c, 1);
+    b->line_range=dw_read (c, 1);
+    b->opcode_base=dw_read (c, 1);
+    b->std_lengths=c->p;
+    if (c->bad || b->max_ops==0 || b->line_range==0 || b->opcode_base==0)
+        return false;
+    dw_skip (c, b->opcode_base - 1);
+
+    b->dirs_total=0;
+    b->unit_files_total=0;
+    if (!(b->version>=5 ? read_entries_v5 (b, c, offset_size) : read_entries (b, c)))
+        return false;
+    return run_program (b, &program);
+};
+
+static int cmp_line_seqs(const void *_p1, const void *_p2)
+{
+    const struct line_seq *p1=(const struct line_seq*)_p1;
+    const struct line_seq *p2=(const struct line_seq*)_p2;
+
+    if (p1->addr!=p2->addr) return p1->addr<p2->addr ? -1 : 1;
+    if (p1->n!=p2->n) return p1->n<p2->n ? -1 : 1;
+    return 0;
+};
+
+// sequences are sorted and rows are copied to ix, the sequence starting first is used where they overlap
+static void merge_sequences (struct line_builder *b, elf_lineindex *ix)
+{
+    if (b->seqs_total>1)
+        qsort (b->seqs, b->seqs_total, sizeof(struct line_seq), cmp_line_seqs);
+    ix->rows=DMALLOC(struct line_row, b->rows_total ? b->rows_total : 1, "line_row");
+    for (size_t i=0; i<b->seqs_total; i++)
+    {
+        struct line_row *r=b->rows + b->seqs[i].first;
+        struct line_row *r_end=r + b->seqs[i].total;
+
+        if (ix->rows_total>0)
+        {
+            // end of previous sequence
+            octa end=ix->rows[ix->rows_total-1].addr;
+
+            if (r->addr<end)
+            {
+                struct line_row *covering=NULL;
+
+                while (r<r_end && r->addr<=end)
+                    covering=r++;
+                if (r==r_end)
+                    continue;
+                // the row covering end of previous sequence replaces its end, it's never the last row
+                ix->rows[ix->rows_total-1].file=covering->file;
+                ix->rows[ix->rows_total-1].line=covering->line;
+            }
+            else if (r->addr==end)
+                ix->rows_total--;
+        };
+        memcpy (ix->rows + ix->rows_total, r, (r_end - r)*sizeof(struct line_row));
+        ix->rows_total+=r_end - r;
+    };
+};
+
+// SHT_NOBITS and compressed sections are treated as absent
+static elf_section *find_debug_section (elf_image *img, const char *name)
+{
+    int n=elf_image_find_section_by_name (img, name);
+    elf_section *s;
+
+    if (n==-1)
+        return NULL;
+    s=elf_image_get_section (img, n);
+    if (s->type==SHT_NOBITS || (s->flags & SHF_COMPRESSED))
+        return NULL;
+    return s;
+};
+
+elf_lineindex *elf_lineindex_build (elf_image *img)
+{
+    struct line_builder b;
+    struct dw_cursor c;
+    elf_section *s=find_debug_section (img, ".debug_line");
+    elf_lineindex *ix;
+    bool ok=true;
+
+    if (s==NULL)
+        return NULL;
+
+    memset (&b, 0, sizeof(b));
+    b.img=img;
+    b.sect_n=s - elf_image_get_section (img, 0);
+    b.sect=elf_image_get_section_start (img, b.sect_n);
+    b.line_str=find_debug_section (img, ".debug_line_str");
+    b.str=find_debug_section (img, ".debug_str");
+    if (elf_image_get_type (img)==ET_REL)
+        b.rel=elf_image_get_relindex (img);
+    b.files_seen=rbtree_create (true, "files_seen", cmp_file_names);
+
+    c.p=b.sect;
+    c.end=b.sect + s->size;
+    c.bad=false;
+    while (ok && c.p<c.end)
+    {
+        struct dw_cursor unit;
+        unsigned offset_size=4;
+        octa length=dw_read (&c, 4);
+
+        if (length==0xffffffff)
+        {
+            // 64-bit DWARF
+            length=dw_read (&c, 8);
+            offset_size=8;
+        };
+        if (c.bad || length>(octa)(c.end - c.p))
+        {
+            ok=false;
+            break;
+        };
+        unit.p=c.p;
+        unit.end=c.p + length;
+        unit.bad=false;
+        ok=read_unit (&b, &unit, offset_size);
+        c.p=unit.end;
+    };
+
+    // names are owned by files
+    rbtree_deinit (b.files_seen);
+    DFREE(b.dirs);
+    DFREE(b.unit_files);
+
+    ix=DCALLOC(elf_lineindex, 1, "elf_lineindex");
+    ix->files=b.files;
+    ix->files_total=b.files_total;
+    if (ok)
+    {
+        oassert (b.rows_total<LINE_END_OF_SEQUENCE);
+        merge_sequences (&b, ix);
+    };
+    DFREE(b.rows);
+    DFREE(b.seqs);
+    if (!ok)
+    {
+        elf_lineindex_free (ix);
+        return NULL;
+    };
+    return ix;
+};
+
+void elf_lineindex_free (elf_lineindex *ix)
+{
+    if (ix==NULL)
+        return;
+    for (size_t i=0; i<ix->files_total; i++)
+        DFREE(ix->files[i]);
+    DFREE(ix->files);
+    DFREE(ix->rows);
+    DFREE(ix);
+};
+
+size_t elf_lineindex_size (elf_lineindex *ix)
+{
+    return ix->rows_total;
+};
+
+// number of first row in [lo, hi) with address above addr, or hi
+// there are no branches depending on addresses in loop, the comparison result is used as a value
+static size_t rows_upper_bound (elf_lineindex *ix, size_t lo, size_t hi, octa addr)
+{
+    struct line_row *base=ix->rows + lo;
+    size_t n=hi-lo;
+
+    if (n==0)
+        return lo;
+    while (n>1)
+    {
+        size_t half=n/2;
+        base=base[half].addr<=addr ? base+half : base;
+        n-=half;
+    };
+    return base - ix->rows + (base->addr<=addr);
+};
+
+// row before upper bound covers the address, if it's not end of sequence
+static bool get_line (elf_lineindex *ix, size_t upper_bound, elf_line *out)
+{
+    struct line_row *r=upper_bound ? &ix->rows[upper_bound-1] : NULL;
+
+    if (r==NULL || r->file==LINE_END_OF_SEQUENCE)
+    {
+        out->file=NULL;
+        out->line=0;
+        out->addr=0;
+        return false;
+    };
+    out->file=ix->files[r->file];
+    out->line=r->line;
+    out->addr=r->addr;
+    return true;
+};
+
+bool elf_lineindex_find (elf_lineindex *ix, octa addr, elf_line *out)
+{
+    return get_line (ix, rows_upper_bound (ix, 0, ix->rows_total, addr), out);
+};
+
+// binary searches for this number of addresses are interleaved in elf_lineindex_find_many()
+#define LINE_BATCH 8
+
+size_t elf_lineindex_find_many (elf_lineindex *ix, const octa *addrs, size_t total, elf_line *out)
+{
+    struct line_row *base[LINE_BATCH];
+    size_t i=0, found=0;
+
+    // all searches have the same number of steps, so they are done in lockstep,
+    // and memory accesses of different searches overlap
+    if (ix->rows_total>0)
+        for (; i+LINE_BATCH<=total; i+=LINE_BATCH)
+        {
+            size_t n=ix->rows_total;
+
+            for (int k=0; k<LINE_BATCH; k++)
+                base[k]=ix->rows;
+            while (n>1)
+            {
+                size_t half=n/2;
+                for (int k=0; k<LINE_BATCH; k++)
+                    base[k]=base[k][half].addr<=addrs[i+k] ? base[k]+half : base[k];
+                n-=half;
+            };
+            for (int k=0; k<LINE_BATCH; k++)
+                if (get_line (ix, base[k] - ix->rows + (base[k]->addr<=addrs[i+k]), &out[i+k]))
+                    found++;
+        };
+    for (; i<total; i++)
+        if (elf_lineindex_find (ix, addrs[i], &out[i]))
+            found++;
+    return found;
+};
+
+struct linecache_entry
+{
+    octa addr;
+    tetra upper_bound; // see rows_upper_bound()
+    bool used;
+};
+
+struct elf_linecache
+{
+    elf_lineindex *ix;
+    struct linecache_entry *entries;
+    unsigned bits;
+    octa hits, misses;
+};
+
+elf_linecache *elf_linecache_create (elf_lineindex *ix, unsigned bits)
+{
+    elf_linecache *c=DCALLOC(elf_linecache, 1, "elf_linecache");
+
+    oassert (bits>=1 && bits<=30);
+    c->ix=ix;
+    c->bits=bits;
+    c->entries=DCALLOC(struct linecache_entry, (size_t)1<<bits, "linecache_entry");
+    return c;
+};
+
+void elf_linecache_free (elf_linecache *c)
+{
+    if (c==NULL)
+        return;
+    DFREE(c->entries);
+    DFREE(c);
+};
+
+bool elf_linecache_find (elf_linecache *c, octa addr, elf_line *out)
+{
+    // Fibonacci hashing
+    struct linecache_entry *e=&c->entries[(addr * 0x9E3779B97F4A7C15ULL) >> (64 - c->bits)];
+
+    if (e->used && e->addr==addr)
+        c->hits++;
+    else
+    {
+        e->addr=addr;
+        e->upper_bound=rows_upper_bound (c->ix, 0, c->ix->rows_total, addr);
+        e->used=true;
+        c->misses++;
+    };
+    return get_line (c->ix, e->upper_bound, out);
+};
+
+void elf_linecache_get_stats (elf_linecache *c, octa *hits, octa *misses)
+{
+    *hits=c->hits;
+    *misses=c->misses;
+};
+
+elf_lineindex *elf_image_get_lineindex (elf_image *img)
+{
+    if (!img->lineindex_built)
+    {
+        img->lineindex=elf_lineindex_build (img);
+        img->lineindex_built=true;
+    };
+    return img->lineindex;
+};
+
 /* vim: set expandtab ts=4 sw=4 : */
@@ -41,6 +41,17 @@
 
 char *elf_get_symbol_name(byte *buf, Elf32_Sym *s);
 
+// ELF64 versions
+
+#define elf64_get_ptr_to_hdr(buf) ((Elf64_Ehdr *)buf)
+#define elf64_get_sections_total(buf) (elf64_get_ptr_to_hdr(buf)->e_shnum)
+#define elf64_get_first_section(buf) ((Elf64_Shdr *)((buf) + elf64_get_ptr_to_hdr(buf)->e_shoff))
+#define elf64_get_ptr_to_section_struc(buf,n) (elf64_get_first_section (buf) + n)
+#define elf64_get_symtab_section(buf) (elf64_get_ptr_to_section_struc ((buf), elf64_find_symtab_section (buf)))
+#define elf64_get_symbols_total(buf) (elf64_get_symtab_section(buf)->sh_size / elf64_get_symtab_section(buf)->sh_entsize)
+#define elf64_get_first_symbol(buf) ((Elf64_Sym *)((buf) + elf64_get_symtab_section(buf)->sh_offset))
+#define elf64_get_strtable_of_symtab(buf) (elf64_get_symtab_section(buf)->sh_link)
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
@@ -75,6 +86,179 @@ Elf32_Shdr *elf_find_section_for_point_in_buf (byte *buf, byte *point, Elf32_Hal
 Elf32_Sym *elf_get_symbol_of_tetra_in_buf (byte* buf, tetra* point);
 char *elf_get_symbol_name_of_tetra_in_buf_or_NULL(byte *buf, tetra* point);
 
+// ELFCLASS32 or ELFCLASS64
+int elf_get_class(byte *buf);
+
+bool elf64_chk_header(byte *buf);
+void elf64_dump_hdr (byte *buf);
+byte* elf64_get_ptr_to_section_start(byte* buf, int sect_n);
+Elf64_Half elf64_find_section_by_type (byte *buf, Elf64_Word type);
+Elf64_Half elf64_find_symtab_section (byte *buf);
+char* elf64_get_str_from_shstr(byte* buf, int idx);
+char *elf64_get_symbol_name(byte *buf, Elf64_Sym *s);
+void elf64_dump_section (byte* buf, Elf64_Shdr *sect);
+void elf64_dump_all_sections(byte *buf);
+Elf64_Sym *elf64_get_n_symbol(byte* buf, int n);
+void elf64_dump_sym (byte* buf, Elf64_Sym *sym);
+Elf64_Sym *elf64_find_symbol_by_name (byte* buf, const char *name);
+void elf64_dump_all_symbols (byte *buf);
+
+// symbol index, for ELF32 and ELF64: built once, then lookups by name are hash table lookups
+// and lookups by address are binary searches (elf_find_symbol_by_*() functions are linear scans)
+typedef struct
+{
+    const char *name;
+    octa value;
+    octa size;
+    tetra n; // number in symbol table
+    wyde shndx;
+    byte bind; // STB_*
+    byte type; // STT_*
+} elf_symbol;
+
+typedef struct elf_symindex elf_symindex;
+
+// .symtab is indexed, or .dynsym if dynamic is set; NULL is returned if there is no such table,
+// or its string table isn't terminated, or a name is out of it
+// for .dynsym, SHT_GNU_HASH or SHT_HASH section is used for name lookups if present
+elf_symindex *elf_symindex_build (byte *buf, bool dynamic);
+void elf_symindex_free (elf_symindex *ix);
+size_t elf_symindex_size (elf_symindex *ix);
+elf_symbol *elf_symindex_get (elf_symindex *ix, size_t n);
+// the first symbol with this name (in symbol table order) or NULL
+elf_symbol *elf_symindex_find_by_name (elf_symindex *ix, const char *name);
+// for relocatable files: the first symbol in section sect_n with this value or NULL,
+// like elf_find_symbol_by_sect_and_offset()
+elf_symbol *elf_symindex_find_by_sect_and_value (elf_symindex *ix, int sect_n, octa value);
+// for executables and shared objects: the defined symbol starting at addr or covering it or NULL
+elf_symbol *elf_symindex_find_by_addr (elf_symindex *ix, octa addr);
+
+// relocation index, for ELF32 and ELF64, SHT_REL and SHT_RELA sections:
+// relocations are sorted by (section, offset), lookups are binary searches
+// (elf_find_reloc_*() functions are linear scans)
+typedef struct
+{
+    octa offset; // r_offset
+    octa_s addend; // r_addend, for SHT_RELA only
+    tetra sym; // symbol number
+    tetra type; // R_386_*, R_X86_64_*
+    tetra n; // number in relocation section
+    wyde sect_n; // section to which relocation is applied
+    wyde symtab_n; // symbol table section
+    bool rela;
+} elf_reloc;
+
+typedef struct elf_relindex elf_relindex;
+
+// buf should be kept while the index is used
+elf_relindex *elf_relindex_build (byte *buf);
+void elf_relindex_free (elf_relindex *ix);
+size_t elf_relindex_size (elf_relindex *ix);
+// relocation for sect_n at offset or NULL
+elf_reloc *elf_relindex_find (elf_relindex *ix, int sect_n, octa offset);
+// relocations for sect_n in [begin, end), in ascending order of offset, NULL if none
+elf_reloc *elf_relindex_find_range (elf_relindex *ix, int sect_n, octa begin, octa end, size_t *out_total);
+// number of section having contents at this point of buf, or -1
+int elf_relindex_section_of_point (elf_relindex *ix, byte *point);
+// name is NULL if the string table is damaged
+void elf_relindex_get_symbol (elf_relindex *ix, elf_reloc *r, elf_symbol *out);
+// for relocatable files: same as elf_dereference_tetra_in_buf(), for ELF64 and SHT_RELA as well
+// R_386_32, R_X86_64_32, R_X86_64_32S and R_X86_64_64 (point is to 64-bit value then) are supported;
+// NULL is returned if there is no relocation at point or its symbol isn't defined in a section
+byte *elf_relindex_dereference (elf_relindex *ix, byte *point);
+
+// loaded image: the file is mapped into memory, headers and section table are parsed once (and checked,
+// so a damaged file is rejected at opening), symbol and relocation indices are built on first use
+// the functions above which take buf are available as elf_image_*() methods, for ELF32 and ELF64;
+// an image can be used by many threads only after indices are built (elf_image_get_symindex(), etc)
+typedef struct
+{
+    const char *name;
+    tetra name_idx, type, link, info;
+    octa flags, addr, offset, size, addralign, entsize;
+} elf_section;
+
+typedef struct elf_image elf_image;
+
+// NULL is returned if the file can't be opened, is empty or isn't ELF (or damaged)
+elf_image *elf_image_open (const char *fname);
+// same, for a buffer (which should be kept while the image is used)
+elf_image *elf_image_from_buf (byte *buf, size_t size);
+void elf_image_close (elf_image *img);
+byte *elf_image_get_buf (elf_image *img, size_t *size);
+int elf_image_get_class (elf_image *img);
+// ET_*
+int elf_image_get_type (elf_image *img);
+unsigned elf_image_get_sections_total (elf_image *img);
+elf_section *elf_image_get_section (elf_image *img, unsigned n);
+byte *elf_image_get_section_start (elf_image *img, unsigned n);
+// -1 if not found
+int elf_image_find_section_by_name (elf_image *img, const char *name);
+// .symtab or .dynsym (for stripped binaries), -1 if there are no symbols
+int elf_image_get_symtab_section (elf_image *img);
+// NULL if there are no symbols
+elf_symindex *elf_image_get_symindex (elf_image *img);
+elf_relindex *elf_image_get_relindex (elf_image *img);
+size_t elf_image_get_symbols_total (elf_image *img);
+elf_symbol *elf_image_get_symbol (elf_image *img, size_t n);
+elf_symbol *elf_image_find_symbol_by_name (elf_image *img, const char *name);
+elf_symbol *elf_image_find_symbol_by_sect_and_offset (elf_image *img, int sect_n, byte *point);
+elf_symbol *elf_image_find_symbol_by_addr (elf_image *img, octa addr);
+byte *elf_image_get_ptr_to_symbol_start (elf_image *img, elf_symbol *s);
+byte *elf_image_get_ptr_to_symbol_start_by_name (elf_image *img, const char *name);
+// -1 if not found
+int elf_image_find_section_for_point (elf_image *img, byte *point);
+// *outsym is set to NULL if relocation refers to other symbol table than the indexed one
+elf_reloc *elf_image_find_reloc_for_point (elf_image *img, byte *point, elf_symbol **outsym);
+byte *elf_image_dereference (elf_image *img, byte *point);
+elf_symbol *elf_image_get_symbol_of_pointer (elf_image *img, byte *point);
+const char *elf_image_get_symbol_name_of_pointer_or_NULL (elf_image *img, byte *point);
+void elf_image_dump_sym (elf_image *img, elf_symbol *s);
+void elf_image_dump_all_sections (elf_image *img);
+void elf_image_dump_all_symbols (elf_image *img);
+// up to n STT_OBJECT symbols, biggest first, returns their number
+size_t elf_image_get_biggest_data_objects (elf_image *img, elf_symbol **out, size_t n);
+void elf_image_dump_biggest_data_objects (elf_image *img, int n);
+
+// line table index, built from .debug_line (DWARF 2..5): address -> (file, line)
+// rows are kept in one array sorted by address (rows having the same file and line as the previous one
+// are dropped), lookups are binary searches
+// for relocatable files, relocations of .debug_line are applied and addresses are offsets in sections;
+// if sequences overlap (as in relocatable files, or for functions discarded by linker), the one starting
+// first is used; compressed (SHF_COMPRESSED) sections are not supported
+typedef struct
+{
+    const char *file; // with directory, if known
+    tetra line;
+    octa addr; // start of the row covering the address
+} elf_line;
+
+typedef struct elf_lineindex elf_lineindex;
+
+// NULL is returned if there is no .debug_line or it is damaged; img should be kept while the index is used
+elf_lineindex *elf_lineindex_build (elf_image *img);
+void elf_lineindex_free (elf_lineindex *ix);
+// number of rows
+size_t elf_lineindex_size (elf_lineindex *ix);
+// false if addr isn't covered by any sequence
+bool elf_lineindex_find (elf_lineindex *ix, octa addr, elf_line *out);
+// out[i] is set for addrs[i] (file is NULL if it isn't covered), returns number of covered addresses
+// binary searches for several addresses are interleaved, so their memory accesses overlap
+size_t elf_lineindex_find_many (elf_lineindex *ix, const octa *addrs, size_t total, elf_line *out);
+
+// direct-mapped cache of lookups, for address streams with repetitions (like sampled addresses);
+// an index can be used by many threads, each having its own cache
+typedef struct elf_linecache elf_linecache;
+
+// 2^bits entries
+elf_linecache *elf_linecache_create (elf_lineindex *ix, unsigned bits);
+void elf_linecache_free (elf_linecache *c);
+bool elf_linecache_find (elf_linecache *c, octa addr, elf_line *out);
+void elf_linecache_get_stats (elf_linecache *c, octa *hits, octa *misses);
+
+// NULL if there is no line table
+elf_lineindex *elf_image_get_lineindex (elf_image *img);
+
 #ifdef  __cplusplus
 }
 #endif
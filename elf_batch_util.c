@@ -0,0 +1,332 @@
+// batch analysis of ELF files in directory trees: biggest data objects, symbol counts, duplicate symbols
+// files are mapped (see elf_image_open()) and analysed by several threads, results are aggregated as
+// files are done; --scaling runs the analysis with 1, 2, 4... threads and reports files/sec
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "elf.h"
+#include "enum_files.h"
+#include "files.h"
+#include "rbtree.h"
+#include "threads.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+struct object
+{
+	char *name;
+	const char *fname;
+	octa size;
+};
+
+// hard links and symlinks to files in the same tree are analysed once
+struct file_id
+{
+	dev_t dev;
+	ino_t ino;
+};
+
+struct dup
+{
+	int count;
+	const char *first_fname;
+};
+
+struct batch
+{
+	char **files;
+	size_t files_total, files_allocated;
+	// struct file_id of files collected from trees
+	rbtree *files_seen;
+	unsigned top;
+	bool quiet;
+
+	// under lock:
+	my_mutex lock;
+	size_t elf32, elf64, not_elf;
+	octa symbols, globals;
+	// biggest objects so far, biggest first
+	struct object *objects;
+	size_t objects_total;
+	// global symbol name -> struct dup
+	rbtree *globals_seen;
+	size_t dups_total;
+};
+
+static void add_file (struct batch *b, const char *pathname)
+{
+	if (b->files_total==b->files_allocated)
+	{
+		b->files_allocated=b->files_allocated ? b->files_allocated*2 : 256;
+		b->files=DREALLOC(b->files, char*, b->files_allocated, "files");
+	};
+	b->files[b->files_total++]=DSTRDUP(pathname, "fname");
+};
+
+// called from several threads
+static void collect_cb (const char *name, const char *pathname, size_t size, time_t t, bool is_dir, void *param)
+{
+	struct batch *b=(struct batch*)param;
+	struct stat st;
+	struct file_id id;
+
+	// symlinks to directories are not followed, symlinks to files are
+	if (is_dir || size==0 || stat (pathname, &st) || !S_ISREG(st.st_mode))
+		return;
+	id.dev=st.st_dev;
+	id.ino=st.st_ino;
+	my_mutex_lock (&b->lock);
+	if (!rbtree_is_key_present (b->files_seen, &id))
+	{
+		rbtree_insert (b->files_seen, DMEMDUP(&id, sizeof(id), "file_id"), NULL);
+		add_file (b, pathname);
+	};
+	my_mutex_unlock (&b->lock);
+};
+
+static int cmp_names (void* left, void* right)
+{
+	return strcmp ((const char*)left, (const char*)right);
+};
+
+static int cmp_file_ids (void* left, void* right)
+{
+	struct file_id *l=(struct file_id*)left, *r=(struct file_id*)right;
+
+	if (l->dev!=r->dev)
+		return l->dev<r->dev ? -1 : 1;
+	if (l->ino!=r->ino)
+		return l->ino<r->ino ? -1 : 1;
+	return 0;
+};
+
+// called under lock
+static void merge_object (struct batch *b, elf_symbol *s, const char *fname)
+{
+	size_t i;
+
+	if (b->objects_total==b->top && b->objects[b->top-1].size>=s->size)
+		return;
+	if (b->objects_total==b->top)
+		DFREE(b->objects[--b->objects_total].name);
+	for (i=b->objects_total; i>0 && b->objects[i-1].size<s->size; i--)
+		b->objects[i]=b->objects[i-1];
+	b->objects[i].name=DSTRDUP(s->name, "object name");
+	b->objects[i].fname=fname;
+	b->objects[i].size=s->size;
+	b->objects_total++;
+};
+
+// called under lock
+static void merge_global (struct batch *b, elf_symbol *s, const char *fname)
+{
+	struct dup *d=(struct dup*)rbtree_lookup (b->globals_seen, (void*)s->name);
+
+	if (d==NULL)
+	{
+		d=DCALLOC(struct dup, 1, "struct dup");
+		d->first_fname=fname;
+		rbtree_insert (b->globals_seen, DSTRDUP(s->name, "global name"), d);
+	}
+	else if (d->count==1)
+		b->dups_total++;
+	d->count++;
+};
+
+static bool is_defined_global (elf_symbol *s)
+{
+	return s->bind==STB_GLOBAL && s->shndx!=SHN_UNDEF && s->type!=STT_SECTION && s->type!=STT_FILE;
+};
+
+static void analyse_file (size_t i, void *param)
+{
+	struct batch *b=(struct batch*)param;
+	const char *fname=b->files[i];
+	elf_image *img=elf_image_open (fname);
+	elf_symbol **objects;
+	size_t symbols_total, objects_total, globals=0;
+
+	if (img==NULL)
+	{
+		my_mutex_lock (&b->lock);
+		b->not_elf++;
+		my_mutex_unlock (&b->lock);
+		return;
+	};
+
+	// all parsing and indexing is done here, outside of lock
+	symbols_total=elf_image_get_symbols_total (img);
+	objects=DMALLOC(elf_symbol*, b->top, "elf_symbol*");
+	objects_total=elf_image_get_biggest_data_objects (img, objects, b->top);
+
+	my_mutex_lock (&b->lock);
+	if (elf_image_get_class (img)==ELFCLASS64)
+		b->elf64++;
+	else
+		b->elf32++;
+	b->symbols+=symbols_total;
+	for (size_t j=0; j<objects_total; j++)
+		merge_object (b, objects[j], fname);
+	for (size_t j=0; j<symbols_total; j++)
+	{
+		elf_symbol *s=elf_image_get_symbol (img, j);
+		if (is_defined_global (s))
+		{
+			merge_global (b, s, fname);
+			globals++;
+		};
+	};
+	b->globals+=globals;
+	if (!b->quiet)
+		printf ("%s: ELF%d, %d symbols, %d defined globals\n", fname,
+				elf_image_get_class (img)==ELFCLASS64 ? 64 : 32, (int)symbols_total, (int)globals);
+	my_mutex_unlock (&b->lock);
+
+	DFREE(objects);
+	elf_image_close (img);
+};
+
+static void free_dup (void *k, void *v)
+{
+	DFREE(k);
+	DFREE(v);
+};
+
+static void free_results (struct batch *b)
+{
+	for (size_t i=0; i<b->objects_total; i++)
+		DFREE(b->objects[i].name);
+	b->objects_total=0;
+	if (b->globals_seen)
+	{
+		rbtree_foreach (b->globals_seen, free_dup, NULL, NULL);
+		rbtree_deinit (b->globals_seen);
+		b->globals_seen=NULL;
+	};
+};
+
+static void reset_results (struct batch *b)
+{
+	free_results (b);
+	b->elf32=b->elf64=b->not_elf=0;
+	b->symbols=b->globals=0;
+	b->globals_seen=rbtree_create (true, "globals_seen", cmp_names);
+	b->dups_total=0;
+};
+
+static void run (struct batch *b, unsigned threads)
+{
+	reset_results (b);
+	parallel_for (b->files_total, threads, analyse_file, b);
+};
+
+struct dups_dump
+{
+	struct batch *b;
+	size_t dumped;
+};
+
+static struct dups_dump *dups_dump_state;
+
+static void dump_dup (void *k, void *v)
+{
+	struct dup *d=(struct dup*)v;
+
+	if (d->count<2 || dups_dump_state->dumped>=dups_dump_state->b->top)
+		return;
+	printf ("  %-40s %4d  %s\n", (const char*)k, d->count, d->first_fname);
+	dups_dump_state->dumped++;
+};
+
+static void report (struct batch *b)
+{
+	struct dups_dump s={ b, 0 };
+
+	printf ("files: %d, ELF32: %d, ELF64: %d, not ELF: %d\n",
+			(int)b->files_total, (int)b->elf32, (int)b->elf64, (int)b->not_elf);
+	printf ("symbols: %lld, defined globals: %lld\n", (long long)b->symbols, (long long)b->globals);
+	printf ("biggest data objects:\n");
+	for (size_t i=0; i<b->objects_total; i++)
+		printf ("  %-40s %10lld  %s\n", b->objects[i].name, (long long)b->objects[i].size, b->objects[i].fname);
+	printf ("global symbols defined in more than one file: %d\n", (int)b->dups_total);
+	// in name order: symbol, number of files, first file
+	dups_dump_state=&s;
+	rbtree_foreach (b->globals_seen, dump_dup, NULL, NULL);
+};
+
+int main(int argc, char* argv[])
+{
+	struct batch b;
+	unsigned threads=0;
+	bool scaling=false;
+	double t;
+
+	memset (&b, 0, sizeof(b));
+	b.top=10;
+	b.files_seen=rbtree_create (true, "files_seen", cmp_file_ids);
+	my_mutex_init (&b.lock);
+
+	for (int i=1; i<argc; i++)
+	{
+		if (strncmp (argv[i], "--threads=", 10)==0)
+			threads=atoi (argv[i]+10);
+		else if (strncmp (argv[i], "--top=", 6)==0)
+			b.top=atoi (argv[i]+6);
+		else if (strcmp (argv[i], "--scaling")==0)
+			scaling=true;
+		else if (strcmp (argv[i], "--quiet")==0)
+			b.quiet=true;
+		else if (memcmp (argv[i], "--", 2)==0)
+			die ("Unknown option %s\n", argv[i]);
+		else if (is_dir (argv[i]))
+			walk_tree (argv[i], threads, WALK_STAT, collect_cb, &b, NULL);
+		else
+			add_file (&b, argv[i]);
+	};
+	if (b.files_total==0 || b.top==0)
+		die ("Usage: %s [--threads=N] [--top=N] [--quiet] [--scaling] <dir or file> ...\n", argv[0]);
+	b.objects=DMALLOC(struct object, b.top, "objects");
+
+	if (scaling)
+	{
+		unsigned max_threads=threads ? threads : get_CPUs_count();
+		b.quiet=true;
+		// the first pass warms up page cache
+		run (&b, max_threads);
+		printf ("threads   files/sec   speedup\n");
+		double base=0;
+		for (unsigned thr=1; ; thr=thr*2>max_threads && thr<max_threads ? max_threads : thr*2)
+		{
+			t=get_monotonic_time();
+			run (&b, thr);
+			t=get_monotonic_time()-t;
+			if (base==0)
+				base=t;
+			printf ("%7d  %10.1f  %7.2fx\n", thr, b.files_total/t, base/t);
+			if (thr>=max_threads)
+				break;
+		};
+	}
+	else
+	{
+		t=get_monotonic_time();
+		run (&b, threads);
+		t=get_monotonic_time()-t;
+		report (&b);
+		printf ("%.1f files/sec\n", b.files_total/t);
+	};
+
+	free_results (&b);
+	DFREE(b.objects);
+	for (size_t i=0; i<b.files_total; i++)
+		DFREE(b.files[i]);
+	DFREE(b.files);
+	rbtree_foreach (b.files_seen, NULL, dfree, NULL);
+	rbtree_deinit (b.files_seen);
+	my_mutex_deinit (&b.lock);
+	dump_unfreed_blocks();
+};
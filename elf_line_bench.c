@@ -0,0 +1,172 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// resolving 1M addresses to file:line: elf_lineindex_find() (binary search for each address),
+// elf_lineindex_find_many() (batched) and elf_linecache_find(), elf_image_find_symbol_by_addr()
+// is for comparison
+// addresses are sampled inside functions: uniformly, and skewed, like samples of a profiler
+// (most of them are in a few hot spots); by default, this benchmark is run on itself
+// usage: elf_line_bench [file]
+
+#include <stdio.h>
+#include <string.h>
+
+#include "elf.h"
+#include "rand.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+#define ADDRS_TOTAL 1000000
+#define HOT_ADDRS 256
+// share of samples in hot spots
+#define HOT_PROBABILITY 0.9
+#define CACHE_BITS 14
+#define BUILD_ROUNDS 10
+
+static elf_symbol **funcs;
+static size_t funcs_total;
+
+static void collect_funcs (elf_image *img)
+{
+	size_t total=elf_image_get_symbols_total (img);
+
+	funcs=DMALLOC(elf_symbol*, total ? total : 1, "elf_symbol*");
+	for (size_t i=0; i<total; i++)
+	{
+		elf_symbol *s=elf_image_get_symbol (img, i);
+		if (s->type==STT_FUNC && s->shndx!=SHN_UNDEF && s->size>0)
+			funcs[funcs_total++]=s;
+	};
+	if (funcs_total==0)
+		die ("no functions in symbol table\n");
+};
+
+static octa random_addr ()
+{
+	elf_symbol *s=funcs[genrand64() % funcs_total];
+	return s->value + genrand64() % s->size;
+};
+
+static void make_addrs (octa *addrs, bool skewed)
+{
+	octa hot[HOT_ADDRS];
+
+	for (int i=0; i<HOT_ADDRS; i++)
+		hot[i]=random_addr();
+	for (size_t i=0; i<ADDRS_TOTAL; i++)
+		if (skewed && rand_double()<HOT_PROBABILITY)
+			addrs[i]=hot[genrand64() % HOT_ADDRS];
+		else
+			addrs[i]=random_addr();
+};
+
+static bool same_line (elf_line *l1, elf_line *l2)
+{
+	return l1->file==l2->file && l1->line==l2->line && l1->addr==l2->addr;
+};
+
+static void report (const char *name, double t, size_t found)
+{
+	printf ("  %-22s %8.1f ms  %6.1f ns/addr  %7.2f Maddr/s  %d found\n",
+			name, t*1000, t*1000000000/ADDRS_TOTAL, ADDRS_TOTAL/t/1000000, (int)found);
+};
+
+static void run (elf_image *img, elf_lineindex *ix, bool skewed)
+{
+	octa *addrs=DMALLOC(octa, ADDRS_TOTAL, "addrs");
+	elf_line *expected=DMALLOC(elf_line, ADDRS_TOTAL, "elf_line");
+	elf_line *out=DMALLOC(elf_line, ADDRS_TOTAL, "elf_line");
+	elf_linecache *c=elf_linecache_create (ix, CACHE_BITS);
+	elf_line l;
+	size_t found=0, symbols_found=0;
+	octa hits, misses;
+	double t;
+
+	make_addrs (addrs, skewed);
+	printf ("%s addresses:\n", skewed ? "skewed" : "uniform");
+
+	t=get_monotonic_time();
+	for (size_t i=0; i<ADDRS_TOTAL; i++)
+		if (elf_image_find_symbol_by_addr (img, addrs[i]))
+			symbols_found++;
+	report ("symbol (for comparison)", get_monotonic_time()-t, symbols_found);
+
+	t=get_monotonic_time();
+	for (size_t i=0; i<ADDRS_TOTAL; i++)
+		if (elf_lineindex_find (ix, addrs[i], &expected[i]))
+			found++;
+	report ("find", get_monotonic_time()-t, found);
+
+	t=get_monotonic_time();
+	oassert (elf_lineindex_find_many (ix, addrs, ADDRS_TOTAL, out)==found);
+	report ("find_many", get_monotonic_time()-t, found);
+	for (size_t i=0; i<ADDRS_TOTAL; i++)
+		oassert (same_line (&out[i], &expected[i]));
+
+	found=0;
+	t=get_monotonic_time();
+	for (size_t i=0; i<ADDRS_TOTAL; i++)
+		if (elf_linecache_find (c, addrs[i], &out[i]))
+			found++;
+	report ("cache", get_monotonic_time()-t, found);
+	for (size_t i=0; i<ADDRS_TOTAL; i++)
+		oassert (same_line (&out[i], &expected[i]));
+	elf_linecache_get_stats (c, &hits, &misses);
+	printf ("  cache hits: %.1f%%\n", (double)hits*100/(hits+misses));
+
+	// results are used like this, to avoid copying file names
+	oassert (elf_lineindex_find (ix, addrs[0], &l)==(expected[0].file!=NULL));
+
+	elf_linecache_free (c);
+	DFREE(out);
+	DFREE(expected);
+	DFREE(addrs);
+};
+
+int main(int argc, char* argv[])
+{
+	const char *fname=argc>1 ? argv[1] : argv[0];
+	elf_image *img=elf_image_open (fname);
+	elf_lineindex *ix;
+	double t;
+
+	if (img==NULL)
+		die ("%s: not ELF\n", fname);
+	sgenrand (1);
+	collect_funcs (img);
+
+	t=get_monotonic_time();
+	for (int i=0; i<BUILD_ROUNDS; i++)
+	{
+		ix=elf_lineindex_build (img);
+		if (ix==NULL)
+			die ("%s: no line table\n", fname);
+		elf_lineindex_free (ix);
+	};
+	t=(get_monotonic_time()-t)/BUILD_ROUNDS;
+	ix=elf_image_get_lineindex (img);
+	printf ("%s: %d rows, %d functions, index is built in %.2f ms\n",
+			fname, (int)elf_lineindex_size (ix), (int)funcs_total, t*1000);
+
+	run (img, ix, false);
+	run (img, ix, true);
+
+	DFREE(funcs);
+	elf_image_close (img);
+	dump_unfreed_blocks();
+};
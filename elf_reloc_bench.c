@@ -0,0 +1,242 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// dereferencing every pointer in .data of a relocatable object:
+// elf_dereference_tetra_in_buf() (linear scans) vs elf_relindex_dereference()
+// objects are synthesized: ELF32 with SHT_REL (both ways) and ELF64 with SHT_RELA (index only)
+
+#include <stdio.h>
+#include <string.h>
+
+#include "elf.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+// pointers in each data object
+#define PTRS_PER_OBJECT 8
+// the linear version is O(n^2), so it's run only up to this number of pointers
+#define MAX_LINEAR_PTRS 20000
+
+enum { SECT_NULL, SECT_DATA, SECT_SYMTAB, SECT_STRTAB, SECT_REL, SECT_SHSTRTAB, SECTIONS_TOTAL };
+
+static const char shstrtab[]="\0.data\0.symtab\0.strtab\0.rel.data\0.rela.data\0.shstrtab";
+
+// offsets of names in shstrtab
+static const int sect_names[]={ 0, 1, 7, 15, 23, 44 };
+
+struct layout
+{
+	size_t ofs[SECTIONS_TOTAL], size[SECTIONS_TOTAL], entsize[SECTIONS_TOTAL], total;
+};
+
+// object i has PTRS_PER_OBJECT pointers, pointer j of it points into object (i*7+j)%objects
+static size_t target_of (size_t i, size_t j, size_t objects)
+{
+	return (i*7+j)%objects;
+};
+
+static byte *make_object (bool is64, size_t objects, size_t *out_size)
+{
+	size_t ptr_size=is64 ? 8 : 4, obj_size=PTRS_PER_OBJECT*ptr_size, ptrs=objects*PTRS_PER_OBJECT;
+	size_t symbols=objects+2; // null symbol and section symbol
+	struct layout l;
+	char *strtab, name[32];
+	size_t strtab_size=1;
+	byte *buf;
+
+	l.entsize[SECT_SYMTAB]=is64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym);
+	l.entsize[SECT_REL]=is64 ? sizeof(Elf64_Rela) : sizeof(Elf32_Rel);
+	l.size[SECT_NULL]=0;
+	l.size[SECT_DATA]=objects*obj_size;
+	l.size[SECT_SYMTAB]=symbols*l.entsize[SECT_SYMTAB];
+	l.size[SECT_STRTAB]=objects*16;
+	l.size[SECT_REL]=ptrs*l.entsize[SECT_REL];
+	l.size[SECT_SHSTRTAB]=sizeof(shstrtab);
+	l.total=is64 ? sizeof(Elf64_Ehdr) : sizeof(Elf32_Ehdr);
+	for (int s=0; s<SECTIONS_TOTAL; s++)
+	{
+		l.total=(l.total+7)&~7;
+		l.ofs[s]=l.total;
+		l.total+=l.size[s];
+	};
+	l.total=(l.total+7)&~7;
+	size_t shoff=l.total;
+	l.total+=SECTIONS_TOTAL*(is64 ? sizeof(Elf64_Shdr) : sizeof(Elf32_Shdr));
+
+	buf=DCALLOC(byte, l.total, "object");
+	strtab=(char*)buf+l.ofs[SECT_STRTAB];
+	memcpy (buf+l.ofs[SECT_SHSTRTAB], shstrtab, sizeof(shstrtab));
+
+	for (size_t i=0; i<objects; i++)
+	{
+		size_t name_ofs=strtab_size;
+		strtab_size+=sprintf (name, "obj%d", (int)i)+1;
+		strcpy (strtab+name_ofs, name);
+		if (is64)
+		{
+			Elf64_Sym *s=(Elf64_Sym*)(buf+l.ofs[SECT_SYMTAB])+i+2;
+			s->st_name=name_ofs;
+			s->st_info=ELF64_ST_INFO(STB_GLOBAL, STT_OBJECT);
+			s->st_shndx=SECT_DATA;
+			s->st_value=i*obj_size;
+			s->st_size=obj_size;
+		}
+		else
+		{
+			Elf32_Sym *s=(Elf32_Sym*)(buf+l.ofs[SECT_SYMTAB])+i+2;
+			s->st_name=name_ofs;
+			s->st_info=ELF32_ST_INFO(STB_GLOBAL, STT_OBJECT);
+			s->st_shndx=SECT_DATA;
+			s->st_value=i*obj_size;
+			s->st_size=obj_size;
+		};
+
+		for (size_t j=0; j<PTRS_PER_OBJECT; j++)
+		{
+			size_t p=i*PTRS_PER_OBJECT+j, sym=target_of (i, j, objects)+2, addend=j*ptr_size;
+			if (is64)
+			{
+				Elf64_Rela *r=(Elf64_Rela*)(buf+l.ofs[SECT_REL])+p;
+				r->r_offset=p*ptr_size;
+				r->r_info=((Elf64_Xword)sym<<32) | R_X86_64_64;
+				r->r_addend=addend;
+			}
+			else
+			{
+				Elf32_Rel *r=(Elf32_Rel*)(buf+l.ofs[SECT_REL])+p;
+				r->r_offset=p*ptr_size;
+				r->r_info=(sym<<8) | R_386_32;
+				// implicit addend
+				*(tetra*)(buf+l.ofs[SECT_DATA]+p*ptr_size)=addend;
+			};
+		};
+	};
+	if (is64)
+	{
+		Elf64_Sym *s=(Elf64_Sym*)(buf+l.ofs[SECT_SYMTAB])+1;
+		s->st_info=ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+		s->st_shndx=SECT_DATA;
+	}
+	else
+	{
+		Elf32_Sym *s=(Elf32_Sym*)(buf+l.ofs[SECT_SYMTAB])+1;
+		s->st_info=ELF32_ST_INFO(STB_LOCAL, STT_SECTION);
+		s->st_shndx=SECT_DATA;
+	};
+
+	for (int s=0; s<SECTIONS_TOTAL; s++)
+	{
+		static const tetra types[]={ SHT_NULL, SHT_PROGBITS, SHT_SYMTAB, SHT_STRTAB, SHT_REL, SHT_STRTAB };
+		tetra type=(s==SECT_REL && is64) ? SHT_RELA : types[s];
+		tetra link=s==SECT_SYMTAB ? SECT_STRTAB : s==SECT_REL ? SECT_SYMTAB : 0;
+		tetra info=s==SECT_SYMTAB ? 2 : s==SECT_REL ? SECT_DATA : 0;
+		tetra name=(s==SECT_REL && is64) ? 33 : sect_names[s];
+		if (is64)
+		{
+			Elf64_Shdr *sh=(Elf64_Shdr*)(buf+shoff)+s;
+			sh->sh_name=name; sh->sh_type=type; sh->sh_link=link; sh->sh_info=info;
+			sh->sh_offset=l.ofs[s]; sh->sh_size=l.size[s];
+			sh->sh_entsize=(s==SECT_SYMTAB || s==SECT_REL) ? l.entsize[s] : 0;
+		}
+		else
+		{
+			Elf32_Shdr *sh=(Elf32_Shdr*)(buf+shoff)+s;
+			sh->sh_name=name; sh->sh_type=type; sh->sh_link=link; sh->sh_info=info;
+			sh->sh_offset=l.ofs[s]; sh->sh_size=l.size[s];
+			sh->sh_entsize=(s==SECT_SYMTAB || s==SECT_REL) ? l.entsize[s] : 0;
+		};
+	};
+
+	if (is64)
+	{
+		Elf64_Ehdr *hdr=(Elf64_Ehdr*)buf;
+		memcpy (hdr->e_ident, "\x7f" "ELF", 4);
+		hdr->e_ident[4]=ELFCLASS64; hdr->e_ident[5]=ELFDATA2LSB; hdr->e_ident[6]=EV_CURRENT;
+		hdr->e_type=ET_REL; hdr->e_machine=EM_X86_64; hdr->e_version=EV_CURRENT;
+		hdr->e_shoff=shoff; hdr->e_ehsize=sizeof(Elf64_Ehdr); hdr->e_shentsize=sizeof(Elf64_Shdr);
+		hdr->e_shnum=SECTIONS_TOTAL; hdr->e_shstrndx=SECT_SHSTRTAB;
+		oassert (elf64_chk_header (buf));
+	}
+	else
+	{
+		Elf32_Ehdr *hdr=(Elf32_Ehdr*)buf;
+		memcpy (hdr->e_ident, "\x7f" "ELF", 4);
+		hdr->e_ident[4]=ELFCLASS32; hdr->e_ident[5]=ELFDATA2LSB; hdr->e_ident[6]=EV_CURRENT;
+		hdr->e_type=ET_REL; hdr->e_machine=EM_386; hdr->e_version=EV_CURRENT;
+		hdr->e_shoff=shoff; hdr->e_ehsize=sizeof(Elf32_Ehdr); hdr->e_shentsize=sizeof(Elf32_Shdr);
+		hdr->e_shnum=SECTIONS_TOTAL; hdr->e_shstrndx=SECT_SHSTRTAB;
+		oassert (elf_chk_header (buf));
+	};
+	*out_size=l.total;
+	return buf;
+};
+
+static void run (bool is64, size_t objects)
+{
+	size_t size, ptr_size=is64 ? 8 : 4, ptrs=objects*PTRS_PER_OBJECT;
+	byte *buf=make_object (is64, objects, &size);
+	byte *data=buf + (is64 ? elf64_get_ptr_to_section_struc (buf, SECT_DATA)->sh_offset
+			: elf_get_ptr_to_section_struc (buf, SECT_DATA)->sh_offset);
+	double t, t_build, t_index, t_linear=0;
+	elf_relindex *ix;
+
+	t=get_monotonic_time();
+	ix=elf_relindex_build (buf);
+	t_build=get_monotonic_time()-t;
+	oassert (elf_relindex_size (ix)==ptrs);
+
+	t=get_monotonic_time();
+	for (size_t p=0; p<ptrs; p++)
+	{
+		size_t i=p/PTRS_PER_OBJECT, j=p%PTRS_PER_OBJECT;
+		byte *target=elf_relindex_dereference (ix, data+p*ptr_size);
+		oassert (target==data + target_of (i, j, objects)*PTRS_PER_OBJECT*ptr_size + j*ptr_size);
+	};
+	t_index=get_monotonic_time()-t;
+
+	if (!is64 && ptrs<=MAX_LINEAR_PTRS)
+	{
+		t=get_monotonic_time();
+		for (size_t p=0; p<ptrs; p++)
+			oassert (elf_dereference_tetra_in_buf (buf, (tetra*)(data+p*ptr_size))
+					==elf_relindex_dereference (ix, data+p*ptr_size));
+		t_linear=get_monotonic_time()-t;
+	};
+
+	printf ("%s %8d   %10.2f  %10.2f", is64 ? "ELF64/RELA" : "ELF32/REL ", (int)ptrs, t_build*1000, t_index*1000);
+	if (t_linear)
+		printf ("  %10.2f  %8.1fx\n", t_linear*1000, t_linear/(t_build+t_index));
+	else
+		printf ("           -          -\n");
+
+	elf_relindex_free (ix);
+	DFREE (buf);
+};
+
+int main()
+{
+	static const size_t objects[]={ 100, 500, 2500, 12500 };
+
+	printf ("object      pointers   build ms    index ms   linear ms   speedup\n");
+	for (int i=0; i<sizeof(objects)/sizeof(objects[0]); i++)
+	{
+		run (false, objects[i]);
+		run (true, objects[i]);
+	};
+	dump_unfreed_blocks();
+};
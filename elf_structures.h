@@ -23,6 +23,14 @@ typedef unsigned short Elf32_Half;
 typedef unsigned int Elf32_Word;
 typedef int Elf32_Sword;
 
+typedef unsigned long long Elf64_Addr;
+typedef unsigned long long Elf64_Off;
+typedef unsigned short Elf64_Half;
+typedef unsigned int Elf64_Word;
+typedef int Elf64_Sword;
+typedef unsigned long long Elf64_Xword;
+typedef long long Elf64_Sxword;
+
 #define EI_NIDENT 16
 
 #pragma pack(push, 1)
@@ -71,6 +79,63 @@ typedef struct {
 	Elf32_Word	r_info;
 } Elf32_Rel;
 
+typedef struct {
+	Elf32_Addr	r_offset;
+	Elf32_Word	r_info;
+	Elf32_Sword	r_addend;
+} Elf32_Rela;
+
+typedef struct {
+	unsigned char   e_ident[EI_NIDENT];
+	Elf64_Half      e_type;
+	Elf64_Half      e_machine;
+	Elf64_Word      e_version;
+	Elf64_Addr      e_entry;
+	Elf64_Off       e_phoff;
+	Elf64_Off       e_shoff;
+	Elf64_Word      e_flags;
+	Elf64_Half      e_ehsize;
+	Elf64_Half      e_phentsize;
+	Elf64_Half      e_phnum;
+	Elf64_Half      e_shentsize;
+	Elf64_Half      e_shnum;
+	Elf64_Half      e_shstrndx;
+} Elf64_Ehdr;
+
+typedef struct {
+	Elf64_Word	sh_name;
+	Elf64_Word	sh_type;
+	Elf64_Xword	sh_flags;
+	Elf64_Addr	sh_addr;
+	Elf64_Off	sh_offset;
+	Elf64_Xword	sh_size;
+	Elf64_Word	sh_link;
+	Elf64_Word	sh_info;
+	Elf64_Xword	sh_addralign;
+	Elf64_Xword	sh_entsize;
+} Elf64_Shdr;
+
+// fields are in different order than in Elf32_Sym
+typedef struct {
+	Elf64_Word	st_name;
+	unsigned char	st_info;
+	unsigned char	st_other;
+	Elf64_Half	st_shndx; // section of ...
+	Elf64_Addr	st_value; // address of ...
+	Elf64_Xword	st_size;
+} Elf64_Sym;
+
+typedef struct {
+	Elf64_Addr	r_offset;
+	Elf64_Xword	r_info;
+} Elf64_Rel;
+
+typedef struct {
+	Elf64_Addr	r_offset;
+	Elf64_Xword	r_info;
+	Elf64_Sxword	r_addend;
+} Elf64_Rela;
+
 #pragma pack(pop)
 
 // The valid values found in Ehdr e_ident[EI_CLASS].
@@ -380,6 +445,7 @@ enum SHF
 	SHF_OS_NONCONFORMING = 0x100,
 	SHF_GROUP = 0x200,
 	SHF_TLS = 0x400,
+	SHF_COMPRESSED = 0x800,
 	SHF_MASKOS = 0x0ff00000,
 	SHF_MASKPROC = 0xf0000000,
 
@@ -443,6 +509,10 @@ enum STT
 #define ELF32_ST_TYPE(i)   ((i)&0xf)
 #define ELF32_ST_INFO(b,t) (((b)<<4)+((t)&0xf))
 
+#define ELF64_ST_BIND(i)   ((i)>>4)
+#define ELF64_ST_TYPE(i)   ((i)&0xf)
+#define ELF64_ST_INFO(b,t) (((b)<<4)+((t)&0xf))
+
 #define ELF32_R_SYM(i)	((i)>>8)
 #define ELF32_R_TYPE(i)   ((unsigned char)(i))
 
@@ -462,6 +532,15 @@ enum STT
 #define R_386_GOTPC	10
 #define R_386_NUM	11
 
+#define ELF64_R_SYM(i)	((i)>>32)
+#define ELF64_R_TYPE(i)	((i)&0xffffffff)
+
+#define R_X86_64_NONE	0
+#define R_X86_64_64	1
+#define R_X86_64_PC32	2
+#define R_X86_64_32	10
+#define R_X86_64_32S	11
+
 /* special section indexes */
 #define SHN_UNDEF	0
 #define SHN_LORESERVE	0xff00
@@ -471,4 +550,45 @@ enum STT
 #define SHN_COMMON	0xfff2
 #define SHN_HIRESERVE	0xffff
 
+/* DWARF .debug_line */
+#define DW_LNS_copy			1
+#define DW_LNS_advance_pc		2
+#define DW_LNS_advance_line		3
+#define DW_LNS_set_file			4
+#define DW_LNS_set_column		5
+#define DW_LNS_negate_stmt		6
+#define DW_LNS_set_basic_block		7
+#define DW_LNS_const_add_pc		8
+#define DW_LNS_fixed_advance_pc		9
+#define DW_LNS_set_prologue_end		10
+#define DW_LNS_set_epilogue_begin	11
+#define DW_LNS_set_isa			12
+
+#define DW_LNE_end_sequence		1
+#define DW_LNE_set_address		2
+#define DW_LNE_define_file		3
+#define DW_LNE_set_discriminator	4
+
+/* DWARF 5 directory and file entry formats */
+#define DW_LNCT_path			1
+#define DW_LNCT_directory_index		2
+#define DW_LNCT_timestamp		3
+#define DW_LNCT_size			4
+#define DW_LNCT_MD5			5
+
+#define DW_FORM_block2			0x03
+#define DW_FORM_block4			0x04
+#define DW_FORM_data2			0x05
+#define DW_FORM_data4			0x06
+#define DW_FORM_data8			0x07
+#define DW_FORM_string			0x08
+#define DW_FORM_block			0x09
+#define DW_FORM_block1			0x0a
+#define DW_FORM_data1			0x0b
+#define DW_FORM_sdata			0x0d
+#define DW_FORM_strp			0x0e
+#define DW_FORM_udata			0x0f
+#define DW_FORM_data16			0x1e
+#define DW_FORM_line_strp		0x1f
+
 /* vim: set expandtab ts=4 sw=4 : */
@@ -0,0 +1,286 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// ELF symbol index is checked against linear scans, on the executable of this test itself
+// (which is built with -g, for the line table)
+
+#include <stdio.h>
+#include <string.h>
+
+#include "elf.h"
+#include "files.h"
+#include "dmalloc.h"
+#include "oassert.h"
+
+static elf_symbol *linear_find_by_name (elf_symindex *ix, const char *name)
+{
+    for (size_t i=0; i<elf_symindex_size (ix); i++)
+        if (strcmp (elf_symindex_get (ix, i)->name, name)==0)
+            return elf_symindex_get (ix, i);
+    return NULL;
+};
+
+static bool defined (elf_symbol *s)
+{
+    return s->shndx!=SHN_UNDEF && s->shndx<SHN_LORESERVE && s->type!=STT_SECTION && s->type!=STT_FILE;
+};
+
+// only these are in address index; TLS symbols have offsets in TLS segment instead of addresses
+static bool has_address (byte *buf, elf_symbol *s)
+{
+    return defined (s) && s->type!=STT_TLS && (elf64_get_ptr_to_section_struc (buf, s->shndx)->sh_flags & SHF_ALLOC);
+};
+
+static void check_index (byte *buf, bool dynamic)
+{
+    elf_symindex *ix=elf_symindex_build (buf, dynamic);
+    size_t total;
+
+    oassert (ix);
+    total=elf_symindex_size (ix);
+    oassert (total>0);
+
+    for (size_t i=0; i<total; i++)
+    {
+        elf_symbol *s=elf_symindex_get (ix, i);
+        oassert (s->n==i);
+
+        if (s->name[0])
+            oassert (elf_symindex_find_by_name (ix, s->name)==linear_find_by_name (ix, s->name));
+
+        if (!dynamic && s->shndx<elf64_get_sections_total(buf))
+        {
+            elf_symbol *f=elf_symindex_find_by_sect_and_value (ix, s->shndx, s->value);
+            oassert (f && f->n<=i && f->shndx==s->shndx && f->value==s->value);
+        };
+
+        if (s->type==STT_TLS)
+            oassert (elf_symindex_find_by_addr (ix, s->value)!=s);
+
+        if (has_address (buf, s) && s->size>0)
+        {
+            elf_symbol *f=elf_symindex_find_by_addr (ix, s->value + s->size/2);
+            oassert (f && f->value<=s->value + s->size/2);
+            oassert (f->value==s->value + s->size/2 || s->value + s->size/2 - f->value < f->size);
+        };
+    };
+
+    oassert (elf_symindex_find_by_name (ix, "no such symbol")==NULL);
+    oassert (elf_symindex_find_by_name (ix, "")==NULL);
+    oassert (elf_symindex_find_by_addr (ix, 0)==NULL);
+
+    if (!dynamic)
+    {
+        // compare with ELF64 linear scan
+        elf_symbol *s=elf_symindex_find_by_name (ix, "main");
+        oassert (s);
+        oassert (elf64_find_symbol_by_name (buf, "main")==elf64_get_n_symbol (buf, s->n));
+        oassert (elf_symindex_find_by_addr (ix, s->value)==s);
+    }
+    else
+    {
+        // some libc function must be imported
+        elf_symbol *s=elf_symindex_find_by_name (ix, "strcmp");
+        oassert (s && s->shndx==SHN_UNDEF);
+    };
+
+    printf ("%s: ok\n", dynamic ? "dynsym" : "symtab");
+    elf_symindex_free (ix);
+};
+
+static void check_relindex (byte *buf)
+{
+    elf_relindex *ix=elf_relindex_build (buf);
+    size_t total=0, in_ranges=0;
+    Elf64_Shdr *sect;
+    int i;
+
+    // each relocation, from SHT_RELA sections directly
+    for (i=0, sect=elf64_get_first_section (buf); i<elf64_get_sections_total (buf); i++, sect++)
+    {
+        Elf64_Rela *r=(Elf64_Rela*)(buf + sect->sh_offset);
+
+        if (sect->sh_type!=SHT_RELA)
+            continue;
+        for (size_t j=0; j<sect->sh_size/sizeof(Elf64_Rela); j++, r++)
+        {
+            elf_reloc *f=elf_relindex_find (ix, sect->sh_info, r->r_offset);
+            oassert (f && f->rela && f->sect_n==sect->sh_info && f->offset==r->r_offset);
+            oassert (f->sym==ELF64_R_SYM (r->r_info) && f->type==ELF64_R_TYPE (r->r_info) && f->addend==r->r_addend);
+            total++;
+        };
+    };
+    oassert (total>0 && total==elf_relindex_size (ix));
+
+    for (i=0, sect=elf64_get_first_section (buf); i<elf64_get_sections_total (buf); i++, sect++)
+    {
+        size_t n;
+        elf_relindex_find_range (ix, i, 0, (octa)-1, &n);
+        in_ranges+=n;
+
+        if (sect->sh_type!=SHT_NULL && sect->sh_type!=SHT_NOBITS && sect->sh_size>0)
+            oassert (elf_relindex_section_of_point (ix, buf + sect->sh_offset + sect->sh_size/2)==i);
+    };
+    oassert (in_ranges==total);
+    oassert (elf_relindex_find (ix, elf64_get_sections_total (buf), 0)==NULL);
+
+    printf ("relocs: ok\n");
+    elf_relindex_free (ix);
+};
+
+static void check_image (const char *fname, byte *buf, size_t size)
+{
+    elf_image *img=elf_image_open (fname);
+    elf_symbol *objects[10], *s;
+    size_t objects_total;
+    byte *copy;
+    Elf64_Shdr *strtab;
+    int text;
+
+    oassert (img);
+    oassert (elf_image_get_class (img)==ELFCLASS64);
+    oassert (elf_image_get_sections_total (img)==elf64_get_sections_total (buf));
+    oassert (elf_image_get_symtab_section (img)==elf64_find_symtab_section (buf));
+    oassert (elf_image_get_symbols_total (img)==elf64_get_symbols_total (buf));
+    text=elf_image_find_section_by_name (img, ".text");
+    oassert (text>0 && strcmp (elf64_get_str_from_shstr (buf, elf64_get_ptr_to_section_struc (buf, text)->sh_name), ".text")==0);
+    oassert (elf_image_get_section_start (img, text)-elf_image_get_buf (img, NULL)==elf64_get_ptr_to_section_start (buf, text)-buf);
+    oassert (elf_image_find_section_by_name (img, ".no_such_section")==-1);
+    // not an ELF file, not a file
+    oassert (elf_image_open ("elf_test.c")==NULL);
+    oassert (elf_image_open ("no_such_file")==NULL);
+    oassert (elf_image_open (".")==NULL);
+
+    s=elf_image_find_symbol_by_name (img, "main");
+    oassert (s && s->n==elf64_find_symbol_by_name (buf, "main")-elf64_get_first_symbol (buf));
+    oassert (elf_image_find_symbol_by_addr (img, s->value)==s);
+    oassert (elf_image_get_ptr_to_symbol_start_by_name (img, "main")==elf_image_get_ptr_to_symbol_start (img, s));
+
+    objects_total=elf_image_get_biggest_data_objects (img, objects, 10);
+    oassert (objects_total>0);
+    for (size_t i=0; i<objects_total; i++)
+    {
+        oassert (objects[i]->type==STT_OBJECT);
+        if (i>0)
+            oassert (objects[i-1]->size>=objects[i]->size);
+    };
+    elf_image_close (img);
+
+    // damaged images are rejected
+    copy=DMALLOC(byte, size, "copy");
+    memcpy (copy, buf, size);
+    oassert (elf_image_from_buf (copy, 16)==NULL);
+    elf64_get_ptr_to_hdr (copy)->e_shoff=size;
+    oassert (elf_image_from_buf (copy, size)==NULL);
+    memcpy (copy, buf, size);
+    elf64_get_ptr_to_section_struc (copy, 1)->sh_offset=size;
+    oassert (elf_image_from_buf (copy, size)==NULL);
+    // symbol table linked to a section which isn't a string table
+    memcpy (copy, buf, size);
+    elf64_get_ptr_to_section_struc (copy, elf64_find_symtab_section (copy))->sh_link=0;
+    oassert (elf_image_from_buf (copy, size)==NULL);
+    // section names in a section which isn't a string table (.bss)
+    memcpy (copy, buf, size);
+    elf64_get_ptr_to_hdr (copy)->e_shstrndx=elf64_find_section_by_type (copy, SHT_NOBITS);
+    oassert (elf_image_from_buf (copy, size)==NULL);
+    // names out of the string table, or the string table isn't terminated: no symbol index
+    memcpy (copy, buf, size);
+    strtab=elf64_get_ptr_to_section_struc (copy, elf64_get_strtable_of_symtab (copy));
+    elf64_get_n_symbol (copy, 1)->st_name=strtab->sh_size;
+    img=elf_image_from_buf (copy, size);
+    oassert (img && elf_image_get_symindex (img)==NULL && elf_image_get_symbols_total (img)==0);
+    elf_image_close (img);
+    memcpy (copy, buf, size);
+    copy[strtab->sh_offset + strtab->sh_size - 1]='x';
+    img=elf_image_from_buf (copy, size);
+    oassert (img && elf_image_get_symindex (img)==NULL);
+    elf_image_close (img);
+    memcpy (copy, buf, size);
+    img=elf_image_from_buf (copy, size);
+    oassert (img);
+    elf_image_close (img);
+    DFREE (copy);
+
+    printf ("image: ok\n");
+};
+
+// the whole function is on one line, its address should be mapped to it
+static int line_marker (int x) { return x + __LINE__; }
+
+static bool same_line (elf_line *l1, elf_line *l2)
+{
+    return l1->file==l2->file && l1->line==l2->line && l1->addr==l2->addr;
+};
+
+static void check_lines (const char *fname)
+{
+    elf_image *img=elf_image_open (fname);
+    elf_lineindex *ix=elf_image_get_lineindex (img);
+    elf_symbol *s=elf_image_find_symbol_by_name (img, "line_marker");
+    elf_linecache *c;
+    elf_line l, many[5];
+    octa addrs[5], hits, misses;
+
+    oassert (ix && elf_lineindex_size (ix)>0);
+    oassert (s && s->size>0);
+    oassert (elf_lineindex_find (ix, s->value, &l));
+    oassert (strstr (l.file, "elf_test.c") && l.line==line_marker (0) && l.addr==s->value);
+    oassert (elf_lineindex_find (ix, s->value + s->size - 1, &l) && l.line==line_marker (0));
+    oassert (!elf_lineindex_find (ix, 0, &l) && l.file==NULL);
+    oassert (!elf_lineindex_find (ix, ~(octa)0, &l));
+
+    addrs[0]=s->value + s->size - 1;
+    addrs[1]=0;
+    addrs[2]=s->value;
+    addrs[3]=s->value;
+    addrs[4]=elf_image_find_symbol_by_name (img, "main")->value;
+    oassert (elf_lineindex_find_many (ix, addrs, 5, many)==4);
+    c=elf_linecache_create (ix, 4);
+    for (int round=0; round<2; round++)
+        for (int i=0; i<5; i++)
+        {
+            oassert (elf_lineindex_find (ix, addrs[i], &l)==(many[i].file!=NULL));
+            oassert (same_line (&l, &many[i]));
+            oassert (elf_linecache_find (c, addrs[i], &l)==(many[i].file!=NULL));
+            oassert (same_line (&l, &many[i]));
+        };
+    elf_linecache_get_stats (c, &hits, &misses);
+    oassert (hits+misses==10 && hits>=1);
+    elf_linecache_free (c);
+    elf_image_close (img);
+
+    printf ("lines: ok\n");
+};
+
+int main(int argc, char **argv)
+{
+    size_t size;
+    byte *buf=load_file_or_die (argv[0], &size);
+
+    oassert (elf64_chk_header (buf));
+    check_index (buf, false);
+    check_index (buf, true);
+    check_relindex (buf);
+    check_image (argv[0], buf, size);
+    check_lines (argv[0]);
+
+    DFREE (buf);
+    dump_unfreed_blocks();
+    return 0;
+};
+
+/* vim: set expandtab ts=4 sw=4 : */
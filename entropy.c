@@ -1,50 +1,212 @@
 #include "datatypes.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+#include "entropy.h"
+#include "dmalloc.h"
+#include "memutils.h"
+#include "oassert.h"
+#include "threads.h"
+
 // entropy calculation
-// this source code is based on example from http://rosettacode.org/wiki/Entropy#C
- 
-static int makehist(byte* S,int *hist,int len)
-{
-	int wherechar[256];
-	int i,histlen;
-	histlen=0;
-	for(i=0;i<256;i++)wherechar[i]=-1;
-	for(i=0;i<len;i++)
+// H = -sum(p*log2(p)), p=c/N, which is the same as log2(N) - sum(c*log2(c))/N
+// the latter form is used everywhere here, since it allows to update sum(c*log2(c)) in O(1)
+// when a single counter is changed
+
+static double clog2c (octa c)
+{
+	if (c<2)
+		return 0;
+	return (double)c*log2((double)c);
+};
+
+static double entropy_from_sum (double sum, octa n)
+{
+	if (n==0)
+		return 0;
+	return log2((double)n) - sum/(double)n;
+};
+
+double entropy (byte* buf, size_t bufsize)
+{
+	entropy_state s;
+	entropy_state_init (&s);
+	entropy_state_add (&s, buf, bufsize);
+	return entropy_state_get (&s);
+}
+
+void entropy_state_init (entropy_state *s)
+{
+	memset (s->hist, 0, sizeof(s->hist));
+	s->total=0;
+};
+
+void entropy_state_add (entropy_state *s, const byte *buf, size_t bufsize)
+{
+	byte_histogram (buf, bufsize, s->hist);
+	s->total+=bufsize;
+};
+
+double entropy_state_get (entropy_state *s)
+{
+	double sum=0;
+	for (int i=0; i<256; i++)
+		sum+=clog2c(s->hist[i]);
+	return entropy_from_sum (sum, s->total);
+};
+
+int32_t entropy_state_get_int (entropy_state *s)
+{
+	octa_s sum=0;
+	for (int i=0; i<256; i++)
+		sum+=entropy_int_clog2c(s->hist[i]);
+	return entropy_int_from_sum (sum, s->total);
+};
+
+void entropy_window_init (entropy_window *w, size_t window_size, bool fixed_point)
+{
+	oassert (window_size>0);
+	memset (w->hist, 0, sizeof(w->hist));
+	w->ring=DMALLOC(byte, window_size, "ring");
+	w->window_size=window_size;
+	w->pos=0;
+	w->filled=0;
+	w->fixed_point=fixed_point;
+	w->sum=0;
+	w->sum_q=0;
+	w->clog2c=NULL;
+	w->clog2c_q=NULL;
+
+	// counter can't be bigger than window_size
+	if (fixed_point)
 	{
-		if(wherechar[(int)S[i]]==-1)
-		{
-			wherechar[(int)S[i]]=histlen;
-			histlen++;
-		}
-		hist[wherechar[(int)S[i]]]++;
+		w->clog2c_q=DMALLOC(octa_s, window_size+1, "clog2c_q");
+		for (size_t c=0; c<=window_size; c++)
+			w->clog2c_q[c]=entropy_int_clog2c(c);
 	}
-	return histlen;
-}
- 
-static double entropy_helper(int *hist,int histlen,int len)
+	else
+	{
+		w->clog2c=DMALLOC(double, window_size+1, "clog2c");
+		for (size_t c=0; c<=window_size; c++)
+			w->clog2c[c]=clog2c(c);
+	};
+};
+
+void entropy_window_deinit (entropy_window *w)
 {
-	int i;
-	double H;
-	H=0;
-	for(i=0;i<histlen;i++)
+	DFREE (w->ring);
+	if (w->clog2c)
+		DFREE (w->clog2c);
+	if (w->clog2c_q)
+		DFREE (w->clog2c_q);
+};
+
+// counter of byte b goes from c to c+delta, delta is -1 or 1
+static void window_update (entropy_window *w, byte b, int delta)
+{
+	tetra c=w->hist[b];
+	if (w->fixed_point)
+		w->sum_q+=w->clog2c_q[c+delta] - w->clog2c_q[c];
+	else
+		w->sum+=w->clog2c[c+delta] - w->clog2c[c];
+	w->hist[b]=c+delta;
+};
+
+void entropy_window_push (entropy_window *w, byte b)
+{
+	if (w->filled==w->window_size)
 	{
-		H-=(double)hist[i]/len*log2((double)hist[i]/len);
+		window_update (w, w->ring[w->pos], -1);
 	}
-	return H;
-}
+	else
+		w->filled++;
 
-double entropy (byte* buf, size_t bufsize)
+	window_update (w, b, 1);
+	w->ring[w->pos]=b;
+	w->pos++;
+	if (w->pos==w->window_size)
+		w->pos=0;
+};
+
+void entropy_window_push_buf (entropy_window *w, const byte *buf, size_t bufsize)
 {
-	int *hist,histlen;
-	
-	hist=(int*)calloc(bufsize,sizeof(int));
+	for (size_t i=0; i<bufsize; i++)
+		entropy_window_push (w, buf[i]);
+};
 
-	histlen=makehist(buf,hist,bufsize);
-	//hist now has no order (known to the program) but that doesn't matter
-	return entropy_helper(hist,histlen,bufsize);
-}
- 
+double entropy_window_get (entropy_window *w)
+{
+	oassert (w->fixed_point==false);
+	return entropy_from_sum (w->sum, w->filled);
+};
+
+int32_t entropy_window_get_int (entropy_window *w)
+{
+	oassert (w->fixed_point);
+	return entropy_int_from_sum (w->sum_q, w->filled);
+};
+
+size_t entropy_sliding (const byte *buf, size_t bufsize, size_t window_size, size_t step, double *out)
+{
+	oassert (step>0);
+	if (bufsize<window_size)
+		return 0;
+
+	entropy_window w;
+	entropy_window_init (&w, window_size, false);
+	entropy_window_push_buf (&w, buf, window_size);
+
+	size_t rt=0;
+	out[rt++]=entropy_window_get (&w);
+	for (size_t ofs=step; ofs+window_size<=bufsize; ofs+=step)
+	{
+		entropy_window_push_buf (&w, buf+ofs+window_size-step, step);
+		out[rt++]=entropy_window_get (&w);
+	};
+
+	entropy_window_deinit (&w);
+	return rt;
+};
+
+struct block_map_job
+{
+	const byte *buf;
+	size_t bufsize;
+	size_t block_size;
+	double *out;
+	int32_t *out_int;
+};
+
+static void block_map_worker (size_t i, void *param)
+{
+	struct block_map_job *j=(struct block_map_job*)param;
+	size_t ofs=i*j->block_size;
+	entropy_state s;
+
+	entropy_state_init (&s);
+	entropy_state_add (&s, j->buf+ofs, min(j->block_size, j->bufsize-ofs));
+	if (j->out)
+		j->out[i]=entropy_state_get (&s);
+	else
+		j->out_int[i]=entropy_state_get_int (&s);
+};
+
+static void block_map (const byte *buf, size_t bufsize, size_t block_size, double *out, int32_t *out_int, unsigned threads)
+{
+	oassert (block_size>0);
+	struct block_map_job j={ buf, bufsize, block_size, out, out_int };
+	parallel_for ((bufsize+block_size-1)/block_size, threads, block_map_worker, &j);
+};
+
+void entropy_block_map (const byte *buf, size_t bufsize, size_t block_size, double *out, unsigned threads)
+{
+	block_map (buf, bufsize, block_size, out, NULL, threads);
+};
+
+void entropy_block_map_int (const byte *buf, size_t bufsize, size_t block_size, int32_t *out, unsigned threads)
+{
+	block_map (buf, bufsize, block_size, NULL, out, threads);
+};
 
@@ -2,6 +2,7 @@
 
 #include "datatypes.h"
 #include <stdio.h>
+#include <stdbool.h>
 
 #ifdef  __cplusplus
 extern "C" {
@@ -12,6 +13,63 @@ double entropy (byte* buf, size_t bufsize);
 // in fixed point format
 int32_t entropy_int (byte* buf, size_t bufsize);
 
+// fixed-point (Q16.16) helpers from entropy_int.c
+int32_t log2fix (uint32_t x);
+int32_t q_mul (int32_t x, int32_t y);
+int32_t q_div (int32_t x, int32_t y);
+int32_t q_make_from_integer (int i);
+
+// streaming entropy: data can be added by chunks
+typedef struct _entropy_state
+{
+	octa hist[256];
+	octa total;
+} entropy_state;
+
+void entropy_state_init (entropy_state *s);
+void entropy_state_add (entropy_state *s, const byte *buf, size_t bufsize);
+double entropy_state_get (entropy_state *s);
+int32_t entropy_state_get_int (entropy_state *s);
+
+// sliding window entropy, O(1) per byte
+// bytes are pushed one by one, entropy is calculated over last window_size bytes
+// (or over all bytes pushed, if there are less)
+typedef struct _entropy_window
+{
+	tetra hist[256];
+	byte *ring;
+	size_t window_size;
+	size_t pos; // position in ring
+	size_t filled; // min(bytes pushed, window_size)
+	bool fixed_point;
+	// sum of c*log2(c) for all counters and table of c*log2(c) for c=0..window_size
+	double sum;
+	double *clog2c;
+	octa_s sum_q; // fixed_point mode, Q16.16
+	octa_s *clog2c_q;
+} entropy_window;
+
+// fixed_point==true: integer-only path, use entropy_window_get_int()
+void entropy_window_init (entropy_window *w, size_t window_size, bool fixed_point);
+void entropy_window_deinit (entropy_window *w);
+void entropy_window_push (entropy_window *w, byte b);
+void entropy_window_push_buf (entropy_window *w, const byte *buf, size_t bufsize);
+double entropy_window_get (entropy_window *w);
+int32_t entropy_window_get_int (entropy_window *w);
+
+// entropy of each window_size-bytes window, starting at 0, step, 2*step...
+// out must have room for (bufsize-window_size)/step+1 values, returns number of values
+size_t entropy_sliding (const byte *buf, size_t bufsize, size_t window_size, size_t step, double *out);
+
+// entropy of each block_size-bytes block (last one can be shorter), computed in parallel
+// out must have room for (bufsize+block_size-1)/block_size values, threads==0 means all CPUs
+void entropy_block_map (const byte *buf, size_t bufsize, size_t block_size, double *out, unsigned threads);
+void entropy_block_map_int (const byte *buf, size_t bufsize, size_t block_size, int32_t *out, unsigned threads);
+
+// c*log2(c) and log2(n)-sum/n in Q16.16 (entropy_int.c)
+octa_s entropy_int_clog2c (octa c);
+int32_t entropy_int_from_sum (octa_s sum, octa n);
+
 #ifdef  __cplusplus
 }
 #endif
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "datatypes.h"
+#include "entropy.h"
 
 // Q16.16
 #define PRECISION 16
@@ -70,48 +71,43 @@ int32_t q_make_from_integer (int i)
 	return i<<PRECISION;
 };
 
-// this source code is based on example from http://rosettacode.org/wiki/Entropy#C
+// see comments in entropy.c
 
-static int makehist(unsigned char *S,int *hist,int len)
+// log2(c) for integer c, Q16.16
+static int32_t log2_of_integer (octa c)
 {
-	int wherechar[256];
-	int i,histlen;
-	histlen=0;
-	for(i=0;i<256;i++)
-		wherechar[i]=-1;
-	for(i=0;i<len;i++)
+	int k=0;
+	while (c>UINT32_MAX)
 	{
-		if(wherechar[(int)S[i]]==-1)
-		{
-			wherechar[(int)S[i]]=histlen;
-			histlen++;
-		}
-		hist[wherechar[(int)S[i]]]++;
-	}
-	return histlen;
-}
+		c>>=1;
+		k++;
+	};
+	// log2fix() treats its argument as Q16.16
+	return log2fix((uint32_t)c) + q_make_from_integer(PRECISION+k);
+};
 
-static int32_t entropy_helper(int *hist,int histlen,int buflen)
+// c*log2(c), Q16.16
+octa_s entropy_int_clog2c (octa c)
 {
-	int i;
-	int32_t H=0;
-	for(i=0;i<histlen;i++)
-	{
-		int32_t tmp=q_div(q_make_from_integer(hist[i]), q_make_from_integer(buflen));
-		H-=q_mul (tmp, log2fix(tmp));
-	}
-	return H;
-}
-	
+	if (c<2)
+		return 0;
+	return (octa_s)c * log2_of_integer(c);
+};
+
+// log2(n) - sum/n, Q16.16
+int32_t entropy_int_from_sum (octa_s sum, octa n)
+{
+	if (n==0)
+		return 0;
+	return log2_of_integer(n) - (int32_t)(sum/(octa_s)n);
+};
+
 // or convert to double: entropy_int(...) / SCALE
 int32_t entropy_int (byte* buf, size_t bufsize)
 {
-	int *hist,histlen;
-	
-	hist=(int*)calloc(bufsize,sizeof(int));
-
-	histlen=makehist(buf,hist,bufsize);
-	//hist now has no order (known to the program) but that doesn't matter
-	return entropy_helper(hist,histlen,bufsize);
+	entropy_state s;
+	entropy_state_init (&s);
+	entropy_state_add (&s, buf, bufsize);
+	return entropy_state_get_int (&s);
 }
 
@@ -31,6 +31,12 @@
 #include <dirent.h>
 #include <errno.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <stdint.h>
 #endif
 
 #include "stuff.h"
@@ -38,6 +44,9 @@
 #include "strbuf.h"
 #include "enum_files.h"
 #include "ostrings.h"
+#include "threads.h"
+#include "dmalloc.h"
+#include "oassert.h"
 
 void enum_files_in_dir(const char* path, callback_fn cb, void *param)
 {
@@ -96,3 +105,370 @@ void enum_files_in_dir(const char* path, callback_fn cb, void *param)
 #warning "undetermined compiler"
 #endif
 };
+
+// recursive walker
+// each thread has a deque of directories to read: new subdirectories are pushed and popped at the tail
+// (so a thread goes deep first), idle threads steal from the head of others' deques (bigger subtrees there)
+
+#if defined(__linux__) || defined(__CYGWIN__) || defined (__APPLE__)
+
+// a directory being read keeps its fd open while it has subdirectories not opened yet, so these are
+// opened relative to it; but not more than this number of fds, then subdirectories are opened by pathname
+#define WALK_MAX_HELD_FDS 256
+#define WALK_DENTS_BUF_SIZE (64*1024)
+// idle threads check for new work or the end at least this often
+#define WALK_IDLE_WAIT_MS 1
+
+struct walk_dir
+{
+	int fd;
+	// the directory itself while it's read, and each subdirectory not opened yet; atomic
+	size_t refs;
+};
+
+struct walk_item
+{
+	struct walk_dir *parent; // NULL: opened by pathname
+	size_t name_ofs; // name is in pathname, 0 for the root
+	char pathname[];
+};
+
+struct walk_deque
+{
+	my_mutex lock;
+	// ring, allocated is power of 2
+	struct walk_item **items;
+	size_t head, tail, allocated;
+};
+
+struct walk
+{
+	int flags;
+	callback_fn cb;
+	void *param;
+	unsigned threads;
+	struct walk_deque *deques;
+	struct walk_stats *stats; // per thread
+	// atomic:
+	size_t pending; // items pushed and not processed yet
+	size_t held_fds;
+	size_t idle;
+	// for idle threads
+	my_mutex lock;
+	my_cond wake;
+};
+
+static void deque_push (struct walk_deque *d, struct walk_item *it)
+{
+	my_mutex_lock (&d->lock);
+	if (d->tail-d->head==d->allocated)
+	{
+		size_t allocated=d->allocated ? d->allocated*2 : 64;
+		struct walk_item **items=DMALLOC(struct walk_item*, allocated, "walk_item*");
+		for (size_t i=d->head; i<d->tail; i++)
+			items[i & (allocated-1)]=d->items[i & (d->allocated-1)];
+		DFREE(d->items);
+		d->items=items;
+		d->allocated=allocated;
+	};
+	d->items[d->tail++ & (d->allocated-1)]=it;
+	my_mutex_unlock (&d->lock);
+};
+
+// from the tail if own, from the head if stolen
+static struct walk_item *deque_take (struct walk_deque *d, bool own)
+{
+	struct walk_item *it=NULL;
+
+	my_mutex_lock (&d->lock);
+	if (d->tail>d->head)
+		it=own ? d->items[--d->tail & (d->allocated-1)] : d->items[d->head++ & (d->allocated-1)];
+	my_mutex_unlock (&d->lock);
+	return it;
+};
+
+static void walk_push (struct walk *w, unsigned t, struct walk_item *it)
+{
+	MY_FETCH_ADD(&w->pending, 1);
+	deque_push (&w->deques[t], it);
+	if (MY_LOAD_ACQUIRE(&w->idle))
+	{
+		my_mutex_lock (&w->lock);
+		my_cond_signal (&w->wake);
+		my_mutex_unlock (&w->lock);
+	};
+};
+
+static struct walk_item *walk_get (struct walk *w, unsigned t)
+{
+	struct walk_item *it=deque_take (&w->deques[t], true);
+
+	for (unsigned i=1; it==NULL && i<w->threads; i++)
+		it=deque_take (&w->deques[(t+i)%w->threads], false);
+	return it;
+};
+
+static void walk_dir_release (struct walk *w, struct walk_dir *d)
+{
+	if (MY_FETCH_ADD(&d->refs, (size_t)-1)!=1)
+		return;
+	close (d->fd);
+	MY_FETCH_ADD(&w->held_fds, (size_t)-1);
+	DFREE(d);
+};
+
+static struct walk_item *walk_item_create (struct walk_dir *parent, const char *pathname, size_t len, size_t name_ofs)
+{
+	struct walk_item *it=(struct walk_item*)DMALLOC(char, sizeof(struct walk_item)+len+1, "walk_item");
+
+	it->parent=parent;
+	it->name_ofs=name_ofs;
+	memcpy (it->pathname, pathname, len+1);
+	return it;
+};
+
+// called for each entry of directory; *d is created at the first subdirectory
+static void walk_entry (struct walk *w, unsigned t, int fd, struct walk_dir **d, strbuf *path, size_t prefix_len,
+		const char *name, unsigned char type)
+{
+	struct walk_stats *stats=&w->stats[t];
+	struct stat st;
+	size_t size=0;
+	time_t mtime=0;
+	bool is_dir;
+
+	if (name[0]=='.' && (name[1]==0 || (name[1]=='.' && name[2]==0)))
+		return;
+	if ((w->flags & WALK_STAT) || type==DT_UNKNOWN)
+	{
+		if (fstatat (fd, name, &st, AT_SYMLINK_NOFOLLOW)==-1)
+		{
+			stats->errors++;
+			return;
+		};
+		type=S_ISDIR(st.st_mode) ? DT_DIR : S_ISLNK(st.st_mode) ? DT_LNK : DT_REG;
+		size=st.st_size;
+		mtime=st.st_mtime;
+	};
+
+	if (path->strlen>prefix_len)
+		strbuf_make_shorter (path, prefix_len);
+	strbuf_addstr (path, name);
+	is_dir=type==DT_DIR;
+	w->cb (name, path->buf, size, mtime, is_dir, w->param);
+	if (!is_dir)
+	{
+		stats->files++;
+		return;
+	};
+
+	stats->dirs++;
+	if (*d==NULL)
+	{
+		if (MY_FETCH_ADD(&w->held_fds, 1)<WALK_MAX_HELD_FDS)
+		{
+			*d=DMALLOC(struct walk_dir, 1, "walk_dir");
+			(*d)->fd=fd;
+			(*d)->refs=1;
+		}
+		else
+			MY_FETCH_ADD(&w->held_fds, (size_t)-1);
+	};
+	if (*d)
+		MY_FETCH_ADD(&(*d)->refs, 1);
+	walk_push (w, t, walk_item_create (*d, path->buf, path->strlen, prefix_len));
+};
+
+#ifdef __linux__
+struct linux_dirent64
+{
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+#endif
+
+static void walk_process (struct walk *w, unsigned t, struct walk_item *it, char *dents_buf, strbuf *path)
+{
+	struct walk_dir *d=NULL;
+	size_t prefix_len;
+	int fd;
+
+	if (it->parent)
+	{
+		fd=openat (it->parent->fd, it->pathname+it->name_ofs, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+		walk_dir_release (w, it->parent);
+	}
+	else
+		fd=open (it->pathname, O_RDONLY | O_DIRECTORY | O_CLOEXEC | (it->name_ofs ? O_NOFOLLOW : 0));
+	if (fd==-1)
+	{
+		w->stats[t].errors++;
+		return;
+	};
+
+	strbuf_reinit (path, 0);
+	strbuf_addstr (path, it->pathname);
+	if (strbuf_last_char (path)!='/')
+		strbuf_addc (path, '/');
+	prefix_len=path->strlen;
+
+#ifdef __linux__
+	// getdents64() fills the buffer with many entries at once, d_type is there
+	for (;;)
+	{
+		long n=syscall (SYS_getdents64, fd, dents_buf, WALK_DENTS_BUF_SIZE);
+		if (n<=0)
+		{
+			if (n<0)
+				w->stats[t].errors++;
+			break;
+		};
+		for (long pos=0; pos<n; )
+		{
+			struct linux_dirent64 *e=(struct linux_dirent64*)(dents_buf+pos);
+			pos+=e->d_reclen;
+			walk_entry (w, t, fd, &d, path, prefix_len, e->d_name, e->d_type);
+		};
+	};
+#else
+	int fd2=dup (fd);
+	DIR *dir=fd2==-1 ? NULL : fdopendir (fd2);
+	struct dirent *e;
+
+	if (dir==NULL)
+		w->stats[t].errors++;
+	else
+	{
+		while ((e=readdir (dir))!=NULL)
+			walk_entry (w, t, fd, &d, path, prefix_len, e->d_name, e->d_type);
+		closedir (dir);
+	};
+#endif
+
+	if (d)
+		walk_dir_release (w, d);
+	else
+		close (fd);
+};
+
+static void walk_worker (size_t t, void *param)
+{
+	struct walk *w=(struct walk*)param;
+	char *dents_buf=DMALLOC(char, WALK_DENTS_BUF_SIZE, "dents_buf");
+	strbuf path=STRBUF_INIT;
+	struct walk_item *it;
+
+	for (;;)
+	{
+		it=walk_get (w, t);
+		if (it)
+		{
+			walk_process (w, t, it, dents_buf, &path);
+			DFREE(it);
+			if (MY_FETCH_ADD(&w->pending, (size_t)-1)==1)
+			{
+				// the last one, wake up idle threads to exit
+				my_mutex_lock (&w->lock);
+				my_cond_broadcast (&w->wake);
+				my_mutex_unlock (&w->lock);
+			};
+			continue;
+		};
+
+		// all items may be processed by other threads at the moment, new ones can appear
+		if (MY_LOAD_ACQUIRE(&w->pending)==0)
+			break;
+		my_mutex_lock (&w->lock);
+		MY_FETCH_ADD(&w->idle, 1);
+		if (MY_LOAD_ACQUIRE(&w->pending))
+			my_cond_timedwait (&w->wake, &w->lock, WALK_IDLE_WAIT_MS);
+		MY_FETCH_ADD(&w->idle, (size_t)-1);
+		my_mutex_unlock (&w->lock);
+	};
+
+	DFREE(dents_buf);
+	strbuf_deinit (&path);
+};
+
+void walk_tree (const char *path, unsigned threads, int flags, callback_fn cb, void *param, struct walk_stats *stats)
+{
+	struct walk w;
+
+	assert(path);
+	if (threads==0)
+		threads=get_CPUs_count();
+	w.flags=flags;
+	w.cb=cb;
+	w.param=param;
+	w.threads=threads;
+	w.deques=DCALLOC(struct walk_deque, threads, "walk_deque");
+	w.stats=DCALLOC(struct walk_stats, threads, "walk_stats");
+	for (unsigned t=0; t<threads; t++)
+		my_mutex_init (&w.deques[t].lock);
+	w.pending=w.held_fds=w.idle=0;
+	my_mutex_init (&w.lock);
+	my_cond_init (&w.wake);
+
+	walk_push (&w, 0, walk_item_create (NULL, path, strlen (path), 0));
+	parallel_for (threads, threads, walk_worker, &w);
+
+	if (stats)
+		memset (stats, 0, sizeof(struct walk_stats));
+	for (unsigned t=0; t<threads; t++)
+	{
+		if (stats)
+		{
+			stats->files+=w.stats[t].files;
+			stats->dirs+=w.stats[t].dirs;
+			stats->errors+=w.stats[t].errors;
+		};
+		oassert (w.deques[t].tail==w.deques[t].head);
+		DFREE(w.deques[t].items);
+		my_mutex_deinit (&w.deques[t].lock);
+	};
+	DFREE(w.deques);
+	DFREE(w.stats);
+	my_cond_deinit (&w.wake);
+	my_mutex_deinit (&w.lock);
+};
+
+#else
+
+// single-threaded here
+
+struct walk_seq
+{
+	callback_fn cb;
+	void *param;
+	struct walk_stats stats;
+};
+
+static void walk_seq_cb (const char *name, const char *pathname, size_t size, time_t t, bool is_dir, void *param)
+{
+	struct walk_seq *w=(struct walk_seq*)param;
+
+	if (strcmp (name, ".")==0 || strcmp (name, "..")==0)
+		return;
+	w->cb (name, pathname, size, t, is_dir, w->param);
+	if (is_dir)
+	{
+		w->stats.dirs++;
+		enum_files_in_dir (pathname, walk_seq_cb, param);
+	}
+	else
+		w->stats.files++;
+};
+
+void walk_tree (const char *path, unsigned threads, int flags, callback_fn cb, void *param, struct walk_stats *stats)
+{
+	struct walk_seq w={ cb, param, { 0, 0, 0 } };
+
+	enum_files_in_dir (path, walk_seq_cb, &w);
+	if (stats)
+		*stats=w.stats;
+};
+
+#endif
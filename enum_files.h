@@ -20,6 +20,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
 
 #ifdef  __cplusplus
 extern "C" {
@@ -28,6 +30,22 @@ extern "C" {
 typedef void (*callback_fn)(const char *name, const char *pathname, size_t size, time_t t, bool is_dir, void *param);
 void enum_files_in_dir(const char* path, callback_fn cb, void *param);
 
+// recursive walk, subdirectories are distributed among threads (0 means get_CPUs_count());
+// cb is called for each file and directory in the tree, except . and .., from several threads at once
+// symlinks aren't followed (is_dir is false for them), except if path itself is a symlink
+// size and t are filled only with WALK_STAT, otherwise they're 0 (unless the file type is unknown
+// without stat() anyway)
+// errors (unreadable directories, files deleted meanwhile) aren't fatal, they're counted
+#define WALK_STAT 1
+
+struct walk_stats
+{
+	size_t files, dirs, errors;
+};
+
+// stats may be NULL
+void walk_tree (const char *path, unsigned threads, int flags, callback_fn cb, void *param, struct walk_stats *stats);
+
 #ifdef  __cplusplus
 }
 #endif
@@ -0,0 +1,92 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// files/sec of walk_tree() with 1, 2, 4... threads, without and with WALK_STAT,
+// vs. recursive enum_files_in_dir(), which calls stat() for each entry
+// usage: enum_files_bench [dir] [max threads]; the tree is walked once before, to warm up caches
+// (enum_files_in_dir() dies on files which can't be stat()-ed, like dangling symlinks, use --no-baseline then)
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "enum_files.h"
+#include "dmalloc.h"
+#include "stuff.h"
+#include "threads.h"
+
+static void count_cb (const char *name, const char *pathname, size_t size, time_t t, bool is_dir, void *param)
+{
+};
+
+static void recursive_cb (const char *name, const char *pathname, size_t size, time_t t, bool is_dir, void *param)
+{
+	if (strcmp (name, ".")==0 || strcmp (name, "..")==0)
+		return;
+	(*(size_t*)param)++;
+	if (is_dir)
+		enum_files_in_dir (pathname, recursive_cb, param);
+};
+
+int main(int argc, char **argv)
+{
+	const char *dir="/usr";
+	unsigned max_threads=get_CPUs_count();
+	bool baseline=true;
+	struct walk_stats stats;
+	double t;
+
+	for (int i=1, n=0; i<argc; i++)
+		if (strcmp (argv[i], "--no-baseline")==0)
+			baseline=false;
+		else if (n++==0)
+			dir=argv[i];
+		else
+			max_threads=atoi (argv[i]);
+	if (max_threads==0)
+		die ("usage: %s [--no-baseline] [dir] [max threads]\n", argv[0]);
+
+	walk_tree (dir, max_threads, WALK_STAT, count_cb, NULL, &stats);
+	printf ("%s: %d files, %d directories, %d errors\n", dir, (int)stats.files, (int)stats.dirs, (int)stats.errors);
+
+	if (baseline)
+	{
+		size_t total=0;
+		t=get_monotonic_time();
+		enum_files_in_dir (dir, recursive_cb, &total);
+		t=get_monotonic_time()-t;
+		printf ("enum_files_in_dir, recursive: %10.0f files/sec\n", total/t);
+	};
+
+	printf ("threads   files/sec   with WALK_STAT\n");
+	for (unsigned thr=1; ; thr=thr*2>max_threads && thr<max_threads ? max_threads : thr*2)
+	{
+		double rates[2];
+		for (int with_stat=0; with_stat<2; with_stat++)
+		{
+			t=get_monotonic_time();
+			walk_tree (dir, thr, with_stat ? WALK_STAT : 0, count_cb, NULL, &stats);
+			t=get_monotonic_time()-t;
+			rates[with_stat]=(stats.files+stats.dirs)/t;
+		};
+		printf ("%7d  %10.0f  %15.0f\n", thr, rates[0], rates[1]);
+		if (thr>=max_threads)
+			break;
+	};
+
+	dump_unfreed_blocks();
+};
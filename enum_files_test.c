@@ -15,7 +15,7 @@
  *
  */
 
-// this test is not included in tests.sh
+// tests.sh runs it and checks its output
 
 #include <stdio.h>
 #include <time.h>
@@ -24,10 +24,15 @@
 #include <unistd.h>
 #endif
 #include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
 
 #include "stuff.h"
 #include "fmt_utils.h"
 #include "enum_files.h"
+#include "files.h"
+#include "threads.h"
+#include "oassert.h"
 
 void cb (const char *name, const char *pathname, size_t size, time_t t, bool is_dir, void *param)
 {
@@ -36,10 +41,115 @@ void cb (const char *name, const char *pathname, size_t size, time_t t, bool is_
 		__FUNCTION__, name, pathname, size, is_dir, asctime(_tm));
 };
 
+#define WALK_DIRS 7
+#define WALK_SUBDIRS 5
+#define WALK_FILES 11
+
+struct walk_seen
+{
+	my_mutex lock;
+	size_t files, dirs, size_total;
+	bool symlink_seen;
+};
+
+static void walk_cb (const char *name, const char *pathname, size_t size, time_t t, bool is_dir, void *param)
+{
+	struct walk_seen *s=(struct walk_seen*)param;
+
+	oassert (strncmp (pathname, "walk_test_tree/", 15)==0);
+	oassert (strcmp (pathname+strlen (pathname)-strlen (name), name)==0);
+	my_mutex_lock (&s->lock);
+	if (is_dir)
+		s->dirs++;
+	else
+	{
+		s->files++;
+		s->size_total+=size;
+		if (strcmp (name, "link")==0)
+			s->symlink_seen=true;
+	};
+	my_mutex_unlock (&s->lock);
+};
+
+// walk_test_tree/dI/dJ/fK, files are K bytes; a symlink to the tree root, not to be followed
+static void make_tree (bool create)
+{
+	char path[256];
+
+	if (create)
+		mkdir ("walk_test_tree", 0755);
+	else
+		unlink ("walk_test_tree/d0/link");
+	for (int i=0; i<WALK_DIRS; i++)
+	{
+		snprintf (path, sizeof(path), "walk_test_tree/d%d", i);
+		if (create)
+			mkdir (path, 0755);
+		for (int j=0; j<WALK_SUBDIRS; j++)
+		{
+			snprintf (path, sizeof(path), "walk_test_tree/d%d/d%d", i, j);
+			if (create)
+				mkdir (path, 0755);
+			for (int k=0; k<WALK_FILES; k++)
+			{
+				snprintf (path, sizeof(path), "walk_test_tree/d%d/d%d/f%d", i, j, k);
+				if (create)
+				{
+					FILE *f=fopen_or_die (path, "wb");
+					for (int b=0; b<k; b++)
+						fputc ('x', f);
+					fclose (f);
+				}
+				else
+					unlink (path);
+			};
+			if (!create)
+			{
+				snprintf (path, sizeof(path), "walk_test_tree/d%d/d%d", i, j);
+				rmdir (path);
+			};
+		};
+		if (!create)
+		{
+			snprintf (path, sizeof(path), "walk_test_tree/d%d", i);
+			rmdir (path);
+		};
+	};
+	if (create)
+		oassert (symlink ("..", "walk_test_tree/d0/link")==0);
+	else
+		rmdir ("walk_test_tree");
+};
+
+static void check_walk_tree (unsigned threads, int flags)
+{
+	struct walk_seen s;
+	struct walk_stats stats;
+
+	memset (&s, 0, sizeof(s));
+	my_mutex_init (&s.lock);
+	walk_tree ("walk_test_tree", threads, flags, walk_cb, &s, &stats);
+	my_mutex_deinit (&s.lock);
+
+	oassert (s.dirs==WALK_DIRS+WALK_DIRS*WALK_SUBDIRS && s.dirs==stats.dirs);
+	oassert (s.files==WALK_DIRS*WALK_SUBDIRS*WALK_FILES+1 && s.files==stats.files);
+	oassert (s.symlink_seen && stats.errors==0);
+	if (flags & WALK_STAT)
+		// plus the symlink
+		oassert (s.size_total==WALK_DIRS*WALK_SUBDIRS*(WALK_FILES*(WALK_FILES-1)/2)+2);
+};
+
 int main()
 {
 	char tmp[256];
 	if (getcwd (tmp, sizeof(tmp))==NULL)
 		die ("getcwd failed: %s\n", strerror(errno));
 	enum_files_in_dir (tmp, cb, NULL);
+
+	make_tree (true);
+	check_walk_tree (1, 0);
+	check_walk_tree (4, 0);
+	check_walk_tree (4, WALK_STAT);
+	make_tree (false);
+	printf ("walk_tree: ok\n");
 };
@@ -38,6 +38,11 @@
 
 #ifdef __GNUC__
 #include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef _MSC_VER
+#include <windows.h>
 #endif
 
 bool file_exist (const char *filename)
@@ -157,6 +162,93 @@ void read_text_file_by_line_or_die (char *fname, read_text_file_by_line_callback
 	fclose (f);
 };
 
+byte* map_file_or_die (const char* fname, size_t *fsize)
+{
+	size_t fs=get_file_size_or_die(fname);
+	byte* rt;
+
+	*fsize=fs;
+	// zero-length mappings are not allowed
+	if (fs==0)
+		return NULL;
+#ifdef _MSC_VER
+	HANDLE f=CreateFileA(fname, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (f==INVALID_HANDLE_VALUE)
+		die ("Cannot open file %s\n", fname);
+	HANDLE m=CreateFileMapping(f, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m==NULL)
+		die ("CreateFileMapping() failed for file %s\n", fname);
+	rt=(byte*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, fs);
+	if (rt==NULL)
+		die ("MapViewOfFile() failed for file %s\n", fname);
+	// the view keeps the file mapped
+	CloseHandle(m);
+	CloseHandle(f);
+#else
+	int fd=open_or_die((char*)fname, O_RDONLY);
+	rt=(byte*)mmap(NULL, fs, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (rt==MAP_FAILED)
+		die ("mmap() failed for file %s\n", fname);
+	close(fd);
+#endif
+	return rt;
+};
+
+// ... or return NULL
+byte* map_file (const char* fname, size_t *fsize)
+{
+	byte* rt;
+
+	*fsize=0;
+#ifdef _MSC_VER
+	HANDLE f=CreateFileA(fname, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	LARGE_INTEGER fs;
+	if (f==INVALID_HANDLE_VALUE)
+		return NULL;
+	if (GetFileSizeEx(f, &fs)==0 || fs.QuadPart==0)
+	{
+		CloseHandle(f);
+		return NULL;
+	};
+	HANDLE m=CreateFileMapping(f, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(f);
+	if (m==NULL)
+		return NULL;
+	rt=(byte*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, (size_t)fs.QuadPart);
+	CloseHandle(m);
+	if (rt==NULL)
+		return NULL;
+	*fsize=(size_t)fs.QuadPart;
+#else
+	struct stat st;
+	int fd=open(fname, O_RDONLY);
+	if (fd==-1)
+		return NULL;
+	if (fstat(fd, &st)!=0 || !S_ISREG(st.st_mode) || st.st_size==0)
+	{
+		close(fd);
+		return NULL;
+	};
+	rt=(byte*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (rt==MAP_FAILED)
+		return NULL;
+	*fsize=st.st_size;
+#endif
+	return rt;
+};
+
+void unmap_file (byte* buf, size_t fsize)
+{
+	if (buf==NULL)
+		return;
+#ifdef _MSC_VER
+	UnmapViewOfFile(buf);
+#else
+	munmap(buf, fsize);
+#endif
+};
+
 // "filename.ext" -> "filename", "ext"
 // no path!
 void split_fname (char *fname, char *basefname, size_t basefname_len, char *ext, size_t ext_len)
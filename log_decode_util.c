@@ -0,0 +1,35 @@
+// renders a log written in binary mode (see L_binary_init()) as text, to stdout
+// --timestamps prefixes each line with the time it was logged at
+
+#include <stdio.h>
+#include <string.h>
+
+#include "logging.h"
+#include "files.h"
+#include "dmalloc.h"
+#include "stuff.h"
+
+int main(int argc, char* argv[])
+{
+	bool timestamps=false;
+	const char *fname=NULL;
+	FILE *in;
+
+	for (int i=1; i<argc; i++)
+	{
+		if (strcmp (argv[i], "--timestamps")==0)
+			timestamps=true;
+		else if (memcmp (argv[i], "--", 2)==0 || fname)
+			die ("Usage: %s [--timestamps] <file>\n", argv[0]);
+		else
+			fname=argv[i];
+	};
+	if (fname==NULL)
+		die ("Usage: %s [--timestamps] <file>\n", argv[0]);
+
+	in=fopen_or_die (fname, "rb");
+	if (!L_binary_decode (in, stdout, timestamps))
+		die ("%s: malformed or truncated log\n", fname);
+	fclose (in);
+	dump_unfreed_blocks();
+};
@@ -23,13 +23,20 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <limits.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "datatypes.h"
 #include "logging.h"
 #include "dmalloc.h"
-#include "rbtree.h"
 #include "strbuf.h"
 #include "stuff.h"
+#include "threads.h"
 #include "inttypes.h"
 #include "fmt_utils.h"
 
@@ -39,23 +46,22 @@ fds cur_fds={ NULL, NULL };
 bool L_timestamp=false;
 int L_ofs_width=__WORDSIZE;
 
-// set actually is here
-rbtree *once_was_printed=NULL;
+static void once_summary (void);
+static void once_deinit (void);
 
 void L_deinit(void)
 {
+    once_summary();
+    L_async_deinit();
+    L_binary_deinit();
+
     if (cur_fds.fd2!=NULL)
     {
         fclose(cur_fds.fd2);
         cur_fds.fd2=NULL;
     };
 
-    if (once_was_printed)
-    {
-        rbtree_foreach(once_was_printed, NULL, dfree, NULL);
-        rbtree_deinit(once_was_printed);
-        once_was_printed=NULL;
-    };
+    once_deinit();
 };
 
 void L_init_stdout_only ()
@@ -75,46 +81,1200 @@ void L_init (const char* fname)
     atexit(L_deinit);
 };
 
-void L_va (const char * fmt, va_list va)
+// asynchronous mode
+
+// records in ring are aligned to this
+#define LOG_RECORD_ALIGN 8
+// writer checks rings at least this often
+#define LOG_WRITER_PERIOD_MS 10
+#define LOG_BATCH_SIZE (64*1024)
+// number of files the writer batches for at once
+#define LOG_BATCHES 4
+
+struct log_record
 {
-    L_fds_va(&cur_fds, fmt, va);
+    FILE *fd1, *fd2;
+    tetra size; // of the whole record, with header and padding
+    tetra len; // of text after header, 0 for padding
 };
 
-void L_fds_va (fds *s, const char * fmt, va_list va)
+// single producer (the owner thread), single consumer (the writer)
+struct log_ring
+{
+    byte *buf;
+    size_t size; // power of 2
+    size_t head; // written by the owner
+    size_t tail; // written by the writer
+    size_t dropped; // written by the owner
+    size_t dropped_reported; // by the writer
+    size_t orphaned; // the owner has exited
+    bool last_char_was_CR_or_unknown;
+    // where the last message has been written, the number of dropped messages is written there too
+    FILE *last_fd1, *last_fd2;
+    struct log_ring *next;
+};
+
+struct log_batch
+{
+    FILE *f;
+    char *buf;
+    size_t len;
+};
+
+static struct
+{
+    volatile bool on;
+    enum L_async_overflow overflow;
+    size_t ring_size;
+    my_tls_key key;
+    my_thread writer;
+    // under lock:
+    my_mutex lock;
+    my_cond wake, drained; // to the writer, from the writer
+    struct log_ring *rings;
+    bool stop;
+    size_t writer_idle; // a hint for callers, accessed atomically
+    size_t flush_requests, flushes_done;
+    octa written, dropped;
+    // used by the writer only
+    struct log_batch batches[LOG_BATCHES];
+} async;
+
+// timestamps
+
+// wall clock is read once, then it's advanced by monotonic clock, so it doesn't go back in time;
+// NTP rate adjustments are followed, but steps of wall clock after that aren't
+static struct
+{
+    size_t ready;
+    my_mutex lock;
+    enum L_timestamp_mode mode;
+    octa wall_us;
+    double monotonic;
+    octa tsc;
+} ts_base={ 0, MY_MUTEX_INITIALIZER, L_TIMESTAMP_MS, 0, 0, 0 };
+
+// local date and time is formatted once in a second, in each thread
+static MY_THREAD_LOCAL struct
+{
+    bool valid;
+    octa sec;
+    char prefix[32];
+    size_t len;
+} ts_cache;
+
+static octa wall_time_us (void)
 {
-    static bool last_char_was_CR_or_unknown=true;
-    // MinGW defines _WIN32
 #ifdef _WIN32
-    SYSTEMTIME t; // win32 only yet
+    FILETIME ft;
+    ULARGE_INTEGER u;
+
+    GetSystemTimeAsFileTime (&ft);
+    u.LowPart=ft.dwLowDateTime;
+    u.HighPart=ft.dwHighDateTime;
+    // since 1601, in 100ns units
+    return (u.QuadPart-116444736000000000ULL)/10;
+#else
+    struct timespec ts;
+
+    clock_gettime (CLOCK_REALTIME, &ts);
+    return (octa)ts.tv_sec*1000000+ts.tv_nsec/1000;
 #endif
+};
 
-    if (L_timestamp && last_char_was_CR_or_unknown)
-    {
-#ifdef _WIN32
-        GetLocalTime (&t);
-        if (s->fd1)
-            fprintf (s->fd1, "[%04d-%02d-%02d %02d:%02d:%02d:%03d] ", 
-                    t.wYear, t.wMonth, t.wDay, t.wHour, t.wMinute, t.wSecond, t.wMilliseconds);
-        if (s->fd2)
-            fprintf (s->fd2, "[%04d-%02d-%02d %02d:%02d:%02d:%03d] ", 
-                    t.wYear, t.wMonth, t.wDay, t.wHour, t.wMinute, t.wSecond, t.wMilliseconds);
+static octa read_tsc (void)
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    return __rdtsc();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    return __builtin_ia32_rdtsc();
 #else
-       oassert(!"to be implemented!");
-       fatal_error();
+    // no TSC, nanoseconds then
+    return (octa)(get_monotonic_time()*1e9);
 #endif
+};
+
+static void ts_base_init (enum L_timestamp_mode mode)
+{
+    ts_base.mode=mode;
+    ts_base.wall_us=wall_time_us();
+    ts_base.monotonic=get_monotonic_time();
+    ts_base.tsc=read_tsc();
+};
+
+void L_set_timestamp_mode (enum L_timestamp_mode mode)
+{
+    my_mutex_lock (&ts_base.lock);
+    ts_base_init (mode);
+    MY_STORE_RELEASE(&ts_base.ready, 1);
+    my_mutex_unlock (&ts_base.lock);
+};
+
+static void format_date (octa sec)
+{
+    time_t t=(time_t)sec;
+    struct tm tm;
+
+#ifdef _MSC_VER
+    localtime_s (&tm, &t);
+#else
+    localtime_r (&t, &tm);
+#endif
+    ts_cache.len=strftime (ts_cache.prefix, sizeof(ts_cache.prefix), "[%Y-%m-%d %H:%M:%S:", &tm);
+    ts_cache.sec=sec;
+    ts_cache.valid=true;
+};
+
+// timestamp for the beginning of line, returns its length
+static int format_timestamp (char *buf, size_t size)
+{
+    octa us, v;
+    int digits;
+    char *p;
+
+    if (MY_LOAD_ACQUIRE(&ts_base.ready)==0)
+    {
+        my_mutex_lock (&ts_base.lock);
+        if (ts_base.ready==0)
+        {
+            ts_base_init (L_TIMESTAMP_MS);
+            MY_STORE_RELEASE(&ts_base.ready, 1);
+        };
+        my_mutex_unlock (&ts_base.lock);
+    };
+
+    if (ts_base.mode==L_TIMESTAMP_TSC)
+    {
+        // as "[%14llu] ", but faster
+        oassert (size>=1+20+3);
+        v=read_tsc()-ts_base.tsc;
+        p=buf+1+20;
+        do
+        {
+            *--p='0'+v%10;
+            v/=10;
+        }
+        while (v);
+        while (p>buf+1+20-14)
+            *--p=' ';
+        *--p='[';
+        digits=buf+1+20-p;
+        memmove (buf, p, digits);
+        p=buf+digits;
+        *p++=']';
+        *p++=' ';
+        *p=0;
+        return p-buf;
+    };
+
+    us=ts_base.wall_us+(octa)((get_monotonic_time()-ts_base.monotonic)*1e6);
+    if (!ts_cache.valid || ts_cache.sec!=us/1000000)
+        format_date (us/1000000);
+    oassert (size>=ts_cache.len+6+3);
+    memcpy (buf, ts_cache.prefix, ts_cache.len);
+    p=buf+ts_cache.len;
+    if (ts_base.mode==L_TIMESTAMP_US)
+    {
+        v=us%1000000;
+        digits=6;
+    }
+    else
+    {
+        v=us/1000%1000;
+        digits=3;
+    };
+    for (int i=digits-1; i>=0; i--, v/=10)
+        p[i]='0'+v%10;
+    p+=digits;
+    *p++=']';
+    *p++=' ';
+    *p=0;
+    return p-buf;
+};
+
+static void batch_flush (struct log_batch *b)
+{
+    if (b->len)
+        fwrite (b->buf, 1, b->len, b->f);
+    b->len=0;
+};
+
+static void batch_write (FILE *f, const char *s, size_t len)
+{
+    struct log_batch *b=NULL;
+
+    for (int i=0; i<LOG_BATCHES && b==NULL; i++)
+        if (async.batches[i].f==f)
+            b=&async.batches[i];
+    for (int i=0; i<LOG_BATCHES && b==NULL; i++)
+        if (async.batches[i].f==NULL)
+            b=&async.batches[i];
+    if (b==NULL)
+    {
+        // too many files
+        b=&async.batches[0];
+        batch_flush (b);
+    };
+    b->f=f;
+    if (b->len+len>LOG_BATCH_SIZE)
+        batch_flush (b);
+    if (len>LOG_BATCH_SIZE)
+        fwrite (s, 1, len, f);
+    else
+    {
+        memcpy (b->buf+b->len, s, len);
+        b->len+=len;
+    };
+};
+
+static void batches_flush_all (void)
+{
+    for (int i=0; i<LOG_BATCHES; i++)
+        if (async.batches[i].f)
+        {
+            batch_flush (&async.batches[i]);
+            fflush (async.batches[i].f);
+            async.batches[i].f=NULL;
+        };
+};
+
+static void drain_ring (struct log_ring *r, octa *written, octa *dropped)
+{
+    size_t tail=r->tail, head=MY_LOAD_ACQUIRE(&r->head), d;
+
+    while (tail!=head)
+    {
+        size_t pos=tail & (r->size-1);
+        struct log_record *rec=(struct log_record*)(r->buf+pos);
+
+        if (r->size-pos<sizeof(struct log_record))
+        {
+            // no room for a record at the end, the next one is at the beginning
+            tail+=r->size-pos;
+            continue;
+        };
+        if (rec->len)
+        {
+            if (rec->fd1)
+                batch_write (rec->fd1, (const char*)(rec+1), rec->len);
+            if (rec->fd2)
+                batch_write (rec->fd2, (const char*)(rec+1), rec->len);
+            r->last_fd1=rec->fd1;
+            r->last_fd2=rec->fd2;
+            (*written)++;
+        };
+        tail+=rec->size;
+    };
+    MY_STORE_RELEASE(&r->tail, tail);
+
+    d=MY_LOAD_ACQUIRE(&r->dropped);
+    if (d!=r->dropped_reported)
+    {
+        char msg[64];
+        int len=snprintf (msg, sizeof(msg), "[%d message(s) dropped]\n", (int)(d-r->dropped_reported));
+        if (r->last_fd1)
+            batch_write (r->last_fd1, msg, len);
+        if (r->last_fd2)
+            batch_write (r->last_fd2, msg, len);
+        *dropped+=d-r->dropped_reported;
+        r->dropped_reported=d;
+    };
+};
+
+static void free_ring (struct log_ring *r)
+{
+    DFREE(r->buf);
+    DFREE(r);
+};
+
+static void writer_thread (void *param)
+{
+    for (;;)
+    {
+        struct log_ring *rings, *r, **prev;
+        size_t flush_target;
+        octa written=0, dropped=0;
+        bool stop;
+
+        my_mutex_lock (&async.lock);
+        if (!async.stop && async.flush_requests==async.flushes_done)
+        {
+            MY_STORE_RELEASE(&async.writer_idle, 1);
+            my_cond_timedwait (&async.wake, &async.lock, LOG_WRITER_PERIOD_MS);
+            MY_STORE_RELEASE(&async.writer_idle, 0);
+        };
+        flush_target=async.flush_requests;
+        stop=async.stop;
+        // new rings are added to the head of list, and only the writer removes them
+        rings=async.rings;
+        my_mutex_unlock (&async.lock);
+
+        for (r=rings; r; r=r->next)
+            drain_ring (r, &written, &dropped);
+        batches_flush_all ();
+
+        my_mutex_lock (&async.lock);
+        // rings of exited threads are freed after they are drained
+        for (prev=&async.rings; *prev; )
+        {
+            r=*prev;
+            if (MY_LOAD_ACQUIRE(&r->orphaned) && r->tail==MY_LOAD_ACQUIRE(&r->head))
+            {
+                *prev=r->next;
+                free_ring (r);
+            }
+            else
+                prev=&r->next;
+        };
+        async.written+=written;
+        async.dropped+=dropped;
+        async.flushes_done=flush_target;
+        my_cond_broadcast (&async.drained);
+        my_mutex_unlock (&async.lock);
+        if (stop)
+            break;
     };
+};
+
+// called at exit of thread which has logged something
+static void ring_destructor (void *p)
+{
+    MY_STORE_RELEASE(&((struct log_ring*)p)->orphaned, 1);
+};
+
+static struct log_ring *get_ring (void)
+{
+    struct log_ring *r=(struct log_ring*)my_tls_get (&async.key);
+
+    if (r)
+        return r;
+    r=DCALLOC(struct log_ring, 1, "log_ring");
+    r->size=async.ring_size;
+    r->buf=DMALLOC(byte, r->size, "log_ring");
+    r->last_char_was_CR_or_unknown=true;
+    r->last_fd1=cur_fds.fd1;
+    r->last_fd2=cur_fds.fd2;
+    my_mutex_lock (&async.lock);
+    r->next=async.rings;
+    async.rings=r;
+    my_mutex_unlock (&async.lock);
+    my_tls_set (&async.key, r);
+    return r;
+};
+
+void L_async_flush (void)
+{
+    size_t target;
+
+    if (!async.on)
+        return;
+    my_mutex_lock (&async.lock);
+    target=++async.flush_requests;
+    my_cond_signal (&async.wake);
+    while (async.flushes_done<target)
+        my_cond_wait (&async.drained, &async.lock);
+    my_mutex_unlock (&async.lock);
+};
+
+static void write_fds_va (fds *s, const char *stamp, const char * fmt, va_list va);
 
-    last_char_was_CR_or_unknown=(strlen(fmt)>0 && fmt[strlen(fmt)-1]=='\n') ? true : false;
-   
+static void async_fds_va (fds *s, const char * fmt, va_list va)
+{
+    struct log_ring *r=get_ring ();
+    char stamp[64];
+    int stamp_len=0, len=-1;
+    size_t fmt_len=strlen (fmt), needed=0;
+    va_list va_copied;
+
+    if (L_timestamp && r->last_char_was_CR_or_unknown)
+        stamp_len=format_timestamp (stamp, sizeof(stamp));
+    r->last_char_was_CR_or_unknown=fmt_len>0 && fmt[fmt_len-1]=='\n';
+
+    for (;;)
+    {
+        size_t head=r->head, used=head-MY_LOAD_ACQUIRE(&r->tail);
+        size_t pos=head & (r->size-1);
+        // positions and sizes are aligned, so these are too
+        size_t contiguous=r->size-pos, room=r->size-used;
+        size_t avail=room<contiguous ? room : contiguous;
+        struct log_record *rec=(struct log_record*)(r->buf+pos);
+
+        if (avail>sizeof(struct log_record)+stamp_len)
+        {
+            // formatting right into the ring, if it fits
+            va_copy (va_copied, va);
+            len=vsnprintf ((char*)(rec+1)+stamp_len, avail-sizeof(struct log_record)-stamp_len, fmt, va_copied);
+            va_end (va_copied);
+            if (len<0)
+                return; // encoding error
+            if (sizeof(struct log_record)+stamp_len+len<avail && sizeof(struct log_record)+stamp_len+len<r->size/2)
+            {
+                memcpy (rec+1, stamp, stamp_len);
+                rec->fd1=s->fd1;
+                rec->fd2=s->fd2;
+                rec->len=stamp_len+len;
+                rec->size=(sizeof(struct log_record)+rec->len+LOG_RECORD_ALIGN-1) & ~(LOG_RECORD_ALIGN-1);
+                MY_STORE_RELEASE(&r->head, head+rec->size);
+                // the writer is woken up early if the ring is filling up
+                if (used+rec->size>=r->size/4 && MY_LOAD_ACQUIRE(&async.writer_idle))
+                {
+                    my_mutex_lock (&async.lock);
+                    my_cond_signal (&async.wake);
+                    my_mutex_unlock (&async.lock);
+                };
+                return;
+            };
+        }
+        else if (len<0)
+        {
+            va_copy (va_copied, va);
+            len=vsnprintf (NULL, 0, fmt, va_copied);
+            va_end (va_copied);
+            if (len<0)
+                return;
+        };
+        needed=(sizeof(struct log_record)+stamp_len+len+1+LOG_RECORD_ALIGN-1) & ~(LOG_RECORD_ALIGN-1);
+
+        if (needed>r->size/2)
+        {
+            // too big: written synchronously, after the messages before it
+            L_async_flush ();
+            write_fds_va (s, stamp_len ? stamp : NULL, fmt, va);
+            return;
+        };
+        if (needed>contiguous && room>=contiguous)
+        {
+            // the message will be at the beginning of ring, the rest of it is skipped
+            if (contiguous>=sizeof(struct log_record))
+            {
+                rec->fd1=rec->fd2=NULL;
+                rec->len=0;
+                rec->size=contiguous;
+            };
+            MY_STORE_RELEASE(&r->head, head+contiguous);
+            continue;
+        };
+        // the ring is full
+        if (async.overflow==L_ASYNC_DROP)
+        {
+            MY_STORE_RELEASE(&r->dropped, r->dropped+1);
+            return;
+        };
+        L_async_flush ();
+    };
+};
+
+void L_async_init (size_t ring_size, enum L_async_overflow overflow)
+{
+    static bool atexit_set=false;
+    size_t size=4096;
+
+    oassert (!async.on);
+    while (size<ring_size)
+        size*=2;
+    async.overflow=overflow;
+    async.ring_size=size;
+    async.rings=NULL;
+    async.stop=false;
+    async.writer_idle=0;
+    async.flush_requests=async.flushes_done=0;
+    async.written=async.dropped=0;
+    for (int i=0; i<LOG_BATCHES; i++)
+    {
+        async.batches[i].f=NULL;
+        async.batches[i].buf=DMALLOC(char, LOG_BATCH_SIZE, "log_batch");
+        async.batches[i].len=0;
+    };
+    my_tls_create (&async.key, ring_destructor);
+    my_mutex_init (&async.lock);
+    my_cond_init (&async.wake);
+    my_cond_init (&async.drained);
+    my_thread_create (&async.writer, writer_thread, NULL);
+    async.on=true;
+    if (!atexit_set)
+    {
+        atexit (L_async_deinit);
+        atexit_set=true;
+    };
+};
+
+void L_async_deinit (void)
+{
+    if (!async.on)
+        return;
+    my_mutex_lock (&async.lock);
+    async.stop=true;
+    my_cond_signal (&async.wake);
+    my_mutex_unlock (&async.lock);
+    my_thread_join (&async.writer);
+    async.on=false;
+
+    // before rings are freed: FlsFree() calls destructors
+    my_tls_delete (&async.key);
+    while (async.rings)
+    {
+        struct log_ring *r=async.rings;
+        async.rings=r->next;
+        free_ring (r);
+    };
+    for (int i=0; i<LOG_BATCHES; i++)
+        DFREE(async.batches[i].buf);
+    my_cond_deinit (&async.drained);
+    my_cond_deinit (&async.wake);
+    my_mutex_deinit (&async.lock);
+};
+
+void L_async_get_stats (octa *written, octa *dropped)
+{
+    if (!async.on)
+    {
+        *written=async.written;
+        *dropped=async.dropped;
+        return;
+    };
+    my_mutex_lock (&async.lock);
+    *written=async.written;
+    *dropped=async.dropped;
+    my_mutex_unlock (&async.lock);
+};
+
+// binary mode
+
+// stream layout (native byte order, records aren't aligned):
+//   header: "OCTOBLOG", tetra version, tetra reserved, octa wall time of L_binary_init() in microseconds since 1970
+//   'F' record: tetra id, tetra length, format string; written once, before the first message using it
+//   'M' record: tetra format id, tetra size of arguments, octa nanoseconds since L_binary_init(), arguments
+//   'T' record: tetra length, octa nanoseconds since L_binary_init(), text formatted as usual
+// arguments are stored as they are passed, strings are stored as tetra length and characters (0xFFFFFFFF for NULL)
+
+#define LOG_BINARY_MAGIC "OCTOBLOG"
+#define LOG_BINARY_VERSION 1
+// argument types a format string can have at most, including '*'
+#define LOG_MAX_ARGS 32
+#define LOG_FORMATS_BITS 12
+// messages with formats beyond this are written as text
+#define LOG_FORMATS_MAX ((1<<LOG_FORMATS_BITS)/4*3)
+#define LOG_NULL_STRING 0xFFFFFFFF
+// longer records are considered damaged by the decoder
+#define LOG_BINARY_RECORD_MAX (1U<<30)
+
+enum log_arg_type
+{
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_SIZE,
+    ARG_INTMAX,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_PTR,
+    ARG_STR,
+    // "%.*s": the string can be not terminated, at most the preceding int argument of bytes are read
+    ARG_STR_PREC
+};
+
+struct log_format
+{
+    // format string pointer, set last, when the rest is filled
+    size_t key;
+    tetra id;
+    // hash of the format text, to catch a buffer reused for another format
+    tetra check;
+    bool text_only; // there are conversions we can't store
+    byte args_total;
+    byte args[LOG_MAX_ARGS];
+};
+
+static struct
+{
+    FILE *f;
+    double start;
+    // open addressing, lookups are lock-free, insertions are done under lock
+    struct log_format *formats;
+    // formats_total slots are taken, ids_total of them were written in 'F' records
+    tetra formats_total, ids_total;
+    my_mutex lock;
+} binary;
+
+// parses a conversion specification, p is after '%'; returns pointer after it, or NULL if it's not supported;
+// types of arguments it takes are added to types[] ('*' takes int), "%%" takes none
+static const char *parse_conversion (const char *p, byte *types, byte *total)
+{
+    enum { M_NONE, M_H, M_L, M_LL, M_Z, M_J, M_T, M_LD } mod=M_NONE;
+    enum { P_NONE, P_LITERAL, P_ARG } prec=P_NONE;
+
+    if (*p=='%')
+        return p+1;
+    if (*total+3>LOG_MAX_ARGS)
+        return NULL;
+    while (*p && strchr ("-+ #0'", *p))
+        p++;
+    if (*p=='*')
+    {
+        types[(*total)++]=ARG_INT;
+        p++;
+    }
+    else
+        while (isdigit (*p))
+            p++;
+    if (*p=='.')
+    {
+        p++;
+        if (*p=='*')
+        {
+            types[(*total)++]=ARG_INT;
+            p++;
+            prec=P_ARG;
+        }
+        else
+        {
+            while (isdigit (*p))
+                p++;
+            prec=P_LITERAL;
+        };
+    };
+
+    switch (*p)
+    {
+        case 'h': p++; mod=M_H; if (*p=='h') p++; break;
+        case 'l': p++; mod=M_L; if (*p=='l') { p++; mod=M_LL; }; break;
+        case 'q': p++; mod=M_LL; break;
+        case 'L': p++; mod=M_LD; break;
+        case 'z': p++; mod=M_Z; break;
+        case 'j': p++; mod=M_J; break;
+        case 't': p++; mod=M_T; break;
+        // MSVC
+        case 'I':
+            p++;
+            if (p[0]=='6' && p[1]=='4')
+            {
+                p+=2;
+                mod=M_LL;
+            }
+            else if (p[0]=='3' && p[1]=='2')
+                p+=2;
+            else
+                mod=M_Z;
+            break;
+        default:
+            break;
+    };
+
+    switch (*p)
+    {
+        case 'c':
+            if (mod==M_L)
+                return NULL; // wint_t
+            // fall through
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            switch (mod)
+            {
+                case M_L: types[(*total)++]=ARG_LONG; break;
+                case M_LL: case M_LD: types[(*total)++]=ARG_LLONG; break;
+                case M_Z: types[(*total)++]=ARG_SIZE; break;
+                case M_J: types[(*total)++]=ARG_INTMAX; break;
+                case M_T: types[(*total)++]=ARG_PTRDIFF; break;
+                default: types[(*total)++]=ARG_INT; break;
+            };
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            types[(*total)++]=mod==M_LD ? ARG_LDOUBLE : ARG_DOUBLE;
+            break;
+        case 's':
+            if (mod==M_L)
+                return NULL; // wide string
+            // "%.10s" is used for buffers which may be not terminated, the limit isn't stored
+            if (prec==P_LITERAL)
+                return NULL;
+            types[(*total)++]=prec==P_ARG ? ARG_STR_PREC : ARG_STR;
+            break;
+        case 'p':
+            types[(*total)++]=ARG_PTR;
+            break;
+        default:
+            // %n and unknown ones
+            return NULL;
+    };
+    return p+1;
+};
+
+static void parse_format (const char *fmt, struct log_format *f)
+{
+    f->args_total=0;
+    f->text_only=false;
+    for (const char *p=fmt; *p; )
+    {
+        if (*p++!='%')
+            continue;
+        p=parse_conversion (p, f->args, &f->args_total);
+        if (p==NULL)
+        {
+            f->text_only=true;
+            return;
+        };
+    };
+};
+
+static size_t format_slot (const char *fmt)
+{
+    return (size_t)(((octa)(size_t)fmt*0x9E3779B97F4A7C15ULL)>>(64-LOG_FORMATS_BITS));
+};
+
+// FNV-1a
+static tetra format_check (const char *fmt)
+{
+    tetra h=2166136261U;
+
+    for (; *fmt; fmt++)
+        h=(h^(byte)*fmt)*16777619U;
+    return h;
+};
+
+static octa binary_timestamp (void)
+{
+    return (octa)((get_monotonic_time()-binary.start)*1e9);
+};
+
+// returns NULL if the table is full, or if fmt is at the address of another format seen before
+static struct log_format *get_format (const char *fmt)
+{
+    size_t mask=(1<<LOG_FORMATS_BITS)-1, i;
+    struct log_format *f;
+    byte hdr[1+4+4];
+    tetra len, check=format_check (fmt);
+
+    for (i=format_slot (fmt); ; i=(i+1)&mask)
+    {
+        size_t key=MY_LOAD_ACQUIRE(&binary.formats[i].key);
+        if (key==(size_t)fmt)
+            return binary.formats[i].check==check ? &binary.formats[i] : NULL;
+        if (key==0)
+            break;
+    };
+
+    my_mutex_lock (&binary.lock);
+    // other thread could add it by now
+    for (; ; i=(i+1)&mask)
+    {
+        f=&binary.formats[i];
+        if (f->key==(size_t)fmt || f->key==0)
+            break;
+    };
+    if (f->key==0)
+    {
+        if (binary.formats_total==LOG_FORMATS_MAX)
+        {
+            my_mutex_unlock (&binary.lock);
+            return NULL;
+        };
+        parse_format (fmt, f);
+        f->check=check;
+        binary.formats_total++;
+        if (!f->text_only)
+        {
+            f->id=binary.ids_total++;
+            len=strlen (fmt);
+            hdr[0]='F';
+            memcpy (hdr+1, &f->id, 4);
+            memcpy (hdr+5, &len, 4);
+            // one fwrite() call, messages of other threads (with known formats) are written without the lock
+            byte *rec=DMALLOC(byte, sizeof(hdr)+len, "log record");
+            memcpy (rec, hdr, sizeof(hdr));
+            memcpy (rec+sizeof(hdr), fmt, len);
+            fwrite (rec, sizeof(hdr)+len, 1, binary.f);
+            DFREE(rec);
+        };
+        MY_STORE_RELEASE(&f->key, (size_t)fmt);
+    }
+    else if (f->check!=check)
+        f=NULL;
+    my_mutex_unlock (&binary.lock);
+    return f;
+};
+
+// a record is built here, on stack if it fits
+struct log_rec_buf
+{
+    byte *buf;
+    size_t len, allocated;
+};
+
+static void rec_reserve (struct log_rec_buf *b, byte *on_stack, size_t more)
+{
+    if (b->len+more<=b->allocated)
+        return;
+    b->allocated=(b->len+more)*2;
+    if (b->buf==on_stack)
+    {
+        b->buf=DMALLOC(byte, b->allocated, "log record");
+        memcpy (b->buf, on_stack, b->len);
+    }
+    else
+        b->buf=DREALLOC(b->buf, byte, b->allocated, "log record");
+};
+
+#define REC_ADD(b, on_stack, type, v) \
+    do { type _v=(v); rec_reserve ((b), (on_stack), sizeof(type)); memcpy ((b)->buf+(b)->len, &_v, sizeof(type)); (b)->len+=sizeof(type); } while (0)
+
+static void binary_text_va (octa ts, const char *fmt, va_list va)
+{
+    strbuf sb=STRBUF_INIT;
+    byte hdr[1+4+8];
+    tetra len;
+
+    strbuf_vaddf (&sb, fmt, va);
+    len=sb.strlen;
+    hdr[0]='T';
+    memcpy (hdr+1, &len, 4);
+    memcpy (hdr+5, &ts, 8);
+    // the record is written by one fwrite() call, so it's not interleaved with others
+    byte *rec=DMALLOC(byte, sizeof(hdr)+len, "log record");
+    memcpy (rec, hdr, sizeof(hdr));
+    memcpy (rec+sizeof(hdr), sb.buf, len);
+    fwrite (rec, sizeof(hdr)+len, 1, binary.f);
+    DFREE(rec);
+    strbuf_deinit (&sb);
+};
+
+static void binary_va (const char *fmt, va_list va)
+{
+    byte on_stack[512];
+    struct log_rec_buf b={ on_stack, 1+4+4+8, sizeof(on_stack) };
+    struct log_format *f=get_format (fmt);
+    octa ts=binary_timestamp ();
+    tetra args_size;
+    int last_int=-1; // precision of "%.*s"
+
+    if (f==NULL || f->text_only)
+    {
+        binary_text_va (ts, fmt, va);
+        return;
+    };
+
+    for (int i=0; i<f->args_total; i++)
+        switch (f->args[i])
+        {
+            case ARG_INT: last_int=va_arg (va, int); REC_ADD(&b, on_stack, int, last_int); break;
+            case ARG_LONG: REC_ADD(&b, on_stack, long, va_arg (va, long)); break;
+            case ARG_LLONG: REC_ADD(&b, on_stack, long long, va_arg (va, long long)); break;
+            case ARG_SIZE: REC_ADD(&b, on_stack, size_t, va_arg (va, size_t)); break;
+            case ARG_INTMAX: REC_ADD(&b, on_stack, intmax_t, va_arg (va, intmax_t)); break;
+            case ARG_PTRDIFF: REC_ADD(&b, on_stack, ptrdiff_t, va_arg (va, ptrdiff_t)); break;
+            case ARG_DOUBLE: REC_ADD(&b, on_stack, double, va_arg (va, double)); break;
+            case ARG_LDOUBLE: REC_ADD(&b, on_stack, long double, va_arg (va, long double)); break;
+            case ARG_PTR: REC_ADD(&b, on_stack, void*, va_arg (va, void*)); break;
+            case ARG_STR:
+            case ARG_STR_PREC:
+                {
+                    const char *s=va_arg (va, const char*);
+                    // negative precision is as if it's omitted
+                    bool limited=f->args[i]==ARG_STR_PREC && last_int>=0;
+                    tetra len=s==NULL ? LOG_NULL_STRING : limited ? strnlen (s, last_int) : strlen (s);
+                    REC_ADD(&b, on_stack, tetra, len);
+                    if (s)
+                    {
+                        rec_reserve (&b, on_stack, len);
+                        memcpy (b.buf+b.len, s, len);
+                        b.len+=len;
+                    };
+                };
+                break;
+            default:
+                oassert(0);
+        };
+
+    args_size=b.len-(1+4+4+8);
+    b.buf[0]='M';
+    memcpy (b.buf+1, &f->id, 4);
+    memcpy (b.buf+5, &args_size, 4);
+    memcpy (b.buf+9, &ts, 8);
+    fwrite (b.buf, b.len, 1, binary.f);
+    if (b.buf!=on_stack)
+        DFREE(b.buf);
+};
+
+void L_binary_init (const char *fname)
+{
+    tetra version=LOG_BINARY_VERSION, reserved=0;
+    octa wall;
+
+    oassert (binary.f==NULL);
+    oassert (!async.on);
+    binary.f=fopen (fname, "wb");
+    if (binary.f==NULL)
+        die ("Can't create %s for writing.\n", fname);
+    setvbuf (binary.f, NULL, _IOFBF, LOG_BATCH_SIZE);
+    binary.formats=DCALLOC(struct log_format, 1<<LOG_FORMATS_BITS, "log_format");
+    binary.formats_total=0;
+    binary.ids_total=0;
+    my_mutex_init (&binary.lock);
+
+    binary.start=get_monotonic_time();
+    wall=wall_time_us();
+    fwrite (LOG_BINARY_MAGIC, 8, 1, binary.f);
+    fwrite (&version, 4, 1, binary.f);
+    fwrite (&reserved, 4, 1, binary.f);
+    fwrite (&wall, 8, 1, binary.f);
+};
+
+void L_binary_deinit (void)
+{
+    if (binary.f==NULL)
+        return;
+    if (fclose (binary.f))
+        die ("%s(): write error\n", __FUNCTION__);
+    binary.f=NULL;
+    DFREE(binary.formats);
+    my_mutex_deinit (&binary.lock);
+};
+
+// decoding
+
+// the conversion is copied to spec with '*' replaced by arguments
+static bool decode_conversion (FILE *out, const char *conv, size_t conv_len, const byte *types, byte types_total,
+        const byte **args, const byte *args_end)
+{
+    char spec[64];
+    size_t len=0;
+    byte t=0;
+
+    if (conv_len>=sizeof(spec)-24)
+        return false;
+#define ARG_GET(type, v) \
+    do { if (*args+sizeof(type)>args_end) return false; memcpy (&(v), *args, sizeof(type)); *args+=sizeof(type); } while (0)
+
+    for (size_t i=0; i<conv_len; i++)
+    {
+        if (conv[i]!='*')
+        {
+            spec[len++]=conv[i];
+            continue;
+        };
+        int v;
+        ARG_GET(int, v);
+        t++;
+        // negative precision is as if it's omitted
+        if (v<0 && len>0 && spec[len-1]=='.')
+            len--;
+        else
+            len+=sprintf (spec+len, "%d", v);
+    };
+    spec[len]=0;
+    if (t==types_total)
+    {
+        // %%
+        fputs (spec+1, out);
+        return true;
+    };
+
+    switch (types[t])
+    {
+        case ARG_INT: { int v; ARG_GET(int, v); fprintf (out, spec, v); break; };
+        case ARG_LONG: { long v; ARG_GET(long, v); fprintf (out, spec, v); break; };
+        case ARG_LLONG: { long long v; ARG_GET(long long, v); fprintf (out, spec, v); break; };
+        case ARG_SIZE: { size_t v; ARG_GET(size_t, v); fprintf (out, spec, v); break; };
+        case ARG_INTMAX: { intmax_t v; ARG_GET(intmax_t, v); fprintf (out, spec, v); break; };
+        case ARG_PTRDIFF: { ptrdiff_t v; ARG_GET(ptrdiff_t, v); fprintf (out, spec, v); break; };
+        case ARG_DOUBLE: { double v; ARG_GET(double, v); fprintf (out, spec, v); break; };
+        case ARG_LDOUBLE: { long double v; ARG_GET(long double, v); fprintf (out, spec, v); break; };
+        case ARG_PTR: { void *v; ARG_GET(void*, v); fprintf (out, spec, v); break; };
+        case ARG_STR:
+        case ARG_STR_PREC:
+            {
+                tetra slen;
+                char *s;
+                ARG_GET(tetra, slen);
+                if (slen==LOG_NULL_STRING)
+                {
+                    fprintf (out, spec, NULL);
+                    break;
+                };
+                if (slen>(size_t)(args_end-*args))
+                    return false;
+                s=DMALLOC(char, slen+1, "string");
+                memcpy (s, *args, slen);
+                s[slen]=0;
+                *args+=slen;
+                fprintf (out, spec, s);
+                DFREE(s);
+            };
+            break;
+        default:
+            return false;
+    };
+#undef ARG_GET
+    return true;
+};
+
+static bool decode_message (FILE *out, const char *fmt, const byte *args, const byte *args_end)
+{
+    byte types[LOG_MAX_ARGS];
+
+    for (const char *p=fmt; *p; )
+    {
+        const char *conv=p;
+        byte total=0;
+
+        if (*p!='%')
+        {
+            p=strchr (p, '%');
+            if (p==NULL)
+                p=conv+strlen (conv);
+            fwrite (conv, p-conv, 1, out);
+            continue;
+        };
+        p=parse_conversion (p+1, types, &total);
+        if (p==NULL || decode_conversion (out, conv, p-conv, types, total, &args, args_end)==false)
+            return false;
+    };
+    return args==args_end;
+};
+
+static void decode_timestamp (FILE *out, octa wall_start, octa ns)
+{
+    octa us=wall_start+ns/1000;
+    time_t t=us/1000000;
+    struct tm *tm=localtime (&t);
+    char buf[32];
+
+    strftime (buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", tm);
+    fprintf (out, "[%s:%03d] ", buf, (int)(us/1000%1000));
+};
+
+static bool read_exactly (FILE *in, void *buf, size_t size)
+{
+    return size==0 || fread (buf, size, 1, in)==1;
+};
+
+bool L_binary_decode (FILE *in, FILE *out, bool timestamps)
+{
+    char magic[8];
+    tetra version, reserved, id, len;
+    octa wall_start, ts;
+    char **formats=NULL;
+    size_t formats_total=0;
+    byte *buf=NULL;
+    bool rt=false, line_start=true;
+    int tag;
+
+    if (!read_exactly (in, magic, 8) || memcmp (magic, LOG_BINARY_MAGIC, 8) || !read_exactly (in, &version, 4) ||
+            version!=LOG_BINARY_VERSION || !read_exactly (in, &reserved, 4) || !read_exactly (in, &wall_start, 8))
+        return false;
+
+    while ((tag=fgetc (in))!=EOF)
+    {
+        switch (tag)
+        {
+            case 'F':
+                if (!read_exactly (in, &id, 4) || !read_exactly (in, &len, 4) || id!=formats_total ||
+                        len>LOG_BINARY_RECORD_MAX)
+                    goto exit;
+                formats=DREALLOC(formats, char*, formats_total+1, "formats");
+                formats[formats_total]=DMALLOC(char, (size_t)len+1, "format");
+                formats[formats_total][len]=0;
+                if (!read_exactly (in, formats[formats_total++], len))
+                    goto exit;
+                break;
+
+            case 'M':
+            case 'T':
+                if (tag=='M' && (!read_exactly (in, &id, 4) || id>=formats_total))
+                    goto exit;
+                if (!read_exactly (in, &len, 4) || !read_exactly (in, &ts, 8) || len>LOG_BINARY_RECORD_MAX)
+                    goto exit;
+                buf=DREALLOC(buf, byte, (size_t)len+1, "args");
+                if (!read_exactly (in, buf, len))
+                    goto exit;
+                if (timestamps && line_start)
+                    decode_timestamp (out, wall_start, ts);
+                if (tag=='M')
+                {
+                    const char *fmt=formats[id];
+                    size_t fmt_len=strlen (fmt);
+                    if (!decode_message (out, fmt, buf, buf+len))
+                        goto exit;
+                    line_start=fmt_len>0 && fmt[fmt_len-1]=='\n';
+                }
+                else
+                {
+                    fwrite (buf, len, 1, out);
+                    line_start=len>0 && buf[len-1]=='\n';
+                };
+                break;
+
+            default:
+                goto exit;
+        };
+    };
+    rt=true;
+
+exit:
+    for (size_t i=0; i<formats_total; i++)
+        DFREE(formats[i]);
+    DFREE(formats);
+    DFREE(buf);
+    return rt;
+};
+
+// synchronous mode
+
+void L_va (const char * fmt, va_list va)
+{
+    L_fds_va(&cur_fds, fmt, va);
+};
+
+static void write_fds_va (fds *s, const char *stamp, const char * fmt, va_list va)
+{
     // we need this voodoo: http://stackoverflow.com/questions/15923210/is-it-possible-to-use-va-list-method-twice-in-a-function
     va_list va_copied;
     va_copy (va_copied, va);
 
     if (s->fd1)
+    {
+        if (stamp)
+            fputs (stamp, s->fd1);
         vfprintf (s->fd1, fmt, va);
+    };
 
     if (s->fd2)
+    {
+        if (stamp)
+            fputs (stamp, s->fd2);
         vfprintf (s->fd2, fmt, va_copied);
+    };
+    va_end (va_copied);
+};
+
+void L_fds_va (fds *s, const char * fmt, va_list va)
+{
+    static bool last_char_was_CR_or_unknown=true;
+    char stamp[64];
+    bool stamped=false;
+    size_t fmt_len;
+
+    if (binary.f)
+    {
+        binary_va (fmt, va);
+        return;
+    };
+
+    if (async.on)
+    {
+        async_fds_va (s, fmt, va);
+        return;
+    };
+
+    if (L_timestamp && last_char_was_CR_or_unknown)
+    {
+        format_timestamp (stamp, sizeof(stamp));
+        stamped=true;
+    };
+
+    fmt_len=strlen(fmt);
+    last_char_was_CR_or_unknown=fmt_len>0 && fmt[fmt_len-1]=='\n';
+
+    write_fds_va (s, stamped ? stamp : NULL, fmt, va);
 };
 
 void L (const char * fmt, ...)
@@ -138,35 +1298,142 @@ void L_fds_strbuf (fds *s, strbuf *sb)
     L_fds (s, "%s", sb->buf);
 };
 
-void L_once_va (const char * fmt, va_list va)
+// L_once(): messages (or call sites) seen are kept as 64-bit hashes in open addressing set,
+// along with a copy of the format string and number of repeats suppressed, for the summary;
+// the set has a limit, messages beyond it are printed, but not tracked
+
+#define L_ONCE_DEFAULT_LIMIT 16384
+// longer formats are truncated in the copy
+#define L_ONCE_FMT_MAX 128
+// the summary lists this number of most repeated messages
+#define L_ONCE_SUMMARY_MAX 16
+
+struct once_entry
 {
-    strbuf sb=STRBUF_INIT;
-    void *found;
-    char *s;
+    octa hash; // 0 is empty slot
+    char *fmt; // owned copy
+    // if keyed by call site:
+    const char *file;
+    int line;
+    octa suppressed;
+};
+
+static struct
+{
+    my_mutex lock;
+    struct once_entry *entries;
+    size_t total, allocated; // allocated is power of 2
+    size_t limit;
+    octa suppressed, untracked;
+} once={ MY_MUTEX_INITIALIZER, NULL, 0, 0, L_ONCE_DEFAULT_LIMIT, 0, 0 };
 
-    if (once_was_printed==NULL)
-        once_was_printed=rbtree_create(true, "rbtree: once_was_printed", (int (*)(void*,void*))strcmp);
+// both hashes are never 0
+
+static octa once_hash_mix (octa h)
+{
+    h^=h>>33;
+    h*=0xFF51AFD7ED558CCDULL;
+    h^=h>>33;
+    h*=0xC4CEB9FE1A85EC53ULL;
+    h^=h>>33;
+    return h ? h : 1;
+};
 
-    strbuf_vaddf(&sb, fmt, va);
-    
-    //printf (__func__"() sb=");
-    //strbuf_puts (&sb);
-    
-    found=rbtree_lookup(once_was_printed, sb.buf);
-    //printf ("found=0x%p\n", found);
+// FNV-1a
+static octa once_hash_string (const char *s, size_t len)
+{
+    octa h=0xCBF29CE484222325ULL;
 
-    if (found)
+    for (size_t i=0; i<len; i++)
     {
-        strbuf_deinit(&sb);
-        return;
+        h^=(byte)s[i];
+        h*=0x100000001B3ULL;
     };
+    return once_hash_mix (h);
+};
 
-    L_va (fmt, va);
+static octa once_hash_site (const char *file, int line)
+{
+    return once_hash_mix ((octa)(size_t)file*0x9E3779B97F4A7C15ULL + (tetra)line);
+};
+
+static void once_insert (struct once_entry *entries, size_t mask, struct once_entry *e)
+{
+    size_t i;
+
+    for (i=e->hash & mask; entries[i].hash; i=(i+1) & mask);
+    entries[i]=*e;
+};
+
+static void once_grow (void)
+{
+    size_t allocated=once.allocated ? once.allocated*2 : 64;
+    struct once_entry *entries=DCALLOC(struct once_entry, allocated, "once_entry");
+
+    for (size_t i=0; i<once.allocated; i++)
+        if (once.entries[i].hash)
+            once_insert (entries, allocated-1, &once.entries[i]);
+    DFREE(once.entries);
+    once.entries=entries;
+    once.allocated=allocated;
+};
+
+// returns true if the message is to be printed
+static bool once_check (octa hash, const char *fmt, const char *file, int line)
+{
+    struct once_entry e={ hash, NULL, file, line, 0 };
+    size_t i;
+
+    my_mutex_lock (&once.lock);
+    if (once.allocated)
+        for (i=hash & (once.allocated-1); once.entries[i].hash; i=(i+1) & (once.allocated-1))
+            if (once.entries[i].hash==hash)
+            {
+                once.entries[i].suppressed++;
+                once.suppressed++;
+                my_mutex_unlock (&once.lock);
+                return false;
+            };
+    if (once.total>=once.limit)
+        once.untracked++;
+    else
+    {
+        // load factor is kept below 1/2
+        if ((once.total+1)*2>once.allocated)
+            once_grow ();
+        // the caller's format may not outlive this call, it's needed until the summary
+        e.fmt=DSTRNDUP((char*)fmt, strnlen (fmt, L_ONCE_FMT_MAX), "once_entry fmt");
+        once_insert (once.entries, once.allocated-1, &e);
+        once.total++;
+    };
+    my_mutex_unlock (&once.lock);
+    return true;
+};
 
-    s=DSTRDUP(sb.buf, "L_once_va()");
-    //printf ("s=%s\n", s);
-    rbtree_insert (once_was_printed, s, "FIXME"); // here will be 'set' someday
-    strbuf_deinit(&sb);
+void L_once_va (const char * fmt, va_list va)
+{
+    char local[256], *s=local;
+    va_list va_copied;
+    int len;
+    octa hash;
+
+    va_copy (va_copied, va);
+    len=vsnprintf (local, sizeof(local), fmt, va_copied);
+    va_end (va_copied);
+    oassert (len>=0);
+    if ((size_t)len>=sizeof(local))
+    {
+        s=DMALLOC(char, len+1, "L_once_va()");
+        va_copy (va_copied, va);
+        vsnprintf (s, len+1, fmt, va_copied);
+        va_end (va_copied);
+    };
+    hash=once_hash_string (s, len);
+    if (s!=local)
+        DFREE(s);
+
+    if (once_check (hash, fmt, NULL, 0))
+        L_va (fmt, va);
 };
 
 void L_once (const char * fmt, ...)
@@ -175,93 +1442,244 @@ void L_once (const char * fmt, ...)
     va_start (va, fmt);
 
     L_once_va (fmt, va);
+    va_end (va);
 };
 
-void L_print_buf_ofs_fds (fds *s, byte *buf, size_t size, size_t ofs)
+void L_once_site (const char *file, int line, const char * fmt, ...)
+{
+    va_list va;
+
+    if (!once_check (once_hash_site (file, line), fmt, file, line))
+        return;
+    va_start (va, fmt);
+    L_va (fmt, va);
+    va_end (va);
+};
+
+void L_once_set_limit (size_t limit)
+{
+    my_mutex_lock (&once.lock);
+    once.limit=limit;
+    my_mutex_unlock (&once.lock);
+};
+
+void L_once_get_stats (size_t *tracked, octa *suppressed, octa *untracked)
+{
+    my_mutex_lock (&once.lock);
+    *tracked=once.total;
+    *suppressed=once.suppressed;
+    *untracked=once.untracked;
+    my_mutex_unlock (&once.lock);
+};
+
+// the most repeated first; the order of equally repeated is stable from run to run
+static int once_cmp_entries (const void *l, const void *r)
 {
-    size_t pos=0;
-    unsigned starting_offset=0;
-    unsigned i;
+    const struct once_entry *a=*(const struct once_entry**)l, *b=*(const struct once_entry**)r;
+    int rt;
 
-    while (size-pos)
+    if (a->suppressed!=b->suppressed)
+        return a->suppressed>b->suppressed ? -1 : 1;
+    if ((a->file==NULL)!=(b->file==NULL))
+        return a->file==NULL ? -1 : 1;
+    if (a->file)
     {
-        size_t wpn;
-        if ((size-pos)>16)
-            wpn=16;
-        else
-            wpn=size-pos;
+        rt=strcmp (a->file, b->file);
+        return rt ? rt : a->line-b->line;
+    };
+    rt=strcmp (a->fmt, b->fmt);
+    if (rt)
+        return rt;
+    return a->hash<b->hash ? -1 : a->hash>b->hash;
+};
+
+static void once_summary (void)
+{
+    struct once_entry **repeated;
+    size_t repeated_total=0;
+
+    if (once.suppressed==0 && once.untracked==0)
+        return;
+    L ("L_once(): " PRI_OCTA_DEC " repeats suppressed", once.suppressed);
+    if (once.untracked)
+        L (", " PRI_OCTA_DEC " messages not tracked (limit " PRI_SIZE_T_DEC ")", once.untracked, once.limit);
+    L ("\n");
 
-        if (L_ofs_width==64)
-            L_fds (s, PRI_OCTA_HEX_PAD ": ", starting_offset + pos + ofs);
-        else if (L_ofs_width==32)
-            L_fds (s, PRI_TETRA_HEX_PAD ": ", starting_offset + pos + ofs);
+    repeated=DMALLOC(struct once_entry*, once.total, "once_entry*");
+    for (size_t i=0; i<once.allocated; i++)
+        if (once.entries[i].suppressed)
+            repeated[repeated_total++]=&once.entries[i];
+    if (repeated_total>1)
+        qsort (repeated, repeated_total, sizeof(struct once_entry*), once_cmp_entries);
+    for (size_t i=0; i<repeated_total && i<L_ONCE_SUMMARY_MAX; i++)
+    {
+        struct once_entry *e=repeated[i];
+        strbuf sb=STRBUF_INIT;
+        char count[24];
+
+        // PRI_OCTA_DEC has '%' in it, so the count is padded as a string
+        snprintf (count, sizeof(count), PRI_OCTA_DEC, e->suppressed);
+        if (e->file)
+            L ("%10s  %s:%d: ", count, e->file, e->line);
         else
-            oassert(!"incorrect L_ofs_width");
-        
-        for (i=0; i<wpn; i++)
-            L_fds (s, "%02X%c", buf[pos+i], (i==7) ? '-' : ' ');
+            L ("%10s  ", count);
+        strbuf_cvt_to_C_string (e->fmt, &sb, false);
+        L ("\"%s\"\n", sb.buf);
+        strbuf_deinit (&sb);
+    };
+    if (repeated_total>L_ONCE_SUMMARY_MAX)
+        L ("... and " PRI_SIZE_T_DEC " more\n", repeated_total-L_ONCE_SUMMARY_MAX);
+    DFREE(repeated);
+};
 
-        if (wpn<16)
-            for (i=0; i<16-wpn; i++)
-                L_fds (s, "   ");
+static void once_deinit (void)
+{
+    for (size_t i=0; i<once.allocated; i++)
+        if (once.entries[i].hash)
+            DFREE(once.entries[i].fmt);
+    DFREE(once.entries);
+    once.entries=NULL;
+    once.total=once.allocated=0;
+    once.suppressed=once.untracked=0;
+};
 
-        L_fds (s, "\"");
+// hexdumps: each row is rendered into a buffer and written by one L_fds() call
 
-        for (i=0; i<wpn; i++)
-            L_fds (s, "%c", isprint (buf[pos+i]) ? buf[pos+i] : '.');
+enum row_style
+{
+    ROW_HEX,
+    ROW_C,
+    ROW_DIFF // only changed bytes are shown
+};
 
-        if (wpn<16)
-            for (i=0; i<16-wpn; i++)
-                L_fds (s, " ");
+// enough for 16-digit offset and 16 bytes in C style
+#define ROW_MAX 160
 
-        L_fds (s, "\"\n");
+static const char hex_upper[]="0123456789ABCDEF";
+static const char hex_lower[]="0123456789abcdef";
 
-        pos+=wpn;
+static char *render_offset (char *p, size_t ofs)
+{
+    int digits;
+
+    if (L_ofs_width==64)
+        digits=16;
+    else if (L_ofs_width==32)
+    {
+        digits=8;
+        ofs=(tetra)ofs;
+    }
+    else
+    {
+        oassert(!"incorrect L_ofs_width");
+        fatal_error();
     };
+    for (int i=digits-1; i>=0; i--, ofs>>=4)
+        p[i]=hex_lower[ofs & 0xF];
+    return p+digits;
 };
 
-// in C/C++ format
-void L_print_buf_ofs_fds_C (fds *s, byte *buf, size_t size, size_t ofs)
+// as isprint() in C locale
+static char printable (byte b)
 {
-    size_t pos=0;
-    unsigned starting_offset=0;
-    unsigned i;
+    return b>=0x20 && b<0x7F ? b : '.';
+};
+
+// the row is terminated by zero, without newline; old is for ROW_DIFF only,
+// last is true if the row is the last one of buffer
+static void render_row (char *out, enum row_style style, const byte *p, const byte *old, size_t wpn, size_t ofs, bool last)
+{
+    char *o=out;
+    size_t i;
 
-    while (size-pos)
+    if (style==ROW_C)
     {
-        size_t wpn;
-        if ((size-pos)>16)
-            wpn=16;
-        else
-            wpn=size-pos;
+        *o++='/';
+        *o++='*';
+        o=render_offset (o, ofs);
+        *o++='*';
+        *o++='/';
+    }
+    else
+    {
+        o=render_offset (o, ofs);
+        *o++=':';
+    };
+    *o++=' ';
 
-        if (L_ofs_width==64)
-            L_fds (s, "/*" PRI_OCTA_HEX_PAD "*/ ", starting_offset + pos + ofs);
-        else if (L_ofs_width==32)
-            L_fds (s, "/*" PRI_TETRA_HEX_PAD "*/ ", starting_offset + pos + ofs);
+    for (i=0; i<wpn; i++)
+    {
+        byte b=p[i];
+        if (style==ROW_C)
+        {
+            *o++='0';
+            *o++='x';
+        };
+        if (style==ROW_DIFF && b==old[i])
+        {
+            *o++=' ';
+            *o++=' ';
+        }
         else
-            oassert(!"incorrect L_ofs_width");
-        
-        for (i=0; i<wpn; i++)
-            L_fds (s, "0x%02X%c ", buf[pos+i], (pos+i+1)==size ? ' ' : ',');
-
-        if (wpn<16)
-            for (i=0; i<16-wpn; i++)
-                L_fds (s, "   ");
+        {
+            *o++=hex_upper[b>>4];
+            *o++=hex_upper[b & 0xF];
+        };
+        if (style==ROW_C)
+        {
+            *o++=last && i==wpn-1 ? ' ' : ',';
+            *o++=' ';
+        }
+        else
+            *o++=i==7 ? '-' : ' ';
+    };
+    // padding is of hex rows width in all styles
+    memset (o, ' ', (16-wpn)*3);
+    o+=(16-wpn)*3;
 
-        L_fds (s, "/*");
+    if (style==ROW_C)
+    {
+        *o++='/';
+        *o++='*';
+    }
+    else
+        *o++='"';
+    for (i=0; i<wpn; i++)
+        *o++=style==ROW_DIFF && p[i]==old[i] ? ' ' : printable (p[i]);
+    memset (o, ' ', 16-wpn);
+    o+=16-wpn;
+    if (style==ROW_C)
+    {
+        *o++='*';
+        *o++='/';
+    }
+    else
+        *o++='"';
+    *o=0;
+    oassert (o-out<ROW_MAX);
+};
 
-        for (i=0; i<wpn; i++)
-            L_fds (s, "%c", isprint (buf[pos+i]) ? buf[pos+i] : '.');
+static void print_rows (fds *s, enum row_style style, byte *buf, size_t size, size_t ofs)
+{
+    char row[ROW_MAX];
 
-        if (wpn<16)
-            for (i=0; i<16-wpn; i++)
-                L_fds (s, " ");
+    for (size_t pos=0; pos<size; pos+=16)
+    {
+        size_t wpn=size-pos>16 ? 16 : size-pos;
+        render_row (row, style, buf+pos, NULL, wpn, pos+ofs, pos+wpn==size);
+        L_fds (s, "%s\n", row);
+    };
+};
 
-        L_fds (s, "*/\n");
+void L_print_buf_ofs_fds (fds *s, byte *buf, size_t size, size_t ofs)
+{
+    print_rows (s, ROW_HEX, buf, size, ofs);
+};
 
-        pos+=wpn;
-    };
+// in C/C++ format
+void L_print_buf_ofs_fds_C (fds *s, byte *buf, size_t size, size_t ofs)
+{
+    print_rows (s, ROW_C, buf, size, ofs);
 };
 
 void L_print_buf_ofs (byte *buf, size_t size, size_t ofs)
@@ -280,69 +1698,49 @@ void L_print_buf_ofs_C (byte *buf, size_t size, size_t ofs)
     L_print_buf_ofs_fds_C (&cur_fds, buf, size, ofs);
 };
 
-void L_print_bufs_diff (byte *buf1, byte *buf2, size_t size)
+// returns position of the first difference at or after pos, or size if there are none;
+// compares by 8 bytes
+static size_t first_difference (const byte *buf1, const byte *buf2, size_t pos, size_t size)
 {
-    size_t pos=0;
-    unsigned starting_offset=0;
-    unsigned i;
-    bool dots_printed=false;
+    octa a, b;
 
-    while (size-pos)
+    for (; pos+8<=size; pos+=8)
     {
-        size_t wpn;
-        if ((size-pos)>16)
-            wpn=16;
-        else
-            wpn=size-pos;
-
-        if (memcmp (buf1+pos, buf2+pos, wpn)!=0) // any changes in the whole line?
-        {
-            if (L_ofs_width==64)
-                L (PRI_OCTA_HEX_PAD ": ", starting_offset + pos);
-            else if (L_ofs_width==32)
-                L (PRI_TETRA_HEX_PAD ": ", starting_offset + pos);
-            else
-                oassert(!"incorrect L_ofs_width");
-            
-            for (i=0; i<wpn; i++)
-            {
-                if (buf1[pos+i]!=buf2[pos+i])
-                    L ("%02X", buf2[pos+i]);
-                else
-                    L ("  ");
-                
-                L ("%c", (i==7) ? '-' : ' ');
-            };
-
-            if (wpn<16)
-                for (i=0; i<16-wpn; i++)
-                    L ("   ");
-
-            L ("\"");
-
-            for (i=0; i<wpn; i++)
-            {
-                if (buf1[pos+i]!=buf2[pos+i])
-                    L ("%c", isprint (buf2[pos+i]) ? buf2[pos+i] : '.');
-                else
-                    L (" ");
-            };
+        memcpy (&a, buf1+pos, 8);
+        memcpy (&b, buf2+pos, 8);
+        if (a!=b)
+            break;
+    };
+    for (; pos<size; pos++)
+        if (buf1[pos]!=buf2[pos])
+            break;
+    return pos;
+};
 
-            if (wpn<16)
-                for (i=0; i<16-wpn; i++)
-                    L (" ");
+void L_print_bufs_diff (byte *buf1, byte *buf2, size_t size)
+{
+    char row[ROW_MAX];
+    size_t pos=0, diff;
 
-            L ("\"\n");
-            dots_printed=false;
-        }
-        else
+    while (pos<size)
+    {
+        // identical rows are shown as a single " ... " line
+        diff=first_difference (buf1, buf2, pos, size);
+        if (diff==size)
         {
-            if (dots_printed==false)
-            {
-                L (" ... \n");
-                dots_printed=true;
-            };
+            L (" ... \n");
+            break;
         };
+        diff&=~(size_t)15;
+        if (diff>pos)
+        {
+            L (" ... \n");
+            pos=diff;
+        };
+
+        size_t wpn=size-pos>16 ? 16 : size-pos;
+        render_row (row, ROW_DIFF, buf2+pos, buf1+pos, wpn, pos, pos+wpn==size);
+        L ("%s\n", row);
         pos+=wpn;
     };
 };
@@ -39,12 +39,23 @@ typedef struct _fds
 // taken from z3\src\util\util.h
 //#define IF_VERBOSE(LVL, CODE) { if (L_verbose_level >= LVL) { CODE } } ((void) 0)
 
+// if set, each line is prefixed with local date and time, as "[2016-01-02 12:34:56:789] ", see L_set_timestamp_mode()
 extern bool L_timestamp;
 extern fds cur_fds;
 extern int L_ofs_width;
 
 //string gen_timestamp();
 void L_init (const char* fname);
+
+enum L_timestamp_mode
+{
+    L_TIMESTAMP_MS, // default
+    L_TIMESTAMP_US, // microseconds instead of milliseconds, "[2016-01-02 12:34:56:789012] "
+    L_TIMESTAMP_TSC // CPU cycles since this call, for latency analysis; nanoseconds on non-x86
+};
+
+// the clock is (re)started here, or at the first timestamp
+void L_set_timestamp_mode (enum L_timestamp_mode mode);
 void L_init_stdout_only ();
 //void L (int level, const char * fmt, ...);
 void L_va (const char * fmt, va_list va);
@@ -54,8 +65,17 @@ void L_fds (fds *s, const char * fmt, ...);
 void L_fds_strbuf (fds *s, strbuf *sb);
 //void L (int level, string s);
 //void L (string s);
+// L_once(): a message is printed only the first time, messages are compared by 64-bit hash of the text;
+// L_ONCE_SITE(): only the first call from this line is printed, the message isn't even formatted after that
+// repeats are counted and the most repeated messages are listed at L_deinit()
+// the number of messages tracked is limited (L_once_set_limit()), messages beyond it are always printed;
+// a copy of the format (first 128 characters) is kept for the summary, so it may be built in a buffer
 void L_once_va (const char * fmt, va_list va);
 void L_once (const char * fmt, ...);
+void L_once_site (const char *file, int line, const char * fmt, ...);
+#define L_ONCE_SITE(...) L_once_site (__FILE__, __LINE__, __VA_ARGS__)
+void L_once_set_limit (size_t limit);
+void L_once_get_stats (size_t *tracked, octa *suppressed, octa *untracked);
 void L_print_buf_ofs_fds (fds *s, byte *buf, size_t size, size_t ofs);
 void L_print_buf_ofs (byte *buf, size_t size, size_t ofs);
 void L_print_buf (byte *buf, size_t size);
@@ -67,6 +87,39 @@ void L_print_buf_ofs_C (byte *buf, size_t size, size_t ofs);
 void L_print_bufs_diff (byte *buf1, byte *buf2, size_t size);
 void L_deinit (void);
 
+// asynchronous mode: callers format messages into per-thread rings, a writer thread writes them
+// in large batches; the order of messages is kept within a thread, messages of different threads
+// are interleaved
+// memory is bounded: a ring of ring_size bytes per thread, it's freed after the thread exits
+// if a ring is full, the caller waits for the writer (L_ASYNC_BLOCK) or the message is dropped
+// (L_ASYNC_DROP, the number of dropped messages is logged then);
+// messages not fitting into half of a ring are written synchronously, after the ring is drained
+enum L_async_overflow
+{
+    L_ASYNC_BLOCK,
+    L_ASYNC_DROP
+};
+
+void L_async_init (size_t ring_size, enum L_async_overflow overflow);
+// all messages logged by now are written and flushed after this call
+void L_async_flush (void);
+// messages are flushed, the writer is stopped, L() is synchronous after this;
+// other threads shouldn't log during this call; L_deinit() calls it as well
+void L_async_deinit (void);
+void L_async_get_stats (octa *written, octa *dropped);
+
+// binary mode: messages aren't formatted, the format string (once) and arguments of each message are written
+// to fname with a timestamp, all messages go there regardless of fds; L_binary_decode() renders the text
+// (log_decode_util does it for a file), on the same platform
+// messages with %n, %lc, %ls or literal string precision (%.10s) are formatted as usual and written as text
+// formats are remembered by address, so they must be string literals or other static storage; a format
+// built in a buffer at the address of another one is detected and written as text, but use L("%s", buf)
+void L_binary_init (const char *fname);
+// L_deinit() calls it as well
+void L_binary_deinit (void);
+// returns false if the stream is malformed, the text decoded by then is written
+bool L_binary_decode (FILE *in, FILE *out, bool timestamps);
+
 #ifdef  __cplusplus
 }
 #endif
@@ -0,0 +1,172 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// L() to a file from several threads: synchronous (unbuffered as after L_init(), and stdio-buffered)
+// vs. asynchronous mode with both overflow policies vs. binary mode (formatting is deferred to log_decode_util)
+// latency is of a single L() call, throughput includes the final flush
+// the buffered sync mode is also run with each timestamp mode
+// then, hexdumps of a buffer (L_print_buf*(), L_print_bufs_diff()) are timed, in MiB/s
+// usage: logging_bench [threads] [messages per thread]
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "logging.h"
+#include "files.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+#include "threads.h"
+
+#define FNAME "logging_bench.log"
+#define RING_SIZE (256*1024)
+#define DUMP_SIZE (4*_1MiB)
+
+enum mode { SYNC_UNBUFFERED, SYNC_BUFFERED, ASYNC_BLOCK, ASYNC_DROP, BINARY };
+
+static const char *mode_names[]={ "sync, unbuffered", "sync, buffered", "async, block", "async, drop", "binary" };
+static const char *timestamp_names[]={ "ms", "us", "tsc" };
+
+struct job
+{
+	size_t messages;
+	// latencies of each call, per thread
+	double **latencies;
+};
+
+static void producer (size_t i, void *param)
+{
+	struct job *j=(struct job*)param;
+	double *lat=j->latencies[i];
+
+	for (size_t m=0; m<j->messages; m++)
+	{
+		double t=get_monotonic_time();
+		L ("thread %d, message %d: request id=%u took %ums\n", (int)i, (int)m, (unsigned)(m*2654435761U), (unsigned)m%2000);
+		lat[m]=get_monotonic_time()-t;
+	};
+};
+
+static int cmp_doubles (const void *a, const void *b)
+{
+	double l=*(const double*)a, r=*(const double*)b;
+	return l<r ? -1 : l>r;
+};
+
+// timestamps is an L_timestamp_mode or -1 for none
+static void run (enum mode mode, int timestamps, unsigned threads, size_t messages)
+{
+	char name[64];
+	struct job j;
+	double t, *all=DMALLOC(double, threads*messages, "latencies");
+	octa written=0, dropped=0;
+
+	cur_fds.fd1=NULL;
+	if (mode==BINARY)
+		L_binary_init (FNAME);
+	else
+		cur_fds.fd2=fopen_or_die (FNAME, "w");
+	if (mode==SYNC_UNBUFFERED)
+		setvbuf (cur_fds.fd2, NULL, _IONBF, 0);
+	if (timestamps>=0)
+	{
+		L_set_timestamp_mode ((enum L_timestamp_mode)timestamps);
+		L_timestamp=true;
+	};
+	if (mode==ASYNC_BLOCK || mode==ASYNC_DROP)
+		L_async_init (RING_SIZE, mode==ASYNC_BLOCK ? L_ASYNC_BLOCK : L_ASYNC_DROP);
+
+	j.messages=messages;
+	j.latencies=DMALLOC(double*, threads, "double*");
+	for (unsigned i=0; i<threads; i++)
+		j.latencies[i]=all+i*messages;
+
+	t=get_monotonic_time();
+	parallel_for (threads, threads, producer, &j);
+	if (mode==ASYNC_BLOCK || mode==ASYNC_DROP)
+	{
+		L_async_flush();
+		L_async_get_stats (&written, &dropped);
+	}
+	else if (mode==BINARY)
+		L_binary_deinit();
+	else
+		fflush (cur_fds.fd2);
+	t=get_monotonic_time()-t;
+	L_deinit();
+	L_timestamp=false;
+
+	qsort (all, threads*messages, sizeof(double), cmp_doubles);
+	if (timestamps>=0)
+		snprintf (name, sizeof(name), "%s, ts %s", mode_names[mode], timestamp_names[timestamps]);
+	else
+		snprintf (name, sizeof(name), "%s", mode_names[mode]);
+	printf ("%-22s %12.0f  %8.3f  %8.3f  %10.3f  %8d\n", name, threads*messages/t,
+			all[threads*messages/2]*1000000, all[threads*messages*99/100]*1000000,
+			all[threads*messages-1]*1000000, (int)dropped);
+
+	DFREE(j.latencies);
+	DFREE(all);
+};
+
+static void run_dumps (void)
+{
+	byte *a=DMALLOC(byte, DUMP_SIZE, "buf"), *b=DMALLOC(byte, DUMP_SIZE, "buf");
+	double t[3];
+
+	for (size_t i=0; i<DUMP_SIZE; i++)
+		a[i]=b[i]=(byte)(i*2654435761U>>24);
+	// a change in each page
+	for (size_t i=0; i<DUMP_SIZE; i+=4096)
+		b[i]^=1;
+
+	cur_fds.fd1=NULL;
+	cur_fds.fd2=fopen_or_die (FNAME, "w");
+	t[0]=get_monotonic_time();
+	L_print_buf (a, DUMP_SIZE);
+	t[1]=get_monotonic_time();
+	L_print_buf_ofs_C (a, DUMP_SIZE, 0);
+	t[2]=get_monotonic_time();
+	L_print_bufs_diff (a, b, DUMP_SIZE);
+	L_deinit();
+	printf ("hexdump: %.1f MiB/s, in C format: %.1f MiB/s, diff: %.1f MiB/s\n", (double)DUMP_SIZE/_1MiB/(t[1]-t[0]),
+			(double)DUMP_SIZE/_1MiB/(t[2]-t[1]), (double)DUMP_SIZE/_1MiB/(get_monotonic_time()-t[2]));
+
+	DFREE(a);
+	DFREE(b);
+};
+
+int main(int argc, char **argv)
+{
+	unsigned threads=argc>1 ? atoi(argv[1]) : get_CPUs_count();
+	size_t messages=argc>2 ? atoi(argv[2]) : 200000;
+
+	if (threads==0 || messages==0)
+		die ("usage: %s [threads] [messages per thread]\n", argv[0]);
+
+	printf ("%d threads, %d messages per thread\n", threads, (int)messages);
+	printf ("mode                        msgs/sec   p50, us   p99, us     max, us   dropped\n");
+	for (enum mode m=SYNC_UNBUFFERED; m<=BINARY; m++)
+		run (m, -1, threads, messages);
+	for (enum L_timestamp_mode ts=L_TIMESTAMP_MS; ts<=L_TIMESTAMP_TSC; ts++)
+		run (SYNC_BUFFERED, ts, threads, messages);
+	run_dumps ();
+
+	remove (FNAME);
+	dump_unfreed_blocks();
+};
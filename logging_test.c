@@ -15,28 +15,293 @@
  *
  */
 
+#include <string.h>
+#include <stdarg.h>
+#include <wchar.h>
+#include <time.h>
+
 #include "logging.h"
 #include "dmalloc.h"
+#include "files.h"
+#include "threads.h"
+#include "oassert.h"
+
+#define ASYNC_THREADS 4
+#define ASYNC_MESSAGES 20000
 
 byte buf[0x20]={ 
 	'a', 'b', 'c', 'd', 1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0, 
 	'a', 'b', 'c', 'd', 1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0 	};
 
+static fds async_fds;
+
+static void async_producer (size_t thread, void *param)
+{
+	char long_line[3000];
+
+	memset (long_line, 'x', sizeof(long_line)-1);
+	long_line[sizeof(long_line)-1]=0;
+	for (int i=0; i<ASYNC_MESSAGES; i++)
+		if (thread==0 && i%1000==0)
+			// bigger than half of ring, written synchronously
+			L_fds (&async_fds, "%d %d %s\n", (int)thread, i, long_line);
+		else
+			L_fds (&async_fds, "%d %d\n", (int)thread, i);
+};
+
+// returns number of messages in the file, and checks their order within each thread
+static int check_async_log (const char *fname, bool all)
+{
+	size_t size;
+	char *buf=(char*)load_file_or_die (fname, &size), *p, *end=buf+size;
+	int next[ASYNC_THREADS]={ 0 }, total=0, thread, i;
+
+	for (p=buf; p<end; p=strchr (p, '\n')+1)
+	{
+		if (*p=='[')
+			continue; // dropped messages
+		oassert (sscanf (p, "%d %d", &thread, &i)==2 && thread<ASYNC_THREADS);
+		if (all)
+			oassert (i==next[thread]);
+		else
+			oassert (i>=next[thread]);
+		next[thread]=i+1;
+		total++;
+	};
+	DFREE(buf);
+	return total;
+};
+
+static void check_async (enum L_async_overflow overflow)
+{
+	octa written, dropped;
+	int total;
+
+	async_fds.fd1=fopen_or_die ("logging_test_async.log", "w");
+	async_fds.fd2=NULL;
+	L_async_init (4096, overflow);
+	parallel_for (ASYNC_THREADS, ASYNC_THREADS, async_producer, NULL);
+	L_async_deinit ();
+	fclose (async_fds.fd1);
+	L_async_get_stats (&written, &dropped);
+	total=check_async_log ("logging_test_async.log", overflow==L_ASYNC_BLOCK);
+	// long lines are not counted as they are written synchronously
+	oassert (total==written+ASYNC_MESSAGES/1000);
+	oassert (written+dropped+ASYNC_MESSAGES/1000==ASYNC_THREADS*ASYNC_MESSAGES);
+	if (overflow==L_ASYNC_BLOCK)
+		oassert (dropped==0);
+	remove ("logging_test_async.log");
+};
+
+// logged in binary mode and formatted as usual, to compare
+static void L_and_format (strbuf *sb, const char *fmt, ...)
+{
+	va_list va, va_copied;
+
+	va_start (va, fmt);
+	va_copy (va_copied, va);
+	strbuf_vaddf (sb, fmt, va_copied);
+	va_end (va_copied);
+	L_va (fmt, va);
+	va_end (va);
+};
+
+static void check_binary ()
+{
+	strbuf expected=STRBUF_INIT;
+	char long_str[1000], fmt_buf[32], unterminated[4]={ 'a', 'b', 'c', 'd' };
+	static const byte damaged[8+4+4+8+1+4+8]={ 'O', 'C', 'T', 'O', 'B', 'L', 'O', 'G', 1, 0, 0, 0, [24]='T', 0xff, 0xff, 0xff, 0xff };
+	FILE *in, *out;
+	size_t size;
+	char *decoded;
+
+	memset (long_str, 'y', sizeof(long_str)-1);
+	long_str[sizeof(long_str)-1]=0;
+
+	L_binary_init ("logging_test.blog");
+	L_and_format (&expected, "%d %u %x %lld %zu %ld %hhx\n", -1, 2U, 0xabcU, -3LL, (size_t)4, 5L, 0x1ff);
+	L_and_format (&expected, "[%s|%-10s|%*d|%-*d|%.*s|%.*d]\n", "abc", "left", 6, 42, 4, 7, 2, "truncated", -1, 8);
+	L_and_format (&expected, "%5.2f %e %g %c %% %p\n", 3.14159, 1e100, 0.5, 'z', (void*)&expected);
+	L_and_format (&expected, "no newline, ");
+	L_and_format (&expected, "%s\n", long_str);
+	// only precision bytes are read
+	L_and_format (&expected, "%.*s|%*.*s|%.*s\n", 3, unterminated, 6, 4, unterminated, -1, "negative");
+	L_and_format (&expected, "%.2s\n", unterminated);
+	// can't be stored in binary form, written as text
+	L_and_format (&expected, "%ls\n", L"wide");
+	L_and_format (&expected, "%ls\n", L"wide");
+	// another format at the same address
+	strcpy (fmt_buf, "%d apples\n");
+	L_and_format (&expected, fmt_buf, 3);
+	strcpy (fmt_buf, "%s pears\n");
+	L_and_format (&expected, fmt_buf, "no");
+	L_binary_deinit ();
+
+	in=fopen_or_die ("logging_test.blog", "rb");
+	out=fopen_or_die ("logging_test_decoded.log", "wb");
+	oassert (L_binary_decode (in, out, false));
+	fclose (in);
+	fclose (out);
+	decoded=(char*)load_file_or_die ("logging_test_decoded.log", &size);
+	oassert (size==expected.strlen && memcmp (decoded, expected.buf, size)==0);
+	DFREE(decoded);
+	strbuf_deinit (&expected);
+
+	// record length is checked before allocation
+	out=fopen_or_die ("logging_test.blog", "wb");
+	fwrite (damaged, sizeof(damaged), 1, out);
+	fclose (out);
+	in=fopen_or_die ("logging_test.blog", "rb");
+	out=fopen_or_die ("logging_test_decoded.log", "wb");
+	oassert (L_binary_decode (in, out, false)==false);
+	fclose (in);
+	fclose (out);
+
+	// several threads
+	L_binary_init ("logging_test.blog");
+	parallel_for (ASYNC_THREADS, ASYNC_THREADS, async_producer, NULL);
+	L_binary_deinit ();
+	in=fopen_or_die ("logging_test.blog", "rb");
+	out=fopen_or_die ("logging_test_decoded.log", "wb");
+	oassert (L_binary_decode (in, out, false));
+	fclose (in);
+	fclose (out);
+	oassert (check_async_log ("logging_test_decoded.log", true)==ASYNC_THREADS*ASYNC_MESSAGES);
+
+	remove ("logging_test.blog");
+	remove ("logging_test_decoded.log");
+};
+
+static void check_once ()
+{
+	size_t tracked;
+	octa suppressed, untracked;
+
+	// printed only for i==0
+	for (int i=0; i<5; i++)
+		L_ONCE_SITE("site %d\n", i);
+	L_once_get_stats (&tracked, &suppressed, &untracked);
+	oassert (tracked==4 && suppressed==10 && untracked==0);
+
+	L_once_set_limit (5);
+	L_once("#4 should be printed once\n");
+	L_once("#4 should be printed once\n");
+	// beyond limit, printed each time
+	L_once("#5 is printed twice\n");
+	L_once("#5 is printed twice\n");
+	L_once_get_stats (&tracked, &suppressed, &untracked);
+	oassert (tracked==5 && suppressed==11 && untracked==2);
+};
+
+// each line is: [YYYY-MM-DD HH:MM:SS:mmm] n, or [cycles] n; timestamps don't decrease
+static void check_timestamps (enum L_timestamp_mode mode)
+{
+	fds s={ NULL, NULL };
+	size_t size;
+	char *buf, *p;
+	int year, mon, day, h, m, sec, n, ofs;
+	unsigned long long frac, prev=0, cur;
+	time_t now=time(NULL);
+	struct tm *tm=localtime (&now);
+
+	L_set_timestamp_mode (mode);
+	L_timestamp=true;
+	s.fd1=fopen_or_die ("logging_test_ts.log", "w");
+	for (int i=0; i<100; i++)
+		L_fds (&s, "%d\n", i);
+	fclose (s.fd1);
+	L_timestamp=false;
+
+	buf=(char*)load_file_or_die ("logging_test_ts.log", &size);
+	p=buf;
+	for (int i=0; i<100; i++)
+	{
+		if (mode==L_TIMESTAMP_TSC)
+		{
+			oassert (sscanf (p, "[%llu] %d\n%n", &cur, &n, &ofs)==2);
+			oassert (p[15]==']');
+		}
+		else
+		{
+			oassert (sscanf (p, "[%4d-%2d-%2d %2d:%2d:%2d:%llu] %d\n%n", &year, &mon, &day, &h, &m, &sec, &frac, &n, &ofs)==8);
+			// the test may run at midnight of Dec 31
+			oassert (year==tm->tm_year+1900 || year==tm->tm_year+1900+1);
+			oassert (p[20]==':' && p[(mode==L_TIMESTAMP_US ? 27 : 24)]==']');
+			cur=(((h*60ULL+m)*60+sec)*1000000)+(mode==L_TIMESTAMP_US ? frac : frac*1000);
+		};
+		oassert (n==i && cur>=prev);
+		prev=cur;
+		p+=ofs;
+	};
+	oassert (p==buf+size);
+	DFREE(buf);
+	remove ("logging_test_ts.log");
+};
+
+// partial rows, both offset widths, identical and changed regions
+static void check_print_bufs ()
+{
+	byte a[300], b[300];
+
+	for (int i=0; i<300; i++)
+		a[i]=i*7+(i>>3);
+	memcpy (b, a, sizeof(a));
+	b[5]^=1;
+	b[6]^=0x80;
+	b[100]=0;
+	b[101]='A';
+	b[299]^=0xFF;
+
+	L_print_buf_ofs (a, 19, 0x1234);
+	L_print_buf_ofs_C (a+3, 21, 0x10);
+	L_print_bufs_diff (a, b, sizeof(a));
+	L_print_bufs_diff (a, a, 40);
+	L_print_bufs_diff (a, b, 7);
+	L_ofs_width=64;
+	L_print_buf_ofs (a, 17, 0x123456789);
+	L_print_buf_ofs_C (a, 3, 0x123456789);
+	L_ofs_width=32;
+};
+
 int main()
 {
+	char once_fmt[32];
+
 	L_init("logging_test.log");
 	L_ofs_width=32;
 	L_once("#1 should be printed once\n");
 	L_once("#2 should be printed once\n");
-	L_once("#3 should be printed once\n");
+	strcpy (once_fmt, "#3 should be printed once\n");
+	L_once(once_fmt);
 	L_once("#1 should be printed once\n");
 	L_once("#1 should be printed once\n");
 	L_once("#1 should be printed once\n");
 	L_once("#2 should be printed once\n");
 	L_once("#2 should be printed once\n");
-	L_once("#3 should be printed once\n");
+	L_once(once_fmt);
+	// the summary has its own copy of the format
+	strcpy (once_fmt, "overwritten\n");
+	check_once ();
 	L_print_buf (buf, 0x20);
 	L_print_buf_ofs_C (buf, 0x20, 0);
+	check_print_bufs ();
+
+	// the same in asynchronous mode
+	L_async_init (0, L_ASYNC_BLOCK);
+	L_print_buf (buf, 0x20);
+	L_async_flush ();
+	L ("%s %d\n", "async", 1);
+	L_async_deinit ();
+
+	check_async (L_ASYNC_BLOCK);
+	check_async (L_ASYNC_DROP);
+	L ("async, %d threads: ok\n", ASYNC_THREADS);
+	check_binary ();
+	L ("binary: ok\n");
+	check_timestamps (L_TIMESTAMP_MS);
+	check_timestamps (L_TIMESTAMP_US);
+	check_timestamps (L_TIMESTAMP_TSC);
+	L ("timestamps: ok\n");
 	L_deinit();
 
 	dump_unfreed_blocks();
@@ -23,6 +23,7 @@
 #include "stuff.h"
 #include "oassert.h"
 #include "dmalloc.h"
+#include "memutils.h"
 
 void bytefill (void* ptr, size_t size, byte val)
 {
@@ -66,23 +67,77 @@ bool is_blk_zero (void *ptr, size_t s)
 	return true;
 };
 
-// my own temporary GNU memmem() implementation
-// TODO rework
+// my own GNU memmem() implementation
+// candidates are positions where both first and last bytes of needle match, 16 positions at once
+// (SSE2 is always present on x64), then the middle is compared
 
-byte *omemmem (byte *haystack, size_t haystack_size, byte *needle, size_t needle_size)
+static byte *omemmem_scalar (byte *haystack, size_t haystack_size, byte *needle, size_t needle_size)
 {
-	if (needle_size > haystack_size)
-		return NULL;
+	byte *end=haystack+haystack_size-needle_size+1;
 
-	// may be optimized, probably...
-	for (size_t i=0; i<haystack_size - needle_size + 1; i++)
+	for (byte *p=haystack; p<end; p++)
 	{
-		if (memcmp (haystack+i, needle, needle_size)==0)
-			return haystack+i;
+		p=(byte*)memchr (p, needle[0], end-p);
+		if (p==NULL)
+			return NULL;
+		if (p[needle_size-1]==needle[needle_size-1] && memcmp (p+1, needle+1, needle_size-1)==0)
+			return p;
 	};
 	return NULL;
 };
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+
+static unsigned lowest_bit_idx (unsigned x)
+{
+#ifdef _MSC_VER
+	unsigned long rt;
+	_BitScanForward(&rt, x);
+	return rt;
+#else
+	return __builtin_ctz(x);
+#endif
+};
+
+static byte *omemmem_sse2 (byte *haystack, size_t haystack_size, byte *needle, size_t needle_size)
+{
+	size_t positions=haystack_size-needle_size+1, i;
+	__m128i first=_mm_set1_epi8(needle[0]);
+	__m128i last=_mm_set1_epi8(needle[needle_size-1]);
+
+	for (i=0; i+16<=positions; i+=16)
+	{
+		__m128i a=_mm_loadu_si128((const __m128i*)(haystack+i));
+		__m128i b=_mm_loadu_si128((const __m128i*)(haystack+i+needle_size-1));
+		unsigned mask=_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+		while (mask)
+		{
+			byte *p=haystack+i+lowest_bit_idx(mask);
+			if (memcmp (p+1, needle+1, needle_size-2)==0)
+				return p;
+			mask&=mask-1;
+		};
+	};
+	return omemmem_scalar (haystack+i, haystack_size-i, needle, needle_size);
+};
+#endif
+
+byte *omemmem (byte *haystack, size_t haystack_size, byte *needle, size_t needle_size)
+{
+	if (needle_size > haystack_size)
+		return NULL;
+	if (needle_size==0)
+		return haystack;
+	if (needle_size==1)
+		return (byte*)memchr (haystack, needle[0], haystack_size);
+#if defined(__SSE2__) || defined(_M_X64)
+	return omemmem_sse2 (haystack, haystack_size, needle, needle_size);
+#else
+	return omemmem_scalar (haystack, haystack_size, needle, needle_size);
+#endif
+};
+
 // Knuth–Morris–Pratt algorithm
 // copypasted from http://cprogramming.com/snippets/source-code/knuthmorrispratt-kmp-string-search-algorithm
 byte *kmp_search(byte *haystack, size_t haystack_size, byte *needle, size_t needle_size)
@@ -170,7 +225,7 @@ bool is_buf_printable (char *s, size_t size)
 {
 	for (size_t i=0; i<size; i++)
 	{
-		if (isprint(s[i])==0)
+		if ((byte_class_table[(byte)s[i]] & BYTE_CLASS_PRINTABLE)==0)
 			return false;
 	};
 	return true;
@@ -184,3 +239,93 @@ int search_for_elem_in_array_of_size_t (size_t* array, size_t size, size_t needl
 
 	return -1;
 };
+
+const byte byte_class_table[256]=
+{
+	0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x05, 0x01, 0x01, 0x01, 0x05,
+	0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+	0x01, 0x17, 0x17, 0x17, 0x17, 0x17, 0x17, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15,
+	0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x01, 0x01, 0x01, 0x01, 0x01,
+	0x01, 0x27, 0x27, 0x27, 0x27, 0x27, 0x27, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25,
+	0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x01, 0x01, 0x01, 0x01, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// 4 sub-histograms: when the same byte repeats, increments of the same counter would
+// otherwise wait for each other (store-to-load forwarding), now they go to different counters
+// 32-bit counters are faster, so the buffer is processed by pieces which can't overflow them
+#define HIST_LANES 4
+#define HIST_PIECE (1U<<30)
+
+void byte_histogram (const byte *buf, size_t size, octa *hist)
+{
+	tetra h[HIST_LANES][256];
+
+	while (size)
+	{
+		size_t piece=min(size, HIST_PIECE);
+		size_t i=0;
+		memset (h, 0, sizeof(h));
+
+		for (; i+8<=piece; i+=8)
+		{
+			octa v;
+			memcpy (&v, buf+i, sizeof(octa));
+			h[0][v&0xFF]++;
+			h[1][(v>>8)&0xFF]++;
+			h[2][(v>>16)&0xFF]++;
+			h[3][(v>>24)&0xFF]++;
+			h[0][(v>>32)&0xFF]++;
+			h[1][(v>>40)&0xFF]++;
+			h[2][(v>>48)&0xFF]++;
+			h[3][v>>56]++;
+		};
+		for (; i<piece; i++)
+			h[0][buf[i]]++;
+
+		for (int b=0; b<256; b++)
+			hist[b]+=h[0][b]+h[1][b]+h[2][b]+h[3][b];
+
+		buf+=piece;
+		size-=piece;
+	};
+};
+
+void byte_stats_calc (const byte *buf, size_t size, struct byte_stats *out)
+{
+	memset (out, 0, sizeof(struct byte_stats));
+	byte_histogram (buf, size, out->hist);
+	out->total=size;
+
+	for (int b=0; b<256; b++)
+	{
+		octa c=out->hist[b];
+		if (c==0)
+			continue;
+		byte cls=byte_class_table[b];
+		if (cls & BYTE_CLASS_PRINTABLE)
+			out->printable+=c;
+		if (cls & BYTE_CLASS_HEX_DIGIT)
+			out->hex_digits+=c;
+		if (cls & BYTE_CLASS_BASE64)
+			out->base64_chars+=c;
+		if (cls & BYTE_CLASS_ZERO)
+			out->zeroes+=c;
+		if (cls & BYTE_CLASS_UPPER)
+			out->upper+=c;
+		if (cls & BYTE_CLASS_LOWER)
+			out->lower+=c;
+		if (cls & BYTE_CLASS_DIGIT)
+			out->digits+=c;
+	};
+};
+
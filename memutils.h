@@ -45,6 +45,29 @@ extern "C" {
 	// -1 if not found
 	int search_for_elem_in_array_of_size_t (size_t* array, size_t size, size_t needle);
 
+	// byte classes, flags in byte_class_table[]
+#define BYTE_CLASS_PRINTABLE (1<<0) // 0x20..0x7E, as isprint() in C locale
+#define BYTE_CLASS_HEX_DIGIT (1<<1)
+#define BYTE_CLASS_BASE64    (1<<2) // without padding symbol
+#define BYTE_CLASS_ZERO      (1<<3)
+#define BYTE_CLASS_UPPER     (1<<4) // Latin
+#define BYTE_CLASS_LOWER     (1<<5) // Latin
+#define BYTE_CLASS_DIGIT     (1<<6)
+	extern const byte byte_class_table[256];
+
+	// adds to hist[256]
+	void byte_histogram (const byte *buf, size_t size, octa *hist);
+
+	// all you need to classify a block, in one pass
+	struct byte_stats
+	{
+		octa hist[256];
+		octa total;
+		octa printable, hex_digits, base64_chars, zeroes;
+		octa upper, lower, digits;
+	};
+	void byte_stats_calc (const byte *buf, size_t size, struct byte_stats *out);
+
 #ifdef  __cplusplus
 }
 #endif
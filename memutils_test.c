@@ -36,6 +36,55 @@ void omemmem_test()
 	char *p="world";
 	must_be_or_exit1 (strcmp (omemmem ((byte*)s, strlen(s), (byte*)p, strlen(p)), "world!\n"), 0, __LINE__);
 	must_be_or_exit1 (strcmp (kmp_search ((byte*)s, strlen(s), (byte*)p, strlen(p)), "world!\n"), 0, __LINE__);
+
+	// against naive search, small alphabet so that there are many partial matches
+	byte hay[100], needle[20];
+	for (int round=0; round<2000; round++)
+	{
+		size_t hay_size=round%100, needle_size=1+round%19;
+		for (size_t i=0; i<hay_size; i++)
+			hay[i]='a'+((round*7+i*i*31)>>3)%3;
+		for (size_t i=0; i<needle_size; i++)
+			needle[i]='a'+((round*13+i*5)>>2)%3;
+		byte *expected=NULL;
+		for (size_t i=0; i+needle_size<=hay_size && expected==NULL; i++)
+			if (memcmp (hay+i, needle, needle_size)==0)
+				expected=hay+i;
+		must_be_or_exit1 (omemmem (hay, hay_size, needle, needle_size)==expected, 1, __LINE__);
+	};
+	must_be_or_exit1 (omemmem (hay, 10, needle, 0)==hay, 1, __LINE__);
+};
+
+void byte_stats_test()
+{
+	char *s="Hello, World! 0123 deadBEEF\x00\x00\xFF";
+	size_t len=30;
+	struct byte_stats st;
+	byte_stats_calc ((byte*)s, len, &st);
+
+	printf ("total=%d printable=%d hex_digits=%d base64_chars=%d zeroes=%d upper=%d lower=%d digits=%d\n",
+		(int)st.total, (int)st.printable, (int)st.hex_digits, (int)st.base64_chars, (int)st.zeroes,
+		(int)st.upper, (int)st.lower, (int)st.digits);
+	must_be_or_exit1 (st.hist['l'], 3, __LINE__);
+	must_be_or_exit1 (st.hist[0xFF], 1, __LINE__);
+	must_be_or_exit1 (st.printable==len-3, is_buf_printable(s, len)==false, __LINE__);
+	must_be_or_exit1 (is_buf_printable(s, 13), true, __LINE__);
+
+	// all lanes and the tail
+	byte buf[1000];
+	octa hist[256];
+	for (int i=0; i<sizeof(buf); i++)
+		buf[i]=i%7;
+	memset (hist, 0, sizeof(hist));
+	byte_histogram (buf+1, sizeof(buf)-1, hist);
+	for (int i=0; i<7; i++)
+	{
+		unsigned expected=0;
+		for (int j=1; j<sizeof(buf); j++)
+			if (buf[j]==i)
+				expected++;
+		must_be_or_exit1 (hist[i], expected, __LINE__);
+	};
 };
 
 int main()
@@ -51,6 +100,7 @@ int main()
 	find_all_needles_tests();
 
 	omemmem_test();	
+	byte_stats_test();
 	dump_unfreed_blocks();
 
 	return 0;
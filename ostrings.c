@@ -28,6 +28,7 @@
 #include "datatypes.h"
 #include "oassert.h"
 #include "ostrings.h"
+#include "memutils.h"
 #include "dmalloc.h"
 #include "strbuf.h"
 
@@ -208,7 +209,10 @@ bool is_string_consists_only_of_Latin_letters (char *s)
 
 bool is_string_consists_only_of_hex_digits (char *s)
 {
-	return strspn (s, "0123456789ABCDEFabcdef")==strlen(s);
+	for (; *s; s++)
+		if ((byte_class_table[(byte)*s] & BYTE_CLASS_HEX_DIGIT)==0)
+			return false;
+	return true;
 };
 
 bool is_string_has_only_one_character_repeating (char *s, char *output)
@@ -0,0 +1,505 @@
+/* Generating a specialized C matcher for a constant pattern.
+   This file is included from regex.c, after regexec.c, so it can use
+   DFA internals directly.
+
+   re_gen_c() compiles the pattern, builds all the DFA states reachable
+   from the initial ones and writes them out as a direct-coded DFA: each
+   state is a label, followed by the halt check and a switch on the next
+   byte jumping to the label of the next state.  RE_TRANSLATE, REG_ICASE
+   and the contexts of bytes (word, newline) are folded into the switches
+   and a 256-entry table, so the generated code doesn't need the regex
+   internals, only regex.h.
+
+   The generated function has the signature and the semantics of
+   regexec(), minus the regex_t argument.  The search is done as
+   re_search_internal() does it for NMATCH <= 1: the automaton is run from
+   each plausible start position (the fastmap is folded into a table too),
+   and the longest match from the leftmost start wins.  A DFA can't track
+   subexpressions, so with NMATCH > 1 the generated code finds out if there
+   is a match at all, and only then calls regexec() of the pattern (taken
+   from regcache).
+
+   Back-references and multibyte locales are not supported.  */
+
+/* Larger automata are better left to regexec().  */
+#define RE_GEN_MAX_STATES 4096
+
+typedef struct
+{
+  re_dfastate_t **states;
+  Idx nstates;
+  /* Indices of STATES by pointer, open addressing.  */
+  Idx *table;
+  size_t table_size;
+} re_gen_t;
+
+static size_t
+gen_hash (const re_dfastate_t *state)
+{
+  return ((size_t) state >> 4) * 2654435761U;
+}
+
+/* Return the index of STATE, adding it if it's new, or -1 for the dead
+   state.  */
+
+static Idx
+gen_state_index (re_gen_t *g, re_dfastate_t *state, reg_errcode_t *err)
+{
+  size_t i;
+
+  if (state == NULL)
+    return -1;
+  for (i = gen_hash (state) & (g->table_size - 1); g->table[i] != -1;
+       i = (i + 1) & (g->table_size - 1))
+    if (g->states[g->table[i]] == state)
+      return g->table[i];
+
+  if (g->nstates == RE_GEN_MAX_STATES)
+    {
+      *err = REG_ESPACE;
+      return -1;
+    }
+  g->states[g->nstates] = state;
+  g->table[i] = g->nstates;
+  return g->nstates++;
+}
+
+/* Same as re_string_t does to the raw byte.  */
+
+static void
+gen_init_xlat (const regex_t *preg, unsigned char *xlat)
+{
+  bool icase = (preg->syntax & RE_ICASE) != 0;
+  int i;
+  for (i = 0; i < SBC_MAX; ++i)
+    {
+      int ch = preg->translate ? preg->translate[i] : i;
+      xlat[i] = icase && islower (ch) ? toupper (ch) : ch;
+    }
+}
+
+/* Same as transit_state() for single byte locale, but for raw byte C.  */
+
+static reg_errcode_t
+gen_transit (const re_dfa_t *dfa, const unsigned char *xlat,
+	     re_dfastate_t *state, int c, re_dfastate_t **dest)
+{
+  unsigned char ch = xlat[c];
+  re_dfastate_t **trtable;
+
+  for (;;)
+    {
+      trtable = re_load_acquire (state->trtable);
+      if (trtable != NULL)
+	{
+	  *dest = trtable[ch];
+	  return REG_NOERROR;
+	}
+      trtable = re_load_acquire (state->word_trtable);
+      if (trtable != NULL)
+	{
+	  *dest = trtable[bitset_contain (dfa->word_char, ch)
+			  ? ch + SBC_MAX : ch];
+	  return REG_NOERROR;
+	}
+      if (!build_trtable (dfa, state))
+	return REG_ESPACE;
+    }
+}
+
+/* Same as acquire_init_state_context().  */
+
+static re_dfastate_t *
+gen_init_state (reg_errcode_t *err, const re_dfa_t *dfa,
+		unsigned int context)
+{
+  if (!dfa->init_state->has_constraint)
+    return dfa->init_state;
+  if (IS_WORD_CONTEXT (context))
+    return dfa->init_state_word;
+  else if (IS_ORDINARY_CONTEXT (context))
+    return dfa->init_state;
+  else if (IS_BEGBUF_CONTEXT (context) && IS_NEWLINE_CONTEXT (context))
+    return dfa->init_state_begbuf;
+  else if (IS_NEWLINE_CONTEXT (context))
+    return dfa->init_state_nl;
+  else if (IS_BEGBUF_CONTEXT (context))
+    return re_acquire_state_context (err, dfa,
+				     dfa->init_state->entrance_nodes,
+				     context);
+  return dfa->init_state;
+}
+
+/* Bit N is set if STATE halts when the next byte has context N.  */
+
+static unsigned int
+gen_halt_mask (const re_dfa_t *dfa, const re_dfastate_t *state)
+{
+  unsigned int mask = 0, context;
+  Idx i;
+
+  if (!state->halt)
+    return 0;
+  if (!state->has_constraint)
+    return 0xffff;
+  for (context = 0; context < (CONTEXT_ENDBUF << 1); ++context)
+    for (i = 0; i < state->nodes.nelem; ++i)
+      if (check_halt_node_context (dfa, state->nodes.elems[i], context))
+	mask |= 1 << context;
+  return mask;
+}
+
+static void
+gen_put_string (FILE *out, const char *s)
+{
+  fputc ('"', out);
+  for (; *s; ++s)
+    {
+      unsigned char c = *s;
+      if (c == '\\' || c == '"' || c == '?')
+	fprintf (out, "\\%c", c);
+      else if (c < ' ' || c >= 0x7f)
+	fprintf (out, "\\%03o", c);
+      else
+	fputc (c, out);
+    }
+  fputc ('"', out);
+}
+
+static void
+gen_put_table (FILE *out, const char *type, const char *name,
+	       const char *suffix, const int *values, int n)
+{
+  int i;
+  fprintf (out, "static const %s %s_%s[%d] =\n{", type, name, suffix, n);
+  for (i = 0; i < n; ++i)
+    fprintf (out, "%s%d%s", i % 16 ? " " : "\n  ", values[i],
+	     i + 1 < n ? "," : "\n};\n\n");
+}
+
+/* Write the code of STATE: the halt check and the switch on the next
+   byte.  NEXT is the index of the next state for each byte.  */
+
+static void
+gen_put_state (FILE *out, Idx idx, unsigned int halt, const Idx *next)
+{
+  int counts[SBC_MAX], c, d;
+  Idx deflt = -1;
+  int best = 0;
+
+  fprintf (out, " s%ld:\n", (long) idx);
+  if (halt == 0xffff)
+    fprintf (out, "  last = i;\n"
+		  "  if (!longest)\n"
+		  "    return last;\n");
+  else if (halt != 0)
+    fprintf (out, "  ctx = i == end ? eof_ctx : ctx_of[s[i]];\n"
+		  "  if ((0x%x >> ctx) & 1)\n"
+		  "    {\n"
+		  "      last = i;\n"
+		  "      if (!longest)\n"
+		  "\treturn last;\n"
+		  "    }\n", halt);
+
+  /* The most frequent next state goes to default.  */
+  for (c = 0; c < SBC_MAX; ++c)
+    {
+      counts[c] = 0;
+      for (d = 0; d < SBC_MAX; ++d)
+	counts[c] += next[d] == next[c];
+      if (counts[c] > best)
+	{
+	  best = counts[c];
+	  deflt = next[c];
+	}
+    }
+  if (best == SBC_MAX && deflt == -1)
+    {
+      fprintf (out, "  return last;\n");
+      return;
+    }
+  fprintf (out, "  if (i == end)\n"
+		"    return last;\n");
+  if (best == SBC_MAX)
+    {
+      fprintf (out, "  i++;\n"
+		    "  goto s%ld;\n", (long) deflt);
+      return;
+    }
+
+  fprintf (out, "  switch (s[i++])\n"
+		"    {\n");
+  for (c = 0; c < SBC_MAX; ++c)
+    {
+      int ncases = 0;
+      if (next[c] == deflt)
+	continue;
+      /* Cases of each next state are written once, at its first byte.  */
+      for (d = 0; d < c && next[d] != next[c]; ++d)
+	;
+      if (d < c)
+	continue;
+      for (d = c; d < SBC_MAX; ++d)
+	if (next[d] == next[c])
+	  fprintf (out, "%s case %d:", ncases++ % 8 ? "" : ncases > 1 ? "\n   " : "   ", d);
+      if (next[c] == -1)
+	fprintf (out, "\n      return last;\n");
+      else
+	fprintf (out, "\n      goto s%ld;\n", (long) next[c]);
+    }
+  if (deflt == -1)
+    fprintf (out, "    default:\n"
+		  "      return last;\n");
+  else
+    fprintf (out, "    default:\n"
+		  "      goto s%ld;\n", (long) deflt);
+  fprintf (out, "    }\n");
+}
+
+static reg_errcode_t
+gen_code (FILE *out, const regex_t *preg, const char *name,
+	  const char *pattern, int cflags)
+{
+  re_dfa_t *dfa = preg->buffer;
+  reg_errcode_t err = REG_NOERROR;
+  unsigned char xlat[SBC_MAX];
+  int ctx_of[SBC_MAX], first[SBC_MAX], init[CONTEXT_ENDBUF << 1];
+  Idx *next = NULL;
+  unsigned int *halt = NULL;
+  unsigned int context;
+  bool use_first, anchored, constrained = false;
+  re_gen_t g;
+  Idx i;
+  int c;
+
+  memset (&g, 0, sizeof (g));
+  g.table_size = 2 * RE_GEN_MAX_STATES;
+  g.states = re_malloc (re_dfastate_t *, RE_GEN_MAX_STATES);
+  g.table = re_malloc (Idx, g.table_size);
+  if (BE (g.states == NULL || g.table == NULL, 0))
+    {
+      err = REG_ESPACE;
+      goto out;
+    }
+  for (i = 0; i < (Idx) g.table_size; ++i)
+    g.table[i] = -1;
+
+  gen_init_xlat (preg, xlat);
+  for (c = 0; c < SBC_MAX; ++c)
+    {
+      if (bitset_contain (dfa->word_char, xlat[c]))
+	ctx_of[c] = CONTEXT_WORD;
+      else
+	ctx_of[c] = (IS_NEWLINE (xlat[c]) && preg->newline_anchor
+		     ? CONTEXT_NEWLINE : 0);
+    }
+
+  /* The contexts a match can start in: of a byte, or of the beginning
+     with or without REG_NOTBOL.  */
+  for (context = 0; context < (CONTEXT_ENDBUF << 1); ++context)
+    {
+      init[context] = -1;
+      if (context <= CONTEXT_NEWLINE
+	  || context == CONTEXT_BEGBUF
+	  || context == (CONTEXT_NEWLINE | CONTEXT_BEGBUF))
+	{
+	  re_dfastate_t *state = gen_init_state (&err, dfa, context);
+	  if (BE (err != REG_NOERROR, 0))
+	    goto out;
+	  init[context] = gen_state_index (&g, state, &err);
+	  if (BE (err != REG_NOERROR, 0))
+	    goto out;
+	}
+    }
+
+  /* Build all the states reachable, the list grows as we go.  */
+  next = re_malloc (Idx, SBC_MAX * RE_GEN_MAX_STATES);
+  if (BE (next == NULL, 0))
+    {
+      err = REG_ESPACE;
+      goto out;
+    }
+  for (i = 0; i < g.nstates; ++i)
+    for (c = 0; c < SBC_MAX; ++c)
+      {
+	re_dfastate_t *dest;
+	err = gen_transit (dfa, xlat, g.states[i], c, &dest);
+	if (BE (err != REG_NOERROR, 0))
+	  goto out;
+	next[i * SBC_MAX + c] = gen_state_index (&g, dest, &err);
+	if (BE (err != REG_NOERROR, 0))
+	  goto out;
+      }
+
+  halt = re_malloc (unsigned int, g.nstates);
+  if (BE (halt == NULL, 0))
+    {
+      err = REG_ESPACE;
+      goto out;
+    }
+  for (i = 0; i < g.nstates; ++i)
+    {
+      halt[i] = gen_halt_mask (dfa, g.states[i]);
+      constrained |= halt[i] != 0 && halt[i] != 0xffff;
+    }
+
+  /* See re_search_internal().  */
+  use_first = (preg->fastmap != NULL && preg->fastmap_accurate
+	       && !preg->can_be_null);
+  for (c = 0; c < SBC_MAX; ++c)
+    first[c] = use_first ? preg->fastmap[preg->translate
+					 ? preg->translate[c] : c] != 0 : 1;
+  anchored = (dfa->init_state->nodes.nelem == 0
+	      && dfa->init_state_word->nodes.nelem == 0
+	      && (dfa->init_state_nl->nodes.nelem == 0
+		  || !preg->newline_anchor));
+
+  fprintf (out, "/* Generated by re_gen_c() from %s_pattern, do not edit.  */\n\n"
+		"static const char %s_pattern[] = ", name, name);
+  gen_put_string (out, pattern);
+  fprintf (out, ";\nstatic const int %s_cflags = %d;\n\n", name, cflags);
+  fprintf (out, "/* Context of each byte: %d word, %d newline.  */\n",
+	   CONTEXT_WORD, CONTEXT_NEWLINE);
+  gen_put_table (out, "unsigned char", name, "ctx", ctx_of, SBC_MAX);
+  if (use_first)
+    {
+      fprintf (out, "/* Bytes a match can start with.  */\n");
+      gen_put_table (out, "unsigned char", name, "first", first, SBC_MAX);
+    }
+  fprintf (out, "/* Initial state for the context of the byte before the "
+		"start, -1 if none.  */\n");
+  gen_put_table (out, "short", name, "init", init, CONTEXT_ENDBUF << 1);
+
+  fprintf (out, "/* Run the DFA from STATE at I, return the end of the "
+		"longest match\n"
+		"   (of the first one if !LONGEST), or -1.  */\n\n"
+		"static regoff_t\n"
+		"%s_run (const unsigned char *s, regoff_t i, regoff_t end, "
+		"int state,\n"
+		"\tunsigned int eof_ctx, bool longest)\n"
+		"{\n"
+		"  const unsigned char *ctx_of = %s_ctx;\n"
+		"  regoff_t last = -1;\n", name, name);
+  if (constrained)
+    fprintf (out, "  unsigned int ctx;\n");
+  fprintf (out, "\n"
+		"  (void) ctx_of;\n"
+		"  (void) eof_ctx;\n"
+		"  switch (state)\n"
+		"    {\n");
+  for (context = 0; context < (CONTEXT_ENDBUF << 1); ++context)
+    {
+      unsigned int prev;
+      /* Each initial state once.  */
+      for (prev = 0; prev < context && init[prev] != init[context]; ++prev)
+	;
+      if (init[context] != -1 && prev == context)
+	fprintf (out, "    case %d:\n"
+		      "      goto s%d;\n", init[context], init[context]);
+    }
+  fprintf (out, "    }\n"
+		"  return last;\n"
+		"\n");
+  for (i = 0; i < g.nstates; ++i)
+    gen_put_state (out, i, halt[i], next + i * SBC_MAX);
+  fprintf (out, "}\n\n");
+
+  fprintf (out, "int\n"
+		"%s (const char *string, size_t nmatch, regmatch_t pmatch[], "
+		"int eflags)\n"
+		"{\n"
+		"  const unsigned char *s = (const unsigned char *) string;\n"
+		"  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? %d : %d;\n"
+		"  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? %d : %d;\n"
+		"  regoff_t start, end, last = -1;\n"
+		"  int state;\n"
+		"\n"
+		"  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))\n"
+		"    return REG_BADPAT;\n"
+		"  if (eflags & REG_STARTEND)\n"
+		"    {\n"
+		"      start = pmatch[0].rm_so;\n"
+		"      end = pmatch[0].rm_eo;\n"
+		"    }\n"
+		"  else\n"
+		"    {\n"
+		"      start = 0;\n"
+		"      end = strlen (string);\n"
+		"    }\n"
+		"  if (start < 0 || start > end)\n"
+		"    return REG_NOMATCH;\n",
+	   name, CONTEXT_BEGBUF, CONTEXT_NEWLINE | CONTEXT_BEGBUF,
+	   CONTEXT_ENDBUF, CONTEXT_NEWLINE | CONTEXT_ENDBUF);
+  if (cflags & REG_NOSUB)
+    fprintf (out, "  nmatch = 0;\n");
+  if (anchored)
+    fprintf (out, "  /* The pattern is anchored.  */\n"
+		  "  if (start != 0)\n"
+		  "    return REG_NOMATCH;\n");
+  fprintf (out, "\n"
+		"  for (;; ++start)\n"
+		"    {\n");
+  /* At the end the byte is taken as NUL, like re_search_internal() does:
+     the matcher still runs there if a match can start with it.  */
+  if (use_first)
+    fprintf (out, "      while (start < end && !%s_first[s[start]])\n"
+		  "\t++start;\n"
+		  "      if (start == end && !%s_first[0])\n"
+		  "\treturn REG_NOMATCH;\n", name, name);
+  fprintf (out, "      state = %s_init[start == 0 ? bof_ctx "
+		": %s_ctx[s[start - 1]]];\n"
+		"      if (state >= 0)\n"
+		"\t{\n"
+		"\t  last = %s_run (s, start, end, state, eof_ctx, "
+		"nmatch != 0);\n"
+		"\t  if (last >= 0)\n"
+		"\t    break;\n"
+		"\t}\n"
+		"      if (%s)\n"
+		"\treturn REG_NOMATCH;\n"
+		"    }\n"
+		"\n"
+		"  if (nmatch > 1)\n"
+		"    {\n"
+		"      /* Subexpressions are left to regexec().  */\n"
+		"      regex_t *r = regcache_get (%s_pattern, %s_cflags);\n"
+		"      int ret = regexec (r, string, nmatch, pmatch, eflags);\n"
+		"      regcache_release (r);\n"
+		"      return ret;\n"
+		"    }\n"
+		"  if (nmatch == 1)\n"
+		"    {\n"
+		"      pmatch[0].rm_so = start;\n"
+		"      pmatch[0].rm_eo = last;\n"
+		"    }\n"
+		"  return 0;\n"
+		"}\n\n",
+	   name, name, name, anchored ? "1" : "start >= end", name, name);
+  if (ferror (out))
+    err = REG_ESPACE;
+
+ out:
+  re_free (halt);
+  re_free (next);
+  re_free (g.table);
+  re_free (g.states);
+  return err;
+}
+
+int
+re_gen_c (FILE *out, const char *name, const char *pattern, int cflags)
+{
+  regex_t r;
+  re_dfa_t *dfa;
+  int ret = regcomp (&r, pattern, cflags);
+
+  if (ret != REG_NOERROR)
+    return ret;
+  dfa = r.buffer;
+  if (dfa->nbackref || dfa->has_mb_node || dfa->mb_cur_max > 1)
+    ret = REG_BADPAT;
+  else
+    ret = gen_code (out, &r, name, pattern, cflags);
+  regfree (&r);
+  return ret;
+}
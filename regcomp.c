@@ -32,6 +32,7 @@ static reg_errcode_t create_initial_state (re_dfa_t *dfa);
 static void optimize_utf8 (re_dfa_t *dfa);
 #endif
 static reg_errcode_t analyze (regex_t *preg);
+static reg_errcode_t extract_literals (re_dfa_t *dfa);
 static reg_errcode_t preorder (bin_tree_t *root,
 			       reg_errcode_t (fn (void *, bin_tree_t *)),
 			       void *extra);
@@ -616,6 +617,8 @@ free_dfa_content (re_dfa_t *dfa)
 {
   Idx i, j;
 
+  if (dfa->bool_set)
+    re_set_free (dfa->bool_set);
   if (dfa->nodes)
     for (i = 0; i < dfa->nodes_len; ++i)
       free_token (dfa->nodes + i);
@@ -646,6 +649,10 @@ free_dfa_content (re_dfa_t *dfa)
 	re_free (entry->array);
       }
   re_free (dfa->state_table);
+#ifndef _LIBC
+  my_rwlock_deinit (&dfa->state_table_lock);
+  my_mutex_deinit (&dfa->trtable_lock);
+#endif
 #ifdef RE_ENABLE_I18N
   if (dfa->sb_char != utf8_sb_map)
     re_free (dfa->sb_char);
@@ -837,6 +844,16 @@ re_compile_internal (regex_t *preg, const char * pattern, size_t length,
     optimize_utf8 (dfa);
 #endif
 
+  /* Literals are searched for in the raw input, so the input must not be
+     translated in any way.  */
+  if (regex_prefilter_enabled && dfa->mb_cur_max == 1
+      && !(syntax & RE_ICASE) && preg->translate == NULL)
+    {
+      err = extract_literals (dfa);
+      if (BE (err != REG_NOERROR, 0))
+	goto re_compile_internal_free_return;
+    }
+
   /* Then create the initial state of the dfa.  */
   err = create_initial_state (dfa);
 
@@ -877,6 +894,10 @@ init_dfa (re_dfa_t *dfa, size_t pat_len)
 			max_i18n_object_size))));
 
   memset (dfa, '\0', sizeof (re_dfa_t));
+#ifndef _LIBC
+  my_rwlock_init (&dfa->state_table_lock);
+  my_mutex_init (&dfa->trtable_lock);
+#endif
 
   /* Force allocation of str_tree_storage the first time.  */
   dfa->str_tree_storage_idx = BIN_TREE_STORAGE_SIZE;
@@ -1265,6 +1286,182 @@ analyze (regex_t *preg)
   return ret;
 }
 
+bool regex_prefilter_enabled = true;
+
+/* Functions for extracting required literals from the tree.
+
+   For each subtree we compute: whether it matches exactly one string,
+   the literal every match of it starts with, the one every match ends
+   with, and the longest one every match contains.  Literals longer than
+   RE_LITERAL_MAX are truncated, which is harmless: a part of a required
+   literal is required as well.  Anything except characters, anchors,
+   concatenations and alternatives is treated as unknown.  */
+
+typedef struct
+{
+  bool exact;
+  re_literal_t left, right, in;
+} re_literals_t;
+
+typedef struct
+{
+  re_literals_t *stack;
+  Idx num, alloc;
+} literals_work_t;
+
+static void
+literal_concat (re_literal_t *dst, const re_literal_t *a,
+		const re_literal_t *b, bool keep_tail)
+{
+  unsigned char buf[2 * RE_LITERAL_MAX];
+  Idx len = a->len + b->len;
+
+  memcpy (buf, a->s, a->len);
+  memcpy (buf + a->len, b->s, b->len);
+  if (len > RE_LITERAL_MAX)
+    {
+      memcpy (dst->s, keep_tail ? buf + len - RE_LITERAL_MAX : buf,
+	      RE_LITERAL_MAX);
+      dst->len = RE_LITERAL_MAX;
+    }
+  else
+    {
+      memcpy (dst->s, buf, len);
+      dst->len = len;
+    }
+}
+
+static const re_literal_t *
+literal_longest (const re_literal_t *a, const re_literal_t *b)
+{
+  return b->len > a->len ? b : a;
+}
+
+static void
+literals_concat (re_literals_t *r, const re_literals_t *a,
+		 const re_literals_t *b)
+{
+  re_literal_t mid;
+  const re_literal_t *in;
+
+  r->exact = (a->exact && b->exact
+	      && a->left.len + b->left.len <= RE_LITERAL_MAX);
+  if (a->exact)
+    literal_concat (&r->left, &a->left, &b->left, false);
+  else
+    r->left = a->left;
+  if (b->exact)
+    literal_concat (&r->right, &a->right, &b->right, true);
+  else
+    r->right = b->right;
+  literal_concat (&mid, &a->right, &b->left, false);
+
+  in = literal_longest (&a->in, &b->in);
+  in = literal_longest (in, &mid);
+  in = literal_longest (in, &r->left);
+  in = literal_longest (in, &r->right);
+  r->in = *in;
+}
+
+static void
+literals_alt (re_literals_t *r, const re_literals_t *a, const re_literals_t *b)
+{
+  Idx i;
+
+  r->exact = (a->exact && b->exact && a->left.len == b->left.len
+	      && memcmp (a->left.s, b->left.s, a->left.len) == 0);
+  for (i = 0; i < a->left.len && i < b->left.len
+	      && a->left.s[i] == b->left.s[i]; ++i)
+    ;
+  r->left.len = i;
+  memcpy (r->left.s, a->left.s, i);
+  for (i = 0; i < a->right.len && i < b->right.len
+	      && (a->right.s[a->right.len - 1 - i]
+		  == b->right.s[b->right.len - 1 - i]); ++i)
+    ;
+  r->right.len = i;
+  memcpy (r->right.s, a->right.s + a->right.len - i, i);
+  r->in = *literal_longest (&r->left, &r->right);
+}
+
+static reg_errcode_t
+calc_literals (void *extra, bin_tree_t *node)
+{
+  literals_work_t *work = (literals_work_t *) extra;
+  re_literals_t a, b, r;
+
+  /* Exact empty string, for missing children.  */
+  memset (&b, '\0', sizeof (re_literals_t));
+  b.exact = true;
+  a = b;
+  if (node->right != NULL)
+    b = work->stack[--work->num];
+  if (node->left != NULL)
+    a = work->stack[--work->num];
+
+  memset (&r, '\0', sizeof (re_literals_t));
+  switch (node->token.type)
+    {
+    case CHARACTER:
+      r.exact = true;
+      r.left.len = 1;
+      r.left.s[0] = node->token.opr.c;
+      r.right = r.in = r.left;
+      break;
+    case ANCHOR:
+    case OP_OPEN_SUBEXP:
+    case OP_CLOSE_SUBEXP:
+    case END_OF_RE:
+      r.exact = true;
+      break;
+    case SUBEXP:
+      r = a;
+      break;
+    case CONCAT:
+      literals_concat (&r, &a, &b);
+      break;
+    case OP_ALT:
+      literals_alt (&r, &a, &b);
+      break;
+    default:
+      break;
+    }
+
+  if (work->num == work->alloc)
+    {
+      Idx new_alloc = 2 * work->alloc + 16;
+      re_literals_t *new_stack = re_realloc (work->stack, re_literals_t,
+					     new_alloc);
+      if (BE (new_stack == NULL, 0))
+	return REG_ESPACE;
+      work->stack = new_stack;
+      work->alloc = new_alloc;
+    }
+  work->stack[work->num++] = r;
+  return REG_NOERROR;
+}
+
+/* Set dfa->prefix and dfa->must.  A single character prefix is left
+   to the fastmap.  */
+
+static reg_errcode_t
+extract_literals (re_dfa_t *dfa)
+{
+  literals_work_t work;
+  reg_errcode_t err;
+
+  memset (&work, '\0', sizeof (literals_work_t));
+  err = postorder (dfa->str_tree, calc_literals, &work);
+  if (err == REG_NOERROR)
+    {
+      if (work.stack[0].left.len >= 2)
+	dfa->prefix = work.stack[0].left;
+      dfa->must = work.stack[0].in;
+    }
+  re_free (work.stack);
+  return err;
+}
+
 /* Our parse trees are very unbalanced, so we cannot use a stack to
    implement parse tree visits.  Instead, we use parent pointers and
    some hairy code in these two functions.  */
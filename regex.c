@@ -69,10 +69,15 @@
 
 #include "regex.h"
 #include "regex_internal.h"
+#include "regex_helpers.h"
 
 #include "regex_internal.c"
 #include "regcomp.c"
 #include "regexec.c"
+#include "regstream.c"
+#include "regset.c"
+#include "regsave.c"
+#include "regcgen.c"
 
 /* Binary backward compatibility.  */
 #if _LIBC
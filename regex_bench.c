@@ -0,0 +1,222 @@
+/*
+ *             _        _   _
+ *            | |      | | | |
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// regex engine benchmark: compile time, throughput and allocations per pattern class
+//
+// output is tab-separated, one line per pattern, to be compared release to release:
+//   class, pattern, flags (E=REG_EXTENDED, i=REG_ICASE, n=REG_NEWLINE), nmatch,
+//   compile_us: regcomp()+regfree() time,
+//   compile_allocs: allocations done by regcomp(),
+//   first_mibs: throughput of the first pass, while DFA states are built,
+//   mibs: throughput of next passes,
+//   matches: number of matches in the input (all of them are found, as in grep -o),
+//   allocs_per_call: allocations per regexec() call in next passes
+//
+// allocations are counted only in _DEBUG builds; for meaningful timings, build with -O2
+// to profile one class: perf record ./regex_bench backref
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+#define TEXT_LINES 8000
+#define LONG_LINE_SIZE (1*_1MiB)
+#define COMPILE_ROUNDS 200
+// each pattern is matched for at least this number of seconds
+#define MIN_TIME 0.2
+
+enum input_kind { INPUT_TEXT, INPUT_LONG_LINE };
+
+struct bench_case
+{
+	const char *class;
+	const char *pattern;
+	int cflags;
+	size_t nmatch;
+	enum input_kind input;
+};
+
+static struct bench_case cases[]=
+{
+	{ "literal", "upstream timeout", REG_EXTENDED, 1, INPUT_TEXT },
+	{ "literal", "id=12345", REG_EXTENDED, 1, INPUT_TEXT },
+	{ "literal", "\\.example\\.com id=", 0, 1, INPUT_TEXT },
+	{ "alternation", "cache miss|connection reset|upstream timeout", REG_EXTENDED, 1, INPUT_TEXT },
+	{ "alternation", "(INFO|WARN|ERROR): (request|cache)", REG_EXTENDED, 3, INPUT_TEXT },
+	{ "alternation", "(GET|PUT|POST|DELETE|HEAD) /[a-z]+/[0-9]+", REG_EXTENDED, 2, INPUT_TEXT },
+	{ "class", "[0-9]+ms", REG_EXTENDED, 1, INPUT_TEXT },
+	{ "class", "[A-Z]+: [a-z]+ [a-z]+", REG_EXTENDED, 1, INPUT_TEXT },
+	{ "subexp", "id=([0-9]+) took ([0-9]+)ms", REG_EXTENDED, 3, INPUT_TEXT },
+	{ "subexp", "(([a-z]+) )+took", REG_EXTENDED, 3, INPUT_TEXT },
+	{ "backref", "([0-9])\\1", REG_EXTENDED, 2, INPUT_TEXT },
+	{ "backref", "\\([a-z]\\)\\1", 0, 2, INPUT_TEXT },
+	{ "backref", "(svc[0-9]+) .* \\1", REG_EXTENDED | REG_NEWLINE, 2, INPUT_TEXT },
+	{ "anchor", "^2016-01-0[1-5]", REG_EXTENDED | REG_NEWLINE, 1, INPUT_TEXT },
+	{ "anchor", "[0-9]ms$", REG_EXTENDED | REG_NEWLINE, 1, INPUT_TEXT },
+	{ "anchor", "\\btook\\b", REG_EXTENDED, 1, INPUT_TEXT },
+	{ "icase", "upstream TIMEOUT", REG_EXTENDED | REG_ICASE, 1, INPUT_TEXT },
+	{ "icase", "error: .* timeout", REG_EXTENDED | REG_ICASE | REG_NEWLINE, 1, INPUT_TEXT },
+	{ "icase", "(get|post) /API/", REG_EXTENDED | REG_ICASE, 2, INPUT_TEXT },
+	{ "long", "x[0-9]+y", REG_EXTENDED, 1, INPUT_LONG_LINE },
+	{ "long", "(ab|cd)+e", REG_EXTENDED, 2, INPUT_LONG_LINE },
+	{ "long", "a.*z$", REG_EXTENDED, 1, INPUT_LONG_LINE },
+};
+
+static const char *levels[]={ "INFO", "DEBUG", "WARN", "ERROR" };
+static const char *msgs[]={ "request served", "cache miss", "connection reset", "upstream timeout" };
+static const char *methods[]={ "GET", "PUT", "POST", "DELETE", "get" };
+
+static char *make_text (size_t *size)
+{
+	char *buf=DMALLOC(char, TEXT_LINES*160, "text");
+	size_t pos=0;
+
+	for (size_t l=0; l<TEXT_LINES; l++)
+	{
+		unsigned h=l*2654435761U;
+		pos+=sprintf (buf+pos, "2016-01-%02d 12:%02d:%02d %s: %s %s /%s/%u svc%u.example.com id=%u took %ums\n",
+				1+h%28, (h>>5)%60, (h>>11)%60, levels[(h>>17)%4], msgs[(h>>20)%4],
+				methods[(h>>9)%5], (h>>13)%3 ? "api" : "static", h%100000, (h>>23)%16, h%1000000, (h>>3)%2000);
+	};
+	*size=pos;
+	return buf;
+};
+
+// a single line without newlines, mostly matching prefixes which fail later
+static char *make_long_line (size_t *size)
+{
+	char *buf=DMALLOC(char, LONG_LINE_SIZE, "long line");
+	const char *chunk="abcdabx1234ab cdcdabab ";
+	size_t chunk_len=strlen (chunk);
+
+	for (size_t pos=0; pos<LONG_LINE_SIZE; pos++)
+		buf[pos]=chunk[pos%chunk_len];
+	// a single match in the middle and at the end
+	memcpy (buf+LONG_LINE_SIZE/2, "x42y abcde", 10);
+	memcpy (buf+LONG_LINE_SIZE-4, "ez z", 4);
+	*size=LONG_LINE_SIZE;
+	return buf;
+};
+
+static const char *flags_to_string (int cflags, char *buf)
+{
+	char *p=buf;
+	if (cflags & REG_EXTENDED)
+		*p++='E';
+	if (cflags & REG_ICASE)
+		*p++='i';
+	if (cflags & REG_NEWLINE)
+		*p++='n';
+	if (p==buf)
+		*p++='-';
+	*p=0;
+	return buf;
+};
+
+// find all matches in the input, returns number of matches
+static octa match_all (regex_t *r, size_t nmatch, const char *input, size_t size, octa *calls)
+{
+	octa matched=0;
+	regmatch_t m[4];
+
+	oassert (nmatch>=1 && nmatch<=4);
+	for (size_t pos=0; pos<size; )
+	{
+		m[0].rm_so=pos;
+		m[0].rm_eo=size;
+		(*calls)++;
+		if (regexec (r, input, nmatch, m, REG_STARTEND))
+			break;
+		matched++;
+		pos=m[0].rm_eo>m[0].rm_so ? m[0].rm_eo : m[0].rm_eo+1;
+	};
+	return matched;
+};
+
+static void run_case (const struct bench_case *c, const char *input, size_t size)
+{
+	regex_t r;
+	char flags[8];
+	octa matched, calls=0, rounds=0;
+	size_t allocs;
+	double t, t_compile, t_first, elapsed, compile_allocs;
+
+	allocs=regex_alloc_calls();
+	t=get_monotonic_time();
+	for (int i=0; i<COMPILE_ROUNDS; i++)
+	{
+		regcomp_or_die (&r, c->pattern, c->cflags);
+		regfree (&r);
+	};
+	t_compile=(get_monotonic_time()-t)/COMPILE_ROUNDS;
+	compile_allocs=(double)(regex_alloc_calls()-allocs)/COMPILE_ROUNDS;
+
+	regcomp_or_die (&r, c->pattern, c->cflags);
+
+	t=get_monotonic_time();
+	matched=match_all (&r, c->nmatch, input, size, &calls);
+	t_first=get_monotonic_time()-t;
+
+	calls=0;
+	allocs=regex_alloc_calls();
+	t=get_monotonic_time();
+	do
+	{
+		oassert (match_all (&r, c->nmatch, input, size, &calls)==matched);
+		rounds++;
+		elapsed=get_monotonic_time()-t;
+	}
+	while (elapsed<MIN_TIME);
+	allocs=regex_alloc_calls()-allocs;
+
+	printf ("%s\t%s\t%s\t%d\t%.2f\t%.1f\t%.1f\t%.1f\t%d\t%.2f\n",
+			c->class, c->pattern, flags_to_string (c->cflags, flags), (int)c->nmatch,
+			t_compile*1000000, compile_allocs,
+			(double)size/_1MiB/t_first, (double)size*rounds/_1MiB/elapsed,
+			(int)matched, (double)allocs/calls);
+	regfree (&r);
+};
+
+int main(int argc, char* argv[])
+{
+	size_t text_size, long_size;
+	char *text=make_text (&text_size);
+	char *long_line=make_long_line (&long_size);
+
+	if (argc>2)
+		die ("usage: %s [class]\n", argv[0]);
+
+	printf ("class\tpattern\tflags\tnmatch\tcompile_us\tcompile_allocs\tfirst_mibs\tmibs\tmatches\tallocs_per_call\n");
+	for (int i=0; i<sizeof(cases)/sizeof(cases[0]); i++)
+	{
+		if (argc==2 && strcmp (argv[1], cases[i].class))
+			continue;
+		if (cases[i].input==INPUT_TEXT)
+			run_case (&cases[i], text, text_size);
+		else
+			run_case (&cases[i], long_line, long_size);
+	};
+
+	DFREE (text);
+	DFREE (long_line);
+	dump_unfreed_blocks();
+};
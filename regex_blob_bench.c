@@ -0,0 +1,163 @@
+/*
+ *             _        _   _
+ *            | |      | | | |
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// cold start: regcomp() of each pattern vs re_blob_load() of saved blobs
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+#define PATTERNS 300
+#define LINES 200
+
+static const char *levels[]={ "INFO", "DEBUG", "WARN", "ERROR" };
+static const char *msgs[]={ "request served", "cache miss", "connection reset", "upstream timeout" };
+
+static char *make_log (size_t *size)
+{
+	char *buf=DMALLOC(char, LINES*128, "log");
+	size_t pos=0;
+
+	for (size_t l=0; l<LINES; l++)
+	{
+		unsigned h=l*2654435761U;
+		pos+=sprintf (buf+pos, "2016-01-%02d 12:%02d:%02d %s: svc%03u %s id=%u took %ums\n",
+				1+h%28, (h>>5)%60, (h>>11)%60, levels[(h>>17)%4], (h>>7)%150, msgs[(h>>20)%4], h%1000000, (h>>3)%2000);
+	};
+	*size=pos;
+	return buf;
+};
+
+static void make_pattern (int i, char *buf)
+{
+	switch (i%3)
+	{
+		case 0:
+			sprintf (buf, "%s: svc%03d (%s|%s)", levels[i%4], i/2, msgs[i%4], msgs[(i/4)%4]);
+			break;
+		case 1:
+			sprintf (buf, "svc%03d .* took %d[0-9]ms", i/2, i%10);
+			break;
+		default:
+			sprintf (buf, "id=%d[0-9]{3}\\b", 100+i);
+			break;
+	};
+};
+
+static octa classify (regex_t *rs, char *log, size_t size)
+{
+	octa matched=0;
+	regmatch_t m[1];
+
+	for (size_t pos=0; pos<size; )
+	{
+		char *eol=memchr (log+pos, '\n', size-pos);
+		m[0].rm_so=pos;
+		m[0].rm_eo=eol-log;
+		for (int p=0; p<PATTERNS; p++)
+			if (regexec (&rs[p], log, 1, m, REG_STARTEND)==0)
+				matched++;
+		pos=eol-log+1;
+	};
+	return matched;
+};
+
+struct blobs
+{
+	void *blob[PATTERNS];
+	size_t len[PATTERNS];
+};
+
+static size_t save_all (regex_t *rs, bool with_states, struct blobs *b)
+{
+	size_t total=0;
+	for (int p=0; p<PATTERNS; p++)
+	{
+		oassert (re_blob_save (&rs[p], with_states, &b->blob[p], &b->len[p])==0);
+		total+=b->len[p];
+	};
+	return total;
+};
+
+// returns time of loading, then time of first classification pass
+static void load_and_run (struct blobs *b, char *log, size_t size, octa expected, double *t_load, double *t_run)
+{
+	regex_t *rs=DMALLOC(regex_t, PATTERNS, "regex_t");
+	double t=get_monotonic_time();
+
+	for (int p=0; p<PATTERNS; p++)
+		oassert (re_blob_load (&rs[p], b->blob[p], b->len[p])==0);
+	*t_load=get_monotonic_time()-t;
+
+	t=get_monotonic_time();
+	oassert (classify (rs, log, size)==expected);
+	*t_run=get_monotonic_time()-t;
+
+	for (int p=0; p<PATTERNS; p++)
+		regfree (&rs[p]);
+	DFREE (rs);
+};
+
+int main()
+{
+	size_t size, cold_size, warm_size;
+	char *log=make_log (&size);
+	regex_t *rs=DMALLOC(regex_t, PATTERNS, "regex_t");
+	struct blobs cold, warm;
+	char buf[128];
+	octa matched;
+	double t, t_comp, t_first, t_load[2], t_run[2];
+
+	t=get_monotonic_time();
+	for (int p=0; p<PATTERNS; p++)
+	{
+		make_pattern (p, buf);
+		regcomp_or_die (&rs[p], buf, REG_EXTENDED | REG_NOSUB);
+	};
+	t_comp=get_monotonic_time()-t;
+	cold_size=save_all (rs, true, &cold);
+
+	// DFA states are built lazily during the first pass
+	t=get_monotonic_time();
+	matched=classify (rs, log, size);
+	t_first=get_monotonic_time()-t;
+	warm_size=save_all (rs, true, &warm);
+
+	load_and_run (&cold, log, size, matched, &t_load[0], &t_run[0]);
+	load_and_run (&warm, log, size, matched, &t_load[1], &t_run[1]);
+
+	printf ("%d patterns, %d lines, %d matches\n", PATTERNS, LINES, (int)matched);
+	printf ("                 startup ms   first pass ms   total ms   blobs KB\n");
+	printf ("regcomp():       %10.2f   %13.2f   %8.2f\n", t_comp*1000, t_first*1000, (t_comp+t_first)*1000);
+	printf ("cold blobs:      %10.2f   %13.2f   %8.2f   %8.1f\n", t_load[0]*1000, t_run[0]*1000, (t_load[0]+t_run[0])*1000, cold_size/1024.0);
+	printf ("warm blobs:      %10.2f   %13.2f   %8.2f   %8.1f\n", t_load[1]*1000, t_run[1]*1000, (t_load[1]+t_run[1])*1000, warm_size/1024.0);
+
+	for (int p=0; p<PATTERNS; p++)
+	{
+		regfree (&rs[p]);
+		free (cold.blob[p]);
+		free (warm.blob[p]);
+	};
+	DFREE (rs);
+	DFREE (log);
+	dump_unfreed_blocks();
+};
@@ -0,0 +1,109 @@
+/*
+ *             _        _   _
+ *            | |      | | | |
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// line filter: regexec() with REG_NOSUB, with and without pure DFA matching, vs memchr()
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+#define LINES 200000
+#define ROUNDS 5
+
+static const char *pats[]={ "ERROR: .* timeout", "(cache|upstream) (miss|timeout)", "[0-9]{4}ms$",
+	"\\bWARN\\b.*reset", "took [0-9]+ms", "id=12345[0-9]" };
+
+static char *make_log (size_t *size)
+{
+	const char *levels[]={ "INFO", "DEBUG", "WARN", "ERROR" };
+	const char *msgs[]={ "request served", "cache miss", "connection reset", "upstream timeout" };
+	char *buf=DMALLOC(char, LINES*128, "log");
+	size_t pos=0;
+
+	for (size_t l=0; l<LINES; l++)
+	{
+		unsigned h=l*2654435761U;
+		pos+=sprintf (buf+pos, "2016-01-%02d 12:%02d:%02d %s: %s id=%u took %ums\n",
+				1+h%28, (h>>5)%60, (h>>11)%60, levels[(h>>17)%4], msgs[(h>>20)%4], h%1000000, (h>>3)%2000);
+	};
+	*size=pos;
+	return buf;
+};
+
+// count matching lines
+static int filter_lines (regex_t *r, char *log, size_t size)
+{
+	int matched=0;
+	regmatch_t m[1];
+
+	for (size_t pos=0; pos<size; )
+	{
+		char *eol=memchr (log+pos, '\n', size-pos);
+		m[0].rm_so=pos;
+		m[0].rm_eo=eol-log;
+		if (regexec (r, log, 0, m, REG_STARTEND)==0)
+			matched++;
+		pos=eol-log+1;
+	};
+	return matched;
+};
+
+int main()
+{
+	size_t size;
+	char *log=make_log (&size);
+	double t, speed[2], memchr_speed;
+	volatile size_t nonzero=0;
+
+	// just splitting into lines, the upper bound
+	t=get_monotonic_time();
+	for (int i=0; i<ROUNDS; i++)
+		for (char *p=log; (p=memchr (p, '\n', log+size-p))!=NULL; p++)
+			nonzero++;
+	memchr_speed=(double)size*ROUNDS/_1MiB/(get_monotonic_time()-t);
+	printf ("memchr() by line: %8.1f MiB/s\n", memchr_speed);
+
+	for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+	{
+		int matched[2];
+		regex_t r;
+
+		regcomp_or_die (&r, pats[p], REG_EXTENDED | REG_NOSUB | REG_NEWLINE);
+		for (int dfa=0; dfa<2; dfa++)
+		{
+			regex_bool_dfa_enabled=dfa;
+			t=get_monotonic_time();
+			for (int i=0; i<ROUNDS; i++)
+				matched[dfa]=filter_lines (&r, log, size);
+			speed[dfa]=(double)size*ROUNDS/_1MiB/(get_monotonic_time()-t);
+		};
+		oassert (matched[0]==matched[1]);
+		printf ("[%s]: %d lines\n", pats[p], matched[1]);
+		printf ("  %8.1f -> %8.1f MiB/s (x%.1f), %.0f%% of memchr()\n", speed[0], speed[1], speed[1]/speed[0],
+				speed[1]*100/memchr_speed);
+		regfree (&r);
+	};
+
+	regex_bool_dfa_enabled=true;
+	DFREE(log);
+	dump_unfreed_blocks();
+};
@@ -0,0 +1,84 @@
+/*
+ *             _        _   _
+ *            | |      | | | |
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// build-time tool: generates C matchers for constant patterns, see re_gen_c()
+// usage: regex_gen <spec> <out.c>
+// each line of spec is: name flags pattern
+//   flags: any of E (REG_EXTENDED), i (REG_ICASE), n (REG_NEWLINE), s (REG_NOSUB), or - for none
+//   the pattern is the rest of line, as is; empty lines and lines starting with # are skipped
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "stuff.h"
+#include "files.h"
+
+static int parse_flags (const char *s, const char *fname, int line)
+{
+	int cflags=0;
+
+	if (strcmp (s, "-")==0)
+		return 0;
+	for (; *s; s++)
+		switch (*s)
+		{
+			case 'E': cflags|=REG_EXTENDED; break;
+			case 'i': cflags|=REG_ICASE; break;
+			case 'n': cflags|=REG_NEWLINE; break;
+			case 's': cflags|=REG_NOSUB; break;
+			default:
+				die ("%s:%d: unknown flag '%c'\n", fname, line, *s);
+		};
+	return cflags;
+};
+
+int main(int argc, char* argv[])
+{
+	char buf[4096], name[128], flags[16], errbuf[128];
+	int line=0, pattern_ofs, rc;
+
+	if (argc!=3)
+		die ("usage: %s <spec> <out.c>\n", argv[0]);
+
+	FILE *in=fopen_or_die (argv[1], "r");
+	FILE *out=fopen_or_die (argv[2], "w");
+
+	fprintf (out, "/* Generated by regex_gen from %s, do not edit.  */\n\n", argv[1]);
+	fprintf (out, "#include <stdbool.h>\n#include <string.h>\n\n#include \"regex.h\"\n#include \"regex_helpers.h\"\n\n");
+
+	while (fgets (buf, sizeof(buf), in))
+	{
+		line++;
+		buf[strcspn (buf, "\r\n")]=0;
+		if (buf[0]==0 || buf[0]=='#')
+			continue;
+		if (sscanf (buf, "%127s %15s %n", name, flags, &pattern_ofs)!=2)
+			die ("%s:%d: can't parse [%s]\n", argv[1], line, buf);
+		rc=re_gen_c (out, name, buf+pattern_ofs, parse_flags (flags, argv[1], line));
+		if (rc)
+		{
+			regerror (rc, NULL, errbuf, sizeof(errbuf));
+			die ("%s:%d: %s: %s\n", argv[1], line, buf+pattern_ofs, errbuf);
+		};
+	};
+
+	fclose (in);
+	if (fclose (out))
+		die ("%s: write error\n", argv[2]);
+};
@@ -0,0 +1,141 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// generated matchers (regex_gen_test.gen.c, made by regex_gen from regex_gen_test.spec)
+// are compared with regexec() over a fuzz corpus
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "rand.h"
+
+#include "regex_gen_test.gen.c"
+
+typedef int (*gen_fn)(const char *string, size_t nmatch, regmatch_t pmatch[], int eflags);
+
+#define GEN(name) { #name, name, name##_pattern, name##_cflags }
+
+struct gen_case
+{
+    const char *name;
+    gen_fn fn;
+    const char *pattern;
+    int cflags;
+};
+
+static struct gen_case cases[]=
+{
+    GEN(gen_literal), GEN(gen_literal_icase), GEN(gen_class), GEN(gen_alt), GEN(gen_alt_sub),
+    GEN(gen_star), GEN(gen_dot_star), GEN(gen_empty_alt), GEN(gen_dot), GEN(gen_dot_nl), GEN(gen_bol),
+    GEN(gen_eol), GEN(gen_bol_nl), GEN(gen_word), GEN(gen_word2), GEN(gen_nonword), GEN(gen_notword),
+    GEN(gen_nested), GEN(gen_bounded), GEN(gen_neg_class), GEN(gen_basic), GEN(gen_nosub),
+    GEN(gen_quote),
+};
+
+#define ROUNDS 3000
+#define MAX_LEN 40
+
+static const char alphabet[]="aabbccdzAB HELLOworld09-?\"\\\n\x80\xff";
+
+// [begin, end], unlike rand_reg(), begin==end is allowed
+static int rnd (int begin, int end)
+{
+    return begin==end ? begin : rand_reg (begin, end);
+};
+
+static void make_string (char *buf, int len)
+{
+    for (int i=0; i<len; i++)
+        buf[i]=alphabet[rand_reg (0, sizeof(alphabet)-2)];
+    buf[len]=0;
+    // plant a piece of some pattern now and then
+    if (len>12 && rand_bernoulli_distribution (0.3))
+    {
+        const char *p=cases[rand_reg (0, sizeof(cases)/sizeof(cases[0])-1)].pattern;
+        size_t plen=strlen (p);
+        size_t ofs=rand_reg (0, len-12);
+        memcpy (buf+ofs, p, plen<12 ? plen : 12);
+    };
+};
+
+static void compare (struct gen_case *c, regex_t *r, const char *buf, int len, int *matches)
+{
+    static const int eflags_variants[]={ 0, REG_NOTBOL, REG_NOTEOL, REG_NOTBOL | REG_NOTEOL };
+    static const size_t nmatch_variants[]={ 0, 1, 3 };
+    regmatch_t m1[3], m2[3];
+
+    for (int e=0; e<4; e++)
+        for (int n=0; n<3; n++)
+            for (int startend=0; startend<2; startend++)
+            {
+                int eflags=eflags_variants[e] | (startend ? REG_STARTEND : 0);
+                size_t nmatch=nmatch_variants[n];
+
+                memset (m1, 0x5a, sizeof(m1));
+                memset (m2, 0x5a, sizeof(m2));
+                if (startend)
+                {
+                    m1[0].rm_so=m2[0].rm_so=rnd (0, len);
+                    m1[0].rm_eo=m2[0].rm_eo=rnd (m1[0].rm_so, len);
+                };
+                int rc1=regexec (r, buf, nmatch, m1, eflags);
+                int rc2=c->fn (buf, nmatch, m2, eflags);
+                if (rc1!=rc2 || (rc1==0 && memcmp (m1, m2, sizeof(m1))))
+                {
+                    printf ("%s: [%s] on [%s] nmatch=%d eflags=%d: %d vs %d\n", c->name, c->pattern, buf,
+                            (int)nmatch, eflags, rc1, rc2);
+                    for (size_t i=0; i<nmatch; i++)
+                        printf ("  %d: %d-%d vs %d-%d\n", (int)i, (int)m1[i].rm_so, (int)m1[i].rm_eo,
+                                (int)m2[i].rm_so, (int)m2[i].rm_eo);
+                    oassert (0);
+                };
+                if (rc1==0)
+                    (*matches)++;
+            };
+};
+
+int main()
+{
+    char buf[MAX_LEN+1];
+    int matches=0, strings=0;
+
+    sgenrand (1);
+    for (int i=0; i<sizeof(cases)/sizeof(cases[0]); i++)
+    {
+        regex_t r;
+        regcomp_or_die (&r, cases[i].pattern, cases[i].cflags);
+        for (int round=0; round<ROUNDS; round++)
+        {
+            int len=rnd (0, MAX_LEN);
+            make_string (buf, len);
+            compare (&cases[i], &r, buf, len, &matches);
+            strings++;
+        };
+        regfree (&r);
+    };
+    printf ("regex gen: %d patterns, %d strings, %d matches\n", (int)(sizeof(cases)/sizeof(cases[0])), strings, matches);
+
+    regcache_clear ();
+    dump_unfreed_blocks();
+    return 0;
+};
+
+/* vim: set expandtab ts=4 sw=4 : */
@@ -0,0 +1,4126 @@
+/* Generated by regex_gen from regex_gen_test.spec, do not edit.  */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+
+/* Generated by re_gen_c() from gen_literal_pattern, do not edit.  */
+
+static const char gen_literal_pattern[] = "abc";
+static const int gen_literal_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_literal_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_literal_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_literal_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_literal_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_literal_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 99:
+      goto s3;
+    default:
+      return last;
+    }
+ s3:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_literal (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_literal_first[s[start]])
+	++start;
+      if (start == end && !gen_literal_first[0])
+	return REG_NOMATCH;
+      state = gen_literal_init[start == 0 ? bof_ctx : gen_literal_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_literal_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_literal_pattern, gen_literal_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_literal_icase_pattern, do not edit.  */
+
+static const char gen_literal_icase_pattern[] = "hello world";
+static const int gen_literal_icase_cflags = 3;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_literal_icase_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_literal_icase_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_literal_icase_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_literal_icase_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_literal_icase_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 72: case 104:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 69: case 101:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 76: case 108:
+      goto s3;
+    default:
+      return last;
+    }
+ s3:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 76: case 108:
+      goto s4;
+    default:
+      return last;
+    }
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 79: case 111:
+      goto s5;
+    default:
+      return last;
+    }
+ s5:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 32:
+      goto s6;
+    default:
+      return last;
+    }
+ s6:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 87: case 119:
+      goto s7;
+    default:
+      return last;
+    }
+ s7:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 79: case 111:
+      goto s8;
+    default:
+      return last;
+    }
+ s8:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 82: case 114:
+      goto s9;
+    default:
+      return last;
+    }
+ s9:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 76: case 108:
+      goto s10;
+    default:
+      return last;
+    }
+ s10:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 68: case 100:
+      goto s11;
+    default:
+      return last;
+    }
+ s11:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_literal_icase (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_literal_icase_first[s[start]])
+	++start;
+      if (start == end && !gen_literal_icase_first[0])
+	return REG_NOMATCH;
+      state = gen_literal_icase_init[start == 0 ? bof_ctx : gen_literal_icase_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_literal_icase_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_literal_icase_pattern, gen_literal_icase_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_class_pattern, do not edit.  */
+
+static const char gen_class_pattern[] = "a[0-9]+z";
+static const int gen_class_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_class_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_class_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_class_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_class_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_class_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 48: case 49: case 50: case 51: case 52: case 53: case 54: case 55:
+    case 56: case 57:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 48: case 49: case 50: case 51: case 52: case 53: case 54: case 55:
+    case 56: case 57:
+      goto s2;
+    case 122:
+      goto s3;
+    default:
+      return last;
+    }
+ s3:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_class (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_class_first[s[start]])
+	++start;
+      if (start == end && !gen_class_first[0])
+	return REG_NOMATCH;
+      state = gen_class_init[start == 0 ? bof_ctx : gen_class_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_class_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_class_pattern, gen_class_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_alt_pattern, do not edit.  */
+
+static const char gen_alt_pattern[] = "cat|dog|bird";
+static const int gen_alt_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_alt_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_alt_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_alt_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_alt_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_alt_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s1;
+    case 99:
+      goto s2;
+    case 100:
+      goto s3;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 105:
+      goto s4;
+    default:
+      return last;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    default:
+      return last;
+    }
+ s3:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 111:
+      goto s6;
+    default:
+      return last;
+    }
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 114:
+      goto s7;
+    default:
+      return last;
+    }
+ s5:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 116:
+      goto s8;
+    default:
+      return last;
+    }
+ s6:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 103:
+      goto s8;
+    default:
+      return last;
+    }
+ s7:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 100:
+      goto s8;
+    default:
+      return last;
+    }
+ s8:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_alt (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_alt_first[s[start]])
+	++start;
+      if (start == end && !gen_alt_first[0])
+	return REG_NOMATCH;
+      state = gen_alt_init[start == 0 ? bof_ctx : gen_alt_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_alt_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_alt_pattern, gen_alt_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_alt_sub_pattern, do not edit.  */
+
+static const char gen_alt_sub_pattern[] = "(ab|cd)+e";
+static const int gen_alt_sub_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_alt_sub_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_alt_sub_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_alt_sub_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_alt_sub_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_alt_sub_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    case 99:
+      goto s2;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s3;
+    default:
+      return last;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 100:
+      goto s3;
+    default:
+      return last;
+    }
+ s3:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s4;
+    case 99:
+      goto s5;
+    case 101:
+      goto s6;
+    default:
+      return last;
+    }
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s7;
+    default:
+      return last;
+    }
+ s5:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 100:
+      goto s7;
+    default:
+      return last;
+    }
+ s6:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+ s7:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s4;
+    case 99:
+      goto s5;
+    case 101:
+      goto s6;
+    default:
+      return last;
+    }
+}
+
+int
+gen_alt_sub (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_alt_sub_first[s[start]])
+	++start;
+      if (start == end && !gen_alt_sub_first[0])
+	return REG_NOMATCH;
+      state = gen_alt_sub_init[start == 0 ? bof_ctx : gen_alt_sub_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_alt_sub_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_alt_sub_pattern, gen_alt_sub_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_star_pattern, do not edit.  */
+
+static const char gen_star_pattern[] = "a*";
+static const int gen_star_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_star_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_star_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_star_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_star_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s0;
+    default:
+      return last;
+    }
+}
+
+int
+gen_star (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      state = gen_star_init[start == 0 ? bof_ctx : gen_star_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_star_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_star_pattern, gen_star_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_dot_star_pattern, do not edit.  */
+
+static const char gen_dot_star_pattern[] = ".*";
+static const int gen_dot_star_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_dot_star_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_dot_star_first[256] =
+{
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_dot_star_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_dot_star_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_dot_star_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 0:
+      return last;
+    default:
+      goto s0;
+    }
+}
+
+int
+gen_dot_star (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_dot_star_first[s[start]])
+	++start;
+      if (start == end && !gen_dot_star_first[0])
+	return REG_NOMATCH;
+      state = gen_dot_star_init[start == 0 ? bof_ctx : gen_dot_star_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_dot_star_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_dot_star_pattern, gen_dot_star_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_empty_alt_pattern, do not edit.  */
+
+static const char gen_empty_alt_pattern[] = "x|";
+static const int gen_empty_alt_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_empty_alt_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_empty_alt_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_empty_alt_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_empty_alt_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 120:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_empty_alt (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      state = gen_empty_alt_init[start == 0 ? bof_ctx : gen_empty_alt_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_empty_alt_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_empty_alt_pattern, gen_empty_alt_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_dot_pattern, do not edit.  */
+
+static const char gen_dot_pattern[] = "a.c";
+static const int gen_dot_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_dot_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_dot_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_dot_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_dot_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_dot_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 0:
+      return last;
+    default:
+      goto s2;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 99:
+      goto s3;
+    default:
+      return last;
+    }
+ s3:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_dot (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_dot_first[s[start]])
+	++start;
+      if (start == end && !gen_dot_first[0])
+	return REG_NOMATCH;
+      state = gen_dot_init[start == 0 ? bof_ctx : gen_dot_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_dot_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_dot_pattern, gen_dot_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_dot_nl_pattern, do not edit.  */
+
+static const char gen_dot_nl_pattern[] = "a.c";
+static const int gen_dot_nl_cflags = 5;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_dot_nl_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_dot_nl_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_dot_nl_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_dot_nl_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_dot_nl_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 0: case 10:
+      return last;
+    default:
+      goto s2;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 99:
+      goto s3;
+    default:
+      return last;
+    }
+ s3:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_dot_nl (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_dot_nl_first[s[start]])
+	++start;
+      if (start == end && !gen_dot_nl_first[0])
+	return REG_NOMATCH;
+      state = gen_dot_nl_init[start == 0 ? bof_ctx : gen_dot_nl_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_dot_nl_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_dot_nl_pattern, gen_dot_nl_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_bol_pattern, do not edit.  */
+
+static const char gen_bol_pattern[] = "^ab";
+static const int gen_bol_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_bol_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_bol_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_bol_init[16] =
+{
+  0, 1, 2, -1, 3, -1, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_bol_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_bol_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    case 1:
+      goto s1;
+    case 2:
+      goto s2;
+    case 3:
+      goto s3;
+    case 4:
+      goto s4;
+    }
+  return last;
+
+ s0:
+  return last;
+ s1:
+  return last;
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    default:
+      return last;
+    }
+ s3:
+  return last;
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    default:
+      return last;
+    }
+ s5:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s6;
+    default:
+      return last;
+    }
+ s6:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_bol (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+  /* The pattern is anchored.  */
+  if (start != 0)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_bol_first[s[start]])
+	++start;
+      if (start == end && !gen_bol_first[0])
+	return REG_NOMATCH;
+      state = gen_bol_init[start == 0 ? bof_ctx : gen_bol_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_bol_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (1)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_bol_pattern, gen_bol_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_eol_pattern, do not edit.  */
+
+static const char gen_eol_pattern[] = "ab$";
+static const int gen_eol_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_eol_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_eol_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_eol_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_eol_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_eol_ctx;
+  regoff_t last = -1;
+  unsigned int ctx;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  ctx = i == end ? eof_ctx : ctx_of[s[i]];
+  if ((0xcccc >> ctx) & 1)
+    {
+      last = i;
+      if (!longest)
+	return last;
+    }
+  return last;
+}
+
+int
+gen_eol (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_eol_first[s[start]])
+	++start;
+      if (start == end && !gen_eol_first[0])
+	return REG_NOMATCH;
+      state = gen_eol_init[start == 0 ? bof_ctx : gen_eol_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_eol_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_eol_pattern, gen_eol_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_bol_nl_pattern, do not edit.  */
+
+static const char gen_bol_nl_pattern[] = "^[a-c]+$";
+static const int gen_bol_nl_cflags = 5;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_bol_nl_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_bol_nl_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_bol_nl_init[16] =
+{
+  0, 1, 2, -1, 3, -1, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_bol_nl_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_bol_nl_ctx;
+  regoff_t last = -1;
+  unsigned int ctx;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    case 1:
+      goto s1;
+    case 2:
+      goto s2;
+    case 3:
+      goto s3;
+    case 4:
+      goto s4;
+    }
+  return last;
+
+ s0:
+  return last;
+ s1:
+  return last;
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99:
+      goto s5;
+    default:
+      return last;
+    }
+ s3:
+  return last;
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99:
+      goto s5;
+    default:
+      return last;
+    }
+ s5:
+  ctx = i == end ? eof_ctx : ctx_of[s[i]];
+  if ((0xcccc >> ctx) & 1)
+    {
+      last = i;
+      if (!longest)
+	return last;
+    }
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99:
+      goto s5;
+    default:
+      return last;
+    }
+}
+
+int
+gen_bol_nl (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_bol_nl_first[s[start]])
+	++start;
+      if (start == end && !gen_bol_nl_first[0])
+	return REG_NOMATCH;
+      state = gen_bol_nl_init[start == 0 ? bof_ctx : gen_bol_nl_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_bol_nl_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_bol_nl_pattern, gen_bol_nl_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_word_pattern, do not edit.  */
+
+static const char gen_word_pattern[] = "\\bab\\b";
+static const int gen_word_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_word_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_word_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_word_init[16] =
+{
+  0, 1, 2, -1, 3, -1, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_word_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_word_ctx;
+  regoff_t last = -1;
+  unsigned int ctx;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    case 1:
+      goto s1;
+    case 2:
+      goto s2;
+    case 3:
+      goto s3;
+    case 4:
+      goto s4;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    default:
+      return last;
+    }
+ s1:
+  return last;
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    default:
+      return last;
+    }
+ s3:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    default:
+      return last;
+    }
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    default:
+      return last;
+    }
+ s5:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s6;
+    default:
+      return last;
+    }
+ s6:
+  ctx = i == end ? eof_ctx : ctx_of[s[i]];
+  if ((0x5555 >> ctx) & 1)
+    {
+      last = i;
+      if (!longest)
+	return last;
+    }
+  return last;
+}
+
+int
+gen_word (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_word_first[s[start]])
+	++start;
+      if (start == end && !gen_word_first[0])
+	return REG_NOMATCH;
+      state = gen_word_init[start == 0 ? bof_ctx : gen_word_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_word_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_word_pattern, gen_word_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_word2_pattern, do not edit.  */
+
+static const char gen_word2_pattern[] = "\\<[a-z]+\\>";
+static const int gen_word2_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_word2_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_word2_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_word2_init[16] =
+{
+  0, 1, 2, -1, 3, -1, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_word2_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_word2_ctx;
+  regoff_t last = -1;
+  unsigned int ctx;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    case 1:
+      goto s1;
+    case 2:
+      goto s2;
+    case 3:
+      goto s3;
+    case 4:
+      goto s4;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99: case 100: case 101: case 102: case 103: case 104:
+    case 105: case 106: case 107: case 108: case 109: case 110: case 111: case 112:
+    case 113: case 114: case 115: case 116: case 117: case 118: case 119: case 120:
+    case 121: case 122:
+      goto s5;
+    default:
+      return last;
+    }
+ s1:
+  return last;
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99: case 100: case 101: case 102: case 103: case 104:
+    case 105: case 106: case 107: case 108: case 109: case 110: case 111: case 112:
+    case 113: case 114: case 115: case 116: case 117: case 118: case 119: case 120:
+    case 121: case 122:
+      goto s5;
+    default:
+      return last;
+    }
+ s3:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99: case 100: case 101: case 102: case 103: case 104:
+    case 105: case 106: case 107: case 108: case 109: case 110: case 111: case 112:
+    case 113: case 114: case 115: case 116: case 117: case 118: case 119: case 120:
+    case 121: case 122:
+      goto s5;
+    default:
+      return last;
+    }
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99: case 100: case 101: case 102: case 103: case 104:
+    case 105: case 106: case 107: case 108: case 109: case 110: case 111: case 112:
+    case 113: case 114: case 115: case 116: case 117: case 118: case 119: case 120:
+    case 121: case 122:
+      goto s5;
+    default:
+      return last;
+    }
+ s5:
+  ctx = i == end ? eof_ctx : ctx_of[s[i]];
+  if ((0x5555 >> ctx) & 1)
+    {
+      last = i;
+      if (!longest)
+	return last;
+    }
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98: case 99: case 100: case 101: case 102: case 103: case 104:
+    case 105: case 106: case 107: case 108: case 109: case 110: case 111: case 112:
+    case 113: case 114: case 115: case 116: case 117: case 118: case 119: case 120:
+    case 121: case 122:
+      goto s5;
+    default:
+      return last;
+    }
+}
+
+int
+gen_word2 (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_word2_first[s[start]])
+	++start;
+      if (start == end && !gen_word2_first[0])
+	return REG_NOMATCH;
+      state = gen_word2_init[start == 0 ? bof_ctx : gen_word2_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_word2_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_word2_pattern, gen_word2_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_nonword_pattern, do not edit.  */
+
+static const char gen_nonword_pattern[] = "a\\Bb";
+static const int gen_nonword_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_nonword_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_nonword_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_nonword_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_nonword_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_nonword_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_nonword (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_nonword_first[s[start]])
+	++start;
+      if (start == end && !gen_nonword_first[0])
+	return REG_NOMATCH;
+      state = gen_nonword_init[start == 0 ? bof_ctx : gen_nonword_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_nonword_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_nonword_pattern, gen_nonword_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_notword_pattern, do not edit.  */
+
+static const char gen_notword_pattern[] = "\\W+";
+static const int gen_notword_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_notword_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_notword_first[256] =
+{
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_notword_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_notword_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_notword_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 48: case 49: case 50: case 51: case 52: case 53: case 54: case 55:
+    case 56: case 57: case 65: case 66: case 67: case 68: case 69: case 70:
+    case 71: case 72: case 73: case 74: case 75: case 76: case 77: case 78:
+    case 79: case 80: case 81: case 82: case 83: case 84: case 85: case 86:
+    case 87: case 88: case 89: case 90: case 95: case 97: case 98: case 99:
+    case 100: case 101: case 102: case 103: case 104: case 105: case 106: case 107:
+    case 108: case 109: case 110: case 111: case 112: case 113: case 114: case 115:
+    case 116: case 117: case 118: case 119: case 120: case 121: case 122:
+      return last;
+    default:
+      goto s1;
+    }
+ s1:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 48: case 49: case 50: case 51: case 52: case 53: case 54: case 55:
+    case 56: case 57: case 65: case 66: case 67: case 68: case 69: case 70:
+    case 71: case 72: case 73: case 74: case 75: case 76: case 77: case 78:
+    case 79: case 80: case 81: case 82: case 83: case 84: case 85: case 86:
+    case 87: case 88: case 89: case 90: case 95: case 97: case 98: case 99:
+    case 100: case 101: case 102: case 103: case 104: case 105: case 106: case 107:
+    case 108: case 109: case 110: case 111: case 112: case 113: case 114: case 115:
+    case 116: case 117: case 118: case 119: case 120: case 121: case 122:
+      return last;
+    default:
+      goto s1;
+    }
+}
+
+int
+gen_notword (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_notword_first[s[start]])
+	++start;
+      if (start == end && !gen_notword_first[0])
+	return REG_NOMATCH;
+      state = gen_notword_init[start == 0 ? bof_ctx : gen_notword_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_notword_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_notword_pattern, gen_notword_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_nested_pattern, do not edit.  */
+
+static const char gen_nested_pattern[] = "((a|b)*c)+d\?";
+static const int gen_nested_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_nested_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_nested_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_nested_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_nested_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_nested_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98:
+      goto s1;
+    case 99:
+      goto s2;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98:
+      goto s1;
+    case 99:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98:
+      goto s3;
+    case 99:
+      goto s4;
+    case 100:
+      goto s5;
+    default:
+      return last;
+    }
+ s3:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98:
+      goto s3;
+    case 99:
+      goto s4;
+    default:
+      return last;
+    }
+ s4:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98:
+      goto s3;
+    case 99:
+      goto s4;
+    case 100:
+      goto s5;
+    default:
+      return last;
+    }
+ s5:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_nested (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_nested_first[s[start]])
+	++start;
+      if (start == end && !gen_nested_first[0])
+	return REG_NOMATCH;
+      state = gen_nested_init[start == 0 ? bof_ctx : gen_nested_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_nested_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_nested_pattern, gen_nested_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_bounded_pattern, do not edit.  */
+
+static const char gen_bounded_pattern[] = "a{2,4}b{0,2}";
+static const int gen_bounded_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_bounded_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_bounded_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_bounded_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_bounded_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_bounded_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s3;
+    case 98:
+      goto s4;
+    default:
+      return last;
+    }
+ s3:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s5;
+    case 98:
+      goto s4;
+    default:
+      return last;
+    }
+ s4:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s6;
+    default:
+      return last;
+    }
+ s5:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s4;
+    default:
+      return last;
+    }
+ s6:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_bounded (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_bounded_first[s[start]])
+	++start;
+      if (start == end && !gen_bounded_first[0])
+	return REG_NOMATCH;
+      state = gen_bounded_init[start == 0 ? bof_ctx : gen_bounded_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_bounded_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_bounded_pattern, gen_bounded_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_neg_class_pattern, do not edit.  */
+
+static const char gen_neg_class_pattern[] = "[^a\\n]+b";
+static const int gen_neg_class_cflags = 5;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_neg_class_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_neg_class_first[256] =
+{
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1,
+  1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_neg_class_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_neg_class_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_neg_class_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 10: case 92: case 97: case 110:
+      return last;
+    default:
+      goto s1;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 10: case 92: case 97: case 110:
+      return last;
+    case 98:
+      goto s2;
+    default:
+      goto s1;
+    }
+ s2:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 10: case 92: case 97: case 110:
+      return last;
+    case 98:
+      goto s2;
+    default:
+      goto s1;
+    }
+}
+
+int
+gen_neg_class (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_neg_class_first[s[start]])
+	++start;
+      if (start == end && !gen_neg_class_first[0])
+	return REG_NOMATCH;
+      state = gen_neg_class_init[start == 0 ? bof_ctx : gen_neg_class_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_neg_class_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_neg_class_pattern, gen_neg_class_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_basic_pattern, do not edit.  */
+
+static const char gen_basic_pattern[] = "\\(a*\\)b\\{1,3\\}";
+static const int gen_basic_cflags = 0;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_basic_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_basic_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_basic_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_basic_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_basic_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    case 98:
+      goto s2;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s1;
+    case 98:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s3;
+    default:
+      return last;
+    }
+ s3:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s4;
+    default:
+      return last;
+    }
+ s4:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_basic (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_basic_first[s[start]])
+	++start;
+      if (start == end && !gen_basic_first[0])
+	return REG_NOMATCH;
+      state = gen_basic_init[start == 0 ? bof_ctx : gen_basic_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_basic_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_basic_pattern, gen_basic_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_nosub_pattern, do not edit.  */
+
+static const char gen_nosub_pattern[] = "(a|b)c*";
+static const int gen_nosub_cflags = 9;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_nosub_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_nosub_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_nosub_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_nosub_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_nosub_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97: case 98:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  last = i;
+  if (!longest)
+    return last;
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 99:
+      goto s1;
+    default:
+      return last;
+    }
+}
+
+int
+gen_nosub (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+  nmatch = 0;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_nosub_first[s[start]])
+	++start;
+      if (start == end && !gen_nosub_first[0])
+	return REG_NOMATCH;
+      state = gen_nosub_init[start == 0 ? bof_ctx : gen_nosub_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_nosub_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_nosub_pattern, gen_nosub_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
+/* Generated by re_gen_c() from gen_quote_pattern, do not edit.  */
+
+static const char gen_quote_pattern[] = "\"a\\\\\?b\"";
+static const int gen_quote_cflags = 1;
+
+/* Context of each byte: 1 word, 2 newline.  */
+static const unsigned char gen_quote_ctx[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Bytes a match can start with.  */
+static const unsigned char gen_quote_first[256] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Initial state for the context of the byte before the start, -1 if none.  */
+static const short gen_quote_init[16] =
+{
+  0, 0, 0, -1, 0, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Run the DFA from STATE at I, return the end of the longest match
+   (of the first one if !LONGEST), or -1.  */
+
+static regoff_t
+gen_quote_run (const unsigned char *s, regoff_t i, regoff_t end, int state,
+	unsigned int eof_ctx, bool longest)
+{
+  const unsigned char *ctx_of = gen_quote_ctx;
+  regoff_t last = -1;
+
+  (void) ctx_of;
+  (void) eof_ctx;
+  switch (state)
+    {
+    case 0:
+      goto s0;
+    }
+  return last;
+
+ s0:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 34:
+      goto s1;
+    default:
+      return last;
+    }
+ s1:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 97:
+      goto s2;
+    default:
+      return last;
+    }
+ s2:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 92:
+      goto s3;
+    case 98:
+      goto s4;
+    default:
+      return last;
+    }
+ s3:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 98:
+      goto s4;
+    default:
+      return last;
+    }
+ s4:
+  if (i == end)
+    return last;
+  switch (s[i++])
+    {
+    case 34:
+      goto s5;
+    default:
+      return last;
+    }
+ s5:
+  last = i;
+  if (!longest)
+    return last;
+  return last;
+}
+
+int
+gen_quote (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  unsigned int bof_ctx = (eflags & REG_NOTBOL) ? 4 : 6;
+  unsigned int eof_ctx = (eflags & REG_NOTEOL) ? 8 : 10;
+  regoff_t start, end, last = -1;
+  int state;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      end = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      end = strlen (string);
+    }
+  if (start < 0 || start > end)
+    return REG_NOMATCH;
+
+  for (;; ++start)
+    {
+      while (start < end && !gen_quote_first[s[start]])
+	++start;
+      if (start == end && !gen_quote_first[0])
+	return REG_NOMATCH;
+      state = gen_quote_init[start == 0 ? bof_ctx : gen_quote_ctx[s[start - 1]]];
+      if (state >= 0)
+	{
+	  last = gen_quote_run (s, start, end, state, eof_ctx, nmatch != 0);
+	  if (last >= 0)
+	    break;
+	}
+      if (start >= end)
+	return REG_NOMATCH;
+    }
+
+  if (nmatch > 1)
+    {
+      /* Subexpressions are left to regexec().  */
+      regex_t *r = regcache_get (gen_quote_pattern, gen_quote_cflags);
+      int ret = regexec (r, string, nmatch, pmatch, eflags);
+      regcache_release (r);
+      return ret;
+    }
+  if (nmatch == 1)
+    {
+      pmatch[0].rm_so = start;
+      pmatch[0].rm_eo = last;
+    }
+  return 0;
+}
+
@@ -0,0 +1,25 @@
+# patterns for regex_gen_test.c: name flags pattern
+
+gen_literal	E	abc
+gen_literal_icase	Ei	hello world
+gen_class	E	a[0-9]+z
+gen_alt	E	cat|dog|bird
+gen_alt_sub	E	(ab|cd)+e
+gen_star	E	a*
+gen_dot_star	E	.*
+gen_empty_alt	E	x|
+gen_dot	E	a.c
+gen_dot_nl	En	a.c
+gen_bol	E	^ab
+gen_eol	E	ab$
+gen_bol_nl	En	^[a-c]+$
+gen_word	E	\bab\b
+gen_word2	E	\<[a-z]+\>
+gen_nonword	E	a\Bb
+gen_notword	E	\W+
+gen_nested	E	((a|b)*c)+d?
+gen_bounded	E	a{2,4}b{0,2}
+gen_neg_class	En	[^a\n]+b
+gen_basic	-	\(a*\)b\{1,3\}
+gen_nosub	Es	(a|b)c*
+gen_quote	E	"a\\?b"
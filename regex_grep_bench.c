@@ -0,0 +1,114 @@
+/*
+ *             _        _   _
+ *            | |      | | | |
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License.
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// grep over a file: read_text_file_by_line_or_die() + regexec() vs regex_grep_file_or_die()
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "files.h"
+#include "oassert.h"
+#include "stuff.h"
+#include "threads.h"
+
+#define LINES 500000
+#define FNAME "regex_grep_bench.tmp"
+
+static const char *pats[]={ "ERROR: .* timeout", "(cache|upstream) (miss|timeout)", "^2016-01-1[0-9] .*[0-9]{4}ms$",
+	"id=12345[0-9]" };
+
+static void make_log (const char *fname, size_t *size)
+{
+	const char *levels[]={ "INFO", "DEBUG", "WARN", "ERROR" };
+	const char *msgs[]={ "request served", "cache miss", "connection reset", "upstream timeout" };
+	FILE *f=fopen_or_die (fname, "wb");
+
+	*size=0;
+	for (size_t l=0; l<LINES; l++)
+	{
+		unsigned h=l*2654435761U;
+		*size+=fprintf (f, "2016-01-%02d 12:%02d:%02d %s: %s id=%u took %ums\n",
+				1+h%28, (h>>5)%60, (h>>11)%60, levels[(h>>17)%4], msgs[(h>>20)%4], h%1000000, (h>>3)%2000);
+	};
+	fclose (f);
+};
+
+struct by_line
+{
+	regex_t *r;
+	int matched;
+};
+
+static void by_line_cb (char *line, void *param)
+{
+	struct by_line *s=(struct by_line*)param;
+	// fgets() leaves newline
+	line[strcspn (line, "\n")]=0;
+	if (regexec (s->r, line, 0, NULL, 0)==0)
+		s->matched++;
+};
+
+static bool count_cb (const char *line, size_t len, octa line_no, octa ofs, void *param)
+{
+	(*(int*)param)++;
+	return true;
+};
+
+int main()
+{
+	size_t size;
+	unsigned threads=get_CPUs_count();
+
+	make_log (FNAME, &size);
+	printf ("%d lines, %.1f MiB, %d CPUs\n", LINES, (double)size/_1MiB, threads);
+
+	for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+	{
+		regex_t r;
+		struct by_line s;
+		int matched[2]={ 0, 0 };
+		double t, speed[3];
+
+		regcomp_or_die (&r, pats[p], REG_EXTENDED | REG_NOSUB);
+
+		s.r=&r;
+		s.matched=0;
+		t=get_monotonic_time();
+		read_text_file_by_line_or_die (FNAME, by_line_cb, &s);
+		speed[0]=(double)size/_1MiB/(get_monotonic_time()-t);
+
+		for (int i=0; i<2; i++)
+		{
+			t=get_monotonic_time();
+			oassert (regex_grep_file_or_die (&r, FNAME, false, i ? 0 : 1, count_cb, &matched[i])==matched[i]);
+			speed[1+i]=(double)size/_1MiB/(get_monotonic_time()-t);
+		};
+		oassert (s.matched==matched[0] && s.matched==matched[1]);
+
+		printf ("[%s]: %d lines\n", pats[p], s.matched);
+		printf ("  by line callback: %8.1f MiB/s\n", speed[0]);
+		printf ("  grep, 1 thread:   %8.1f MiB/s (x%.1f)\n", speed[1], speed[1]/speed[0]);
+		printf ("  grep, %d threads: %8.1f MiB/s (x%.1f)\n", threads, speed[2], speed[2]/speed[0]);
+		regfree (&r);
+	};
+
+	remove (FNAME);
+	dump_unfreed_blocks();
+};
@@ -22,18 +22,24 @@
 //#include <memory.h>
 //#include <ctype.h>
 
-//#include "oassert.h"
+#include <string.h>
+
+#include "oassert.h"
 //#include "datatypes.h"
-//#include "stuff.h"
+#include "stuff.h"
 //#include "fmt_utils.h"
 //#include "ostrings.h"
 #include "dmalloc.h"
+#include "rbtree.h"
+#include "threads.h"
+#include "files.h"
 
 //#ifdef _MSC_VER
 //#include <intrin.h>
 //#endif
 
 #include "regex.h"
+#include "regex_helpers.h"
 
 void regcomp_or_die (regex_t *_Restrict_ preg, const char *_Restrict_ pattern, int cflags)
 {
@@ -81,3 +87,344 @@ char **regexec_to_array_of_string (regex_t *r, char *s, size_t nmatch)
 	return rt;
 };
 
+// regcache
+// entries are in rbtree (for lookup) and in double linked list (most recently used first)
+
+struct regcache_entry
+{
+	regex_t r; // must be first, regcache_release() casts regex_t* back to entry
+	char *pattern;
+	int cflags;
+	unsigned refcount;
+	bool evicted; // already removed from tree and list, to be freed by last regcache_release()
+	struct regcache_entry *prev, *next;
+};
+
+static my_mutex regcache_lock=MY_MUTEX_INITIALIZER;
+static rbtree *regcache_tbl=NULL;
+static struct regcache_entry *regcache_head=NULL, *regcache_tail=NULL;
+static size_t regcache_capacity=64;
+static struct regcache_stats regcache_st;
+
+static int regcache_compare (void* leftp, void* rightp)
+{
+	struct regcache_entry *left=(struct regcache_entry*)leftp;
+	struct regcache_entry *right=(struct regcache_entry*)rightp;
+
+	if (left->cflags!=right->cflags)
+		return left->cflags < right->cflags ? -1 : 1;
+	return strcmp (left->pattern, right->pattern);
+};
+
+static void regcache_unlink (struct regcache_entry *e)
+{
+	if (e->prev)
+		e->prev->next=e->next;
+	else
+		regcache_head=e->next;
+	if (e->next)
+		e->next->prev=e->prev;
+	else
+		regcache_tail=e->prev;
+	e->prev=e->next=NULL;
+};
+
+static void regcache_link_at_head (struct regcache_entry *e)
+{
+	e->prev=NULL;
+	e->next=regcache_head;
+	if (regcache_head)
+		regcache_head->prev=e;
+	regcache_head=e;
+	if (regcache_tail==NULL)
+		regcache_tail=e;
+};
+
+static void regcache_free_entry (struct regcache_entry *e)
+{
+	regfree (&e->r);
+	DFREE (e->pattern);
+	DFREE (e);
+};
+
+// must be called with lock held
+static void regcache_remove (struct regcache_entry *e)
+{
+	rbtree_delete (regcache_tbl, e);
+	regcache_unlink (e);
+	regcache_st.entries--;
+	if (e->refcount)
+		e->evicted=true;
+	else
+		regcache_free_entry (e);
+};
+
+// must be called with lock held
+static void regcache_evict ()
+{
+	// go from least recently used, skip entries in use
+	struct regcache_entry *e=regcache_tail;
+	while (regcache_st.entries > regcache_capacity && e)
+	{
+		struct regcache_entry *prev=e->prev;
+		if (e->refcount==0)
+		{
+			regcache_remove (e);
+			regcache_st.evictions++;
+		};
+		e=prev;
+	};
+};
+
+// must be called with lock held
+static struct regcache_entry *regcache_lookup (const char *pattern, int cflags)
+{
+	struct regcache_entry key;
+	key.pattern=(char*)pattern;
+	key.cflags=cflags;
+
+	if (regcache_tbl==NULL)
+		regcache_tbl=rbtree_create(true, "regcache", regcache_compare);
+	return (struct regcache_entry*)rbtree_lookup (regcache_tbl, &key);
+};
+
+regex_t *regcache_get (const char *pattern, int cflags)
+{
+	my_mutex_lock (&regcache_lock);
+	struct regcache_entry *e=regcache_lookup (pattern, cflags);
+	if (e)
+	{
+		regcache_st.hits++;
+		e->refcount++;
+		regcache_unlink (e);
+		regcache_link_at_head (e);
+		my_mutex_unlock (&regcache_lock);
+		return &e->r;
+	};
+	regcache_st.misses++;
+	my_mutex_unlock (&regcache_lock);
+
+	// compile without lock, so other threads are not blocked
+	struct regcache_entry *new_e=DCALLOC(struct regcache_entry, 1, "regcache_entry");
+	regcomp_or_die (&new_e->r, pattern, cflags);
+	new_e->pattern=DSTRDUP(pattern, "pattern");
+	new_e->cflags=cflags;
+	new_e->refcount=1;
+
+	my_mutex_lock (&regcache_lock);
+	// other thread may compile the same pattern meanwhile
+	e=regcache_lookup (pattern, cflags);
+	if (e)
+	{
+		e->refcount++;
+		regcache_unlink (e);
+		regcache_link_at_head (e);
+		my_mutex_unlock (&regcache_lock);
+		regcache_free_entry (new_e);
+		return &e->r;
+	};
+	rbtree_insert (regcache_tbl, new_e, new_e);
+	regcache_link_at_head (new_e);
+	regcache_st.entries++;
+	regcache_evict ();
+	my_mutex_unlock (&regcache_lock);
+	return &new_e->r;
+};
+
+void regcache_release (regex_t *r)
+{
+	struct regcache_entry *e=(struct regcache_entry*)r;
+
+	my_mutex_lock (&regcache_lock);
+	oassert (e->refcount>0);
+	e->refcount--;
+	if (e->refcount==0)
+	{
+		if (e->evicted)
+			regcache_free_entry (e);
+		else
+			regcache_evict ();
+	};
+	my_mutex_unlock (&regcache_lock);
+};
+
+void regcache_set_capacity (size_t capacity)
+{
+	my_mutex_lock (&regcache_lock);
+	regcache_capacity=capacity;
+	regcache_evict ();
+	my_mutex_unlock (&regcache_lock);
+};
+
+void regcache_get_stats (struct regcache_stats *out)
+{
+	my_mutex_lock (&regcache_lock);
+	*out=regcache_st;
+	my_mutex_unlock (&regcache_lock);
+};
+
+void regcache_clear ()
+{
+	my_mutex_lock (&regcache_lock);
+	struct regcache_entry *e=regcache_head;
+	while (e)
+	{
+		struct regcache_entry *next=e->next;
+		if (e->refcount==0)
+			regcache_remove (e);
+		e=next;
+	};
+	regcache_st.hits=regcache_st.misses=regcache_st.evictions=0;
+	if (regcache_st.entries==0 && regcache_tbl)
+	{
+		rbtree_deinit (regcache_tbl);
+		regcache_tbl=NULL;
+	};
+	my_mutex_unlock (&regcache_lock);
+};
+
+
+// grep
+// the input is cut into chunks at newlines, workers take chunks in order (as parallel_for() does)
+// and collect matching lines of a chunk; the worker which completes the first chunk not yet reported
+// reports it and all completed chunks after it, so lines come out in original order, as soon as possible
+
+size_t regex_grep_chunk_size=1*_1MiB;
+
+struct grep_hit
+{
+	size_t ofs, len; // in chunk
+	octa line_no; // in chunk
+};
+
+struct grep_chunk
+{
+	const char *begin, *end;
+	struct grep_hit *hits;
+	size_t nhits, alloc;
+	octa lines;
+	bool done;
+};
+
+struct grep_state
+{
+	const regex_t *r;
+	const char *buf;
+	bool invert;
+	regex_grep_fn fn;
+	void *param;
+	struct grep_chunk *chunks;
+	size_t nchunks;
+	my_mutex lock;
+	// guarded by lock
+	size_t next_to_report;
+	octa line_base, reported;
+	volatile bool stopped;
+};
+
+static void grep_chunk_add_hit (struct grep_chunk *c, size_t ofs, size_t len, octa line_no)
+{
+	if (c->nhits==c->alloc)
+	{
+		c->alloc=c->alloc ? c->alloc*2 : 64;
+		c->hits=DREALLOC(c->hits, struct grep_hit, c->alloc, "grep_hit");
+	};
+	c->hits[c->nhits].ofs=ofs;
+	c->hits[c->nhits].len=len;
+	c->hits[c->nhits].line_no=line_no;
+	c->nhits++;
+};
+
+// must be called with lock held
+static void grep_report (struct grep_state *s)
+{
+	while (s->next_to_report < s->nchunks && s->chunks[s->next_to_report].done)
+	{
+		struct grep_chunk *c=&s->chunks[s->next_to_report];
+		for (size_t i=0; i<c->nhits && !s->stopped; i++)
+		{
+			struct grep_hit *h=&c->hits[i];
+			s->reported++;
+			if (s->fn (c->begin+h->ofs, h->len, s->line_base+h->line_no, c->begin+h->ofs-s->buf, s->param)==false)
+				s->stopped=true;
+		};
+		s->line_base+=c->lines;
+		DFREE (c->hits);
+		c->hits=NULL;
+		s->next_to_report++;
+	};
+};
+
+static void grep_worker (size_t i, void *param)
+{
+	struct grep_state *s=(struct grep_state*)param;
+	struct grep_chunk *c=&s->chunks[i];
+
+	if (s->stopped==false)
+		for (const char *line=c->begin; line<c->end; c->lines++)
+		{
+			const char *eol=memchr (line, '\n', c->end-line);
+			size_t len=(eol ? eol : c->end)-line;
+			// each line is a separate string, so ^ and $ match at its boundaries
+			if ((regexec_bool (s->r, line, len, 0)==0) != s->invert)
+				grep_chunk_add_hit (c, line-c->begin, len, c->lines);
+			line+=len+1;
+		};
+
+	my_mutex_lock (&s->lock);
+	c->done=true;
+	grep_report (s);
+	my_mutex_unlock (&s->lock);
+};
+
+octa regex_grep_buf (const regex_t *r, const char *buf, size_t size, bool invert, unsigned threads,
+		regex_grep_fn fn, void *param)
+{
+	struct grep_state s;
+	size_t alloc=size/regex_grep_chunk_size+1;
+
+	memset (&s, 0, sizeof(s));
+	s.r=r;
+	s.buf=buf;
+	s.invert=invert;
+	s.fn=fn;
+	s.param=param;
+	s.chunks=DMALLOC(struct grep_chunk, alloc, "grep_chunk");
+	my_mutex_init (&s.lock);
+
+	// chunks end just after newline, a line longer than chunk makes it longer
+	for (size_t pos=0; pos<size; )
+	{
+		size_t end=pos+regex_grep_chunk_size;
+		if (end>=size)
+			end=size;
+		else
+		{
+			const char *nl=memchr (buf+end-1, '\n', size-end+1);
+			end=nl ? nl-buf+1 : size;
+		};
+		oassert (s.nchunks<alloc);
+		memset (&s.chunks[s.nchunks], 0, sizeof(struct grep_chunk));
+		s.chunks[s.nchunks].begin=buf+pos;
+		s.chunks[s.nchunks].end=buf+end;
+		s.nchunks++;
+		pos=end;
+	};
+
+	parallel_for (s.nchunks, threads, grep_worker, &s);
+	oassert (s.next_to_report==s.nchunks);
+
+	my_mutex_deinit (&s.lock);
+	DFREE (s.chunks);
+	return s.reported;
+};
+
+octa regex_grep_file_or_die (const regex_t *r, const char *fname, bool invert, unsigned threads,
+		regex_grep_fn fn, void *param)
+{
+	size_t size;
+	byte *buf=map_file_or_die (fname, &size);
+	octa rt=regex_grep_buf (r, (const char*)buf, size, invert, threads, fn, param);
+	unmap_file (buf, size);
+	return rt;
+};
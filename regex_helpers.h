@@ -15,10 +15,129 @@
  *
  */
 
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
 #include "regex.h"
+#include "datatypes.h"
 
 void regcomp_or_die (regex_t *_Restrict_ preg, const char *_Restrict_ pattern, int cflags);
 size_t regmatch_len (regmatch_t *m);
 char *regmatch_dup(regmatch_t *m, char *str);
 char **regexec_to_array_of_string (regex_t *r, char *s, size_t nmatch);
 
+// cache of compiled regexes, keyed by (pattern, cflags), thread-safe, with LRU eviction
+// regex returned is valid until regcache_release(), even if it's evicted meanwhile
+// dies if pattern is incorrect, as regcomp_or_die()
+regex_t *regcache_get (const char *pattern, int cflags);
+void regcache_release (regex_t *r);
+// 64 by default, unused entries over capacity are evicted
+void regcache_set_capacity (size_t capacity);
+
+struct regcache_stats
+{
+	octa hits, misses, evictions;
+	size_t entries;
+};
+void regcache_get_stats (struct regcache_stats *out);
+// free all unused entries and reset counters
+void regcache_clear ();
+
+
+// regcomp() extracts literals every match must start with or contain, and regexec() skips
+// straight to their occurrences; can be turned off (before regcomp()) to measure/test
+extern bool regex_prefilter_enabled;
+
+// number of allocations done by the regex code so far (in all threads),
+// counted only in _DEBUG builds, 0 otherwise
+size_t regex_alloc_calls ();
+
+// buffers used by regexec() are allocated and freed on each call;
+// regexec_ctx() takes them from ctx instead and leaves them there for the next call,
+// so they only grow, and matching doesn't allocate in steady state (except with back-references)
+// ctx can be used with any regex, but only by one thread at a time: keep one per thread
+typedef struct regmatch_ctx regmatch_ctx_t;
+
+regmatch_ctx_t *regmatch_ctx_new ();
+void regmatch_ctx_free (regmatch_ctx_t *ctx);
+// same as regexec()
+int regexec_ctx (regmatch_ctx_t *ctx, const regex_t *preg, const char *string,
+		size_t nmatch, regmatch_t pmatch[], int eflags);
+
+// streaming search: input is fed in chunks of any size, matches are reported with
+// absolute offsets, leftmost-longest, non-overlapping, as in a loop of regexec() calls
+// with REG_STARTEND over the whole input
+// only bytes since start of current match candidate are kept in memory;
+// if max_match_len isn't zero, candidates longer than it are dropped, so memory usage is bounded
+// back-references and multibyte locales aren't supported (REG_BADPAT is returned)
+// return false from callback to stop
+typedef bool (*re_stream_fn)(octa start, octa end, void *param);
+typedef struct re_stream re_stream_t;
+
+int re_stream_begin (re_stream_t **out, const regex_t *preg, int eflags,
+		size_t max_match_len, re_stream_fn fn, void *param);
+int re_stream_feed (re_stream_t *st, const char *buf, size_t len);
+// number of bytes kept for rescanning
+octa re_stream_retained (const re_stream_t *st);
+// report matches at the end of input and free the stream
+int re_stream_end (re_stream_t *st);
+
+// grep: lines of input matching (or not matching, if invert is set) the regex are reported
+// in original order; input is cut into chunks at newlines, chunks are matched by several threads
+// (threads==0 means get_CPUs_count()); each line is matched as a separate string, so ^ and $
+// match at its boundaries; line is passed without newline, line_no is zero-based, ofs is offset
+// of line in input
+// fn is called from worker threads, but never concurrently; return false to stop
+// returns number of lines reported
+typedef bool (*regex_grep_fn)(const char *line, size_t len, octa line_no, octa ofs, void *param);
+octa regex_grep_buf (const regex_t *r, const char *buf, size_t size, bool invert, unsigned threads,
+		regex_grep_fn fn, void *param);
+// the file is mapped into memory
+octa regex_grep_file_or_die (const regex_t *r, const char *fname, bool invert, unsigned threads,
+		regex_grep_fn fn, void *param);
+// chunk size, 1MiB by default, can be changed to tune/test
+extern size_t regex_grep_chunk_size;
+
+// if no submatches are wanted (nmatch==0 or REG_NOSUB), regexec() runs a pure DFA over the input:
+// all match attempts at once, one table lookup per byte, no backtracking or registers
+// (back-references and multibyte locales excepted); can be turned off to measure/test
+extern bool regex_bool_dfa_enabled;
+// same as regexec() with nmatch==0, but the string is (ptr, len) and not NUL-terminated
+int regexec_bool (const regex_t *preg, const char *string, size_t len, int eflags);
+
+// regex set: many patterns are compiled into one automaton, and one pass over the string
+// finds all patterns which match somewhere in it (as regexec() would), like RE2::Set
+// if a pattern is incorrect, its index is returned via bad_pattern (can be NULL);
+// back-references and multibyte locales aren't supported (REG_BADPAT is returned)
+// the set can be used by many threads at once
+typedef struct re_set re_set_t;
+
+int re_set_compile (re_set_t **out, const char **patterns, size_t n, int cflags, size_t *bad_pattern);
+// ids must have room for all patterns, they are returned in ascending order
+int re_set_match (re_set_t *set, const char *string, size_t len, int eflags, size_t *ids, size_t *nids);
+size_t re_set_size (const re_set_t *set);
+// number of automaton states built so far, states are built lazily during matching
+size_t re_set_states (const re_set_t *set);
+void re_set_free (re_set_t *set);
+
+// a compiled regex can be saved into a binary blob and loaded back without compiling it again;
+// if with_states is set, DFA states built by matching so far are saved too, so the loaded regex
+// is "warm"; the blob is position independent and can be loaded from a mmap()-ed file
+// the blob is checked while loading (REG_BADPAT if it's damaged or made by another version),
+// but not against deliberately crafted contents: load only blobs made by re_blob_save();
+// multibyte locales aren't supported (REG_BADPAT)
+// the saved blob is to be freed by caller, the loaded regex by regfree()
+int re_blob_save (const regex_t *preg, bool with_states, void **out, size_t *out_len);
+int re_blob_load (regex_t *preg, const void *blob, size_t len);
+
+// specialized matcher generator: the constant pattern is compiled into a direct-coded DFA,
+// written to out as C code of function
+//   int name (const char *string, size_t nmatch, regmatch_t pmatch[], int eflags);
+// with the same semantics as regexec() of the pattern; for nmatch>1 (subexpressions),
+// regexec() is called after the DFA has found a match; the generated code needs regex.h,
+// regex_helpers.h, string.h and stdbool.h; see regex_gen.c
+// back-references and multibyte locales aren't supported (REG_BADPAT),
+// too large automata aren't either (REG_ESPACE)
+int re_gen_c (FILE *out, const char *name, const char *pattern, int cflags);
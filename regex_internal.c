@@ -28,6 +28,24 @@ static re_dfastate_t *create_cd_newstate (const re_dfa_t *dfa,
 					  const re_node_set *nodes,
 					  unsigned int context,
 					  re_hashval_t hash) internal_function;
+
+#if defined _DEBUG && !defined _LIBC
+size_t re_alloc_calls;
+#endif
+
+size_t
+regex_alloc_calls (void)
+{
+#if defined _DEBUG && !defined _LIBC
+# if defined _MSC_VER
+  return re_alloc_calls;
+# else
+  return __atomic_load_n (&re_alloc_calls, __ATOMIC_RELAXED);
+# endif
+#else
+  return 0;
+#endif
+}
 
 /* Functions for string operation.  */
 
@@ -48,9 +66,13 @@ re_string_allocate (re_string_t *pstr, const char *str, Idx len, Idx init_len,
   init_buf_len = (len + 1 < init_len) ? len + 1: init_len;
   re_string_construct_common (str, len, pstr, trans, icase, dfa);
 
-  ret = re_string_realloc_buffers (pstr, init_buf_len);
-  if (BE (ret != REG_NOERROR, 0))
-    return ret;
+  /* The buffers may be given by the caller, see regexec_ctx().  */
+  if (pstr->bufs_len < init_buf_len)
+    {
+      ret = re_string_realloc_buffers (pstr, init_buf_len);
+      if (BE (ret != REG_NOERROR, 0))
+	return ret;
+    }
 
   pstr->word_char = dfa->word_char;
   pstr->word_ops_used = dfa->word_ops_used;
@@ -1046,6 +1068,27 @@ re_node_set_init_copy (re_node_set *dest, const re_node_set *src)
   return REG_NOERROR;
 }
 
+/* Same as re_node_set_init_copy, but DEST is already initialized, and its
+   buffer is reused if it is large enough.  */
+
+static reg_errcode_t
+internal_function __attribute_warn_unused_result__
+re_node_set_assign (re_node_set *dest, const re_node_set *src)
+{
+  if (dest->alloc < src->nelem)
+    {
+      Idx *new_elems = re_realloc (dest->elems, Idx, src->nelem);
+      if (BE (new_elems == NULL, 0))
+	return REG_ESPACE;
+      dest->elems = new_elems;
+      dest->alloc = src->nelem;
+    }
+  dest->nelem = src->nelem;
+  if (src->nelem > 0)
+    memcpy (dest->elems, src->elems, src->nelem * sizeof (Idx));
+  return REG_NOERROR;
+}
+
 /* Calculate the intersection of the sets SRC1 and SRC2. And merge it to
    DEST. Return value indicate the error code or REG_NOERROR if succeeded.
    Note: We assume dest->elems is NULL, when dest->alloc is 0.  */
@@ -1464,6 +1507,45 @@ calc_state_hash (const re_node_set *nodes, unsigned int context)
   return hash;
 }
 
+/* Look up the state with node set NODES in bucket SPOT of the state
+   table.  The caller holds the state table lock.  */
+
+static re_dfastate_t *
+find_state (const struct re_state_table_entry *spot, const re_node_set *nodes,
+	    re_hashval_t hash)
+{
+  Idx i;
+  for (i = 0 ; i < spot->num ; i++)
+    {
+      re_dfastate_t *state = spot->array[i];
+      if (hash != state->hash)
+	continue;
+      if (re_node_set_compare (&state->nodes, nodes))
+	return state;
+    }
+  return NULL;
+}
+
+/* Same as find_state, for the state with entrance nodes NODES and
+   context CONTEXT.  */
+
+static re_dfastate_t *
+find_state_context (const struct re_state_table_entry *spot,
+		    const re_node_set *nodes, unsigned int context,
+		    re_hashval_t hash)
+{
+  Idx i;
+  for (i = 0 ; i < spot->num ; i++)
+    {
+      re_dfastate_t *state = spot->array[i];
+      if (state->hash == hash
+	  && state->context == context
+	  && re_node_set_compare (state->entrance_nodes, nodes))
+	return state;
+    }
+  return NULL;
+}
+
 /* Search for the state whose node_set is equivalent to NODES.
    Return the pointer to the state, if we found it in the DFA.
    Otherwise create the new one and return it.  In case of an error
@@ -1481,7 +1563,6 @@ re_acquire_state (reg_errcode_t *err, const re_dfa_t *dfa,
   re_hashval_t hash;
   re_dfastate_t *new_state;
   struct re_state_table_entry *spot;
-  Idx i;
 #ifdef lint
   /* Suppress bogus uninitialized-variable warnings.  */
   *err = REG_NOERROR;
@@ -1494,19 +1575,25 @@ re_acquire_state (reg_errcode_t *err, const re_dfa_t *dfa,
   hash = calc_state_hash (nodes, 0);
   spot = dfa->state_table + (hash & dfa->state_hash_mask);
 
-  for (i = 0 ; i < spot->num ; i++)
+  /* States are added while matching, possibly by several threads at once
+     on the same DFA.  Lookups go in parallel, additions are exclusive.  */
+  re_state_table_lock_shared (dfa);
+  new_state = find_state (spot, nodes, hash);
+  re_state_table_unlock_shared (dfa);
+  if (new_state != NULL)
+    return new_state;
+
+  re_state_table_lock (dfa);
+  /* Somebody may have added it meanwhile.  */
+  new_state = find_state (spot, nodes, hash);
+  if (new_state == NULL)
     {
-      re_dfastate_t *state = spot->array[i];
-      if (hash != state->hash)
-	continue;
-      if (re_node_set_compare (&state->nodes, nodes))
-	return state;
+      /* There are no appropriate state in the dfa, create the new one.  */
+      new_state = create_ci_newstate (dfa, nodes, hash);
+      if (BE (new_state == NULL, 0))
+	*err = REG_ESPACE;
     }
-
-  /* There are no appropriate state in the dfa, create the new one.  */
-  new_state = create_ci_newstate (dfa, nodes, hash);
-  if (BE (new_state == NULL, 0))
-    *err = REG_ESPACE;
+  re_state_table_unlock (dfa);
 
   return new_state;
 }
@@ -1529,7 +1616,6 @@ re_acquire_state_context (reg_errcode_t *err, const re_dfa_t *dfa,
   re_hashval_t hash;
   re_dfastate_t *new_state;
   struct re_state_table_entry *spot;
-  Idx i;
 #ifdef lint
   /* Suppress bogus uninitialized-variable warnings.  */
   *err = REG_NOERROR;
@@ -1542,18 +1628,23 @@ re_acquire_state_context (reg_errcode_t *err, const re_dfa_t *dfa,
   hash = calc_state_hash (nodes, context);
   spot = dfa->state_table + (hash & dfa->state_hash_mask);
 
-  for (i = 0 ; i < spot->num ; i++)
+  /* See re_acquire_state.  */
+  re_state_table_lock_shared (dfa);
+  new_state = find_state_context (spot, nodes, context, hash);
+  re_state_table_unlock_shared (dfa);
+  if (new_state != NULL)
+    return new_state;
+
+  re_state_table_lock (dfa);
+  new_state = find_state_context (spot, nodes, context, hash);
+  if (new_state == NULL)
     {
-      re_dfastate_t *state = spot->array[i];
-      if (state->hash == hash
-	  && state->context == context
-	  && re_node_set_compare (state->entrance_nodes, nodes))
-	return state;
+      /* There are no appropriate state in 'dfa', create the new one.  */
+      new_state = create_cd_newstate (dfa, nodes, context, hash);
+      if (BE (new_state == NULL, 0))
+	*err = REG_ESPACE;
     }
-  /* There are no appropriate state in 'dfa', create the new one.  */
-  new_state = create_cd_newstate (dfa, nodes, context, hash);
-  if (BE (new_state == NULL, 0))
-    *err = REG_ESPACE;
+  re_state_table_unlock (dfa);
 
   return new_state;
 }
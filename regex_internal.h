@@ -44,6 +44,45 @@
 # define __libc_lock_unlock(NAME) do { } while (0)
 #endif
 
+/* DFA states and transition tables are built lazily while matching.
+   In glibc, whole regexec() calls are serialized with dfa->lock.  Here,
+   several threads can match against the same compiled pattern at once:
+   the state table is guarded by a readers-writer lock, transition tables
+   are built under a mutex and published with release stores, so that
+   transit_state() can read them without locking.  */
+#if defined _LIBC
+# define re_state_table_lock_shared(dfa) do { } while (0)
+# define re_state_table_unlock_shared(dfa) do { } while (0)
+# define re_state_table_lock(dfa) do { } while (0)
+# define re_state_table_unlock(dfa) do { } while (0)
+# define re_trtable_lock(dfa) do { } while (0)
+# define re_trtable_unlock(dfa) do { } while (0)
+#else
+# include "threads.h"
+# include "memutils.h"
+# define re_state_table_lock_shared(dfa) \
+  my_rwlock_lock_shared ((my_rwlock *) &(dfa)->state_table_lock)
+# define re_state_table_unlock_shared(dfa) \
+  my_rwlock_unlock_shared ((my_rwlock *) &(dfa)->state_table_lock)
+# define re_state_table_lock(dfa) \
+  my_rwlock_lock ((my_rwlock *) &(dfa)->state_table_lock)
+# define re_state_table_unlock(dfa) \
+  my_rwlock_unlock ((my_rwlock *) &(dfa)->state_table_lock)
+# define re_trtable_lock(dfa) \
+  my_mutex_lock ((my_mutex *) &(dfa)->trtable_lock)
+# define re_trtable_unlock(dfa) \
+  my_mutex_unlock ((my_mutex *) &(dfa)->trtable_lock)
+#endif
+
+#if defined _MSC_VER
+/* Volatile accesses have acquire/release semantics on x86/x64 MSVC.  */
+# define re_load_acquire(p) (*(void *volatile *) &(p))
+# define re_store_release(p, v) (*(void *volatile *) &(p) = (v))
+#else
+# define re_load_acquire(p) __atomic_load_n (&(p), __ATOMIC_ACQUIRE)
+# define re_store_release(p, v) __atomic_store_n (&(p), (v), __ATOMIC_RELEASE)
+#endif
+
 /* In case that the system doesn't have isblank().  */
 #if !defined _LIBC && ! (defined isblank || (HAVE_ISBLANK && HAVE_DECL_ISBLANK))
 # define isblank(ch) ((ch) == ' ' || (ch) == '\t')
@@ -479,16 +518,38 @@ static unsigned int re_string_context_at (const re_string_t *input, Idx idx,
 # define MIN(a,b) ((a) < (b) ? (a) : (b))
 #endif
 
+/* In debug builds, allocations are counted, see regex_alloc_calls().  */
+#if defined _DEBUG && !defined _LIBC
+extern size_t re_alloc_calls;
+# if defined _MSC_VER
+#  define re_count_alloc() ((void) re_alloc_calls++)
+# else
+#  define re_count_alloc() \
+  ((void) __atomic_fetch_add (&re_alloc_calls, 1, __ATOMIC_RELAXED))
+# endif
+#else
+# define re_count_alloc() ((void) 0)
+#endif
+
 #ifdef RE_USE_DMALLOC
-#define re_malloc(type,size) (DMALLOC(type, size, "regex"))
-#define re_realloc(ptr,type,size) (DREALLOC(ptr, type, size, "regex"))
+#define re_malloc(type,size) (re_count_alloc (), DMALLOC(type, size, "regex"))
+#define re_realloc(ptr,type,size) (re_count_alloc (), DREALLOC(ptr, type, size, "regex"))
 #define re_free(ptr) DFREE (ptr)
 #else
-#define re_malloc(t,n) ((t *) malloc ((n) * sizeof (t)))
-#define re_realloc(p,t,n) ((t *) realloc (p, (n) * sizeof (t)))
+#define re_malloc(t,n) (re_count_alloc (), (t *) malloc ((n) * sizeof (t)))
+#define re_realloc(p,t,n) (re_count_alloc (), (t *) realloc (p, (n) * sizeof (t)))
 #define re_free(p) free (p)
 #endif
 
+/* Literal string required by the regex, see extract_literals.  */
+#define RE_LITERAL_MAX 32
+
+typedef struct
+{
+  Idx len;
+  unsigned char s[RE_LITERAL_MAX];
+} re_literal_t;
+
 struct bin_tree_t
 {
   struct bin_tree_t *parent;
@@ -638,6 +699,8 @@ typedef struct
   Idx nsub_tops;
   Idx asub_tops;
   re_sub_match_top_t **sub_tops;
+  /* Owner of the buffers above, see struct regmatch_ctx.  */
+  struct regmatch_ctx *ctx;
 } re_match_context_t;
 
 typedef struct
@@ -662,6 +725,48 @@ struct re_fail_stack_t
   Idx num;
   Idx alloc;
   struct re_fail_stack_ent_t *stack;
+  /* Entries below READY have REGS (of NREGS elements) and EPS_VIA_NODES
+     allocated, they are reused by push_fail_stack().  */
+  Idx ready;
+  Idx nregs;
+};
+
+/* Buffers of re_search_internal().  They are kept between calls in
+   regmatch_ctx_t of the caller and only grow, so matching doesn't
+   allocate in steady state.  regexec() uses a temporary one.  */
+
+struct regmatch_ctx
+{
+  /* Buffers of re_string_t and their lengths.  */
+  unsigned char *mbs;
+  Idx mbs_len;
+#ifdef RE_ENABLE_I18N
+  wint_t *wcs;
+  Idx wcs_len;
+  Idx *offsets;
+  Idx offsets_len;
+#endif
+  re_dfastate_t **state_log;
+  Idx state_log_alloc;
+  /* For prune_impossible_nodes().  */
+  re_dfastate_t **sifted_states;
+  Idx sifted_states_alloc;
+  re_dfastate_t **lim_states;
+  Idx lim_states_alloc;
+  /* Back reference cache of re_match_context_t.  */
+  struct re_backref_cache_entry *bkref_ents;
+  Idx abkref_ents;
+  re_sub_match_top_t **sub_tops;
+  Idx asub_tops;
+  /* For set_regs().  */
+  regmatch_t *prev_idx_match;
+  Idx prev_idx_match_alloc;
+  re_node_set eps_via_nodes;
+  struct re_fail_stack_t fs;
+  /* For sift_states_backward(), which is recursive with back references,
+     so only the outermost call uses it.  */
+  re_node_set sift_nodes;
+  bool sift_nodes_busy;
 };
 
 struct re_dfa_t
@@ -705,11 +810,20 @@ struct re_dfa_t
   bitset_t word_char;
   reg_syntax_t syntax;
   Idx *subexp_map;
+  /* Every match starts with PREFIX and contains MUST (empty if unknown),
+     used by re_search_internal to skip hopeless positions.  */
+  re_literal_t prefix;
+  re_literal_t must;
+  /* Pure DFA matcher, built on first use, see re_bool_match.  */
+  struct re_set *bool_set;
 #ifdef DEBUG
   char* re_str;
 #endif
 #ifdef _LIBC
   __libc_lock_define (, lock)
+#else
+  my_rwlock state_table_lock;
+  my_mutex trtable_lock;
 #endif
 };
 
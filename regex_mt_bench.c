@@ -0,0 +1,102 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// throughput of regexec() with several threads matching against the same compiled regex_t,
+// lock-free vs. serialized (as glibc does with dfa->lock)
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+#include "threads.h"
+
+#define LINES 200000
+#define LINES_PER_JOB 1000
+#define LINE_SIZE 96
+
+struct job
+{
+	regex_t *r;
+	char *lines;
+	bool serialize;
+	octa matched;
+};
+
+static my_mutex serialize_lock=MY_MUTEX_INITIALIZER;
+static my_mutex matched_lock=MY_MUTEX_INITIALIZER;
+
+static void worker (size_t i, void *param)
+{
+	struct job *j=(struct job*)param;
+	octa matched=0;
+
+	for (size_t l=i*LINES_PER_JOB; l<(i+1)*LINES_PER_JOB; l++)
+	{
+		int rc;
+		if (j->serialize)
+			my_mutex_lock(&serialize_lock);
+		rc=regexec(j->r, j->lines+l*LINE_SIZE, 0, NULL, 0);
+		if (j->serialize)
+			my_mutex_unlock(&serialize_lock);
+		if (rc==0)
+			matched++;
+	};
+	my_mutex_lock(&matched_lock);
+	j->matched+=matched;
+	my_mutex_unlock(&matched_lock);
+};
+
+// optional argument: max number of threads, number of CPUs by default
+int main(int argc, char **argv)
+{
+	const char *levels[]={ "INFO", "DEBUG", "WARN", "ERROR" };
+	struct job j;
+	regex_t r;
+	unsigned max_threads=argc>1 ? atoi(argv[1]) : get_CPUs_count();
+
+	j.lines=DMALLOC(char, LINES*LINE_SIZE, "lines");
+	for (size_t l=0; l<LINES; l++)
+	{
+		unsigned h=l*2654435761U;
+		snprintf (j.lines+l*LINE_SIZE, LINE_SIZE, "2016-01-%02d 12:%02d:%02d [%s] request id=%u took %ums from 10.0.%u.%u",
+				1+h%28, (h>>5)%60, (h>>11)%60, levels[(h>>17)%4], h, (h>>3)%2000, (h>>8)&255, (h>>16)&255);
+	};
+
+	regcomp_or_die(&r, "\\[(ERROR|WARN)\\].*took [0-9]{4,}ms", REG_EXTENDED | REG_NOSUB);
+	j.r=&r;
+
+	for (int serialize=1; serialize>=0; serialize--)
+		for (unsigned threads=1; threads<=max_threads; threads*=2)
+		{
+			double t=get_monotonic_time();
+			j.serialize=serialize;
+			j.matched=0;
+			parallel_for (LINES/LINES_PER_JOB, threads, worker, &j);
+			t=get_monotonic_time()-t;
+			printf ("%-10s threads=%-3u %10.0f lines/s (matched %d)\n", serialize ? "serialized" : "lock-free",
+					threads, LINES/t, (int)j.matched);
+		};
+
+	regfree(&r);
+	DFREE(j.lines);
+	dump_unfreed_blocks();
+};
@@ -0,0 +1,126 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// log grep: regexec() with and without literal prefilter, line by line and over whole buffer
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+#define LINES 200000
+#define ROUNDS 5
+
+static const char *pats[]={ "ERROR: .* timeout", "[a-z]+ timeout after [0-9]+ms", "id=12345[0-9]" };
+
+static char *make_log (size_t *size)
+{
+	const char *levels[]={ "INFO", "DEBUG", "WARN", "ERROR" };
+	const char *msgs[]={ "request served", "cache miss", "connection reset", "upstream timeout" };
+	char *buf=DMALLOC(char, LINES*128, "log");
+	size_t pos=0;
+
+	for (size_t l=0; l<LINES; l++)
+	{
+		unsigned h=l*2654435761U;
+		pos+=sprintf (buf+pos, "2016-01-%02d 12:%02d:%02d %s: %s id=%u took %ums\n",
+				1+h%28, (h>>5)%60, (h>>11)%60, levels[(h>>17)%4], msgs[(h>>20)%4], h%1000000, (h>>3)%2000);
+	};
+	*size=pos;
+	return buf;
+};
+
+// count matching lines
+static int grep_lines (regex_t *r, char *log, size_t size)
+{
+	int matched=0;
+	regmatch_t m[1];
+
+	for (size_t pos=0; pos<size; )
+	{
+		char *eol=memchr (log+pos, '\n', size-pos);
+		m[0].rm_so=pos;
+		m[0].rm_eo=eol-log;
+		if (regexec (r, log, 1, m, REG_STARTEND)==0)
+			matched++;
+		pos=eol-log+1;
+	};
+	return matched;
+};
+
+// REG_NEWLINE, find all matches in the whole buffer
+static int grep_buffer (regex_t *r, char *log, size_t size)
+{
+	int matched=0;
+	regmatch_t m[1];
+
+	for (size_t pos=0; pos<size; )
+	{
+		m[0].rm_so=pos;
+		m[0].rm_eo=size;
+		if (regexec (r, log, 1, m, REG_STARTEND))
+			break;
+		matched++;
+		pos=m[0].rm_eo>m[0].rm_so ? m[0].rm_eo : m[0].rm_eo+1;
+	};
+	return matched;
+};
+
+int main()
+{
+	size_t size;
+	char *log=make_log (&size);
+
+	for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+	{
+		double speed[2][2];
+		int matched[2][2];
+
+		for (int prefilter=0; prefilter<2; prefilter++)
+		{
+			regex_t r, rn;
+			regex_prefilter_enabled=prefilter;
+			regcomp_or_die (&r, pats[p], REG_EXTENDED | REG_NOSUB);
+			regcomp_or_die (&rn, pats[p], REG_EXTENDED | REG_NEWLINE);
+
+			double t=get_monotonic_time();
+			for (int i=0; i<ROUNDS; i++)
+				matched[prefilter][0]=grep_lines (&r, log, size);
+			speed[prefilter][0]=(double)size*ROUNDS/_1MiB/(get_monotonic_time()-t);
+
+			t=get_monotonic_time();
+			for (int i=0; i<ROUNDS; i++)
+				matched[prefilter][1]=grep_buffer (&rn, log, size);
+			speed[prefilter][1]=(double)size*ROUNDS/_1MiB/(get_monotonic_time()-t);
+
+			regfree (&r);
+			regfree (&rn);
+		};
+		oassert (matched[0][0]==matched[1][0] && matched[0][1]==matched[1][1]);
+		printf ("[%s]: %d lines\n", pats[p], matched[1][0]);
+		printf ("  by line:     %8.1f -> %8.1f MiB/s (x%.1f)\n", speed[0][0], speed[1][0], speed[1][0]/speed[0][0]);
+		printf ("  whole buffer:%8.1f -> %8.1f MiB/s (x%.1f)\n", speed[0][1], speed[1][1], speed[1][1]/speed[0][1]);
+	};
+
+	regex_prefilter_enabled=true;
+	DFREE(log);
+	dump_unfreed_blocks();
+};
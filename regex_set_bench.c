@@ -0,0 +1,154 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// log line classification: one regex set vs regexec() of each pattern
+
+#include <stdio.h>
+#include <string.h>
+
+#include "regex.h"
+#include "regex_helpers.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+#define PATTERNS 300
+#define LINES 20000
+#define ROUNDS 5
+
+static const char *levels[]={ "INFO", "DEBUG", "WARN", "ERROR" };
+static const char *msgs[]={ "request served", "cache miss", "connection reset", "upstream timeout" };
+
+static char *make_log (size_t *size)
+{
+	char *buf=DMALLOC(char, LINES*128, "log");
+	size_t pos=0;
+
+	for (size_t l=0; l<LINES; l++)
+	{
+		unsigned h=l*2654435761U;
+		pos+=sprintf (buf+pos, "2016-01-%02d 12:%02d:%02d %s: svc%03u %s id=%u took %ums\n",
+				1+h%28, (h>>5)%60, (h>>11)%60, levels[(h>>17)%4], (h>>7)%150, msgs[(h>>20)%4], h%1000000, (h>>3)%2000);
+	};
+	*size=pos;
+	return buf;
+};
+
+static char **make_patterns()
+{
+	char **pats=DMALLOC(char*, PATTERNS, "pats");
+	char buf[128];
+
+	for (int i=0; i<PATTERNS; i++)
+	{
+		switch (i%3)
+		{
+			case 0:
+				sprintf (buf, "%s: svc%03d (%s|%s)", levels[i%4], i/2, msgs[i%4], msgs[(i/4)%4]);
+				break;
+			case 1:
+				sprintf (buf, "svc%03d .* took %d[0-9]ms", i/2, i%10);
+				break;
+			default:
+				sprintf (buf, "id=%d[0-9]{3}\\b", 100+i);
+				break;
+		};
+		pats[i]=DSTRDUP(buf, "pat");
+	};
+	return pats;
+};
+
+// total number of (line, pattern) matches
+static octa classify_regexec (regex_t *rs, char *log, size_t size)
+{
+	octa matched=0;
+	regmatch_t m[1];
+
+	for (size_t pos=0; pos<size; )
+	{
+		char *eol=memchr (log+pos, '\n', size-pos);
+		m[0].rm_so=pos;
+		m[0].rm_eo=eol-log;
+		for (int p=0; p<PATTERNS; p++)
+			if (regexec (&rs[p], log, 1, m, REG_STARTEND)==0)
+				matched++;
+		pos=eol-log+1;
+	};
+	return matched;
+};
+
+static octa classify_set (re_set_t *set, char *log, size_t size)
+{
+	octa matched=0;
+	size_t ids[PATTERNS], nids;
+
+	for (size_t pos=0; pos<size; )
+	{
+		char *eol=memchr (log+pos, '\n', size-pos);
+		oassert (re_set_match (set, log+pos, eol-log-pos, 0, ids, &nids)==0);
+		matched+=nids;
+		pos=eol-log+1;
+	};
+	return matched;
+};
+
+int main()
+{
+	size_t size, bad;
+	char *log=make_log (&size);
+	char **pats=make_patterns();
+	regex_t *rs=DMALLOC(regex_t, PATTERNS, "regex_t");
+	re_set_t *set;
+	octa matched[3];
+	double t, speed[3];
+
+	for (int p=0; p<PATTERNS; p++)
+		regcomp_or_die (&rs[p], pats[p], REG_EXTENDED | REG_NOSUB);
+	if (re_set_compile (&set, (const char**)pats, PATTERNS, REG_EXTENDED, &bad))
+		die ("re_set_compile() failed on [%s]\n", pats[bad]);
+
+	t=get_monotonic_time();
+	matched[0]=classify_regexec (rs, log, size);
+	speed[0]=LINES/(get_monotonic_time()-t);
+
+	// automaton states are built lazily, so the first pass is slower
+	t=get_monotonic_time();
+	matched[1]=classify_set (set, log, size);
+	speed[1]=LINES/(get_monotonic_time()-t);
+
+	t=get_monotonic_time();
+	for (int i=0; i<ROUNDS; i++)
+		matched[2]=classify_set (set, log, size);
+	speed[2]=(double)LINES*ROUNDS/(get_monotonic_time()-t);
+
+	oassert (matched[0]==matched[1] && matched[1]==matched[2]);
+	printf ("%d patterns, %d lines, %d matches, %d set states\n", PATTERNS, LINES, (int)matched[0], (int)re_set_states (set));
+	printf ("sequential regexec():   %10.0f lines/s\n", speed[0]);
+	printf ("regex set, first pass:  %10.0f lines/s (x%.1f)\n", speed[1], speed[1]/speed[0]);
+	printf ("regex set, next passes: %10.0f lines/s (x%.1f)\n", speed[2], speed[2]/speed[0]);
+
+	re_set_free (set);
+	for (int p=0; p<PATTERNS; p++)
+	{
+		regfree (&rs[p]);
+		DFREE (pats[p]);
+	};
+	DFREE (rs);
+	DFREE (pats);
+	DFREE (log);
+	dump_unfreed_blocks();
+};
@@ -16,8 +16,12 @@
  */
 
 #include "regex.h"
+#include "regex_helpers.h"
 #include "dmalloc.h"
 #include "stuff.h"
+#include "oassert.h"
+#include "threads.h"
+#include "files.h"
 
 void tst2()
 {
@@ -51,6 +55,653 @@ void tst2()
     regfree (&trace_skip_pat);
 };
 
+static const char *regcache_pats[]={ "^a+b$", "c[0-9]+", "(x|y)z", "^$", "hello" };
+
+static void regcache_worker (size_t i, void *param)
+{
+    regex_t *r=regcache_get (regcache_pats[i%5], REG_EXTENDED | REG_NOSUB);
+    regex_t *r2=regcache_get (regcache_pats[i%5], REG_EXTENDED | REG_NOSUB);
+    oassert (r==r2);
+    regcache_release (r2);
+    regcache_release (r);
+};
+
+void regcache_test()
+{
+    struct regcache_stats st;
+
+    regex_t *r1=regcache_get ("^a+b$", REG_EXTENDED);
+    oassert (regexec (r1, "aaab", 0, NULL, 0)==0);
+    regcache_release (r1);
+    regex_t *r2=regcache_get ("^a+b$", REG_EXTENDED);
+    oassert (r1==r2);
+    regcache_release (r2);
+    // different cflags, different entry
+    regex_t *r3=regcache_get ("^a+b$", REG_EXTENDED | REG_ICASE);
+    oassert (r3!=r1);
+    oassert (regexec (r3, "AAB", 0, NULL, 0)==0);
+    regcache_release (r3);
+    regcache_get_stats (&st);
+    printf ("regcache: hits=%d misses=%d evictions=%d entries=%d\n", (int)st.hits, (int)st.misses, (int)st.evictions, (int)st.entries);
+
+    // LRU: "^a+b$"/REG_EXTENDED is least recently used and must go first
+    regcache_set_capacity (2);
+    regex_t *r4=regcache_get ("c[0-9]+", REG_EXTENDED);
+    regcache_release (r4);
+    regcache_get_stats (&st);
+    printf ("regcache: hits=%d misses=%d evictions=%d entries=%d\n", (int)st.hits, (int)st.misses, (int)st.evictions, (int)st.entries);
+    r2=regcache_get ("^a+b$", REG_EXTENDED | REG_ICASE);
+    regcache_release (r2);
+
+    // entry in use survives eviction
+    regex_t *held=regcache_get ("held", 0);
+    regcache_set_capacity (0);
+    oassert (regexec (held, "is held?", 0, NULL, 0)==0);
+    regcache_release (held);
+    regcache_get_stats (&st);
+    printf ("regcache: hits=%d misses=%d evictions=%d entries=%d\n", (int)st.hits, (int)st.misses, (int)st.evictions, (int)st.entries);
+
+    regcache_set_capacity (64);
+    parallel_for (10000, 8, regcache_worker, NULL);
+    regcache_get_stats (&st);
+    printf ("regcache: hits+misses=%d entries=%d\n", (int)(st.hits+st.misses), (int)st.entries);
+
+    regcache_clear ();
+};
+
+struct stream_matches
+{
+    int cnt;
+    octa start[256], end[256];
+};
+
+static bool stream_cb (octa start, octa end, void *param)
+{
+    struct stream_matches *m=(struct stream_matches*)param;
+    oassert (m->cnt<256);
+    m->start[m->cnt]=start;
+    m->end[m->cnt]=end;
+    m->cnt++;
+    return true;
+};
+
+static bool stream_stop_cb (octa start, octa end, void *param)
+{
+    stream_cb (start, end, param);
+    return false;
+};
+
+static void stream_by_regexec (regex_t *r, const char *text, struct stream_matches *out)
+{
+    size_t len=strlen(text), start=0;
+    regmatch_t m[1];
+
+    out->cnt=0;
+    while (start<=len)
+    {
+        m[0].rm_so=start;
+        m[0].rm_eo=len;
+        if (regexec (r, text, 1, m, REG_STARTEND))
+            break;
+        oassert (out->cnt<256);
+        out->start[out->cnt]=m[0].rm_so;
+        out->end[out->cnt]=m[0].rm_eo;
+        out->cnt++;
+        start=m[0].rm_eo==m[0].rm_so ? m[0].rm_eo+1 : m[0].rm_eo;
+    };
+};
+
+static void stream_by_chunks (regex_t *r, const char *text, size_t chunk, struct stream_matches *out)
+{
+    size_t len=strlen(text);
+    re_stream_t *st;
+
+    out->cnt=0;
+    oassert (re_stream_begin (&st, r, 0, 0, stream_cb, out)==REG_NOERROR);
+    for (size_t i=0; i<len; i+=chunk)
+        oassert (re_stream_feed (st, text+i, min(chunk, len-i))==REG_NOERROR);
+    oassert (re_stream_end (st)==REG_NOERROR);
+};
+
+void stream_test()
+{
+    const char *text="foo bar\nfoobar abcd aab\n\n12 word words wo\nFOO ab x xx bar\nabab";
+    const char *pats[]={ "a+b", "[0-9]+", "^foo", "bar$", "\\<wo[a-z]*\\>", "\\bx", "x*",
+        "(ab|abc)d?", "^$", ".*", "[[:space:]]+", "o$", "^", "\\Bo+", "(ab)+$" };
+    const int cflags[]={ REG_EXTENDED, REG_EXTENDED | REG_NEWLINE, REG_EXTENDED | REG_ICASE };
+    const size_t chunks[]={ 1, 2, 3, 5, 7, 64, 1000 };
+    struct stream_matches ref, got;
+    regex_t r;
+    re_stream_t *st;
+
+    for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+        for (int f=0; f<sizeof(cflags)/sizeof(cflags[0]); f++)
+        {
+            regcomp_or_die (&r, pats[p], cflags[f]);
+            stream_by_regexec (&r, text, &ref);
+            for (int c=0; c<sizeof(chunks)/sizeof(chunks[0]); c++)
+            {
+                stream_by_chunks (&r, text, chunks[c], &got);
+                oassert (got.cnt==ref.cnt);
+                for (int i=0; i<ref.cnt; i++)
+                    oassert (got.start[i]==ref.start[i] && got.end[i]==ref.end[i]);
+            };
+            printf ("stream: [%s] cflags=%d: %d matches", pats[p], cflags[f], ref.cnt);
+            if (ref.cnt)
+                printf (", first at [%d, %d), last at [%d, %d)", (int)ref.start[0], (int)ref.end[0],
+                        (int)ref.start[ref.cnt-1], (int)ref.end[ref.cnt-1]);
+            printf ("\n");
+            regfree (&r);
+        };
+
+    // match spanning many chunks, absolute offsets
+    regcomp_or_die (&r, "x[ab]+y", REG_EXTENDED);
+    oassert (re_stream_begin (&st, &r, 0, 0, stream_cb, &got)==REG_NOERROR);
+    got.cnt=0;
+    oassert (re_stream_feed (st, "..x", 3)==REG_NOERROR);
+    for (int i=0; i<1000; i++)
+        oassert (re_stream_feed (st, "abab", 4)==REG_NOERROR);
+    oassert (re_stream_feed (st, "y..xay", 6)==REG_NOERROR);
+    oassert (re_stream_end (st)==REG_NOERROR);
+    oassert (got.cnt==2);
+    oassert (got.start[0]==2 && got.end[0]==4004);
+    oassert (got.start[1]==4006 && got.end[1]==4009);
+
+    // memory is bounded by max_match_len, longer candidates are dropped
+    oassert (re_stream_begin (&st, &r, 0, 100, stream_cb, &got)==REG_NOERROR);
+    got.cnt=0;
+    oassert (re_stream_feed (st, "x", 1)==REG_NOERROR);
+    for (int i=0; i<1000; i++)
+    {
+        oassert (re_stream_feed (st, "abab", 4)==REG_NOERROR);
+        oassert (re_stream_retained (st)<=100+4);
+    };
+    oassert (re_stream_feed (st, "y xaby", 6)==REG_NOERROR);
+    oassert (re_stream_end (st)==REG_NOERROR);
+    oassert (got.cnt==1);
+    oassert (got.start[0]==4003 && got.end[0]==4007);
+
+    // callback may stop the search
+    oassert (re_stream_begin (&st, &r, 0, 0, stream_stop_cb, &got)==REG_NOERROR);
+    got.cnt=0;
+    oassert (re_stream_feed (st, "xay xby", 7)==REG_NOERROR);
+    oassert (re_stream_end (st)==REG_NOERROR);
+    oassert (got.cnt==1);
+    regfree (&r);
+
+    // back-references need the whole input
+    regcomp_or_die (&r, "(a)\\1", REG_EXTENDED);
+    oassert (re_stream_begin (&st, &r, 0, 0, stream_cb, &got)==REG_BADPAT);
+    regfree (&r);
+};
+
+// many DFA states are built lazily, while all threads match against the same regex_t
+#define SHARED_INPUTS 64
+
+struct shared_regex_job
+{
+    regex_t r;
+    char inputs[SHARED_INPUTS][40];
+    regmatch_t expected[SHARED_INPUTS];
+    int expected_rc[SHARED_INPUTS];
+};
+
+static void shared_regex_worker (size_t i, void *param)
+{
+    struct shared_regex_job *j=(struct shared_regex_job*)param;
+    regmatch_t m[1];
+    int k=i%SHARED_INPUTS;
+    int rc=regexec (&j->r, j->inputs[k], 1, m, 0);
+
+    oassert (rc==j->expected_rc[k]);
+    if (rc==0)
+        oassert (m[0].rm_so==j->expected[k].rm_so && m[0].rm_eo==j->expected[k].rm_eo);
+};
+
+void shared_regex_test()
+{
+    const char *pat="(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)c";
+    struct shared_regex_job *j=DCALLOC(struct shared_regex_job, 1, "shared_regex_job");
+    regex_t ref;
+    int matched=0;
+
+    regcomp_or_die (&ref, pat, REG_EXTENDED);
+    for (int i=0; i<SHARED_INPUTS; i++)
+    {
+        int len=10+i%25;
+        for (int k=0; k<len; k++)
+            j->inputs[i][k]=((i*2654435761U)>>(k%29))&1 ? 'a' : 'b';
+        j->inputs[i][len]=i%3 ? 'c' : 'x';
+        j->inputs[i][len+1]=0;
+        j->expected_rc[i]=regexec (&ref, j->inputs[i], 1, &j->expected[i], 0);
+        if (j->expected_rc[i]==0)
+            matched++;
+    };
+    regfree (&ref);
+
+    // fresh regex_t, no DFA states besides initial ones
+    regcomp_or_die (&j->r, pat, REG_EXTENDED);
+    parallel_for (SHARED_INPUTS*100, 8, shared_regex_worker, j);
+    regfree (&j->r);
+    printf ("shared regex: %d of %d inputs matched\n", matched, SHARED_INPUTS);
+    DFREE (j);
+};
+
+// results must be the same with and without literal prefilter
+void prefilter_test()
+{
+    const char *pats[]={ "ERROR: .* timeout", "abc", "a(bc|bd)e", "(abc|abd)", "x[0-9]+yz", "^ab+c", "ab$",
+        "(ab)*cd", "a.c", "\\<abc\\>", "(a|b)c(d|e)", "ERR(OR)?:", "c(ab)+", "((ab)c|abd)e?" };
+    const char alphabet[]="abcdexyz019ERO: \n";
+    char buf[200];
+    regex_t with, without;
+    regmatch_t m1[3], m2[3];
+    int total=0;
+
+    for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+    {
+        int matched=0;
+        regcomp_or_die (&with, pats[p], REG_EXTENDED);
+        regex_prefilter_enabled=false;
+        regcomp_or_die (&without, pats[p], REG_EXTENDED);
+        regex_prefilter_enabled=true;
+        for (int round=0; round<500; round++)
+        {
+            int len=round%(sizeof(buf)-1);
+            for (int i=0; i<len; i++)
+                buf[i]=alphabet[((round*2654435761U)^(i*40503U))%(sizeof(alphabet)-1)];
+            buf[len]=0;
+            // plant pattern-looking pieces
+            if (round%3==0 && len>20)
+                memcpy (buf+round%(len-20), round%2 ? "ERROR: abc timeout" : "abde x019yz abc", 15);
+            int rc1=regexec (&with, buf, 3, m1, 0);
+            int rc2=regexec (&without, buf, 3, m2, 0);
+            oassert (rc1==rc2);
+            if (rc1==0)
+            {
+                matched++;
+                for (int i=0; i<3; i++)
+                    oassert (m1[i].rm_so==m2[i].rm_so && m1[i].rm_eo==m2[i].rm_eo);
+            };
+        };
+        total+=matched;
+        regfree (&with);
+        regfree (&without);
+    };
+    printf ("prefilter: %d matches\n", total);
+};
+
+// regex set must report exactly those patterns which regexec() finds
+static void set_check (const char **pats, size_t n, int cflags, const char *text, int eflags, size_t *total)
+{
+    re_set_t *set;
+    size_t ids[32], nids, j=0;
+    int rc=re_set_compile (&set, pats, n, cflags, NULL);
+    oassert (rc==0);
+    rc=re_set_match (set, text, strlen(text), eflags, ids, &nids);
+    oassert (rc==0);
+    for (size_t p=0; p<n; p++)
+    {
+        regex_t r;
+        regcomp_or_die (&r, pats[p], cflags | REG_NOSUB);
+        if (regexec (&r, text, 0, NULL, eflags)==0)
+        {
+            oassert (j<nids && ids[j]==p);
+            j++;
+        };
+        regfree (&r);
+    };
+    oassert (j==nids);
+    *total+=nids;
+    re_set_free (set);
+};
+
+void set_test()
+{
+    const char *pats[]={ "a+b", "[0-9]+", "^foo", "bar$", "\\<wo[a-z]*\\>", "\\bx", "x*", "(ab|cd)e",
+        "^$", "o\nF", "[^a-z ]+", "FOO|Bar", "w(or)+d", "q", "^ab", "b\\b", "a.*z", "(x|y){2}" };
+    const char *texts[]={ "", "foo bar\nfoobar abcd aab\n\n12 word words wo\nFOO ab x xx bar\nabab",
+        "abcde", "xy\nbar", "foo", "wo", "abz" };
+    int cflags[]={ REG_EXTENDED, REG_EXTENDED | REG_ICASE, REG_EXTENDED | REG_NEWLINE };
+    size_t n=sizeof(pats)/sizeof(pats[0]), total=0, bad;
+    re_set_t *set;
+
+    for (int c=0; c<3; c++)
+        for (int t=0; t<sizeof(texts)/sizeof(texts[0]); t++)
+            for (int eflags=0; eflags<=(REG_NOTBOL | REG_NOTEOL); eflags+=REG_NOTBOL)
+            {
+                set_check (pats, n, cflags[c], texts[t], eflags, &total);
+                // subsets too: early exit when all patterns are matched
+                set_check (pats+t, 3, cflags[c], texts[t], eflags, &total);
+            };
+    const char *bre[]={ "a\\{2\\}", "\\(ab\\)*c", "a|b", "^*x" };
+    set_check (bre, 4, 0, "aac a|b *x", 0, &total);
+    printf ("regex set: %d matches\n", (int)total);
+
+    const char *wrong[]={ "abc", "a(b", "c" };
+    oassert (re_set_compile (&set, wrong, 3, REG_EXTENDED, &bad)==REG_EPAREN && bad==1);
+    const char *backref[]={ "abc", "d", "(a)\\1" };
+    oassert (re_set_compile (&set, backref, 3, REG_EXTENDED, &bad)==REG_BADPAT && bad==2);
+};
+
+// regexec_ctx() must give the same results as regexec(), one context is shared by all regexes;
+// once buffers are grown, there must be no allocations, except with back-references
+void ctx_test()
+{
+    struct { const char *pat; int cflags; bool backref; } pats[]={
+        { "a([0-9]+)z", REG_EXTENDED }, { "(a|b)*c(d|e)", REG_EXTENDED }, { "abc", REG_EXTENDED | REG_ICASE },
+        { "^x.*y$", REG_EXTENDED | REG_NEWLINE }, { "(a*)*b", REG_EXTENDED }, { "((a)|b)+", REG_EXTENDED },
+        { "c(ab)+", REG_EXTENDED | REG_NOSUB }, { "(ab)\\1", REG_EXTENDED, true }, { "\\(a*\\)b\\1", 0, true } };
+    const char alphabet[]="abcdexyz0129AB\n";
+    char buf[300];
+    regex_t r[sizeof(pats)/sizeof(pats[0])];
+    regmatch_t m1[4], m2[4];
+    regmatch_ctx_t *ctx=regmatch_ctx_new();
+    int total=0;
+
+    for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+        regcomp_or_die (&r[p], pats[p].pat, pats[p].cflags);
+
+    for (int pass=0; pass<2; pass++)
+        for (int round=0; round<200; round++)
+        {
+            int len=(round*7)%(sizeof(buf)-1);
+            for (int i=0; i<len; i++)
+                buf[i]=alphabet[((round*2654435761U)^(i*40503U))%(sizeof(alphabet)-1)];
+            buf[len]=0;
+            for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+            {
+                int rc1=regexec (&r[p], buf, 4, m1, 0);
+                size_t allocs=regex_alloc_calls();
+                int rc2;
+                if (round%2)
+                    rc2=regexec_ctx (ctx, &r[p], buf, 4, m2, 0);
+                else
+                {
+                    // the same with REG_STARTEND
+                    m2[0].rm_so=0;
+                    m2[0].rm_eo=len;
+                    rc2=regexec_ctx (ctx, &r[p], buf, 4, m2, REG_STARTEND);
+                };
+                if (pass==1 && !pats[p].backref)
+                    oassert (regex_alloc_calls()==allocs);
+                oassert (rc1==rc2);
+                if (rc1==0)
+                {
+                    if (pass==0)
+                        total++;
+                    if (pats[p].cflags & REG_NOSUB)
+                        continue;
+                    for (int i=0; i<4; i++)
+                        oassert (m1[i].rm_so==m2[i].rm_so && m1[i].rm_eo==m2[i].rm_eo);
+                };
+            };
+        };
+
+    for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+        regfree (&r[p]);
+    regmatch_ctx_free (ctx);
+    printf ("regmatch ctx: %d matches\n", total);
+};
+
+// regex loaded from a blob must match the same as the original one, corrupted blobs must be rejected
+void blob_test()
+{
+    struct { const char *pat; int cflags; } pats[]={
+        { "a([0-9]+)z", REG_EXTENDED }, { "(a|b)*c(d|e)", REG_EXTENDED }, { "abc", REG_EXTENDED | REG_ICASE },
+        { "^x.*y$", REG_EXTENDED | REG_NEWLINE }, { "\\<ab[^c]\\>", REG_EXTENDED }, { "((a)|b)+", REG_EXTENDED },
+        { "c(ab)+", REG_EXTENDED | REG_NOSUB }, { "(ab)\\1", REG_EXTENDED }, { "\\(a*\\)b\\1", 0 },
+        { "a\\{2,3\\}[xyz]", 0 }, { "(^|[^0-9])[0-9]{2}($|[^0-9])", REG_EXTENDED }, { "\\bde?\\B", REG_EXTENDED },
+        // eclosures with duplicate nodes
+        { "a**", REG_EXTENDED }, { "(a*)*", REG_EXTENDED }, { "(a|b*)*", REG_EXTENDED }, { "((a)*)*", REG_EXTENDED } };
+    const char alphabet[]="abcdexyz0129AB \n";
+    char buf[100];
+    regmatch_t m1[4], m2[4];
+    int total=0, rejected=0;
+
+    for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+        for (int with_states=0; with_states<2; with_states++)
+        {
+            regex_t r, loaded;
+            void *blob;
+            size_t len;
+
+            regcomp_or_die (&r, pats[p].pat, pats[p].cflags);
+            // build some DFA states
+            regexec (&r, "abcde xyz 0123 aab ababc", 4, m1, 0);
+            oassert (re_blob_save (&r, with_states, &blob, &len)==0);
+            oassert (re_blob_load (&loaded, blob, len)==0);
+            for (int round=0; round<200; round++)
+            {
+                int l=(round*7)%(sizeof(buf)-1);
+                for (int i=0; i<l; i++)
+                    buf[i]=alphabet[((round*2654435761U)^(i*40503U))%(sizeof(alphabet)-1)];
+                buf[l]=0;
+                int rc1=regexec (&r, buf, 4, m1, 0);
+                int rc2=regexec (&loaded, buf, 4, m2, 0);
+                oassert (rc1==rc2);
+                if (rc1==0)
+                {
+                    total++;
+                    if (pats[p].cflags & REG_NOSUB)
+                        continue;
+                    for (int i=0; i<4; i++)
+                        oassert (m1[i].rm_so==m2[i].rm_so && m1[i].rm_eo==m2[i].rm_eo);
+                };
+            };
+            regfree (&loaded);
+
+            // truncated and damaged blobs
+            for (size_t l=0; l<len; l+=1+l/8)
+            {
+                oassert (re_blob_load (&loaded, blob, l)==REG_BADPAT);
+                rejected++;
+            };
+            for (size_t i=0; i<len; i+=1+i/8)
+            {
+                ((byte*)blob)[i]^=0x10;
+                oassert (re_blob_load (&loaded, blob, len)==REG_BADPAT);
+                ((byte*)blob)[i]^=0x10;
+                rejected++;
+            };
+            oassert (re_blob_load (&loaded, blob, len)==0);
+            regfree (&loaded);
+            free (blob);
+            regfree (&r);
+        };
+    printf ("regex blob: %d matches, %d broken blobs rejected\n", total, rejected);
+};
+
+// a regex warmed by many subjects has many DFA states, some of them equivalent (a context independent
+// state and a state of context 0 with the same nodes); the loaded regex must keep all of them distinct
+void blob_warm_test()
+{
+    const char *pats[]={ "[^a]*^cab", "(^|b)a\\>", "[^b]*\\Bab|c$" };
+    const char alphabet[]="abc \n";
+    char buf[40];
+    regmatch_t m1[1], m2[1];
+    int total=0;
+
+    for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+        for (int newline=0; newline<2; newline++)
+        {
+            regex_t r, loaded;
+            void *blob;
+            size_t len;
+
+            regcomp_or_die (&r, pats[p], REG_EXTENDED | (newline ? REG_NEWLINE : 0));
+            for (int round=0; round<20000; round++)
+            {
+                int l=(round*7)%(sizeof(buf)-1);
+                for (int i=0; i<l; i++)
+                    buf[i]=alphabet[((round*2654435761U)^(i*40503U))%(sizeof(alphabet)-1)];
+                buf[l]=0;
+                if (round==5000)
+                {
+                    oassert (re_blob_save (&r, true, &blob, &len)==0);
+                    oassert (re_blob_load (&loaded, blob, len)==0);
+                    free (blob);
+                };
+                if (round<5000)
+                {
+                    regexec (&r, buf, 0, NULL, 0);
+                    regexec (&r, buf, 1, m1, 0);
+                    continue;
+                };
+                int rc1=regexec (&r, buf, 1, m1, 0);
+                int rc2=regexec (&loaded, buf, 1, m2, 0);
+                oassert (rc1==rc2);
+                oassert (regexec (&r, buf, 0, NULL, 0)==regexec (&loaded, buf, 0, NULL, 0));
+                if (rc1==0)
+                {
+                    total++;
+                    oassert (m1[0].rm_so==m2[0].rm_so && m1[0].rm_eo==m2[0].rm_eo);
+                };
+            };
+            regfree (&loaded);
+            regfree (&r);
+        };
+    printf ("regex blob, warm: %d matches\n", total);
+};
+
+// pure DFA matching (nmatch==0 or REG_NOSUB) must agree with the full matcher
+void bool_dfa_test()
+{
+    const char *pats[]={ "abc", "a+b", "^foo", "bar$", "\\<wo[a-z]*\\>", "\\bx", "x*", "(ab|cd)e", "^$",
+        "o\nF", "[^a-z ]+", "FOO|Bar", "w(or)+d", "b\\b", "a.*z", "(x|y){2}", "\\Bo", "^a|b$", "ERROR: .* timeout",
+        "x[0-9]+yz", "(a|b)c(d|e)", "c(ab)+", "(ab)\\1" };
+    int cflags[]={ REG_EXTENDED, REG_EXTENDED | REG_ICASE, REG_EXTENDED | REG_NEWLINE, REG_EXTENDED | REG_NOSUB };
+    const char alphabet[]="abcdefoxyzw019ERO: \n";
+    char buf[120];
+    regmatch_t m[1];
+    int total=0;
+
+    for (int c=0; c<sizeof(cflags)/sizeof(cflags[0]); c++)
+        for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+        {
+            regex_t r;
+            regcomp_or_die (&r, pats[p], cflags[c]);
+            for (int round=0; round<150; round++)
+            {
+                int len=round%(sizeof(buf)-1);
+                for (int i=0; i<len; i++)
+                    buf[i]=alphabet[((round*2654435761U)^(i*40503U))%(sizeof(alphabet)-1)];
+                buf[len]=0;
+                if (round%4==0 && len>20)
+                    memcpy (buf+round%(len-20), round%8 ? "foo bar\nFOO abcde" : "ERROR: a timeout", 16);
+                int eflags=round%3==0 ? REG_NOTBOL : round%3==1 ? REG_NOTEOL : 0;
+                int start=round%5 ? 0 : round%(len+1);
+
+                m[0].rm_so=start;
+                m[0].rm_eo=len;
+                regex_bool_dfa_enabled=false;
+                int rc1=regexec (&r, buf, 1, m, eflags | REG_STARTEND);
+                if (rc1==0)
+                    total++;
+                m[0].rm_so=start;
+                m[0].rm_eo=len;
+                int rc2=regexec (&r, buf, 0, m, eflags | REG_STARTEND);
+                regex_bool_dfa_enabled=true;
+                int rc3=regexec (&r, buf, 0, m, eflags | REG_STARTEND);
+                oassert (rc1==rc2 && rc2==rc3);
+                if (start==0)
+                    oassert (regexec_bool (&r, buf, len, eflags)==rc3);
+            };
+            // rm_so>rm_eo is no match for the pure DFA, and nothing is read past rm_eo
+            m[0].rm_so=11;
+            m[0].rm_eo=10;
+            oassert (regexec (&r, buf, 0, m, REG_STARTEND)==REG_NOMATCH);
+            m[0].rm_so=sizeof(buf)*1000;
+            oassert (regexec (&r, buf, 0, m, REG_STARTEND)==REG_NOMATCH);
+            regfree (&r);
+        };
+    printf ("bool dfa: %d matches\n", total);
+};
+
+struct grep_results
+{
+    octa lines[1000], ofs[1000];
+    size_t n, stop_after;
+};
+
+static bool grep_collect (const char *line, size_t len, octa line_no, octa ofs, void *param)
+{
+    struct grep_results *out=(struct grep_results*)param;
+    oassert (out->n<1000);
+    out->lines[out->n]=line_no;
+    out->ofs[out->n]=ofs;
+    out->n++;
+    return out->n!=out->stop_after;
+};
+
+// lines reported by regex_grep_buf() must be the same as found by regexec_bool() line by line, in order
+void grep_test()
+{
+    const char *pats[]={ "^ab", "b$", "^$", "a+b|cd", "(a)\\1", "x" };
+    const char alphabet[]="abcdx\n\n";
+    size_t chunk_sizes[]={ 1, 7, 64, 1*_1MiB };
+    char buf[2000];
+    octa total=0;
+
+    for (size_t i=0; i<sizeof(buf); i++)
+        buf[i]=alphabet[((i*2654435761U)>>7)%(sizeof(alphabet)-1)];
+
+    for (int p=0; p<sizeof(pats)/sizeof(pats[0]); p++)
+        for (int invert=0; invert<2; invert++)
+        {
+            regex_t r;
+            struct grep_results expected, got;
+            size_t size=sizeof(buf)-p*100; // with and without trailing newline
+            octa line_no=0;
+
+            regcomp_or_die (&r, pats[p], REG_EXTENDED);
+            expected.n=0;
+            expected.stop_after=0;
+            for (const char *line=buf; line<buf+size; line_no++)
+            {
+                const char *eol=memchr (line, '\n', buf+size-line);
+                size_t len=(eol ? eol : buf+size)-line;
+                if ((regexec_bool (&r, line, len, 0)==0) != invert)
+                    grep_collect (line, len, line_no, line-buf, &expected);
+                line+=len+1;
+            };
+
+            for (int c=0; c<sizeof(chunk_sizes)/sizeof(chunk_sizes[0]); c++)
+                for (unsigned threads=1; threads<=4; threads+=3)
+                {
+                    regex_grep_chunk_size=chunk_sizes[c];
+                    got.n=0;
+                    got.stop_after=0;
+                    oassert (regex_grep_buf (&r, buf, size, invert, threads, grep_collect, &got)==expected.n);
+                    oassert (got.n==expected.n);
+                    for (size_t i=0; i<got.n; i++)
+                        oassert (got.lines[i]==expected.lines[i] && got.ofs[i]==expected.ofs[i]);
+                    // early stop
+                    got.n=0;
+                    got.stop_after=3;
+                    oassert (regex_grep_buf (&r, buf, size, invert, threads, grep_collect, &got)==(expected.n<3 ? expected.n : 3));
+                };
+            regex_grep_chunk_size=1*_1MiB;
+            total+=expected.n;
+
+            // the same from file
+            save_file_or_die ("regex_grep_test.tmp", (byte*)buf, size);
+            got.n=0;
+            got.stop_after=0;
+            oassert (regex_grep_file_or_die (&r, "regex_grep_test.tmp", invert, 0, grep_collect, &got)==expected.n);
+            oassert (got.n==expected.n && (got.n==0 || got.ofs[got.n-1]==expected.ofs[got.n-1]));
+            regfree (&r);
+        };
+    // empty file can't be mapped
+    regex_t r;
+    regcomp_or_die (&r, "x", REG_EXTENDED);
+    fclose (fopen_or_die ("regex_grep_test.tmp", "wb"));
+    oassert (regex_grep_file_or_die (&r, "regex_grep_test.tmp", true, 0, grep_collect, NULL)==0);
+    remove ("regex_grep_test.tmp");
+    regfree (&r);
+    printf ("regex grep: %d lines\n", (int)total);
+};
+
 int main(int argc, char **argv)
 {
     char *pat = "^config=([^;]*)(;.*)?$";
@@ -81,6 +732,16 @@ int main(int argc, char **argv)
     regfree (&r);
 
     tst2();
+    regcache_test();
+    stream_test();
+    shared_regex_test();
+    prefilter_test();
+    set_test();
+    ctx_test();
+    blob_test();
+    blob_warm_test();
+    bool_dfa_test();
+    grep_test();
 
     dump_unfreed_blocks();
     dmalloc_deinit();
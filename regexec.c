@@ -39,7 +39,12 @@ static reg_errcode_t re_search_internal (const regex_t *preg,
 					 const char *string, Idx length,
 					 Idx start, Idx last_start, Idx stop,
 					 size_t nmatch, regmatch_t pmatch[],
-					 int eflags) internal_function;
+					 int eflags, struct regmatch_ctx *ctx)
+     internal_function;
+/* Pure DFA matching without submatches, see regset.c.  */
+static bool re_bool_usable (const regex_t *preg);
+static reg_errcode_t re_bool_match (const regex_t *preg, const char *string,
+				    Idx start, Idx length, int eflags);
 static regoff_t re_search_2_stub (struct re_pattern_buffer *bufp,
 				  const char *string1, Idx length1,
 				  const char *string2, Idx length2,
@@ -247,12 +252,14 @@ regexec (preg, string, nmatch, pmatch, eflags)
     }
 
   __libc_lock_lock (dfa->lock);
-  if (preg->no_sub)
+  if ((preg->no_sub || nmatch == 0) && re_bool_usable (preg))
+    err = re_bool_match (preg, string, start, length, eflags);
+  else if (preg->no_sub)
     err = re_search_internal (preg, string, length, start, length,
-			      length, 0, NULL, eflags);
+			      length, 0, NULL, eflags, NULL);
   else
     err = re_search_internal (preg, string, length, start, length,
-			      length, nmatch, pmatch, eflags);
+			      length, nmatch, pmatch, eflags, NULL);
   __libc_lock_unlock (dfa->lock);
   return err != REG_NOERROR;
 }
@@ -470,7 +477,7 @@ re_search_stub (struct re_pattern_buffer *bufp,
     }
 
   result = re_search_internal (bufp, string, length, start, last_start, stop,
-			       nregs, pmatch, eflags);
+			       nregs, pmatch, eflags, NULL);
 
   rval = 0;
 
@@ -622,6 +629,176 @@ re_exec (s)
 
 /* Internal entry point.  */
 
+/* Return the position of the first occurrence of LIT in STRING at or
+   after FROM, or REG_MISSING.  */
+
+static Idx
+internal_function
+find_literal (const char *string, Idx length, Idx from,
+	      const re_literal_t *lit)
+{
+  byte *p = omemmem ((byte *) string + from, length - from,
+		     (byte *) lit->s, lit->len);
+  return p == NULL ? REG_MISSING : (Idx) ((const char *) p - string);
+}
+
+/* Make sure BUF, an array of *ALLOC elements of SIZE bytes, has room for
+   N > 0 elements.  Return the (possibly moved) array, or NULL if we run
+   out of memory, in which case BUF is left as is.  */
+
+static void *
+internal_function
+regmatch_ctx_reserve (void *buf, Idx *alloc, Idx n, size_t size)
+{
+  if (BE (*alloc >= n, 1))
+    return buf;
+  /* Avoid overflow.  */
+  if (BE (SIZE_MAX / size < (size_t) n, 0))
+    return NULL;
+  buf = re_realloc (buf, char, n * size);
+  if (BE (buf != NULL, 1))
+    *alloc = n;
+  return buf;
+}
+
+/* Give the buffers of CTX to INPUT before re_string_allocate(), which
+   reallocates them only if they are shorter than it needs.  Only the
+   buffers INPUT will use are given, BUFS_LEN is the shortest of them.  */
+
+static void
+internal_function
+regmatch_ctx_lend_input (struct regmatch_ctx *ctx, re_string_t *input,
+			 bool mbs_allocated, int mb_cur_max)
+{
+  Idx len = IDX_MAX;
+  if (mbs_allocated)
+    {
+      input->mbs = ctx->mbs;
+      len = MIN (len, ctx->mbs_len);
+    }
+#ifdef RE_ENABLE_I18N
+  if (mb_cur_max > 1)
+    {
+      input->wcs = ctx->wcs;
+      len = MIN (len, ctx->wcs_len);
+      /* OFFSETS is allocated on demand with BUFS_LEN elements.  */
+      if (ctx->offsets != NULL)
+	{
+	  input->offsets = ctx->offsets;
+	  len = MIN (len, ctx->offsets_len);
+	}
+    }
+#endif
+  input->bufs_len = len == IDX_MAX ? 0 : len;
+}
+
+/* Take the buffers of INPUT back to CTX after matching.  */
+
+static void
+internal_function
+regmatch_ctx_take_input (struct regmatch_ctx *ctx, re_string_t *input)
+{
+  if (input->mbs_allocated)
+    {
+      ctx->mbs = input->mbs;
+      ctx->mbs_len = input->bufs_len;
+    }
+#ifdef RE_ENABLE_I18N
+  if (input->mb_cur_max > 1)
+    {
+      ctx->wcs = input->wcs;
+      ctx->wcs_len = input->bufs_len;
+      if (input->offsets != NULL)
+	{
+	  ctx->offsets = input->offsets;
+	  ctx->offsets_len = input->bufs_len;
+	}
+    }
+#endif
+}
+
+/* Free all the buffers of CTX, but not CTX itself.  */
+
+static void
+internal_function
+regmatch_ctx_release (struct regmatch_ctx *ctx)
+{
+  Idx i;
+  re_free (ctx->mbs);
+#ifdef RE_ENABLE_I18N
+  re_free (ctx->wcs);
+  re_free (ctx->offsets);
+#endif
+  re_free (ctx->state_log);
+  re_free (ctx->sifted_states);
+  re_free (ctx->lim_states);
+  re_free (ctx->bkref_ents);
+  re_free (ctx->sub_tops);
+  re_free (ctx->prev_idx_match);
+  re_node_set_free (&ctx->eps_via_nodes);
+  for (i = 0; i < ctx->fs.ready; ++i)
+    {
+      re_free (ctx->fs.stack[i].regs);
+      re_node_set_free (&ctx->fs.stack[i].eps_via_nodes);
+    }
+  re_free (ctx->fs.stack);
+  re_node_set_free (&ctx->sift_nodes);
+}
+
+regmatch_ctx_t *
+regmatch_ctx_new ()
+{
+  regmatch_ctx_t *ctx = re_malloc (regmatch_ctx_t, 1);
+  if (ctx != NULL)
+    memset (ctx, '\0', sizeof (regmatch_ctx_t));
+  return ctx;
+}
+
+void
+regmatch_ctx_free (regmatch_ctx_t *ctx)
+{
+  if (ctx == NULL)
+    return;
+  regmatch_ctx_release (ctx);
+  re_free (ctx);
+}
+
+/* Same as regexec(), but the buffers needed for matching are taken from
+   CTX and left there for the next call.  CTX can be used with any regex,
+   but only by one thread at a time.  */
+
+int
+regexec_ctx (regmatch_ctx_t *ctx, const regex_t *preg, const char *string,
+	     size_t nmatch, regmatch_t pmatch[], int eflags)
+{
+  reg_errcode_t err;
+  Idx start, length;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
+    return REG_BADPAT;
+
+  if (eflags & REG_STARTEND)
+    {
+      start = pmatch[0].rm_so;
+      length = pmatch[0].rm_eo;
+    }
+  else
+    {
+      start = 0;
+      length = strlen (string);
+    }
+
+  if ((preg->no_sub || nmatch == 0) && re_bool_usable (preg))
+    err = re_bool_match (preg, string, start, length, eflags);
+  else if (preg->no_sub)
+    err = re_search_internal (preg, string, length, start, length,
+			      length, 0, NULL, eflags, ctx);
+  else
+    err = re_search_internal (preg, string, length, start, length,
+			      length, nmatch, pmatch, eflags, ctx);
+  return err != REG_NOERROR;
+}
+
 /* Searches for a compiled pattern PREG in the string STRING, whose
    length is LENGTH.  NMATCH, PMATCH, and EFLAGS have the same
    meaning as with regexec.  LAST_START is START + RANGE, where
@@ -637,16 +814,18 @@ re_search_internal (const regex_t *preg,
 		    const char *string, Idx length,
 		    Idx start, Idx last_start, Idx stop,
 		    size_t nmatch, regmatch_t pmatch[],
-		    int eflags)
+		    int eflags, struct regmatch_ctx *ctx)
 {
   reg_errcode_t err;
   const re_dfa_t *dfa = preg->buffer;
+  struct regmatch_ctx tmp_ctx;
   Idx left_lim, right_lim;
   int incr;
   bool fl_longest_match;
   int match_kind;
   Idx match_first;
   Idx match_last = REG_MISSING;
+  Idx must_at = 0;
   Idx extra_nmatch;
   bool sb;
   int ch;
@@ -692,9 +871,30 @@ re_search_internal (const regex_t *preg,
       start = last_start = 0;
     }
 
+  /* Every match contains dfa->must, so give up at once if it doesn't occur
+     after START.  MUST_AT is its next occurrence.  */
+  if (dfa->must.len != 0 && start <= last_start)
+    {
+      must_at = find_literal (string, length, start, &dfa->must);
+      if (must_at == REG_MISSING)
+	return REG_NOMATCH;
+    }
+
   /* We must check the longest matching, if nmatch > 0.  */
   fl_longest_match = (nmatch != 0 || dfa->nbackref);
 
+  /* Without a context given by the caller, all the buffers live only
+     during this call.  */
+  if (ctx == NULL)
+    {
+      memset (&tmp_ctx, '\0', sizeof (tmp_ctx));
+      ctx = &tmp_ctx;
+    }
+  mctx.ctx = ctx;
+  regmatch_ctx_lend_input (ctx, &mctx.input,
+			   t != NULL || (preg->syntax & RE_ICASE) != 0,
+			   dfa->mb_cur_max);
+
   err = re_string_allocate (&mctx.input, string, length, dfa->nodes_len + 1,
 			    preg->translate, (preg->syntax & RE_ICASE) != 0,
 			    dfa);
@@ -723,12 +923,16 @@ re_search_internal (const regex_t *preg,
 	}
 
       //mctx.state_log = re_malloc (re_dfastate_t *, mctx.input.bufs_len + 1);
-      mctx.state_log = re_malloc (re_dfastate_t *, mctx.input.bufs_len * 2); // IDK why is this!
+      mctx.state_log = regmatch_ctx_reserve (ctx->state_log,
+					     &ctx->state_log_alloc,
+					     mctx.input.bufs_len * 2, // IDK why is this!
+					     sizeof (re_dfastate_t *));
       if (BE (mctx.state_log == NULL, 0))
 	{
 	  err = REG_ESPACE;
 	  goto free_return;
 	}
+      ctx->state_log = mctx.state_log;
     }
   else
     mctx.state_log = NULL;
@@ -755,6 +959,23 @@ re_search_internal (const regex_t *preg,
       if (match_first < left_lim || right_lim < match_first)
 	goto free_return;
 
+      /* Skip straight to the place where a match can start, using the
+	 literals required by the regex.  */
+      if (dfa->prefix.len != 0 && start <= last_start)
+	{
+	  Idx at = find_literal (string, length, match_first, &dfa->prefix);
+	  if (at == REG_MISSING || right_lim < at)
+	    goto free_return;
+	  match_first = at;
+	}
+      else if (dfa->must.len != 0 && start <= last_start
+	       && must_at < match_first)
+	{
+	  must_at = find_literal (string, length, match_first, &dfa->must);
+	  if (must_at == REG_MISSING)
+	    goto free_return;
+	}
+
       /* Advance as rapidly as possible through the string, until we
 	 find a plausible place to start matching.  This may be done
 	 with varying efficiency, so there are various possibilities:
@@ -961,10 +1182,11 @@ re_search_internal (const regex_t *preg,
     }
 
  free_return:
-  re_free (mctx.state_log);
   if (dfa->nbackref)
     match_ctx_free (&mctx);
-  re_string_destruct (&mctx.input);
+  regmatch_ctx_take_input (ctx, &mctx.input);
+  if (ctx == &tmp_ctx)
+    regmatch_ctx_release (ctx);
   return err;
 }
 
@@ -973,6 +1195,7 @@ __attribute_warn_unused_result__
 prune_impossible_nodes (re_match_context_t *mctx)
 {
   const re_dfa_t *const dfa = mctx->dfa;
+  struct regmatch_ctx *ctx = mctx->ctx;
   Idx halt_node, match_last;
   reg_errcode_t ret;
   re_dfastate_t **sifted_states;
@@ -988,20 +1211,22 @@ prune_impossible_nodes (re_match_context_t *mctx)
   if (BE (MIN (IDX_MAX, SIZE_MAX / sizeof (re_dfastate_t *)) <= match_last, 0))
     return REG_ESPACE;
 
-  sifted_states = re_malloc (re_dfastate_t *, match_last + 1 + 100); // who to blame? block is too small for operations
+  sifted_states = regmatch_ctx_reserve (ctx->sifted_states,
+					&ctx->sifted_states_alloc,
+					match_last + 1 + 100, // who to blame? block is too small for operations
+					sizeof (re_dfastate_t *));
   if (BE (sifted_states == NULL, 0))
-    {
-      ret = REG_ESPACE;
-      goto free_return;
-    }
+    return REG_ESPACE;
+  ctx->sifted_states = sifted_states;
   if (dfa->nbackref)
     {
-      lim_states = re_malloc (re_dfastate_t *, match_last + 1);
+      lim_states = regmatch_ctx_reserve (ctx->lim_states,
+					 &ctx->lim_states_alloc,
+					 match_last + 1,
+					 sizeof (re_dfastate_t *));
       if (BE (lim_states == NULL, 0))
-	{
-	  ret = REG_ESPACE;
-	  goto free_return;
-	}
+	return REG_ESPACE;
+      ctx->lim_states = lim_states;
       while (1)
 	{
 	  memset (lim_states, '\0',
@@ -1030,8 +1255,6 @@ prune_impossible_nodes (re_match_context_t *mctx)
 	}
       ret = merge_state_array (dfa, sifted_states, lim_states,
 			       match_last + 1);
-      re_free (lim_states);
-      lim_states = NULL;
       if (BE (ret != REG_NOERROR, 0))
 	goto free_return;
     }
@@ -1048,15 +1271,19 @@ prune_impossible_nodes (re_match_context_t *mctx)
 	  goto free_return;
 	}
     }
-  re_free (mctx->state_log);
-  mctx->state_log = sifted_states;
-  sifted_states = NULL;
+  /* SIFTED_STATES is the new state log, keep the old one for the next
+     call.  */
+  ctx->sifted_states = ctx->state_log;
+  ctx->state_log = mctx->state_log = sifted_states;
+  {
+    Idx alloc = ctx->sifted_states_alloc;
+    ctx->sifted_states_alloc = ctx->state_log_alloc;
+    ctx->state_log_alloc = alloc;
+  }
   mctx->last_node = halt_node;
   mctx->match_last = match_last;
   ret = REG_NOERROR;
  free_return:
-  re_free (sifted_states);
-  re_free (lim_states);
   return ret;
 }
 
@@ -1405,11 +1632,16 @@ push_fail_stack (struct re_fail_stack_t *fs, Idx str_idx, Idx dest_node,
     }
   fs->stack[num].idx = str_idx;
   fs->stack[num].node = dest_node;
-  fs->stack[num].regs = re_malloc (regmatch_t, nregs);
-  if (fs->stack[num].regs == NULL)
-    return REG_ESPACE;
+  if (num == fs->ready)
+    {
+      fs->stack[num].regs = re_malloc (regmatch_t, fs->nregs);
+      if (fs->stack[num].regs == NULL)
+	return REG_ESPACE;
+      re_node_set_init_empty (&fs->stack[num].eps_via_nodes);
+      fs->ready++;
+    }
   memcpy (fs->stack[num].regs, regs, sizeof (regmatch_t) * nregs);
-  err = re_node_set_init_copy (&fs->stack[num].eps_via_nodes, eps_via_nodes);
+  err = re_node_set_assign (&fs->stack[num].eps_via_nodes, eps_via_nodes);
   return err;
 }
 
@@ -1419,12 +1651,14 @@ pop_fail_stack (struct re_fail_stack_t *fs, Idx *pidx, Idx nregs,
 		regmatch_t *regs, re_node_set *eps_via_nodes)
 {
   Idx num = --fs->num;
+  re_node_set tmp;
   assert (REG_VALID_INDEX (num));
   *pidx = fs->stack[num].idx;
   memcpy (regs, fs->stack[num].regs, sizeof (regmatch_t) * nregs);
-  re_node_set_free (eps_via_nodes);
-  re_free (fs->stack[num].regs);
+  /* Swap, so the entry keeps a buffer to reuse.  */
+  tmp = *eps_via_nodes;
   *eps_via_nodes = fs->stack[num].eps_via_nodes;
+  fs->stack[num].eps_via_nodes = tmp;
   return fs->stack[num].node;
 }
 
@@ -1439,12 +1673,11 @@ set_regs (const regex_t *preg, const re_match_context_t *mctx, size_t nmatch,
 	  regmatch_t *pmatch, bool fl_backtrack)
 {
   const re_dfa_t *dfa = preg->buffer;
+  struct regmatch_ctx *ctx = mctx->ctx;
   Idx idx, cur_node;
-  re_node_set eps_via_nodes;
+  re_node_set *eps_via_nodes = &ctx->eps_via_nodes;
   struct re_fail_stack_t *fs;
-  struct re_fail_stack_t fs_body = { 0, 2, NULL };
   regmatch_t *prev_idx_match;
-  bool prev_idx_match_malloced = false;
 
 #ifdef DEBUG
   assert (nmatch > 1);
@@ -1452,29 +1685,52 @@ set_regs (const regex_t *preg, const re_match_context_t *mctx, size_t nmatch,
 #endif
   if (fl_backtrack)
     {
-      fs = &fs_body;
-      fs->stack = re_malloc (struct re_fail_stack_ent_t, fs->alloc);
+      fs = &ctx->fs;
       if (fs->stack == NULL)
-	return REG_ESPACE;
+	{
+	  fs->stack = re_malloc (struct re_fail_stack_ent_t, 2);
+	  if (fs->stack == NULL)
+	    return REG_ESPACE;
+	  fs->alloc = 2;
+	}
+      if (fs->nregs < (Idx) nmatch)
+	{
+	  /* The entries kept are too short for this regex.  */
+	  Idx fs_idx;
+	  for (fs_idx = 0; fs_idx < fs->ready; ++fs_idx)
+	    {
+	      regmatch_t *new_regs = re_realloc (fs->stack[fs_idx].regs,
+						 regmatch_t, nmatch);
+	      if (new_regs == NULL)
+		{
+		  /* Drop the entries which are not reallocated.  */
+		  Idx i;
+		  for (i = fs_idx; i < fs->ready; ++i)
+		    {
+		      re_free (fs->stack[i].regs);
+		      re_node_set_free (&fs->stack[i].eps_via_nodes);
+		    }
+		  fs->ready = fs_idx;
+		  return REG_ESPACE;
+		}
+	      fs->stack[fs_idx].regs = new_regs;
+	    }
+	  fs->nregs = nmatch;
+	}
+      fs->num = 0;
     }
   else
     fs = NULL;
 
   cur_node = dfa->init_node;
-  re_node_set_init_empty (&eps_via_nodes);
+  eps_via_nodes->nelem = 0;
 
-  if (__libc_use_alloca (nmatch * sizeof (regmatch_t)))
-    prev_idx_match = (regmatch_t *) alloca (nmatch * sizeof (regmatch_t));
-  else
-    {
-      prev_idx_match = re_malloc (regmatch_t, nmatch);
-      if (prev_idx_match == NULL)
-	{
-	  free_fail_stack_return (fs);
-	  return REG_ESPACE;
-	}
-      prev_idx_match_malloced = true;
-    }
+  prev_idx_match = regmatch_ctx_reserve (ctx->prev_idx_match,
+					 &ctx->prev_idx_match_alloc, nmatch,
+					 sizeof (regmatch_t));
+  if (prev_idx_match == NULL)
+    return REG_ESPACE;
+  ctx->prev_idx_match = prev_idx_match;
   memcpy (prev_idx_match, pmatch, sizeof (regmatch_t) * nmatch);
 
   for (idx = pmatch[0].rm_so; idx <= pmatch[0].rm_eo ;)
@@ -1490,53 +1746,32 @@ set_regs (const regex_t *preg, const re_match_context_t *mctx, size_t nmatch,
 		if (pmatch[reg_idx].rm_so > -1 && pmatch[reg_idx].rm_eo == -1)
 		  break;
 	      if (reg_idx == nmatch)
-		{
-		  re_node_set_free (&eps_via_nodes);
-		  if (prev_idx_match_malloced)
-		    re_free (prev_idx_match);
-		  return free_fail_stack_return (fs);
-		}
+		return free_fail_stack_return (fs);
 	      cur_node = pop_fail_stack (fs, &idx, nmatch, pmatch,
-					 &eps_via_nodes);
+					 eps_via_nodes);
 	    }
 	  else
-	    {
-	      re_node_set_free (&eps_via_nodes);
-	      if (prev_idx_match_malloced)
-		re_free (prev_idx_match);
-	      return REG_NOERROR;
-	    }
+	    return REG_NOERROR;
 	}
 
       /* Proceed to next node.  */
       cur_node = proceed_next_node (mctx, nmatch, pmatch, &idx, cur_node,
-				    &eps_via_nodes, fs);
+				    eps_via_nodes, fs);
 
       if (BE (! REG_VALID_INDEX (cur_node), 0))
 	{
 	  if (BE (cur_node == REG_ERROR, 0))
 	    {
-	      re_node_set_free (&eps_via_nodes);
-	      if (prev_idx_match_malloced)
-		re_free (prev_idx_match);
 	      free_fail_stack_return (fs);
 	      return REG_ESPACE;
 	    }
 	  if (fs)
 	    cur_node = pop_fail_stack (fs, &idx, nmatch, pmatch,
-				       &eps_via_nodes);
+				       eps_via_nodes);
 	  else
-	    {
-	      re_node_set_free (&eps_via_nodes);
-	      if (prev_idx_match_malloced)
-		re_free (prev_idx_match);
-	      return REG_NOMATCH;
-	    }
+	    return REG_NOMATCH;
 	}
     }
-  re_node_set_free (&eps_via_nodes);
-  if (prev_idx_match_malloced)
-    re_free (prev_idx_match);
   return free_fail_stack_return (fs);
 }
 
@@ -1544,16 +1779,9 @@ static reg_errcode_t
 internal_function
 free_fail_stack_return (struct re_fail_stack_t *fs)
 {
+  /* The entries are kept for the next call, see struct regmatch_ctx.  */
   if (fs)
-    {
-      Idx fs_idx;
-      for (fs_idx = 0; fs_idx < fs->num; ++fs_idx)
-	{
-	  re_node_set_free (&fs->stack[fs_idx].eps_via_nodes);
-	  re_free (fs->stack[fs_idx].regs);
-	}
-      re_free (fs->stack);
-    }
+    fs->num = 0;
   return REG_NOERROR;
 }
 
@@ -1636,18 +1864,36 @@ sift_states_backward (const re_match_context_t *mctx, re_sift_context_t *sctx)
   reg_errcode_t err;
   int null_cnt = 0;
   Idx str_idx = sctx->last_str_idx;
-  re_node_set cur_dest;
+  struct regmatch_ctx *ctx = mctx->ctx;
+  re_node_set local_dest;
+  re_node_set *cur_dest;
 
 #ifdef DEBUG
   assert (mctx->state_log != NULL && mctx->state_log[str_idx] != NULL);
 #endif
 
+  /* The buffer of CTX is used by the outermost call only, this function
+     is called recursively with back references.  */
+  if (!ctx->sift_nodes_busy)
+    {
+      cur_dest = &ctx->sift_nodes;
+      ctx->sift_nodes_busy = true;
+    }
+  else
+    {
+      cur_dest = &local_dest;
+      re_node_set_init_empty (cur_dest);
+    }
+
   /* Build sifted state_log[str_idx].  It has the nodes which can epsilon
      transit to the last_node and the last_node itself.  */
-  err = re_node_set_init_1 (&cur_dest, sctx->last_node);
-  if (BE (err != REG_NOERROR, 0))
-    return err;
-  err = update_cur_sifted_state (mctx, sctx, str_idx, &cur_dest);
+  re_node_set_empty (cur_dest);
+  if (BE (! re_node_set_insert (cur_dest, sctx->last_node), 0))
+    {
+      err = REG_ESPACE;
+      goto free_return;
+    }
+  err = update_cur_sifted_state (mctx, sctx, str_idx, cur_dest);
   if (BE (err != REG_NOERROR, 0))
     goto free_return;
 
@@ -1660,15 +1906,14 @@ sift_states_backward (const re_match_context_t *mctx, re_sift_context_t *sctx)
 	{
 	  memset (sctx->sifted_states, '\0',
 		  sizeof (re_dfastate_t *) * str_idx);
-	  re_node_set_free (&cur_dest);
-	  return REG_NOERROR;
+	  break;
 	}
-      re_node_set_empty (&cur_dest);
+      re_node_set_empty (cur_dest);
       --str_idx;
 
       if (mctx->state_log[str_idx])
 	{
-	  err = build_sifted_states (mctx, sctx, str_idx, &cur_dest);
+	  err = build_sifted_states (mctx, sctx, str_idx, cur_dest);
 	  if (BE (err != REG_NOERROR, 0))
 	    goto free_return;
 	}
@@ -1677,13 +1922,16 @@ sift_states_backward (const re_match_context_t *mctx, re_sift_context_t *sctx)
 	 - It can epsilon transit to a node in CUR_DEST.
 	 - It is in CUR_SRC.
 	 And update state_log.  */
-      err = update_cur_sifted_state (mctx, sctx, str_idx, &cur_dest);
+      err = update_cur_sifted_state (mctx, sctx, str_idx, cur_dest);
       if (BE (err != REG_NOERROR, 0))
 	goto free_return;
     }
   err = REG_NOERROR;
  free_return:
-  re_node_set_free (&cur_dest);
+  if (cur_dest == &local_dest)
+    re_node_set_free (cur_dest);
+  else
+    ctx->sift_nodes_busy = false;
   return err;
 }
 
@@ -2323,11 +2571,11 @@ transit_state (reg_errcode_t *err, re_match_context_t *mctx,
   ch = re_string_fetch_byte (&mctx->input);
   for (;;)
     {
-      trtable = state->trtable;
+      trtable = re_load_acquire (state->trtable);
       if (BE (trtable != NULL, 1))
 	return trtable[ch];
 
-      trtable = state->word_trtable;
+      trtable = re_load_acquire (state->word_trtable);
       if (BE (trtable != NULL, 1))
 	{
 	  unsigned int context;
@@ -3357,11 +3605,11 @@ expand_bkref_cache (re_match_context_t *mctx, re_node_set *cur_nodes,
 }
 
 /* Build transition table for the state.
-   Return true if successful.  */
+   Return true if successful.  The caller holds the trtable lock.  */
 
 static bool
 internal_function
-build_trtable (const re_dfa_t *dfa, re_dfastate_t *state)
+build_trtable_locked (const re_dfa_t *dfa, re_dfastate_t *state)
 {
   reg_errcode_t err;
   Idx i, j;
@@ -3399,9 +3647,6 @@ build_trtable (const re_dfa_t *dfa, re_dfastate_t *state)
   dests_node = dests_alloc->dests_node;
   dests_ch = dests_alloc->dests_ch;
 
-  /* Initialize transition table.  */
-  state->word_trtable = state->trtable = NULL;
-
   /* At first, group all nodes belonging to 'state' into several
      destinations.  */
   ndests = group_nodes_into_DFAstates (dfa, state, dests_node, dests_ch);
@@ -3417,13 +3662,14 @@ build_trtable (const re_dfa_t *dfa, re_dfastate_t *state)
       if (ndests == 0)
 	{
 #ifdef RE_USE_DMALLOC
-	  state->trtable = DCALLOC (re_dfastate_t *, SBC_MAX, "re_dfastate_t *");
+	  trtable = DCALLOC (re_dfastate_t *, SBC_MAX, "re_dfastate_t *");
 #else
-	  state->trtable = (re_dfastate_t **)
+	  trtable = (re_dfastate_t **)
 	    calloc (sizeof (re_dfastate_t *), SBC_MAX);
 #endif
-          if (BE (state->trtable == NULL, 0))
+          if (BE (trtable == NULL, 0))
             return false;
+	  re_store_release (state->trtable, trtable);
 	  return true;
 	}
       return false;
@@ -3528,7 +3774,7 @@ out_free:
 	 character, or we are in a single-byte character set so we can
 	 discern by looking at the character code: allocate a
 	 256-entry transition table.  */
-      trtable = state->trtable =
+      trtable =
 #ifdef RE_USE_DMALLOC
 	DCALLOC (re_dfastate_t *, SBC_MAX, "re_dfastate_t *");
 #else
@@ -3563,7 +3809,7 @@ out_free:
 	 by looking at the character code: build two 256-entry
 	 transition tables, one starting at trtable[0] and one
 	 starting at trtable[SBC_MAX].  */
-      trtable = state->word_trtable =
+      trtable =
 #ifdef RE_USE_DMALLOC
 	DCALLOC (re_dfastate_t *, 2 * SBC_MAX, "re_dfastate_t *");
 #else
@@ -3607,6 +3853,13 @@ out_free:
 	  }
     }
 
+  /* Publish the table only when it is complete: other threads read it
+     without locking, see transit_state.  */
+  if (need_word_trtable)
+    re_store_release (state->word_trtable, trtable);
+  else
+    re_store_release (state->trtable, trtable);
+
   if (dest_states_malloced)
 #ifdef RE_USE_DMALLOC
     DFREE (dest_states);
@@ -3628,6 +3881,21 @@ out_free:
   return true;
 }
 
+/* Build transition table for the state, unless another thread has
+   already done it.  Return true if successful.  */
+
+static bool
+internal_function
+build_trtable (const re_dfa_t *dfa, re_dfastate_t *state)
+{
+  bool ret = true;
+  re_trtable_lock (dfa);
+  if (state->trtable == NULL && state->word_trtable == NULL)
+    ret = build_trtable_locked (dfa, state);
+  re_trtable_unlock (dfa);
+  return ret;
+}
+
 /* Group all nodes belonging to STATE into several destinations.
    Then for all destinations, set the nodes belonging to the destination
    to DESTS_NODE[i] and set the characters accepted by the destination
@@ -4197,11 +4465,14 @@ extend_buffers (re_match_context_t *mctx, int min_len)
       /* XXX We have no indication of the size of this buffer.  If this
 	 allocation fail we have no indication that the state_log array
 	 does not have the right size.  */
-      re_dfastate_t **new_array = re_realloc (mctx->state_log, re_dfastate_t *,
-					      pstr->bufs_len + 1+100); // who to blame? block is too small for operations
+      struct regmatch_ctx *ctx = mctx->ctx;
+      re_dfastate_t **new_array
+	= regmatch_ctx_reserve (ctx->state_log, &ctx->state_log_alloc,
+				pstr->bufs_len + 1+100, // who to blame? block is too small for operations
+				sizeof (re_dfastate_t *));
       if (BE (new_array == NULL, 0))
 	return REG_ESPACE;
-      mctx->state_log = new_array;
+      mctx->state_log = ctx->state_log = new_array;
     }
 
   /* Then reconstruct the buffers.  */
@@ -4242,8 +4513,10 @@ static reg_errcode_t
 internal_function __attribute_warn_unused_result__
 match_ctx_init (re_match_context_t *mctx, int eflags, Idx n)
 {
+  struct regmatch_ctx *ctx = mctx->ctx;
   mctx->eflags = eflags;
   mctx->match_last = REG_MISSING;
+  mctx->max_mb_elem_len = 1;
   if (n > 0)
     {
       /* Avoid overflow.  */
@@ -4253,19 +4526,29 @@ match_ctx_init (re_match_context_t *mctx, int eflags, Idx n)
       if (BE (MIN (IDX_MAX, SIZE_MAX / max_object_size) < n, 0))
 	return REG_ESPACE;
 
-      mctx->bkref_ents = re_malloc (struct re_backref_cache_entry, n);
-      mctx->sub_tops = re_malloc (re_sub_match_top_t *, n);
-      if (BE (mctx->bkref_ents == NULL || mctx->sub_tops == NULL, 0))
+      /* The arrays are borrowed from CTX until match_ctx_free().  */
+      mctx->bkref_ents = regmatch_ctx_reserve (ctx->bkref_ents,
+					       &ctx->abkref_ents, n,
+					       sizeof (struct re_backref_cache_entry));
+      if (BE (mctx->bkref_ents == NULL, 0))
+	return REG_ESPACE;
+      mctx->abkref_ents = ctx->abkref_ents;
+      ctx->bkref_ents = NULL;
+      ctx->abkref_ents = 0;
+
+      mctx->sub_tops = regmatch_ctx_reserve (ctx->sub_tops, &ctx->asub_tops,
+					     n, sizeof (re_sub_match_top_t *));
+      if (BE (mctx->sub_tops == NULL, 0))
 	return REG_ESPACE;
+      mctx->asub_tops = ctx->asub_tops;
+      ctx->sub_tops = NULL;
+      ctx->asub_tops = 0;
     }
   /* Already zero-ed by the caller.
      else
        mctx->bkref_ents = NULL;
      mctx->nbkref_ents = 0;
      mctx->nsub_tops = 0;  */
-  mctx->abkref_ents = n;
-  mctx->max_mb_elem_len = 1;
-  mctx->asub_tops = n;
   return REG_NOERROR;
 }
 
@@ -4311,10 +4594,22 @@ static void
 internal_function
 match_ctx_free (re_match_context_t *mctx)
 {
+  struct regmatch_ctx *ctx = mctx->ctx;
   /* First, free all the memory associated with MCTX->SUB_TOPS.  */
   match_ctx_clean (mctx);
-  re_free (mctx->sub_tops);
-  re_free (mctx->bkref_ents);
+  /* Then give the arrays back to CTX.  */
+  if (mctx->sub_tops != NULL)
+    {
+      re_free (ctx->sub_tops);
+      ctx->sub_tops = mctx->sub_tops;
+      ctx->asub_tops = mctx->asub_tops;
+    }
+  if (mctx->bkref_ents != NULL)
+    {
+      re_free (ctx->bkref_ents);
+      ctx->bkref_ents = mctx->bkref_ents;
+      ctx->abkref_ents = mctx->abkref_ents;
+    }
 }
 
 /* Add a new backreference entry to MCTX.
@@ -4333,10 +4628,7 @@ match_ctx_add_entry (re_match_context_t *mctx, Idx node, Idx str_idx, Idx from,
       new_entry = re_realloc (mctx->bkref_ents, struct re_backref_cache_entry,
 			      mctx->abkref_ents * 2);
       if (BE (new_entry == NULL, 0))
-	{
-	  re_free (mctx->bkref_ents);
-	  return REG_ESPACE;
-	}
+	return REG_ESPACE;
       mctx->bkref_ents = new_entry;
       memset (mctx->bkref_ents + mctx->nbkref_ents, '\0',
 	      sizeof (struct re_backref_cache_entry) * mctx->abkref_ents);
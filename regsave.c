@@ -0,0 +1,1013 @@
+/* Saving a compiled regex into a binary blob and loading it back.
+   This file is included from regex.c, after regexec.c, so it can use
+   DFA internals directly.
+
+   The blob holds everything regcomp() computes: the NFA nodes with their
+   nexts, edests, eclosures and inveclosures, the fastmap, the literals
+   for the prefilter and the initial DFA states.  Optionally, all DFA
+   states built so far by matching are added along with their transition
+   tables, so the loaded regex doesn't have to build them again.
+
+   The blob is position independent (indices instead of pointers, fixed
+   width little endian fields), so it can be written to a file as is and
+   loaded from a mmap()-ed region.  Since the DFA grows while matching,
+   the loaded regex_t has its own copy of the data, but loading is just
+   a sequence of copies, no parsing or analysis is done.
+
+   Layout, all fields are little endian:
+
+	"ORXB" version(4) body_len(4) checksum(4)	header
+	regex_t fields, fastmap, translate
+	re_dfa_t fields, literals
+	nodes, nexts, edests, eclosures, inveclosures, subexp_map
+	DFA states (context + node set), init states, transition tables
+	(run length encoded)
+
+   The loader checks the checksum (FNV-1a) of the body, lengths, indices
+   of nodes and states, sortedness of node sets and the basic properties
+   of the NFA matching relies on, so damaged blobs and blobs of other
+   versions are rejected.  It doesn't redo the analysis of regcomp()
+   though, so a blob deliberately crafted to be consistent but wrong can
+   still break the matcher: load only blobs made by re_blob_save().
+   The blob depends on the single byte locale it was made in (word
+   characters, case folding), multibyte locales aren't supported.  */
+
+#define RE_BLOB_MAGIC "ORXB"
+#define RE_BLOB_VERSION 1
+#define RE_BLOB_HEADER_LEN 16
+#define RE_BLOB_NONE 0xffffffffU
+
+/* Flags of regex_t and re_dfa_t.  */
+#define RE_BLOB_CAN_BE_NULL	0x0001
+#define RE_BLOB_FASTMAP_ACCURATE 0x0002
+#define RE_BLOB_NO_SUB		0x0004
+#define RE_BLOB_NOT_BOL		0x0008
+#define RE_BLOB_NOT_EOL		0x0010
+#define RE_BLOB_NEWLINE_ANCHOR	0x0020
+#define RE_BLOB_FASTMAP		0x0040
+#define RE_BLOB_TRANSLATE	0x0080
+#define RE_BLOB_PLURAL_MATCH	0x0100
+#define RE_BLOB_MB_NODE		0x0200
+#define RE_BLOB_WORD_OPS_USED	0x0400
+#define RE_BLOB_EDESTS		0x0800
+#define RE_BLOB_ECLOSURES	0x1000
+#define RE_BLOB_INVECLOSURES	0x2000
+#define RE_BLOB_SUBEXP_MAP	0x4000
+
+/* Flags of re_token_t.  */
+#define RE_BLOB_TOKEN_OPT_SUBEXP 0x01
+#define RE_BLOB_TOKEN_ACCEPT_MB	0x02
+#define RE_BLOB_TOKEN_MB_PARTIAL 0x04
+#define RE_BLOB_TOKEN_WORD_CHAR	0x08
+
+/* Kinds of DFA states, see blob_state_kind().  */
+#define RE_BLOB_STATE_CI	0
+#define RE_BLOB_STATE_CD	1
+
+/* Transition tables of a state.  */
+#define RE_BLOB_TRTABLE		1
+#define RE_BLOB_WORD_TRTABLE	2
+
+typedef struct
+{
+  unsigned char *buf;
+  size_t len, alloc;
+  bool oom;
+} re_blob_writer_t;
+
+typedef struct
+{
+  const unsigned char *p, *end;
+  bool bad;
+} re_blob_reader_t;
+
+static tetra
+blob_checksum (const unsigned char *p, size_t len)
+{
+  tetra h = 2166136261U;
+  size_t i;
+  for (i = 0; i < len; ++i)
+    h = (h ^ p[i]) * 16777619U;
+  return h;
+}
+
+static void
+blob_put (re_blob_writer_t *w, const void *p, size_t n)
+{
+  if (w->oom)
+    return;
+  if (w->len + n > w->alloc)
+    {
+      size_t new_alloc = MAX (w->alloc * 2, w->len + n);
+      unsigned char *new_buf = re_realloc (w->buf, unsigned char, new_alloc);
+      if (BE (new_buf == NULL, 0))
+	{
+	  w->oom = true;
+	  return;
+	}
+      w->buf = new_buf;
+      w->alloc = new_alloc;
+    }
+  memcpy (w->buf + w->len, p, n);
+  w->len += n;
+}
+
+static void
+blob_put_u8 (re_blob_writer_t *w, unsigned int v)
+{
+  unsigned char b = v;
+  blob_put (w, &b, 1);
+}
+
+static void
+blob_put_u32 (re_blob_writer_t *w, tetra v)
+{
+  unsigned char b[4];
+  b[0] = v;
+  b[1] = v >> 8;
+  b[2] = v >> 16;
+  b[3] = v >> 24;
+  blob_put (w, b, 4);
+}
+
+static void
+blob_put_u64 (re_blob_writer_t *w, octa v)
+{
+  blob_put_u32 (w, (tetra) v);
+  blob_put_u32 (w, (tetra) (v >> 32));
+}
+
+/* REG_MISSING is saved as RE_BLOB_NONE.  */
+
+static void
+blob_put_idx (re_blob_writer_t *w, Idx idx)
+{
+  blob_put_u32 (w, REG_VALID_INDEX (idx) ? (tetra) idx : RE_BLOB_NONE);
+}
+
+static void
+blob_put_bitset (re_blob_writer_t *w, re_const_bitset_ptr_t set)
+{
+  unsigned char b[SBC_MAX / 8];
+  int ch;
+  memset (b, 0, sizeof (b));
+  for (ch = 0; ch < SBC_MAX; ++ch)
+    if (bitset_contain (set, ch))
+      b[ch / 8] |= 1 << (ch % 8);
+  blob_put (w, b, sizeof (b));
+}
+
+static void
+blob_put_node_set (re_blob_writer_t *w, const re_node_set *set)
+{
+  Idx i;
+  blob_put_u32 (w, set->nelem);
+  for (i = 0; i < set->nelem; ++i)
+    blob_put_u32 (w, set->elems[i]);
+}
+
+static void
+blob_put_literal (re_blob_writer_t *w, const re_literal_t *lit)
+{
+  unsigned char s[RE_LITERAL_MAX];
+  /* Bytes after LEN may be uninitialized.  */
+  memset (s, 0, sizeof (s));
+  memcpy (s, lit->s, lit->len);
+  blob_put_u32 (w, lit->len);
+  blob_put (w, s, RE_LITERAL_MAX);
+}
+
+static const unsigned char *
+blob_get (re_blob_reader_t *r, size_t n)
+{
+  const unsigned char *p = r->p;
+  if (r->bad || (size_t) (r->end - r->p) < n)
+    {
+      r->bad = true;
+      return NULL;
+    }
+  r->p += n;
+  return p;
+}
+
+static unsigned int
+blob_get_u8 (re_blob_reader_t *r)
+{
+  const unsigned char *p = blob_get (r, 1);
+  return p ? p[0] : 0;
+}
+
+static tetra
+blob_get_u32 (re_blob_reader_t *r)
+{
+  const unsigned char *p = blob_get (r, 4);
+  if (p == NULL)
+    return 0;
+  return (p[0] | ((tetra) p[1] << 8) | ((tetra) p[2] << 16)
+	  | ((tetra) p[3] << 24));
+}
+
+static octa
+blob_get_u64 (re_blob_reader_t *r)
+{
+  octa lo = blob_get_u32 (r);
+  return lo | ((octa) blob_get_u32 (r) << 32);
+}
+
+/* Read a count of items of at least ITEM_LEN bytes each, which must fit
+   into the rest of the blob, so corrupted counts can't cause huge
+   allocations.  */
+
+static Idx
+blob_get_count (re_blob_reader_t *r, size_t item_len)
+{
+  tetra n = blob_get_u32 (r);
+  if (n > (size_t) (r->end - r->p) / item_len)
+    {
+      r->bad = true;
+      return 0;
+    }
+  return n;
+}
+
+/* Read an index below LIMIT, or RE_BLOB_NONE as REG_MISSING if
+   ALLOW_NONE.  */
+
+static Idx
+blob_get_idx (re_blob_reader_t *r, Idx limit, bool allow_none)
+{
+  tetra v = blob_get_u32 (r);
+  if (v == RE_BLOB_NONE && allow_none)
+    return REG_MISSING;
+  if (v >= (size_t) limit)
+    {
+      r->bad = true;
+      return 0;
+    }
+  return v;
+}
+
+static void
+blob_get_bitset (re_blob_reader_t *r, re_bitset_ptr_t set)
+{
+  const unsigned char *b = blob_get (r, SBC_MAX / 8);
+  int ch;
+  bitset_empty (set);
+  if (b == NULL)
+    return;
+  for (ch = 0; ch < SBC_MAX; ++ch)
+    if (b[ch / 8] & (1 << (ch % 8)))
+      bitset_set (set, ch);
+}
+
+/* Read a node set into SET, which must be empty.  The elements must be
+   nodes below NODES_LEN in non-descending order: regcomp() may leave
+   duplicates in eclosures, e.g. of "(a*)*".  */
+
+static reg_errcode_t
+blob_get_node_set (re_blob_reader_t *r, re_node_set *set, Idx nodes_len)
+{
+  Idx i, n = blob_get_count (r, 4);
+  if (r->bad)
+    return REG_BADPAT;
+  if (n == 0)
+    return REG_NOERROR;
+  if (BE (re_node_set_alloc (set, n) != REG_NOERROR, 0))
+    return REG_ESPACE;
+  for (i = 0; i < n; ++i)
+    {
+      Idx elem = blob_get_idx (r, nodes_len, false);
+      if (r->bad || (i > 0 && elem < set->elems[i - 1]))
+	return REG_BADPAT;
+      set->elems[set->nelem++] = elem;
+    }
+  return REG_NOERROR;
+}
+
+static void
+blob_get_literal (re_blob_reader_t *r, re_literal_t *lit)
+{
+  const unsigned char *s;
+  lit->len = blob_get_u32 (r);
+  s = blob_get (r, RE_LITERAL_MAX);
+  if (s == NULL || lit->len > RE_LITERAL_MAX)
+    {
+      r->bad = true;
+      lit->len = 0;
+      return;
+    }
+  memcpy (lit->s, s, RE_LITERAL_MAX);
+}
+
+/* States made by re_acquire_state() are found by their nodes, states made
+   by re_acquire_state_context() by their entrance nodes and context, see
+   find_state() and find_state_context().  The ones without constraints
+   are the same either way.  */
+
+static unsigned int
+blob_state_kind (const re_dfastate_t *state, const re_node_set **key)
+{
+  *key = state->entrance_nodes;
+  if (state->entrance_nodes == &state->nodes && state->has_constraint)
+    return RE_BLOB_STATE_CI;
+  return RE_BLOB_STATE_CD;
+}
+
+/* A saved state and its index in the blob, plus 1.  */
+
+typedef struct
+{
+  const re_dfastate_t *state;
+  tetra idx;
+} re_blob_state_t;
+
+static int
+blob_state_cmp (const void *a, const void *b)
+{
+  const re_dfastate_t *x = ((const re_blob_state_t *) a)->state;
+  const re_dfastate_t *y = ((const re_blob_state_t *) b)->state;
+  return x < y ? -1 : x > y;
+}
+
+/* Index of STATE in the blob plus 1, 0 for NULL; STATES are sorted by
+   address.  Return false if STATE isn't there.  */
+
+static bool
+blob_state_index (const re_blob_state_t *states, Idx nstates,
+		  const re_dfastate_t *state, tetra *idx)
+{
+  re_blob_state_t key, *found;
+  if (state == NULL)
+    {
+      *idx = 0;
+      return true;
+    }
+  key.state = state;
+  found = bsearch (&key, states, nstates, sizeof (re_blob_state_t),
+		   blob_state_cmp);
+  if (found == NULL)
+    return false;
+  *idx = found->idx;
+  return true;
+}
+
+static void
+blob_put_trtable (re_blob_writer_t *w, const re_blob_state_t *states,
+		  Idx nstates, const re_dfastate_t *state)
+{
+  re_dfastate_t **trtable = re_load_acquire (state->trtable);
+  re_dfastate_t **word_trtable = re_load_acquire (state->word_trtable);
+  re_dfastate_t **table = trtable ? trtable : word_trtable;
+  int n = trtable ? SBC_MAX : 2 * SBC_MAX;
+  tetra idx;
+  int i;
+
+  /* A table referring a state not saved is dropped, it will be built
+     again when needed.  */
+  if (table != NULL)
+    for (i = 0; i < n; ++i)
+      if (!blob_state_index (states, nstates, table[i], &idx))
+	{
+	  table = NULL;
+	  break;
+	}
+  if (table == NULL)
+    {
+      blob_put_u8 (w, 0);
+      return;
+    }
+  /* Most bytes lead to a few states, so the table is stored as runs of
+     equal entries: length(2) state(4).  */
+  blob_put_u8 (w, trtable ? RE_BLOB_TRTABLE : RE_BLOB_WORD_TRTABLE);
+  for (i = 0; i < n; )
+    {
+      int run = 1;
+      while (i + run < n && table[i + run] == table[i])
+	++run;
+      blob_state_index (states, nstates, table[i], &idx);
+      blob_put_u8 (w, run & 0xff);
+      blob_put_u8 (w, run >> 8);
+      blob_put_u32 (w, idx);
+      i += run;
+    }
+}
+
+static bool
+blob_is_init_state (re_dfastate_t *const *init, const re_dfastate_t *state)
+{
+  return (state == init[0] || state == init[1] || state == init[2]
+	  || state == init[3]);
+}
+
+/* The states are saved in the order of the state table: states with the
+   same hash are in one bucket in order of creation.  The loader
+   registers them in the same order, so a lookup finds the same state of
+   the equivalent ones (e.g. a context independent state and a state of
+   context 0 with the same entrance nodes) as it would in the original
+   regex.  */
+
+static reg_errcode_t
+blob_put_states (re_blob_writer_t *w, const re_dfa_t *dfa, bool with_states)
+{
+  re_dfastate_t *init[4];
+  re_dfastate_t **states;
+  re_blob_state_t *sorted;
+  Idx nstates = 0, i, j;
+  tetra idx;
+
+  init[0] = dfa->init_state;
+  init[1] = dfa->init_state_word;
+  init[2] = dfa->init_state_nl;
+  init[3] = dfa->init_state_begbuf;
+
+  /* New states are registered under the exclusive lock, so the states
+     seen here don't change, and all the states the transition tables
+     refer to are among them.  */
+  re_state_table_lock_shared (dfa);
+  if (with_states)
+    for (i = 0; i <= dfa->state_hash_mask; ++i)
+      nstates += dfa->state_table[i].num;
+  else
+    nstates = 4;
+  states = re_malloc (re_dfastate_t *, nstates);
+  sorted = re_malloc (re_blob_state_t, nstates);
+  if (BE (states == NULL || sorted == NULL, 0))
+    {
+      re_state_table_unlock_shared (dfa);
+      re_free (states);
+      re_free (sorted);
+      return REG_ESPACE;
+    }
+  /* The initial states may be the same, each state is in the table
+     once.  */
+  nstates = 0;
+  for (i = 0; i <= dfa->state_hash_mask; ++i)
+    for (j = 0; j < dfa->state_table[i].num; ++j)
+      {
+	re_dfastate_t *state = dfa->state_table[i].array[j];
+	if (with_states || blob_is_init_state (init, state))
+	  {
+	    sorted[nstates].state = state;
+	    sorted[nstates].idx = nstates + 1;
+	    states[nstates++] = state;
+	  }
+      }
+  qsort (sorted, nstates, sizeof (re_blob_state_t), blob_state_cmp);
+
+  blob_put_u32 (w, nstates);
+  for (i = 0; i < nstates; ++i)
+    {
+      const re_node_set *key;
+      blob_put_u8 (w, blob_state_kind (states[i], &key));
+      blob_put_u8 (w, states[i]->context);
+      blob_put_node_set (w, key);
+    }
+  for (i = 0; i < 4; ++i)
+    {
+      blob_state_index (sorted, nstates, init[i], &idx);
+      blob_put_u32 (w, idx);
+    }
+  for (i = 0; i < nstates; ++i)
+    if (with_states)
+      blob_put_trtable (w, sorted, nstates, states[i]);
+    else
+      blob_put_u8 (w, 0);
+  re_state_table_unlock_shared (dfa);
+
+  re_free (states);
+  re_free (sorted);
+  return REG_NOERROR;
+}
+
+int
+re_blob_save (const regex_t *preg, bool with_states, void **out,
+	      size_t *out_len)
+{
+  const re_dfa_t *dfa = preg->buffer;
+  re_blob_writer_t w;
+  unsigned int flags;
+  reg_errcode_t err;
+  size_t body_len;
+  Idx i;
+
+  if (BE (preg->used == 0 || dfa == NULL || dfa->init_state == NULL, 0))
+    return REG_BADPAT;
+  if (dfa->mb_cur_max != 1 || dfa->nodes_len >= RE_BLOB_NONE)
+    return REG_BADPAT;
+  for (i = 0; i < dfa->nodes_len; ++i)
+    if (dfa->nodes[i].type != CHARACTER && dfa->nodes[i].type != END_OF_RE
+	&& dfa->nodes[i].type != SIMPLE_BRACKET
+	&& dfa->nodes[i].type != OP_BACK_REF
+	&& dfa->nodes[i].type != OP_PERIOD
+	&& !IS_EPSILON_NODE (dfa->nodes[i].type))
+      return REG_BADPAT;
+
+  memset (&w, 0, sizeof (w));
+  blob_put (&w, RE_BLOB_MAGIC, 4);
+  blob_put_u32 (&w, RE_BLOB_VERSION);
+  /* Body length and checksum, set at the end.  */
+  blob_put_u32 (&w, 0);
+  blob_put_u32 (&w, 0);
+
+  flags = ((preg->can_be_null ? RE_BLOB_CAN_BE_NULL : 0)
+	   | (preg->fastmap_accurate ? RE_BLOB_FASTMAP_ACCURATE : 0)
+	   | (preg->no_sub ? RE_BLOB_NO_SUB : 0)
+	   | (preg->not_bol ? RE_BLOB_NOT_BOL : 0)
+	   | (preg->not_eol ? RE_BLOB_NOT_EOL : 0)
+	   | (preg->newline_anchor ? RE_BLOB_NEWLINE_ANCHOR : 0)
+	   | (preg->fastmap ? RE_BLOB_FASTMAP : 0)
+	   | (preg->translate ? RE_BLOB_TRANSLATE : 0)
+	   | (dfa->has_plural_match ? RE_BLOB_PLURAL_MATCH : 0)
+	   | (dfa->has_mb_node ? RE_BLOB_MB_NODE : 0)
+	   | (dfa->word_ops_used ? RE_BLOB_WORD_OPS_USED : 0)
+	   | (dfa->edests ? RE_BLOB_EDESTS : 0)
+	   | (dfa->eclosures ? RE_BLOB_ECLOSURES : 0)
+	   | (dfa->inveclosures ? RE_BLOB_INVECLOSURES : 0)
+	   | (dfa->subexp_map ? RE_BLOB_SUBEXP_MAP : 0));
+  blob_put_u32 (&w, flags);
+  blob_put_u64 (&w, preg->syntax);
+  blob_put_u32 (&w, preg->re_nsub);
+  if (preg->fastmap)
+    blob_put (&w, preg->fastmap, SBC_MAX);
+  if (preg->translate)
+    blob_put (&w, preg->translate, SBC_MAX);
+
+  blob_put_u64 (&w, dfa->syntax);
+  blob_put_u32 (&w, dfa->nodes_len);
+  blob_put_u32 (&w, dfa->init_node);
+  blob_put_u32 (&w, dfa->nbackref);
+  blob_put_u64 (&w, dfa->used_bkref_map);
+  blob_put_u64 (&w, dfa->completed_bkref_map);
+  blob_put_bitset (&w, dfa->word_char);
+  blob_put_literal (&w, &dfa->prefix);
+  blob_put_literal (&w, &dfa->must);
+
+  for (i = 0; i < dfa->nodes_len; ++i)
+    {
+      const re_token_t *node = dfa->nodes + i;
+      blob_put_u8 (&w, node->type);
+      blob_put_u8 (&w, ((node->opt_subexp ? RE_BLOB_TOKEN_OPT_SUBEXP : 0)
+#ifdef RE_ENABLE_I18N
+			| (node->accept_mb ? RE_BLOB_TOKEN_ACCEPT_MB : 0)
+			| (node->mb_partial ? RE_BLOB_TOKEN_MB_PARTIAL : 0)
+#endif
+			| (node->word_char ? RE_BLOB_TOKEN_WORD_CHAR : 0)));
+      blob_put_u32 (&w, node->constraint);
+      switch (node->type)
+	{
+	case CHARACTER:
+	  blob_put_u32 (&w, node->opr.c);
+	  break;
+	case SIMPLE_BRACKET:
+	  blob_put_bitset (&w, node->opr.sbcset);
+	  break;
+	case ANCHOR:
+	  blob_put_u32 (&w, node->opr.ctx_type);
+	  break;
+	case OP_BACK_REF:
+	case OP_OPEN_SUBEXP:
+	case OP_CLOSE_SUBEXP:
+	  blob_put_u32 (&w, node->opr.idx);
+	  break;
+	default:
+	  break;
+	}
+    }
+  for (i = 0; i < dfa->nodes_len; ++i)
+    blob_put_idx (&w, dfa->nexts[i]);
+  for (i = 0; i < dfa->nodes_len; ++i)
+    {
+      if (dfa->edests)
+	blob_put_node_set (&w, dfa->edests + i);
+      if (dfa->eclosures)
+	blob_put_node_set (&w, dfa->eclosures + i);
+      if (dfa->inveclosures)
+	blob_put_node_set (&w, dfa->inveclosures + i);
+    }
+  if (dfa->subexp_map)
+    for (i = 0; i < (Idx) preg->re_nsub; ++i)
+      blob_put_u32 (&w, dfa->subexp_map[i]);
+
+  err = blob_put_states (&w, dfa, with_states);
+  if (BE (err != REG_NOERROR || w.oom, 0))
+    {
+      re_free (w.buf);
+      return REG_ESPACE;
+    }
+
+  /* Fill in the header.  */
+  body_len = w.len - RE_BLOB_HEADER_LEN;
+  w.len = 8;
+  blob_put_u32 (&w, body_len);
+  blob_put_u32 (&w, blob_checksum (w.buf + RE_BLOB_HEADER_LEN, body_len));
+  *out = w.buf;
+  *out_len = body_len + RE_BLOB_HEADER_LEN;
+  return REG_NOERROR;
+}
+
+static reg_errcode_t
+blob_get_token (re_blob_reader_t *r, re_token_t *node, size_t re_nsub)
+{
+  unsigned int flags;
+  tetra v;
+
+  memset (node, 0, sizeof (re_token_t));
+  node->type = blob_get_u8 (r);
+  flags = blob_get_u8 (r);
+  v = blob_get_u32 (r);
+  if (v >= (1 << 10))
+    return REG_BADPAT;
+  node->constraint = v;
+  node->opt_subexp = (flags & RE_BLOB_TOKEN_OPT_SUBEXP) != 0;
+#ifdef RE_ENABLE_I18N
+  node->accept_mb = (flags & RE_BLOB_TOKEN_ACCEPT_MB) != 0;
+  node->mb_partial = (flags & RE_BLOB_TOKEN_MB_PARTIAL) != 0;
+#endif
+  node->word_char = (flags & RE_BLOB_TOKEN_WORD_CHAR) != 0;
+  switch (node->type)
+    {
+    case CHARACTER:
+      v = blob_get_u32 (r);
+      if (v >= SBC_MAX)
+	return REG_BADPAT;
+      node->opr.c = v;
+      break;
+    case SIMPLE_BRACKET:
+      /* Duplicated nodes shared the bitset with the original one, but
+	 here each node gets its own copy.  */
+      node->opr.sbcset = re_malloc (bitset_word_t, BITSET_WORDS);
+      if (BE (node->opr.sbcset == NULL, 0))
+	{
+	  node->type = NON_TYPE;
+	  return REG_ESPACE;
+	}
+      blob_get_bitset (r, node->opr.sbcset);
+      break;
+    case ANCHOR:
+      v = blob_get_u32 (r);
+      if (v != INSIDE_WORD && v != WORD_FIRST && v != WORD_LAST
+	  && v != INSIDE_NOTWORD && v != LINE_FIRST && v != LINE_LAST
+	  && v != BUF_FIRST && v != BUF_LAST && v != WORD_DELIM
+	  && v != NOT_WORD_DELIM)
+	return REG_BADPAT;
+      node->opr.ctx_type = v;
+      break;
+    case OP_BACK_REF:
+    case OP_OPEN_SUBEXP:
+    case OP_CLOSE_SUBEXP:
+      node->opr.idx = blob_get_idx (r, re_nsub, false);
+      break;
+    case END_OF_RE:
+    case OP_PERIOD:
+    case OP_ALT:
+    case OP_DUP_ASTERISK:
+      break;
+    default:
+      return REG_BADPAT;
+    }
+  return r->bad ? REG_BADPAT : REG_NOERROR;
+}
+
+static reg_errcode_t
+blob_get_node_sets (re_blob_reader_t *r, re_dfa_t *dfa, unsigned int flags)
+{
+  reg_errcode_t err;
+  Idx i;
+
+  /* The sets are made empty first, so free_dfa_content() can free them
+     if we fail in the middle.  */
+  if (flags & RE_BLOB_EDESTS)
+    {
+      dfa->edests = re_malloc (re_node_set, dfa->nodes_len);
+      if (BE (dfa->edests == NULL, 0))
+	return REG_ESPACE;
+      memset (dfa->edests, 0, sizeof (re_node_set) * dfa->nodes_len);
+    }
+  if (flags & RE_BLOB_ECLOSURES)
+    {
+      dfa->eclosures = re_malloc (re_node_set, dfa->nodes_len);
+      if (BE (dfa->eclosures == NULL, 0))
+	return REG_ESPACE;
+      memset (dfa->eclosures, 0, sizeof (re_node_set) * dfa->nodes_len);
+    }
+  if (flags & RE_BLOB_INVECLOSURES)
+    {
+      dfa->inveclosures = re_malloc (re_node_set, dfa->nodes_len);
+      if (BE (dfa->inveclosures == NULL, 0))
+	return REG_ESPACE;
+      memset (dfa->inveclosures, 0, sizeof (re_node_set) * dfa->nodes_len);
+    }
+
+  for (i = 0; i < dfa->nodes_len; ++i)
+    {
+      if (dfa->edests)
+	{
+	  err = blob_get_node_set (r, dfa->edests + i, dfa->nodes_len);
+	  if (BE (err != REG_NOERROR, 0))
+	    return err;
+	}
+      if (dfa->eclosures)
+	{
+	  err = blob_get_node_set (r, dfa->eclosures + i, dfa->nodes_len);
+	  if (BE (err != REG_NOERROR, 0))
+	    return err;
+	}
+      if (dfa->inveclosures)
+	{
+	  err = blob_get_node_set (r, dfa->inveclosures + i, dfa->nodes_len);
+	  if (BE (err != REG_NOERROR, 0))
+	    return err;
+	}
+    }
+  return REG_NOERROR;
+}
+
+/* Check what matching takes for granted: each node is in its own
+   eclosure, nodes consuming input have a next node, only epsilon nodes
+   (and back references, for the empty match) have edests, inveclosures
+   are there when prune_impossible_nodes() needs them.  */
+
+static bool
+blob_check_nodes (const regex_t *preg, const re_dfa_t *dfa)
+{
+  Idx i;
+  if (dfa->eclosures == NULL || dfa->edests == NULL)
+    return false;
+  /* See analyze().  */
+  if (((!preg->no_sub && preg->re_nsub > 0 && dfa->has_plural_match)
+       || dfa->nbackref) && dfa->inveclosures == NULL)
+    return false;
+  for (i = 0; i < dfa->nodes_len; ++i)
+    {
+      re_token_type_t type = dfa->nodes[i].type;
+      if (!re_node_set_contains (dfa->eclosures + i, i)
+	  || (dfa->inveclosures
+	      && !re_node_set_contains (dfa->inveclosures + i, i)))
+	return false;
+      if (IS_EPSILON_NODE (type))
+	{
+	  if (dfa->edests[i].nelem > 2)
+	    return false;
+	}
+      else if (dfa->edests[i].nelem > (type == OP_BACK_REF ? 1 : 0)
+	       || (type != END_OF_RE && !REG_VALID_INDEX (dfa->nexts[i])))
+	return false;
+    }
+  return true;
+}
+
+/* Make the transition table TYPE of STATE from the indices in the blob.  */
+
+static reg_errcode_t
+blob_get_trtable (re_blob_reader_t *r, re_dfastate_t *state,
+		  re_dfastate_t **states, Idx nstates, unsigned int type)
+{
+  int i, n = type == RE_BLOB_TRTABLE ? SBC_MAX : 2 * SBC_MAX;
+  re_dfastate_t **table = re_malloc (re_dfastate_t *, n);
+  if (BE (table == NULL, 0))
+    return REG_ESPACE;
+  for (i = 0; i < n && !r->bad; )
+    {
+      int run = blob_get_u8 (r);
+      Idx idx;
+      run |= blob_get_u8 (r) << 8;
+      idx = blob_get_idx (r, nstates + 1, false);
+      if (run == 0 || run > n - i)
+	r->bad = true;
+      for (; run > 0 && !r->bad; --run)
+	table[i++] = idx ? states[idx - 1] : NULL;
+    }
+  if (r->bad)
+    {
+      re_free (table);
+      return REG_BADPAT;
+    }
+  if (type == RE_BLOB_TRTABLE)
+    state->trtable = table;
+  else
+    state->word_trtable = table;
+  return REG_NOERROR;
+}
+
+static reg_errcode_t
+blob_get_states (re_blob_reader_t *r, re_dfa_t *dfa)
+{
+  reg_errcode_t err = REG_NOERROR;
+  re_dfastate_t **states;
+  re_dfastate_t **init[4];
+  Idx nstates, i;
+
+  /* Each state takes at least 6 bytes: kind, context and set length.  */
+  nstates = blob_get_count (r, 6);
+  if (r->bad || nstates == 0)
+    return REG_BADPAT;
+  states = re_malloc (re_dfastate_t *, nstates);
+  if (BE (states == NULL, 0))
+    return REG_ESPACE;
+
+  for (i = 0; i < nstates; ++i)
+    {
+      unsigned int kind = blob_get_u8 (r);
+      unsigned int context = blob_get_u8 (r);
+      re_node_set key;
+
+      re_node_set_init_empty (&key);
+      err = blob_get_node_set (r, &key, dfa->nodes_len);
+      if (BE (err == REG_NOERROR
+	      && (key.nelem == 0 || kind > RE_BLOB_STATE_CD
+		  || context >= (CONTEXT_ENDBUF << 1)
+		  || (kind == RE_BLOB_STATE_CI && context != 0)), 0))
+	err = REG_BADPAT;
+      /* Each state is made anew rather than looked up, equivalent states
+	 of the original regex must stay distinct, along with their
+	 transition tables.  Nobody else uses the DFA yet, so the state
+	 table isn't locked.  */
+      if (err == REG_NOERROR)
+	{
+	  if (kind == RE_BLOB_STATE_CI)
+	    states[i] = create_ci_newstate (dfa, &key,
+					    calc_state_hash (&key, 0));
+	  else
+	    states[i] = create_cd_newstate (dfa, &key, context,
+					    calc_state_hash (&key, context));
+	  if (BE (states[i] == NULL, 0))
+	    err = REG_ESPACE;
+	}
+      re_node_set_free (&key);
+      if (BE (err != REG_NOERROR, 0))
+	goto free_return;
+    }
+
+  init[0] = &dfa->init_state;
+  init[1] = &dfa->init_state_word;
+  init[2] = &dfa->init_state_nl;
+  init[3] = &dfa->init_state_begbuf;
+  for (i = 0; i < 4; ++i)
+    {
+      Idx idx = blob_get_idx (r, nstates + 1, false);
+      if (idx == 0)
+	r->bad = true;
+      else
+	*init[i] = states[idx - 1];
+    }
+
+  for (i = 0; i < nstates && !r->bad; ++i)
+    {
+      unsigned int type = blob_get_u8 (r);
+      if (type == RE_BLOB_TRTABLE || type == RE_BLOB_WORD_TRTABLE)
+	{
+	  err = blob_get_trtable (r, states[i], states, nstates, type);
+	  if (BE (err != REG_NOERROR, 0))
+	    goto free_return;
+	}
+      else if (type != 0)
+	r->bad = true;
+    }
+  err = r->bad ? REG_BADPAT : REG_NOERROR;
+
+ free_return:
+  re_free (states);
+  return err;
+}
+
+static reg_errcode_t
+re_blob_load_internal (regex_t *preg, re_blob_reader_t *r)
+{
+  re_dfa_t *dfa;
+  unsigned int flags;
+  reg_errcode_t err;
+  const unsigned char *p;
+  octa syntax;
+  Idx nodes_len, i;
+
+  flags = blob_get_u32 (r);
+  preg->syntax = blob_get_u64 (r);
+  preg->re_nsub = blob_get_u32 (r);
+  preg->can_be_null = (flags & RE_BLOB_CAN_BE_NULL) != 0;
+  preg->fastmap_accurate = (flags & RE_BLOB_FASTMAP_ACCURATE) != 0;
+  preg->no_sub = (flags & RE_BLOB_NO_SUB) != 0;
+  preg->not_bol = (flags & RE_BLOB_NOT_BOL) != 0;
+  preg->not_eol = (flags & RE_BLOB_NOT_EOL) != 0;
+  preg->newline_anchor = (flags & RE_BLOB_NEWLINE_ANCHOR) != 0;
+  preg->regs_allocated = REGS_UNALLOCATED;
+  if (flags & RE_BLOB_FASTMAP)
+    {
+      p = blob_get (r, SBC_MAX);
+      if (p == NULL)
+	return REG_BADPAT;
+      preg->fastmap = re_malloc (char, SBC_MAX);
+      if (BE (preg->fastmap == NULL, 0))
+	return REG_ESPACE;
+      memcpy (preg->fastmap, p, SBC_MAX);
+    }
+  if (flags & RE_BLOB_TRANSLATE)
+    {
+      p = blob_get (r, SBC_MAX);
+      if (p == NULL)
+	return REG_BADPAT;
+      preg->translate = re_malloc (unsigned char, SBC_MAX);
+      if (BE (preg->translate == NULL, 0))
+	return REG_ESPACE;
+      memcpy (preg->translate, p, SBC_MAX);
+    }
+
+  syntax = blob_get_u64 (r);
+  /* Each node takes at least 6 bytes: type, flags and constraint.  */
+  nodes_len = blob_get_count (r, 6);
+  if (r->bad || nodes_len == 0)
+    return REG_BADPAT;
+
+  dfa = re_malloc (re_dfa_t, 1);
+  if (BE (dfa == NULL, 0))
+    return REG_ESPACE;
+  preg->buffer = dfa;
+  preg->allocated = sizeof (re_dfa_t);
+  preg->used = sizeof (re_dfa_t);
+  err = init_dfa (dfa, nodes_len);
+  if (BE (err != REG_NOERROR, 0))
+    return err;
+  /* The blob is made for single byte locales.  */
+  if (dfa->mb_cur_max != 1)
+    return REG_BADPAT;
+
+  dfa->syntax = syntax;
+  dfa->has_plural_match = (flags & RE_BLOB_PLURAL_MATCH) != 0;
+  dfa->has_mb_node = (flags & RE_BLOB_MB_NODE) != 0;
+  dfa->word_ops_used = (flags & RE_BLOB_WORD_OPS_USED) != 0;
+  dfa->init_node = blob_get_idx (r, nodes_len, false);
+  dfa->nbackref = blob_get_idx (r, nodes_len + 1, false);
+  dfa->used_bkref_map = blob_get_u64 (r);
+  dfa->completed_bkref_map = blob_get_u64 (r);
+  blob_get_bitset (r, dfa->word_char);
+  blob_get_literal (r, &dfa->prefix);
+  blob_get_literal (r, &dfa->must);
+  if (r->bad)
+    return REG_BADPAT;
+
+  /* NODES_LEN counts the nodes read so far, so free_dfa_content() frees
+     only them if we fail.  */
+  for (i = 0; i < nodes_len; ++i)
+    {
+      err = blob_get_token (r, dfa->nodes + i, preg->re_nsub);
+      if (dfa->nodes[i].type != NON_TYPE)
+	dfa->nodes_len = i + 1;
+      if (BE (err != REG_NOERROR, 0))
+	return err;
+    }
+
+  dfa->nexts = re_malloc (Idx, nodes_len);
+  if (BE (dfa->nexts == NULL, 0))
+    return REG_ESPACE;
+  for (i = 0; i < nodes_len; ++i)
+    dfa->nexts[i] = blob_get_idx (r, nodes_len, true);
+  err = blob_get_node_sets (r, dfa, flags);
+  if (BE (err != REG_NOERROR, 0))
+    return err;
+  if (!blob_check_nodes (preg, dfa))
+    return REG_BADPAT;
+
+  if (flags & RE_BLOB_SUBEXP_MAP)
+    {
+      dfa->subexp_map = re_malloc (Idx, MAX (preg->re_nsub, 1));
+      if (BE (dfa->subexp_map == NULL, 0))
+	return REG_ESPACE;
+      for (i = 0; i < (Idx) preg->re_nsub; ++i)
+	dfa->subexp_map[i] = blob_get_idx (r, preg->re_nsub, false);
+    }
+  if (r->bad)
+    return REG_BADPAT;
+
+  return blob_get_states (r, dfa);
+}
+
+int
+re_blob_load (regex_t *preg, const void *blob, size_t len)
+{
+  re_blob_reader_t r;
+  const unsigned char *header;
+  reg_errcode_t err;
+
+  memset (preg, 0, sizeof (regex_t));
+  r.p = blob;
+  r.end = r.p + len;
+  r.bad = false;
+
+  header = blob_get (&r, 4);
+  if (header == NULL || memcmp (header, RE_BLOB_MAGIC, 4) != 0
+      || blob_get_u32 (&r) != RE_BLOB_VERSION
+      || blob_get_u32 (&r) != len - RE_BLOB_HEADER_LEN)
+    return REG_BADPAT;
+  if (blob_get_u32 (&r) != blob_checksum (r.p, len - RE_BLOB_HEADER_LEN))
+    return REG_BADPAT;
+
+  err = re_blob_load_internal (preg, &r);
+  /* Trailing garbage is an error too.  */
+  if (err == REG_NOERROR && r.p != r.end)
+    err = REG_BADPAT;
+  if (BE (err != REG_NOERROR, 0))
+    {
+      regfree (preg);
+      return err;
+    }
+  return REG_NOERROR;
+}
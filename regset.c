@@ -0,0 +1,683 @@
+/* Matching many regular expressions in one pass.
+   This file is included from regex.c, after regexec.c, so it can use
+   DFA internals directly.
+
+   All patterns are parsed into one tree:
+
+		ALT
+	       /   \
+	    CAT     CAT   ...
+	    / \     / \
+	<re0> EOR <re1> EOR
+
+   and each END_OF_RE node carries the index of its pattern in opr.idx (it
+   is copied along when the node is duplicated for constraints).
+
+   The search is unanchored.  Instead of restarting the DFA at each position
+   as re_search_internal() does, the nodes of the initial state are added to
+   each state, so all match attempts run at once, and the patterns whose
+   END_OF_RE node is in the state (with constraint satisfied by the next
+   byte) have a match ending at the current position.  These "set states"
+   are built lazily on top of the DFA states, and their transitions are
+   cached in dense tables indexed by raw byte.
+
+   The same machinery serves as the pure DFA matcher of a single regex
+   compiled by regcomp(): when no submatches are wanted, the set of one
+   pattern is built lazily on top of its DFA, see re_bool_match().
+
+   Back-references and multibyte locales are not supported.  */
+
+typedef struct re_set_state re_set_state_t;
+
+struct re_set_state
+{
+  re_dfastate_t *state;
+  /* Indexed by raw byte, NULL if not built yet.  */
+  re_set_state_t *next[SBC_MAX];
+  /* END_OF_RE nodes in STATE.  */
+  Idx *halt_nodes;
+  Idx nhalt;
+};
+
+struct re_set
+{
+  /* All patterns compiled into one DFA, unused if the set borrows the DFA
+     of a regex compiled by regcomp().  */
+  regex_t preg;
+  bool own_preg;
+  bool newline_anchor;
+  re_dfa_t *dfa;
+  size_t n;
+  /* RE_TRANSLATE and REG_ICASE applied to raw byte, as in re_string_t.  */
+  unsigned char xlat[SBC_MAX];
+  /* Initial set states, indexed by context of the byte before the start.  */
+  re_set_state_t *start[CONTEXT_ENDBUF << 1];
+  /* Initial DFA states, indexed by context.  */
+  re_dfastate_t *init[CONTEXT_ENDBUF << 1];
+  /* All set states, by STATE, open addressing.  */
+  re_set_state_t **table;
+  size_t table_size, nstates;
+  /* Protects building of set states, the matching itself is lock-free.  */
+  my_mutex lock;
+};
+
+#define SET_BOF (-1)
+#define SET_EOF (-2)
+
+/* Same as re_string_context_at(), but for a raw byte C.  */
+
+static unsigned int
+set_context (const re_set_t *set, int c, int eflags)
+{
+  if (c == SET_BOF)
+    return ((eflags & REG_NOTBOL) ? CONTEXT_BEGBUF
+	    : CONTEXT_NEWLINE | CONTEXT_BEGBUF);
+  if (c == SET_EOF)
+    return ((eflags & REG_NOTEOL) ? CONTEXT_ENDBUF
+	    : CONTEXT_NEWLINE | CONTEXT_ENDBUF);
+  c = set->xlat[c];
+  if (bitset_contain (set->dfa->word_char, c))
+    return CONTEXT_WORD;
+  return IS_NEWLINE (c) && set->newline_anchor ? CONTEXT_NEWLINE : 0;
+}
+
+static void
+set_init_xlat (re_set_t *set, RE_TRANSLATE_TYPE translate, bool icase)
+{
+  int i;
+  for (i = 0; i < SBC_MAX; ++i)
+    {
+      int ch = translate ? translate[i] : i;
+      set->xlat[i] = icase && islower (ch) ? toupper (ch) : ch;
+    }
+}
+
+static size_t
+set_hash (const re_dfastate_t *state)
+{
+  return ((size_t) state >> 4) * 2654435761U;
+}
+
+static reg_errcode_t
+set_table_grow (re_set_t *set)
+{
+  size_t new_size = set->table_size ? set->table_size * 2 : 64;
+  re_set_state_t **new_table = re_malloc (re_set_state_t *, new_size);
+  size_t i, j;
+
+  if (BE (new_table == NULL, 0))
+    return REG_ESPACE;
+  memset (new_table, 0, new_size * sizeof (re_set_state_t *));
+  for (i = 0; i < set->table_size; ++i)
+    if (set->table[i] != NULL)
+      {
+	for (j = set_hash (set->table[i]->state) & (new_size - 1);
+	     new_table[j] != NULL; j = (j + 1) & (new_size - 1))
+	  ;
+	new_table[j] = set->table[i];
+      }
+  re_free (set->table);
+  set->table = new_table;
+  set->table_size = new_size;
+  return REG_NOERROR;
+}
+
+/* Find or create the set state for STATE.  Must be called with SET->lock
+   held.  */
+
+static re_set_state_t *
+set_state_get (re_set_t *set, re_dfastate_t *state, reg_errcode_t *err)
+{
+  re_set_state_t *ss;
+  size_t i;
+  Idx j;
+
+  if (set->nstates * 2 >= set->table_size)
+    {
+      *err = set_table_grow (set);
+      if (BE (*err != REG_NOERROR, 0))
+	return NULL;
+    }
+  for (i = set_hash (state) & (set->table_size - 1); set->table[i] != NULL;
+       i = (i + 1) & (set->table_size - 1))
+    if (set->table[i]->state == state)
+      return set->table[i];
+
+  ss = re_malloc (re_set_state_t, 1);
+  if (BE (ss == NULL, 0))
+    {
+      *err = REG_ESPACE;
+      return NULL;
+    }
+  memset (ss, 0, sizeof (re_set_state_t));
+  ss->state = state;
+  if (state != NULL && state->halt)
+    {
+      ss->halt_nodes = re_malloc (Idx, state->nodes.nelem);
+      if (BE (ss->halt_nodes == NULL, 0))
+	{
+	  re_free (ss);
+	  *err = REG_ESPACE;
+	  return NULL;
+	}
+      for (j = 0; j < state->nodes.nelem; ++j)
+	if (set->dfa->nodes[state->nodes.elems[j]].type == END_OF_RE)
+	  ss->halt_nodes[ss->nhalt++] = state->nodes.elems[j];
+    }
+  set->table[i] = ss;
+  set->nstates++;
+  return ss;
+}
+
+/* Return the set state for NODES (may be NULL) plus the initial nodes in
+   CONTEXT of the previous byte.
+
+   NODES are already checked against the context they were reached in, and
+   that may differ from CONTEXT: the transition tables use newline context
+   for '\n' even without REG_NEWLINE, while new match attempts start in the
+   context of re_string_context_at().  So the initial nodes are checked
+   separately, and the union is acquired without context.  */
+
+static re_set_state_t *
+set_state_acquire (re_set_t *set, const re_node_set *nodes,
+		   unsigned int context, reg_errcode_t *err)
+{
+  re_dfa_t *const dfa = set->dfa;
+  re_dfastate_t *init, *state;
+  re_node_set all;
+
+  *err = REG_NOERROR;
+  init = set->init[context];
+  if (init == NULL)
+    {
+      init = re_acquire_state_context (err, dfa,
+				       dfa->init_state->entrance_nodes,
+				       context);
+      if (BE (init == NULL && *err != REG_NOERROR, 0))
+	return NULL;
+      set->init[context] = init;
+    }
+
+  if (nodes == NULL)
+    state = init;
+  else if (init == NULL)
+    state = re_acquire_state (err, dfa, nodes);
+  else
+    {
+      *err = re_node_set_init_union (&all, nodes, &init->nodes);
+      if (BE (*err != REG_NOERROR, 0))
+	return NULL;
+      state = re_acquire_state (err, dfa, &all);
+      re_node_set_free (&all);
+    }
+  if (BE (state == NULL && *err != REG_NOERROR, 0))
+    return NULL;
+  /* NULL state is the empty one, there are no match attempts in it, but
+     new ones are still started on each byte.  */
+  return set_state_get (set, state, err);
+}
+
+/* Build transition of SS on raw byte C.  Must be called with SET->lock
+   held.  */
+
+static re_set_state_t *
+set_transit (re_set_t *set, re_set_state_t *ss, int c, reg_errcode_t *err)
+{
+  re_dfastate_t *state = ss->state, *dest = NULL;
+  re_dfastate_t **trtable;
+  unsigned int context = set_context (set, c, 0);
+  unsigned char ch = set->xlat[c];
+  re_set_state_t *next;
+
+  while (state != NULL)
+    {
+      trtable = re_load_acquire (state->trtable);
+      if (trtable != NULL)
+	{
+	  dest = trtable[ch];
+	  break;
+	}
+      trtable = re_load_acquire (state->word_trtable);
+      if (trtable != NULL)
+	{
+	  dest = trtable[IS_WORD_CONTEXT (context) ? ch + SBC_MAX : ch];
+	  break;
+	}
+      if (!build_trtable (set->dfa, state))
+	{
+	  *err = REG_ESPACE;
+	  return NULL;
+	}
+    }
+
+  next = set_state_acquire (set, dest ? &dest->nodes : NULL, context, err);
+  if (next != NULL)
+    re_store_release (ss->next[c], next);
+  return next;
+}
+
+/* Same as re_compile_internal(), but for many patterns.  */
+
+static reg_errcode_t
+re_set_compile_internal (regex_t *preg, const char **patterns, size_t n,
+			 reg_syntax_t syntax)
+{
+  reg_errcode_t err = REG_NOERROR;
+  re_dfa_t *dfa;
+  re_string_t regexp;
+  re_token_t token;
+  bin_tree_t **trees;
+  size_t i, step, length = 0;
+
+  for (i = 0; i < n; ++i)
+    length += strlen (patterns[i]);
+
+  /* Initialize the pattern buffer.  */
+  preg->fastmap_accurate = 0;
+  preg->syntax = syntax;
+  preg->not_bol = preg->not_eol = 0;
+  preg->re_nsub = 0;
+  preg->can_be_null = 0;
+  preg->regs_allocated = REGS_UNALLOCATED;
+
+  dfa = re_malloc (re_dfa_t, 1);
+  if (BE (dfa == NULL, 0))
+    return REG_ESPACE;
+  preg->buffer = dfa;
+  preg->allocated = preg->used = sizeof (re_dfa_t);
+
+  err = init_dfa (dfa, length);
+  if (BE (err != REG_NOERROR, 0))
+    {
+      free_dfa_content (dfa);
+      preg->buffer = NULL;
+      preg->allocated = 0;
+      return err;
+    }
+  __libc_lock_init (dfa->lock);
+
+  trees = re_malloc (bin_tree_t *, n);
+  if (BE (trees == NULL, 0))
+    {
+      err = REG_ESPACE;
+      goto free_return;
+    }
+  if (dfa->mb_cur_max > 1)
+    {
+      err = REG_BADPAT;
+      goto free_return;
+    }
+
+  dfa->syntax = syntax;
+  for (i = 0; i < n; ++i)
+    {
+      bin_tree_t *tree, *eor;
+
+      err = re_string_construct (&regexp, patterns[i], strlen (patterns[i]),
+				 preg->translate, (syntax & RE_ICASE) != 0,
+				 dfa);
+      if (BE (err != REG_NOERROR, 0))
+	{
+	  re_string_destruct (&regexp);
+	  goto free_return;
+	}
+      fetch_token (&token, &regexp, syntax | RE_CARET_ANCHORS_HERE);
+      tree = parse_reg_exp (&regexp, preg, &token, syntax, 0, &err);
+      re_string_destruct (&regexp);
+      if (BE (err != REG_NOERROR, 0))
+	goto free_return;
+
+      eor = create_tree (dfa, NULL, NULL, END_OF_RE);
+      if (BE (eor == NULL, 0))
+	{
+	  err = REG_ESPACE;
+	  goto free_return;
+	}
+      eor->token.opr.idx = i;
+      trees[i] = tree != NULL ? create_tree (dfa, tree, eor, CONCAT) : eor;
+      if (BE (trees[i] == NULL, 0))
+	{
+	  err = REG_ESPACE;
+	  goto free_return;
+	}
+    }
+
+  /* Join alternatives pairwise, so the tree (and the recursion in
+     calc_eclosure_iter()) is only log(N) deep.  */
+  for (step = 1; step < n; step *= 2)
+    for (i = 0; i + step < n; i += step * 2)
+      {
+	trees[i] = create_tree (dfa, trees[i], trees[i + step], OP_ALT);
+	if (BE (trees[i] == NULL, 0))
+	  {
+	    err = REG_ESPACE;
+	    goto free_return;
+	  }
+      }
+  dfa->str_tree = trees[0];
+
+  err = analyze (preg);
+  if (BE (err != REG_NOERROR, 0))
+    goto free_return;
+
+  err = create_initial_state (dfa);
+
+ free_return:
+  re_free (trees);
+  free_workarea_compile (preg);
+  if (BE (err != REG_NOERROR, 0))
+    {
+      free_dfa_content (dfa);
+      preg->buffer = NULL;
+      preg->allocated = 0;
+    }
+  return err;
+}
+
+int
+re_set_compile (re_set_t **out, const char **patterns, size_t n, int cflags,
+		size_t *bad_pattern)
+{
+  reg_syntax_t syntax = ((cflags & REG_EXTENDED) ? RE_SYNTAX_POSIX_EXTENDED
+			 : RE_SYNTAX_POSIX_BASIC);
+  bool icase = (cflags & REG_ICASE) != 0;
+  reg_errcode_t err;
+  re_set_t *set;
+  size_t i;
+
+  if (n == 0)
+    return REG_BADPAT;
+
+  /* Compile each pattern alone first, to find out which one is bad.  */
+  for (i = 0; i < n; ++i)
+    {
+      regex_t r;
+      int ret = regcomp (&r, patterns[i], cflags | REG_NOSUB);
+      if (ret == REG_NOERROR)
+	{
+	  if (((re_dfa_t *) r.buffer)->nbackref)
+	    ret = REG_BADPAT;
+	  regfree (&r);
+	}
+      if (ret != REG_NOERROR)
+	{
+	  if (bad_pattern != NULL)
+	    *bad_pattern = i;
+	  return ret;
+	}
+    }
+
+  set = re_malloc (re_set_t, 1);
+  if (BE (set == NULL, 0))
+    return REG_ESPACE;
+  memset (set, 0, sizeof (re_set_t));
+  set->n = n;
+
+  syntax |= icase ? RE_ICASE : 0;
+  if (cflags & REG_NEWLINE)
+    {
+      syntax &= ~RE_DOT_NEWLINE;
+      syntax |= RE_HAT_LISTS_NOT_NEWLINE;
+      set->preg.newline_anchor = 1;
+      set->newline_anchor = true;
+    }
+  /* Subexpressions are never reported.  */
+  set->preg.no_sub = 1;
+
+  err = re_set_compile_internal (&set->preg, patterns, n, syntax);
+  if (BE (err != REG_NOERROR, 0))
+    {
+      re_free (set);
+      return err;
+    }
+  set->own_preg = true;
+  set->dfa = set->preg.buffer;
+  set_init_xlat (set, NULL, icase);
+  my_mutex_init (&set->lock);
+
+  *out = set;
+  return REG_NOERROR;
+}
+
+size_t
+re_set_size (const re_set_t *set)
+{
+  return set->n;
+}
+
+size_t
+re_set_states (const re_set_t *set)
+{
+  return set->nstates;
+}
+
+static void
+set_check_halt (const re_set_t *set, const re_set_state_t *ss,
+		unsigned int context, bitset_word_t *found, size_t *nfound)
+{
+  Idx i;
+  for (i = 0; i < ss->nhalt; ++i)
+    {
+      Idx node = ss->halt_nodes[i];
+      /* regcomp() leaves opr of END_OF_RE unset, and the only pattern of
+	 a borrowed DFA is 0.  */
+      Idx id = set->n == 1 ? 0 : set->dfa->nodes[node].opr.idx;
+      bitset_word_t bit = (bitset_word_t) 1 << id % BITSET_WORD_BITS;
+      if (!(found[id / BITSET_WORD_BITS] & bit)
+	  && check_halt_node_context (set->dfa, node, context))
+	{
+	  found[id / BITSET_WORD_BITS] |= bit;
+	  (*nfound)++;
+	}
+    }
+}
+
+/* Match bytes [START, LEN) of STRING, the byte before START (if any)
+   gives the context of the start.  */
+
+static reg_errcode_t
+set_match (re_set_t *set, const char *string, size_t start, size_t len,
+	   int eflags, size_t *ids, size_t *nids)
+{
+  const unsigned char *s = (const unsigned char *) string;
+  bitset_word_t found_buf[16], *found = found_buf;
+  size_t words = (set->n + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+  size_t i, nfound = 0;
+  reg_errcode_t err = REG_NOERROR;
+  re_set_state_t *ss, *next;
+  unsigned int context = set_context (set, start ? s[start - 1] : SET_BOF,
+				      eflags);
+
+  *nids = 0;
+  if (words > sizeof (found_buf) / sizeof (found_buf[0]))
+    {
+      found = re_malloc (bitset_word_t, words);
+      if (BE (found == NULL, 0))
+	return REG_ESPACE;
+    }
+  memset (found, 0, words * sizeof (bitset_word_t));
+
+  ss = re_load_acquire (set->start[context]);
+  if (BE (ss == NULL, 0))
+    {
+      my_mutex_lock (&set->lock);
+      ss = set->start[context];
+      if (ss == NULL)
+	{
+	  ss = set_state_acquire (set, NULL, context, &err);
+	  if (ss != NULL)
+	    re_store_release (set->start[context], ss);
+	}
+      my_mutex_unlock (&set->lock);
+      if (BE (ss == NULL, 0))
+	goto out;
+    }
+
+  for (i = start;; ++i)
+    {
+      if (ss->nhalt != 0)
+	{
+	  set_check_halt (set, ss, set_context (set, i < len ? s[i] : SET_EOF,
+						eflags), found, &nfound);
+	  if (nfound == set->n)
+	    break;
+	}
+      if (i == len)
+	break;
+
+      next = re_load_acquire (ss->next[s[i]]);
+      if (BE (next == NULL, 0))
+	{
+	  my_mutex_lock (&set->lock);
+	  next = ss->next[s[i]];
+	  if (next == NULL)
+	    next = set_transit (set, ss, s[i], &err);
+	  my_mutex_unlock (&set->lock);
+	  if (BE (next == NULL, 0))
+	    goto out;
+	}
+      ss = next;
+    }
+
+  for (i = 0; i < set->n; ++i)
+    if (found[i / BITSET_WORD_BITS] & ((bitset_word_t) 1 << i % BITSET_WORD_BITS))
+      ids[(*nids)++] = i;
+
+ out:
+  if (found != found_buf)
+    re_free (found);
+  return err;
+}
+
+int
+re_set_match (re_set_t *set, const char *string, size_t len, int eflags,
+	      size_t *ids, size_t *nids)
+{
+  *nids = 0;
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL))
+    return REG_BADPAT;
+  return set_match (set, string, 0, len, eflags, ids, nids);
+}
+
+void
+re_set_free (re_set_t *set)
+{
+  size_t i;
+  for (i = 0; i < set->table_size; ++i)
+    if (set->table[i] != NULL)
+      {
+	re_free (set->table[i]->halt_nodes);
+	re_free (set->table[i]);
+      }
+  re_free (set->table);
+  my_mutex_deinit (&set->lock);
+  if (set->own_preg)
+    regfree (&set->preg);
+  re_free (set);
+}
+
+/* Pure DFA matching of a regex compiled by regcomp(), for callers which
+   only need to know whether there is a match.  Unlike re_search_internal(),
+   it doesn't restart the DFA at each position, and has no state log,
+   longest match search or registers to take care of.  */
+
+bool regex_bool_dfa_enabled = true;
+
+static bool
+re_bool_usable (const regex_t *preg)
+{
+  const re_dfa_t *dfa = preg->buffer;
+  return (regex_bool_dfa_enabled && dfa->mb_cur_max == 1 && !dfa->nbackref
+	  && !dfa->has_mb_node);
+}
+
+/* Return the set of one pattern borrowing the DFA of PREG, build it if
+   needed.  */
+
+static re_set_t *
+bool_set_get (const regex_t *preg, reg_errcode_t *err)
+{
+  re_dfa_t *dfa = preg->buffer;
+  re_set_t *set = re_load_acquire (dfa->bool_set);
+
+  if (BE (set != NULL, 1))
+    return set;
+  re_trtable_lock (dfa);
+  set = dfa->bool_set;
+  if (set == NULL)
+    {
+      set = re_malloc (re_set_t, 1);
+      if (BE (set == NULL, 0))
+	*err = REG_ESPACE;
+      else
+	{
+	  memset (set, 0, sizeof (re_set_t));
+	  set->n = 1;
+	  set->dfa = dfa;
+	  set->newline_anchor = preg->newline_anchor;
+	  set_init_xlat (set, preg->translate,
+			 (preg->syntax & RE_ICASE) != 0);
+	  my_mutex_init (&set->lock);
+	  re_store_release (dfa->bool_set, set);
+	}
+    }
+  re_trtable_unlock (dfa);
+  return set;
+}
+
+/* Same as re_search_internal() with NMATCH == 0 and LAST_START == STOP ==
+   LENGTH.  The caller checks re_bool_usable().  */
+
+static reg_errcode_t
+re_bool_match (const regex_t *preg, const char *string, Idx start,
+	       Idx length, int eflags)
+{
+  const re_dfa_t *dfa = preg->buffer;
+  reg_errcode_t err = REG_NOERROR;
+  re_set_t *set;
+  size_t id, nids;
+
+  /* Check if the DFA haven't been compiled.  */
+  if (BE (preg->used == 0 || dfa->init_state == NULL, 0))
+    return REG_NOMATCH;
+
+  /* As in re_search_internal(): REG_STARTEND with rm_so > rm_eo.  */
+  if (BE (start < 0 || start > length, 0))
+    return REG_NOMATCH;
+
+  /* Every match contains dfa->must and starts with dfa->prefix, so skip
+     straight to the first place a match can start at.  */
+  if (dfa->must.len != 0
+      && find_literal (string, length, start, &dfa->must) == REG_MISSING)
+    return REG_NOMATCH;
+  if (dfa->prefix.len != 0)
+    {
+      start = find_literal (string, length, start, &dfa->prefix);
+      if (start == REG_MISSING)
+	return REG_NOMATCH;
+    }
+
+  set = bool_set_get (preg, &err);
+  if (BE (set == NULL, 0))
+    return err;
+  err = set_match (set, string, start, length, eflags, &id, &nids);
+  if (BE (err != REG_NOERROR, 0))
+    return err;
+  return nids ? REG_NOERROR : REG_NOMATCH;
+}
+
+int
+regexec_bool (const regex_t *preg, const char *string, size_t len,
+	      int eflags)
+{
+  reg_errcode_t err;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL))
+    return REG_BADPAT;
+  if (re_bool_usable (preg))
+    err = re_bool_match (preg, string, 0, len, eflags);
+  else
+    err = re_search_internal (preg, string, len, 0, len, len, 0, NULL,
+			      eflags, NULL);
+  return err != REG_NOERROR;
+}
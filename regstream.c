@@ -0,0 +1,400 @@
+/* Streaming search on top of the regexec.c DFA.
+   This file is included from regex.c, after regexec.c, so it can use
+   DFA internals directly.
+
+   The input is fed in chunks of arbitrary size.  The matcher does the same
+   thing re_search_internal() + check_matching() do for the nmatch == 1 case
+   (leftmost-longest match, no state log), but the DFA state, the current
+   match candidate and the context of the previous byte are carried across
+   chunk boundaries.  Only bytes which may be rescanned (starting from the
+   current match candidate) are retained, so the whole input is never needed
+   in memory.
+
+   Since the halt of a state with constraints ('$', '\b', etc) depends on the
+   next byte, it is resolved when the next byte arrives or at the end of
+   input.
+
+   Back-references and multibyte locales are not supported: both require
+   the state log, i.e., the whole history of the match.  */
+
+struct re_stream
+{
+  const regex_t *preg;
+  re_dfa_t *dfa;
+  int eflags;
+  size_t max_len;
+  re_stream_fn fn;
+  void *param;
+
+  /* RE_TRANSLATE and REG_ICASE applied to raw byte, as in re_string_t.  */
+  unsigned char xlat[SBC_MAX];
+  const char *fastmap;
+  bool anchored;
+
+  /* Bytes [base, base + len) of input, which may still be rescanned.  */
+  unsigned char *buf;
+  size_t len, alloc;
+  octa base;
+  /* Byte at base - 1, or -1 at the beginning of input.  */
+  int before;
+  /* Next byte to feed into the DFA.  */
+  octa pos;
+
+  /* Current match candidate, see check_matching().  */
+  bool active;
+  octa first, next_start, last;
+  bool at_init_state, matched;
+  re_dfastate_t *state;
+  /* STATE is a halt state with constraint, to be checked against the
+     context of the byte at POS.  */
+  bool halt_pending;
+
+  bool stopped;
+  reg_errcode_t err;
+};
+
+#define STREAM_BOF (-1)
+#define STREAM_EOF (-2)
+
+static int
+stream_byte_at (const re_stream_t *st, octa idx)
+{
+  if (idx == (octa)-1)
+    return STREAM_BOF;
+  if (idx < st->base)
+    return st->before;
+  return st->buf[idx - st->base];
+}
+
+/* Same as re_string_context_at(), but for a raw byte C.  */
+
+static unsigned int
+stream_context (const re_stream_t *st, int c)
+{
+  if (c == STREAM_BOF)
+    return ((st->eflags & REG_NOTBOL) ? CONTEXT_BEGBUF
+	    : CONTEXT_NEWLINE | CONTEXT_BEGBUF);
+  if (c == STREAM_EOF)
+    return ((st->eflags & REG_NOTEOL) ? CONTEXT_ENDBUF
+	    : CONTEXT_NEWLINE | CONTEXT_ENDBUF);
+  c = st->xlat[c];
+  if (bitset_contain (st->dfa->word_char, c))
+    return CONTEXT_WORD;
+  return IS_NEWLINE (c) && st->preg->newline_anchor ? CONTEXT_NEWLINE : 0;
+}
+
+/* Same as acquire_init_state_context().  */
+
+static re_dfastate_t *
+stream_init_state (re_stream_t *st, unsigned int context)
+{
+  const re_dfa_t *const dfa = st->dfa;
+  if (!dfa->init_state->has_constraint)
+    return dfa->init_state;
+  if (IS_WORD_CONTEXT (context))
+    return dfa->init_state_word;
+  else if (IS_ORDINARY_CONTEXT (context))
+    return dfa->init_state;
+  else if (IS_BEGBUF_CONTEXT (context) && IS_NEWLINE_CONTEXT (context))
+    return dfa->init_state_begbuf;
+  else if (IS_NEWLINE_CONTEXT (context))
+    return dfa->init_state_nl;
+  else if (IS_BEGBUF_CONTEXT (context))
+    return re_acquire_state_context (&st->err, dfa,
+				     dfa->init_state->entrance_nodes,
+				     context);
+  return dfa->init_state;
+}
+
+static bool
+stream_check_halt (const re_stream_t *st, unsigned int context)
+{
+  Idx i;
+  for (i = 0; i < st->state->nodes.nelem; ++i)
+    if (check_halt_node_context (st->dfa, st->state->nodes.elems[i], context))
+      return true;
+  return false;
+}
+
+/* Same as transit_state() for single byte locale.  */
+
+static re_dfastate_t *
+stream_transit (re_stream_t *st, re_dfastate_t *state, int c)
+{
+  unsigned char ch = st->xlat[c];
+  re_dfastate_t **trtable;
+  for (;;)
+    {
+      trtable = re_load_acquire (state->trtable);
+      if (BE (trtable != NULL, 1))
+	return trtable[ch];
+      trtable = re_load_acquire (state->word_trtable);
+      if (BE (trtable != NULL, 1))
+	{
+	  if (IS_WORD_CONTEXT (stream_context (st, c)))
+	    return trtable[ch + SBC_MAX];
+	  else
+	    return trtable[ch];
+	}
+      if (!build_trtable (st->dfa, state))
+	{
+	  st->err = REG_ESPACE;
+	  return NULL;
+	}
+    }
+}
+
+static void
+stream_set_state (re_stream_t *st, re_dfastate_t *state)
+{
+  st->state = state;
+  if (state->halt)
+    {
+      if (!state->has_constraint)
+	{
+	  st->matched = true;
+	  st->last = st->pos;
+	}
+      else
+	st->halt_pending = true;
+    }
+}
+
+/* Run the matcher over all bytes available.  If EOF is false, stops when
+   the next byte is needed.  */
+
+static void
+stream_run (re_stream_t *st, bool eof)
+{
+  octa end = st->base + st->len;
+
+  while (!st->stopped && st->err == REG_NOERROR)
+    {
+      if (!st->active)
+	{
+	  /* Find a plausible place to start matching.  */
+	  if (st->anchored && st->pos != 0)
+	    {
+	      st->stopped = true;
+	      return;
+	    }
+	  if (st->fastmap != NULL)
+	    {
+	      RE_TRANSLATE_TYPE t = st->preg->translate;
+	      while (st->pos < end)
+		{
+		  unsigned char c = st->buf[st->pos - st->base];
+		  if (st->fastmap[t ? t[c] : c])
+		    break;
+		  st->pos++;
+		}
+	    }
+	  if (st->pos > end || (st->pos == end && !eof))
+	    return;
+	  /* At the end of input, re_search_internal() checks the fastmap
+	     against '\0'.  */
+	  if (st->pos == end && st->fastmap != NULL
+	      && !st->fastmap[st->preg->translate ? st->preg->translate[0] : 0])
+	    return;
+
+	  st->active = true;
+	  st->first = st->next_start = st->pos;
+	  st->at_init_state = true;
+	  st->matched = false;
+	  st->halt_pending = false;
+	  st->state = stream_init_state (st, stream_context (st,
+				stream_byte_at (st, st->pos - 1)));
+	  if (BE (st->state == NULL, 0))
+	    {
+	      st->err = REG_ESPACE;
+	      return;
+	    }
+	  stream_set_state (st, st->state);
+	}
+
+      for (;;)
+	{
+	  re_dfastate_t *next;
+	  int c;
+
+	  if (st->halt_pending)
+	    {
+	      unsigned int context;
+	      if (st->pos < end)
+		context = stream_context (st, st->buf[st->pos - st->base]);
+	      else if (eof)
+		context = stream_context (st, STREAM_EOF);
+	      else
+		return;
+	      st->halt_pending = false;
+	      if (stream_check_halt (st, context))
+		{
+		  st->matched = true;
+		  st->last = st->pos;
+		}
+	    }
+
+	  if (st->pos == end)
+	    {
+	      if (!eof)
+		return;
+	      break;
+	    }
+	  if (st->max_len != 0 && st->pos - st->first >= st->max_len)
+	    break;
+
+	  c = st->buf[st->pos - st->base];
+	  next = stream_transit (st, st->state, c);
+	  if (next == NULL)
+	    {
+	      if (BE (st->err != REG_NOERROR, 0))
+		return;
+	      break;
+	    }
+	  st->pos++;
+	  if (BE (st->at_init_state, 0))
+	    {
+	      if (next == st->state)
+		st->next_start = st->pos;
+	      else
+		st->at_init_state = false;
+	    }
+	  stream_set_state (st, next);
+	}
+
+      /* The candidate is over.  */
+      st->active = false;
+      if (st->matched)
+	{
+	  if (!st->fn (st->first, st->last, st->param))
+	    st->stopped = true;
+	  /* Empty match, don't get stuck at the same place.  */
+	  st->pos = st->last == st->first ? st->last + 1 : st->last;
+	}
+      else
+	st->pos = st->next_start + 1;
+    }
+}
+
+/* Drop bytes which will never be rescanned.  */
+
+static void
+stream_trim (re_stream_t *st)
+{
+  octa keep, end = st->base + st->len;
+  size_t shift;
+
+  if (st->stopped)
+    keep = end;
+  else if (st->active)
+    keep = st->matched ? st->last : st->next_start;
+  else
+    keep = st->pos < end ? st->pos : end;
+
+  if (keep <= st->base)
+    return;
+  shift = keep - st->base;
+  st->before = st->buf[shift - 1];
+  memmove (st->buf, st->buf + shift, st->len - shift);
+  st->len -= shift;
+  st->base = keep;
+}
+
+int
+re_stream_begin (re_stream_t **out, const regex_t *preg, int eflags,
+		 size_t max_match_len, re_stream_fn fn, void *param)
+{
+  re_dfa_t *dfa = preg->buffer;
+  re_stream_t *st;
+  bool icase = (preg->syntax & RE_ICASE) != 0;
+  int i;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL))
+    return REG_BADPAT;
+  if (dfa->nbackref || dfa->has_mb_node || dfa->mb_cur_max > 1)
+    return REG_BADPAT;
+
+  st = re_malloc (re_stream_t, 1);
+  if (BE (st == NULL, 0))
+    return REG_ESPACE;
+  memset (st, 0, sizeof (re_stream_t));
+  st->preg = preg;
+  st->dfa = dfa;
+  st->eflags = eflags;
+  st->max_len = max_match_len;
+  st->fn = fn;
+  st->param = param;
+  st->before = STREAM_BOF;
+
+  for (i = 0; i < SBC_MAX; ++i)
+    {
+      int ch = preg->translate ? preg->translate[i] : i;
+      st->xlat[i] = icase && islower (ch) ? toupper (ch) : ch;
+    }
+
+  st->fastmap = (preg->fastmap != NULL && preg->fastmap_accurate
+		 && !preg->can_be_null) ? preg->fastmap : NULL;
+
+  /* Check if the DFA haven't been compiled.  */
+  if (BE (preg->used == 0 || dfa->init_state == NULL
+	  || dfa->init_state_word == NULL || dfa->init_state_nl == NULL
+	  || dfa->init_state_begbuf == NULL, 0))
+    st->stopped = true;
+  /* See re_search_internal().  */
+  else if (dfa->init_state->nodes.nelem == 0
+	   && dfa->init_state_word->nodes.nelem == 0
+	   && (dfa->init_state_nl->nodes.nelem == 0
+	       || !preg->newline_anchor))
+    st->anchored = true;
+
+  *out = st;
+  return REG_NOERROR;
+}
+
+int
+re_stream_feed (re_stream_t *st, const char *buf, size_t len)
+{
+  if (st->stopped || st->err != REG_NOERROR)
+    return st->err;
+
+  if (st->len + len > st->alloc)
+    {
+      size_t new_alloc = MAX (st->alloc * 2, st->len + len);
+      unsigned char *new_buf = re_realloc (st->buf, unsigned char, new_alloc);
+      if (BE (new_buf == NULL, 0))
+	return st->err = REG_ESPACE;
+      st->buf = new_buf;
+      st->alloc = new_alloc;
+    }
+  memcpy (st->buf + st->len, buf, len);
+  st->len += len;
+
+  __libc_lock_lock (st->dfa->lock);
+  stream_run (st, false);
+  __libc_lock_unlock (st->dfa->lock);
+  stream_trim (st);
+  return st->err;
+}
+
+octa
+re_stream_retained (const re_stream_t *st)
+{
+  return st->len;
+}
+
+int
+re_stream_end (re_stream_t *st)
+{
+  reg_errcode_t err = st->err;
+
+  if (!st->stopped && err == REG_NOERROR)
+    {
+      __libc_lock_lock (st->dfa->lock);
+      stream_run (st, true);
+      __libc_lock_unlock (st->dfa->lock);
+      err = st->err;
+    }
+  re_free (st->buf);
+  re_free (st);
+  return err;
+}
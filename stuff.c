@@ -31,6 +31,11 @@
 
 #ifdef _MSC_VER
 #include <intrin.h>
+#include <windows.h>
+#endif
+
+#ifdef __GNUC__
+#include <time.h>
 #endif
 
 #ifdef __GNUC__
@@ -497,3 +502,19 @@ bool AND_array_of_bools(bool* array, size_t size)
 			return false;
 	return true;
 };
+
+// in seconds, for measuring intervals only
+double get_monotonic_time()
+{
+#ifdef _MSC_VER
+	LARGE_INTEGER freq, cnt;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cnt);
+	return (double)cnt.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec/1e9;
+#endif
+};
+
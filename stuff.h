@@ -125,6 +125,9 @@ extern "C" {
 
 	bool AND_array_of_bools(bool* array, size_t size);
 
+	// in seconds, for measuring intervals only
+	double get_monotonic_time();
+
 #ifdef  __cplusplus
 }
 #endif
@@ -29,6 +29,8 @@
 #include "logging.h"
 #include "lisp.h"
 
+#include <math.h>
+
 void x86_intrin_tests()
 {
 	oassert(rotr32(1,1)==0x80000000);
@@ -42,6 +44,82 @@ void base64_tests()
 	oassert (likely_base64_string("aaAA11")==1);
 	oassert (likely_base64_string("aaaaAAAA1111")==1);
 	oassert (likely_base64_string("aaaaaAAAAA11")==1);
+
+	// RFC 4648 test vectors
+	const char *plain[]={"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+	const char *coded[]={"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+	char enc[64];
+	byte dec[64];
+	size_t dec_len, err_pos;
+	for (int i=0; i<7; i++)
+	{
+		oassert(base64_encode((const byte*)plain[i], strlen(plain[i]), enc)==strlen(coded[i]));
+		oassert(strcmp(enc, coded[i])==0);
+		oassert(base64_decode(coded[i], strlen(coded[i]), dec, &dec_len, NULL)==BASE64_OK);
+		oassert(dec_len==strlen(plain[i]) && memcmp(dec, plain[i], dec_len)==0);
+	};
+
+	// validation
+	oassert(base64_decode("Zm9v!mFy", 8, dec, &dec_len, &err_pos)==BASE64_ERR_BAD_CHAR);
+	oassert(err_pos==4 && dec_len==3);
+	oassert(base64_decode("Zg=", 3, dec, &dec_len, NULL)==BASE64_ERR_BAD_PADDING);
+	oassert(base64_decode("Z===", 4, dec, &dec_len, NULL)==BASE64_ERR_BAD_PADDING);
+	oassert(base64_decode("Zg==Zg==", 8, dec, &dec_len, &err_pos)==BASE64_ERR_TRAILING_DATA);
+	oassert(err_pos==4);
+	oassert(base64_decode("Zm9vY", 5, dec, &dec_len, NULL)==BASE64_ERR_TRUNCATED);
+	oassert(base64_decode("Zm9vYg", 6, dec, &dec_len, NULL)==BASE64_OK && dec_len==4); // no padding is OK
+
+	// long buffers, SIMD and scalar code, streaming with all chunk sizes
+	byte *buf=DMALLOC(byte, 1000, "buf");
+	char *e1=DMALLOC(char, BASE64_ENCODED_LEN(1000)+1, "e1");
+	char *e2=DMALLOC(char, BASE64_ENCODED_LEN(1000)+4, "e2");
+	byte *d1=DMALLOC(byte, 1000+3, "d1");
+	for (int i=0; i<1000; i++)
+		buf[i]=(i*i*7+i*13)&0xFF;
+	for (int simd=0; simd<2; simd++)
+	{
+		base64_simd_enabled=simd;
+		for (size_t len=0; len<1000; len+=37)
+		{
+			size_t e1_len=base64_encode(buf, len, e1);
+			oassert(e1_len==BASE64_ENCODED_LEN(len));
+			oassert(Base64decode((char*)d1, e1)==len && memcmp(d1, buf, len)==0);
+			for (size_t chunk=1; chunk<40; chunk+=7)
+			{
+				base64_encoder e;
+				base64_encoder_init(&e);
+				size_t e2_len=0;
+				for (size_t ofs=0; ofs<len; ofs+=chunk)
+					e2_len+=base64_encoder_feed(&e, buf+ofs, min(chunk, len-ofs), e2+e2_len);
+				e2_len+=base64_encoder_finish(&e, e2+e2_len);
+				oassert(e2_len==e1_len && memcmp(e1, e2, e1_len)==0);
+
+				base64_decoder d;
+				base64_decoder_init(&d, false);
+				size_t d1_len=0, n;
+				for (size_t ofs=0; ofs<e1_len; ofs+=chunk)
+				{
+					oassert(base64_decoder_feed(&d, e1+ofs, min(chunk, e1_len-ofs), d1+d1_len, &n)==BASE64_OK);
+					d1_len+=n;
+				};
+				oassert(base64_decoder_finish(&d, d1+d1_len, &n)==BASE64_OK);
+				d1_len+=n;
+				oassert(d1_len==len && memcmp(d1, buf, len)==0);
+			};
+		};
+	};
+	base64_simd_enabled=true;
+
+	// whitespace
+	base64_decoder d;
+	base64_decoder_init(&d, true);
+	oassert(base64_decoder_feed(&d, "Zm9v\r\nYmFy\n", 11, dec, &dec_len)==BASE64_OK);
+	oassert(dec_len==6 && memcmp(dec, "foobar", 6)==0);
+
+	DFREE(buf);
+	DFREE(e1);
+	DFREE(e2);
+	DFREE(d1);
 };
 
 void octomath_tests()
@@ -114,6 +192,55 @@ void entropy_tests()
 	for (int i=0; i<256; i++)
 		buf[i]=i;
 	oassert(entropy_int (buf, sizeof(buf))>>16==8);
+
+	// streaming, sliding window and block map should agree with entropy()
+	size_t size=5000, window=300, step=7;
+	byte *big=DMALLOC(byte, size, "big");
+	for (size_t i=0; i<size; i++)
+		big[i]=(i<2000) ? (i%5) : (i*i*31+i*7)>>3;
+
+	entropy_state s;
+	entropy_state_init (&s);
+	entropy_state_add (&s, big, 1234);
+	entropy_state_add (&s, big+1234, size-1234);
+	oassert(fabs(entropy_state_get (&s)-entropy(big, size))<1e-9);
+	oassert(abs(entropy_state_get_int (&s)-entropy_int(big, size))<=1);
+
+	size_t total=(size-window)/step+1;
+	double *sliding=DMALLOC(double, total, "sliding");
+	oassert(entropy_sliding (big, size, window, step, sliding)==total);
+	for (size_t i=0; i<total; i++)
+		oassert(fabs(sliding[i]-entropy(big+i*step, window))<1e-9);
+
+	entropy_window w;
+	entropy_window_init (&w, window, true);
+	for (size_t i=0; i<size; i++)
+	{
+		entropy_window_push (&w, big[i]);
+		if (i>=window-1 && (i%97)==0)
+		{
+			double e=entropy(big+i+1-window, window);
+			oassert(fabs(entropy_window_get_int(&w)/65536.0-e)<0.001);
+		};
+	};
+	entropy_window_deinit (&w);
+
+	size_t block=512, blocks=(size+block-1)/block;
+	double *map=DMALLOC(double, blocks, "map");
+	int32_t *map_int=DMALLOC(int32_t, blocks, "map_int");
+	entropy_block_map (big, size, block, map, 4);
+	entropy_block_map_int (big, size, block, map_int, 0);
+	for (size_t i=0; i<blocks; i++)
+	{
+		size_t len=min(block, size-i*block);
+		oassert(map[i]==entropy(big+i*block, len));
+		oassert(map_int[i]==entropy_int(big+i*block, len));
+	};
+
+	DFREE(map);
+	DFREE(map_int);
+	DFREE(sliding);
+	DFREE(big);
 }
 
 void dlist_tests()
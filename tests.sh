@@ -17,6 +17,10 @@ rm $TMPFILE
 diff -b regex_test.correct $TMPFILE
 rm $TMPFILE
 
+./regex_gen_test > $TMPFILE
+diff -b regex_gen_test.correct $TMPFILE
+rm $TMPFILE
+
 ./ostrings_test > $TMPFILE
 diff -b ostrings_test.correct $TMPFILE
 rm $TMPFILE
@@ -37,11 +41,18 @@ rm $TMPFILE
 diff -b rbtree_test.correct $TMPFILE
 rm $TMPFILE
 
+./elf_test > $TMPFILE
+diff -b elf_test.correct $TMPFILE
+rm $TMPFILE
+
 echo hello > tmp
-ec=$(./enum_files_test | grep tmp | grep "size=6" | wc -l)
+./enum_files_test > $TMPFILE
+ec=$(grep tmp $TMPFILE | grep "size=6" | wc -l)
 if [ $ec -ne 1 ]
 then
 	echo enum_files_test failed
 fi
+grep -q "walk_tree: ok" $TMPFILE
+rm $TMPFILE
 rm tmp
 
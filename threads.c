@@ -0,0 +1,370 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _MSC_VER
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#endif
+
+#include "threads.h"
+#include "dmalloc.h"
+#include "oassert.h"
+#include "stuff.h"
+
+unsigned get_CPUs_count()
+{
+#ifdef _MSC_VER
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return si.dwNumberOfProcessors;
+#else
+	long rt=sysconf(_SC_NPROCESSORS_ONLN);
+	if (rt<1)
+		return 1;
+	return rt;
+#endif
+};
+
+void my_mutex_init (my_mutex *m)
+{
+#ifdef _MSC_VER
+	InitializeSRWLock(m);
+#else
+	pthread_mutex_init(m, NULL);
+#endif
+};
+
+void my_mutex_deinit (my_mutex *m)
+{
+#ifndef _MSC_VER
+	pthread_mutex_destroy(m);
+#endif
+};
+
+void my_mutex_lock (my_mutex *m)
+{
+#ifdef _MSC_VER
+	AcquireSRWLockExclusive(m);
+#else
+	pthread_mutex_lock(m);
+#endif
+};
+
+void my_mutex_unlock (my_mutex *m)
+{
+#ifdef _MSC_VER
+	ReleaseSRWLockExclusive(m);
+#else
+	pthread_mutex_unlock(m);
+#endif
+};
+
+void my_rwlock_init (my_rwlock *l)
+{
+#ifdef _MSC_VER
+	InitializeSRWLock(l);
+#else
+	pthread_rwlock_init(l, NULL);
+#endif
+};
+
+void my_rwlock_deinit (my_rwlock *l)
+{
+#ifndef _MSC_VER
+	pthread_rwlock_destroy(l);
+#endif
+};
+
+void my_rwlock_lock_shared (my_rwlock *l)
+{
+#ifdef _MSC_VER
+	AcquireSRWLockShared(l);
+#else
+	pthread_rwlock_rdlock(l);
+#endif
+};
+
+void my_rwlock_unlock_shared (my_rwlock *l)
+{
+#ifdef _MSC_VER
+	ReleaseSRWLockShared(l);
+#else
+	pthread_rwlock_unlock(l);
+#endif
+};
+
+void my_rwlock_lock (my_rwlock *l)
+{
+#ifdef _MSC_VER
+	AcquireSRWLockExclusive(l);
+#else
+	pthread_rwlock_wrlock(l);
+#endif
+};
+
+void my_rwlock_unlock (my_rwlock *l)
+{
+#ifdef _MSC_VER
+	ReleaseSRWLockExclusive(l);
+#else
+	pthread_rwlock_unlock(l);
+#endif
+};
+
+void my_cond_init (my_cond *c)
+{
+#ifdef _MSC_VER
+	InitializeConditionVariable(c);
+#else
+	pthread_cond_init(c, NULL);
+#endif
+};
+
+void my_cond_deinit (my_cond *c)
+{
+#ifndef _MSC_VER
+	pthread_cond_destroy(c);
+#endif
+};
+
+void my_cond_wait (my_cond *c, my_mutex *m)
+{
+#ifdef _MSC_VER
+	SleepConditionVariableSRW(c, m, INFINITE, 0);
+#else
+	pthread_cond_wait(c, m);
+#endif
+};
+
+bool my_cond_timedwait (my_cond *c, my_mutex *m, unsigned ms)
+{
+#ifdef _MSC_VER
+	return SleepConditionVariableSRW(c, m, ms, 0) ? true : false;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec+=ms/1000;
+	ts.tv_nsec+=(long)(ms%1000)*1000000;
+	if (ts.tv_nsec>=1000000000)
+	{
+		ts.tv_sec++;
+		ts.tv_nsec-=1000000000;
+	};
+	return pthread_cond_timedwait(c, m, &ts)!=ETIMEDOUT;
+#endif
+};
+
+void my_cond_signal (my_cond *c)
+{
+#ifdef _MSC_VER
+	WakeConditionVariable(c);
+#else
+	pthread_cond_signal(c);
+#endif
+};
+
+void my_cond_broadcast (my_cond *c)
+{
+#ifdef _MSC_VER
+	WakeAllConditionVariable(c);
+#else
+	pthread_cond_broadcast(c);
+#endif
+};
+
+struct thread_start
+{
+	my_thread_fn fn;
+	void *param;
+};
+
+#ifdef _MSC_VER
+static DWORD WINAPI thread_start_routine (LPVOID p)
+#else
+static void* thread_start_routine (void *p)
+#endif
+{
+	struct thread_start s=*(struct thread_start*)p;
+
+	DFREE(p);
+	s.fn(s.param);
+	return 0;
+};
+
+void my_thread_create (my_thread *t, my_thread_fn fn, void *param)
+{
+	struct thread_start *s=DMALLOC(struct thread_start, 1, "thread_start");
+
+	s->fn=fn;
+	s->param=param;
+#ifdef _MSC_VER
+	*t=CreateThread(NULL, 0, thread_start_routine, s, 0, NULL);
+	if (*t==NULL)
+		die ("%s(): CreateThread() failed\n", __func__);
+#else
+	int rc=pthread_create(t, NULL, thread_start_routine, s);
+	if (rc)
+		die ("%s(): pthread_create() failed: %s\n", __func__, strerror(rc));
+#endif
+};
+
+void my_thread_join (my_thread *t)
+{
+#ifdef _MSC_VER
+	WaitForSingleObject(*t, INFINITE);
+	CloseHandle(*t);
+#else
+	pthread_join(*t, NULL);
+#endif
+};
+
+void my_tls_create (my_tls_key *k, void (*destructor)(void*))
+{
+#ifdef _MSC_VER
+	// fiber local storage: unlike TlsAlloc(), it has a callback at thread exit
+	*k=FlsAlloc((PFLS_CALLBACK_FUNCTION)destructor);
+	if (*k==FLS_OUT_OF_INDEXES)
+		die ("%s(): FlsAlloc() failed\n", __func__);
+#else
+	int rc=pthread_key_create(k, destructor);
+	if (rc)
+		die ("%s(): pthread_key_create() failed: %s\n", __func__, strerror(rc));
+#endif
+};
+
+void my_tls_delete (my_tls_key *k)
+{
+#ifdef _MSC_VER
+	FlsFree(*k);
+#else
+	pthread_key_delete(*k);
+#endif
+};
+
+void *my_tls_get (my_tls_key *k)
+{
+#ifdef _MSC_VER
+	return FlsGetValue(*k);
+#else
+	return pthread_getspecific(*k);
+#endif
+};
+
+void my_tls_set (my_tls_key *k, void *v)
+{
+#ifdef _MSC_VER
+	FlsSetValue(*k, v);
+#else
+	pthread_setspecific(*k, v);
+#endif
+};
+
+struct parallel_for_state
+{
+	size_t total;
+	volatile size_t next;
+	parallel_for_fn fn;
+	void *param;
+};
+
+static size_t fetch_and_inc (volatile size_t *p)
+{
+#ifdef _MSC_VER
+#if __WORDSIZE==64
+	return InterlockedExchangeAdd64((volatile LONG64*)p, 1);
+#else
+	return InterlockedExchangeAdd((volatile LONG*)p, 1);
+#endif
+#else
+	return __atomic_fetch_add(p, 1, __ATOMIC_RELAXED);
+#endif
+};
+
+static void parallel_for_worker (struct parallel_for_state *s)
+{
+	size_t i;
+	while ((i=fetch_and_inc(&s->next)) < s->total)
+		s->fn(i, s->param);
+};
+
+#ifdef _MSC_VER
+static DWORD WINAPI parallel_for_thread (LPVOID p)
+{
+	parallel_for_worker ((struct parallel_for_state*)p);
+	return 0;
+};
+#else
+static void* parallel_for_thread (void *p)
+{
+	parallel_for_worker ((struct parallel_for_state*)p);
+	return NULL;
+};
+#endif
+
+void parallel_for (size_t total, unsigned threads, parallel_for_fn fn, void *param)
+{
+	struct parallel_for_state s;
+	s.total=total;
+	s.next=0;
+	s.fn=fn;
+	s.param=param;
+
+	if (threads==0)
+		threads=get_CPUs_count();
+	if (threads>total)
+		threads=total;
+	if (threads<=1)
+	{
+		parallel_for_worker (&s);
+		return;
+	};
+
+	// current thread is a worker as well
+#ifdef _MSC_VER
+	HANDLE *h=DMALLOC(HANDLE, threads-1, "HANDLE");
+	for (unsigned t=0; t<threads-1; t++)
+	{
+		h[t]=CreateThread(NULL, 0, parallel_for_thread, &s, 0, NULL);
+		if (h[t]==NULL)
+			die ("%s(): CreateThread() failed\n", __func__);
+	};
+	parallel_for_worker (&s);
+	for (unsigned t=0; t<threads-1; t++)
+	{
+		WaitForSingleObject(h[t], INFINITE);
+		CloseHandle(h[t]);
+	};
+#else
+	pthread_t *h=DMALLOC(pthread_t, threads-1, "pthread_t");
+	for (unsigned t=0; t<threads-1; t++)
+	{
+		int rc=pthread_create(&h[t], NULL, parallel_for_thread, &s);
+		if (rc)
+			die ("%s(): pthread_create() failed: %s\n", __func__, strerror(rc));
+	};
+	parallel_for_worker (&s);
+	for (unsigned t=0; t<threads-1; t++)
+		pthread_join(h[t], NULL);
+#endif
+	DFREE(h);
+};
+
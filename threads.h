@@ -0,0 +1,143 @@
+/*
+ *             _        _   _                           
+ *            | |      | | | |                          
+ *   ___   ___| |_ ___ | |_| |__   ___  _ __ _ __   ___ 
+ *  / _ \ / __| __/ _ \| __| '_ \ / _ \| '__| '_ \ / _ \
+ * | (_) | (__| || (_) | |_| | | | (_) | |  | |_) |  __/
+ *  \___/ \___|\__\___/ \__|_| |_|\___/|_|  | .__/ \___|
+ *                                          | |         
+ *                                          |_|
+ *
+ * Written by Dennis Yurichev <dennis(a)yurichev.com>, 2013
+ *
+ * This work is licensed under the Creative Commons Attribution-NonCommercial-NoDerivs 3.0 Unported License. 
+ * To view a copy of this license, visit http://creativecommons.org/licenses/by-nc-nd/3.0/.
+ *
+ */
+
+// Rationale: minimal portable layer over pthreads/Win32 threads, just what other modules need.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "datatypes.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+unsigned get_CPUs_count();
+
+#ifdef _MSC_VER
+// SRWLOCK: Vista+, can be initialized statically
+typedef SRWLOCK my_mutex;
+#define MY_MUTEX_INITIALIZER SRWLOCK_INIT
+#else
+typedef pthread_mutex_t my_mutex;
+#define MY_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#endif
+
+void my_mutex_init (my_mutex *m);
+void my_mutex_deinit (my_mutex *m);
+void my_mutex_lock (my_mutex *m);
+void my_mutex_unlock (my_mutex *m);
+
+// readers-writer lock, for data which is mostly read
+#ifdef _MSC_VER
+typedef SRWLOCK my_rwlock;
+#else
+typedef pthread_rwlock_t my_rwlock;
+#endif
+
+void my_rwlock_init (my_rwlock *l);
+void my_rwlock_deinit (my_rwlock *l);
+void my_rwlock_lock_shared (my_rwlock *l);
+void my_rwlock_unlock_shared (my_rwlock *l);
+void my_rwlock_lock (my_rwlock *l);
+void my_rwlock_unlock (my_rwlock *l);
+
+// condition variable, used with my_mutex
+#ifdef _MSC_VER
+typedef CONDITION_VARIABLE my_cond;
+#else
+typedef pthread_cond_t my_cond;
+#endif
+
+void my_cond_init (my_cond *c);
+void my_cond_deinit (my_cond *c);
+void my_cond_wait (my_cond *c, my_mutex *m);
+// false on timeout
+bool my_cond_timedwait (my_cond *c, my_mutex *m, unsigned ms);
+void my_cond_signal (my_cond *c);
+void my_cond_broadcast (my_cond *c);
+
+// threads, die() is called if a thread can't be created
+#ifdef _MSC_VER
+typedef HANDLE my_thread;
+#else
+typedef pthread_t my_thread;
+#endif
+
+typedef void (*my_thread_fn)(void *param);
+
+void my_thread_create (my_thread *t, my_thread_fn fn, void *param);
+void my_thread_join (my_thread *t);
+
+// thread-local value, destructor (if not NULL) is called at thread exit for values which are not NULL
+#ifdef _MSC_VER
+typedef DWORD my_tls_key;
+#else
+typedef pthread_key_t my_tls_key;
+#endif
+
+void my_tls_create (my_tls_key *k, void (*destructor)(void*));
+void my_tls_delete (my_tls_key *k);
+void *my_tls_get (my_tls_key *k);
+void my_tls_set (my_tls_key *k, void *v);
+
+// for simple thread-local variables, without destructors
+#ifdef _MSC_VER
+#define MY_THREAD_LOCAL __declspec(thread)
+#else
+#define MY_THREAD_LOCAL __thread
+#endif
+
+// for lock-free structures, p is size_t*
+#ifdef _MSC_VER
+// on x86/x64, volatile accesses have acquire/release semantics in MSVC (/volatile:ms)
+#define MY_LOAD_ACQUIRE(p) (*(volatile size_t*)(p))
+#define MY_STORE_RELEASE(p, v) (*(volatile size_t*)(p)=(v))
+#else
+#define MY_LOAD_ACQUIRE(p) __atomic_load_n ((p), __ATOMIC_ACQUIRE)
+#define MY_STORE_RELEASE(p, v) __atomic_store_n ((p), (v), __ATOMIC_RELEASE)
+#endif
+
+// returns the old value, v can be (size_t)-1
+#ifdef _MSC_VER
+#if __WORDSIZE==64
+#define MY_FETCH_ADD(p, v) ((size_t)InterlockedExchangeAdd64 ((volatile LONG64*)(p), (LONG64)(v)))
+#else
+#define MY_FETCH_ADD(p, v) ((size_t)InterlockedExchangeAdd ((volatile LONG*)(p), (LONG)(v)))
+#endif
+#else
+#define MY_FETCH_ADD(p, v) __atomic_fetch_add ((p), (v), __ATOMIC_ACQ_REL)
+#endif
+
+typedef void (*parallel_for_fn)(size_t i, void *param);
+
+// call fn(i, param) for each i in [0, total) using several threads
+// threads==0 means get_CPUs_count(), indices are handed out dynamically, so uneven jobs are OK
+void parallel_for (size_t total, unsigned threads, parallel_for_fn fn, void *param);
+
+#ifdef  __cplusplus
+}
+#endif
+
@@ -62,7 +62,7 @@ void dump_flags (fds *s, tetra flags)
     strbuf sb = STRBUF_INIT;
     flags_to_str(flags, &sb);
 
-    L_fds (s, sb.buf);
+    L_fds (s, "%s", sb.buf);
 
     strbuf_deinit (&sb);
 };
@@ -96,7 +96,7 @@ void dump_DR7 (fds* s, tetra DR7)
 {
     strbuf sb=STRBUF_INIT;
     DR7_to_str(DR7, &sb);
-    L_fds (s, sb.buf);
+    L_fds (s, "%s", sb.buf);
     strbuf_deinit(&sb);
 };
 
@@ -253,4 +253,20 @@ bool sse2_supported()
     return false;
 };
 
+bool ssse3_supported()
+{
+#ifdef _MSC_VER
+    int b[4];
+    __cpuid(b,1);
+    if (b[2] & (1<<9)) // ECX, bit 9
+        return true;
+#else
+    int a, b, c, d;
+    __cpuid(1, a, b, c, d);
+    if (c & (1<<9)) // ECX, bit 9
+        return true;
+#endif
+    return false;
+};
+
 /* vim: set expandtab ts=4 sw=4 : */
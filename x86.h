@@ -130,6 +130,7 @@ void XMM_to_strbuf (byte* p, strbuf *sb);
 
 bool sse_supported();
 bool sse2_supported();
+bool ssse3_supported();
 
 #if __WORDSIZE==64
 #define AX_REGISTER_NAME "RAX"